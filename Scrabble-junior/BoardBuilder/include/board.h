@@ -3,27 +3,36 @@
 
 #include <iostream>
 #include <vector>
+#include <unordered_map>
+#include <cstdint>
 #include "cell.h"
 #include "position.h"
 #include "word.h"
 
 // Represents a Scrabble board.
+//
+// Only 'Cell's with a letter are kept, so a 'Board' may be far bigger
+// than the console (up to 'MAX_SIZE' in each direction) as long as most
+// of it is empty.
 class Board {
     // The width of the 'Board'.
     unsigned int width;
     // The height of the 'Board'.
     unsigned int height;
 
-    // The matrix of cells that form this 'Board'.
-    std::vector<std::vector<Cell>> grid;
+    // The 'Cell's with a letter of this 'Board', by 'keyOf' their 'Position'.
+    std::unordered_map<uint64_t, Cell> cells;
     // A list of all words inserted in this 'Board'.
     std::vector<Word> words;
 
-    // The total number of letters (non-empty cells) 
-    // that this 'Board' contains.
-    unsigned int total_letters;
+    // Returns the key of 'position' in 'cells'.
+    static uint64_t keyOf(Position position);
     
     public:
+    // The largest width and height of a 'Board': every row and column
+    // has a name in board coordinates (see 'Position').
+    static const unsigned int MAX_SIZE = 26 + 26*26 + 26*26*26;
+
     // Constructs a 'Board' with given width and height.
     Board(unsigned int width, unsigned int height);
 
@@ -37,7 +46,8 @@ class Board {
     unsigned int getHeight() const;
     // Returns the 'width' of this 'Board'.
     unsigned int getWidth() const;
-    // Returns the 'Cell' at the given 'Position'.
+    // Returns the 'Cell' at the given 'Position', which is empty if
+    // it has no letter.
     const Cell& getCell(Position position) const;
 
     // Returns whether the given 'Word' may currently be 
@@ -68,6 +78,9 @@ class Board {
     void loadWords(std::istream &save);
     // Writes the data from this 'Board' to stram 'out', obeying
     // the specification of a board file.
+    //
+    // The 2D representation at the end is only written for boards whose
+    // rows and columns are all named by a single letter.
     void writeData(std::ostream &out) const;
 };
 
@@ -22,6 +22,11 @@ class BoardBuilder {
     // Try to parse a 'Position' from 'input' to 'position'.
     // Returns whether the parsing was successful.
     bool parsePosition(std::istream &input, Position &position);
+    // Try to parse the command 'view Ab', which scrolls the board to
+    // the given position, from 'input'. Returns whether 'input' was that
+    // command (even if its position was invalid); otherwise, nothing
+    // is consumed from 'input'.
+    bool parseViewCommand(std::istream &input);
     // Try to parse an 'Orientation' from 'input' to 'orientation'.
     // Returns whether the parsing was successful.
     bool parseOrientation(std::istream &input, Orientation &orientation);
@@ -7,22 +7,61 @@
 #include "board.h"
 #include "word.h"
 #include "cmd.h"
+#include "screen.h"
+#include "viewport.h"
 
 // Helps to display and animate the state of the program to the user.
+//
+// The board and its properties are drawn to a 'Screen', so updating them
+// only writes what changed. The prompt is written below them directly.
+// Only the part of the board that fits in the console is shown, which
+// scrolls to each new word.
 class BoardBuilderDisplayer {
     // Number of milliseconds between adding each
     // letter when adding a new 'Word' to the board.
     static const int ADD_LETTER_TO_BOARD_DELAY;
+    // Width of the zone of the screen that shows board properties.
+    static const unsigned int BOARD_INFO_WIDTH;
+    // Columns kept for board properties, and lines kept below the board
+    // for the prompt, when the board doesn't fit in the console.
+    static const unsigned int MIN_BOARD_INFO_WIDTH;
+    static const unsigned int PROMPT_HEIGHT;
+    // Fewest columns and rows of the board shown, however small the console.
+    static const unsigned int MIN_VIEWPORT_SIZE;
+    // Most columns and rows of the board shown when the size of the console
+    // is unknown: those named by a single letter.
+    static const unsigned int MAX_VIEWPORT_SIZE;
 
     // The stream of error messages printed immediately
     // before prompting user for input.
     std::ostringstream error_messages;
+    // The part of the board shown.
+    Viewport viewport;
+    // Columns taken by the names of the rows, on the left of the board,
+    // and lines taken by the names of the columns, written downwards
+    // above it (see 'Position').
+    unsigned int label_width;
+    unsigned int label_height;
     // Horizontal offset before starting the zone of the
     // screen that shows board properties.
     unsigned int board_info_x_offset;
     // Vertical offset before starting the zone of the
     // screen where the player is prompted for input.
     unsigned int prompt_y_offset;
+    // What the board and its properties look like on screen.
+    Screen screen;
+
+    // Auxiliary method to draw 'label' in a dark color followed by
+    // 'value' at line 'y' of the zone of board properties.
+    void drawBoardInfoLine(int y, const std::string &label, const std::string &value, Color value_color);
+    // Auxiliary method to size the 'Viewport' and the zones of the screen
+    // for the console. Returns whether anything moved, so that everything
+    // must be drawn again.
+    bool fitToConsole();
+    // Auxiliary methods of 'printBoard' to draw the labels of the rows and
+    // columns shown, and to draw 'cell' at 'position', which must be shown.
+    void drawLabels();
+    void drawCell(Position position, const Cell &cell);
 
     public:
     // Normal text color.
@@ -48,17 +87,23 @@ class BoardBuilderDisplayer {
     std::ostream& getErrorStream();
     // Clears all errors in the stream of error messages.
     void clearErrors();
+    // Clears the console, to draw everything again.
+    void clearScreen();
 
-    // Prints the given 'Board' to screen.
-    void printBoard(const Board &board) const;
+    // Prints the part of the given 'Board' that is shown to screen.
+    void printBoard(const Board &board);
+    // Scrolls the board shown so 'position' is in the middle, as far as
+    // the board allows. It is shown by the next 'printBoard'.
+    void centerOn(Position position);
     // Prints the properties of given 'Board' to screen, along with
     // its name and the maximum number of players.
-    void printBoardInfo(const std::string &board_name, const Board &board, unsigned int max_players) const;
+    void printBoardInfo(const std::string &board_name, const Board &board, unsigned int max_players);
     // Prints the prompt for user to enter another word.
     void printPrompt(unsigned int max_players, unsigned int total_letters) const;
     // Prints a new word, letter by letter (with a short delay inbetween)
-    // that is being added to the board. 
-    void printNewWord(const Word &word, const Board &board) const;
+    // that is being added to the board, first scrolling to it if its
+    // start isn't shown.
+    void printNewWord(const Word &word, const Board &board);
 };
 
 #endif
\ No newline at end of file
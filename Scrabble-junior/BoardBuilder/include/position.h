@@ -2,10 +2,18 @@
 #define POSITION_H
 
 #include <ostream>
+#include <string>
+#include <string_view>
 #include <utility>
 #include "orientation.h"
 
 // Represents a position in the board.
+//
+// In board coordinates, the row is written in uppercase letters followed
+// by the column in lowercase ones. Past 'Z' (or 'z') they continue like
+// the columns of a spreadsheet: 'AA', 'AB', ..., 'AZ', 'BA', ..., 'ZZ',
+// 'AAA', and so on. So 'Ab' is row 0, column 1, and 'AAbc' is row 26,
+// column 54.
 class Position {
     // Overload of the insertion operator.
     // Prints this position in board coordinates. (For example, 'Ab')
@@ -17,18 +25,24 @@ class Position {
     int y;
 
     public:
+    // The most letters in the row or in the column of board coordinates.
+    static const int MAX_COORDINATE_LETTERS = 3;
+
     // Default constructor. Constructs a 'Position' at the origin
     // (top left corner of the board).
     Position();
     // Constructs a 'Position' with given numeric coordinates.
     Position(int x, int y);
-    // Constructs a 'Position' with given board coordinates.
-    // (For example, 'Ab' is ('b', 'A'))
-    //
-    // Should be constructed with valid board coordinates ('x' must
-    // be a letter in range 'a-z', and 'y' must be a letter in range
-    // 'A-Z').
-    Position(char x, char y); 
+
+    // Parses board coordinates, like 'Ab' or 'AAbc', into 'position'.
+    // Returns whether 'coordinates' are valid: one to
+    // 'MAX_COORDINATE_LETTERS' uppercase letters followed by one
+    // to 'MAX_COORDINATE_LETTERS' lowercase ones, and nothing else.
+    static bool parse(std::string_view coordinates, Position &position);
+    // Returns the name of row 'y' in board coordinates ('A' for 0).
+    static std::string rowName(int y);
+    // Returns the name of column 'x' in board coordinates ('a' for 0).
+    static std::string columnName(int x);
 
     // Returns the numeric x coordinate.
     int getX() const;
@@ -0,0 +1,97 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+
+#include <string>
+#include <vector>
+#include "cmd.h"
+
+// A buffer of what the top left rectangle of the console shows, so that
+// it can be redrawn without caring about what is already there.
+//
+// Everything is drawn to the next frame with 'put', 'print' and 'erase',
+// and 'flush' writes only the characters that changed since the last one,
+// moving the cursor and changing colors only when needed, all in a single
+// write. Redrawing a whole board where one letter was covered only writes
+// that letter.
+class Screen {
+    public:
+    // A character on the screen, with its colors.
+    struct Glyph {
+        char character;
+        Color color;
+        Color background;
+
+        bool operator==(const Glyph &other) const;
+        bool operator!=(const Glyph &other) const;
+    };
+
+    private:
+    // Most characters between two changes that are written again
+    // instead of moving the cursor, which takes more bytes.
+    static const int MAX_REWRITTEN_GAP = 4;
+
+    // Size of the rectangle, in characters.
+    int width;
+    int height;
+    // Colors of empty space, which are also left set after every frame.
+    Color text_color;
+    Color background;
+    // Whether frames are written as ANSI escape sequences. Otherwise they
+    // are written with 'gotoxy' and 'setcolor', which is slower.
+    bool ansi;
+
+    // What the console shows, row after row. A character of 0 is unknown.
+    std::vector<Glyph> shown;
+    // What the next frame shows, row after row.
+    std::vector<Glyph> next;
+    // Indexes of 'next' changed since the last frame, each only once,
+    // so 'flush' doesn't need to look at the others.
+    std::vector<int> dirty;
+    std::vector<bool> is_dirty;
+
+    // The frame being written, reused between frames.
+    std::string output;
+    // Where the cursor is while writing a frame (-1 if unknown), and its
+    // colors, if known.
+    int cursor_x;
+    int cursor_y;
+    Color cursor_color;
+    Color cursor_background;
+    bool colors_known;
+
+    // Returns an empty character.
+    Glyph blank() const;
+    // Changes the character at 'x', 'y' of the next frame, which must be inside.
+    void set(int x, int y, const Glyph &glyph);
+    // Write the cursor movement, the colors and the characters of a frame.
+    void moveCursor(int x, int y);
+    void changeColors(Color color, Color background);
+    void write(char character);
+
+    public:
+    // Constructs a screen of 'width' by 'height' characters, whose empty
+    // space has 'text_color' on 'background'. What the console shows is
+    // unknown, so the first frame writes everything.
+    Screen(int width, int height, Color text_color, Color background = BLACK);
+
+    int getWidth() const;
+    int getHeight() const;
+
+    // Puts 'character' at column 'x', line 'y' of the next frame, with
+    // 'color' on 'background'. Nothing is put outside the screen.
+    void put(int x, int y, char character, Color color, Color background = BLACK);
+    // Puts 'text' from column 'x', line 'y' of the next frame. Returns the
+    // column after it.
+    int print(int x, int y, const std::string &text, Color color, Color background = BLACK);
+    // Erases 'length' characters from column 'x', line 'y' of the next frame.
+    void erase(int x, int y, int length);
+
+    // Tells the screen that the console was cleared (see 'clrscr'), so the
+    // next frame is empty and nothing needs to be written for it.
+    void clear();
+    // Writes what changed in the next frame to the console, leaving the
+    // cursor at the start of the line below the screen with its colors.
+    void flush();
+};
+
+#endif
@@ -2,21 +2,30 @@
 
 using namespace std;
 
+// The 'Cell' of every 'Position' without a letter.
+static const Cell EMPTY_CELL;
+
+// Most rows and columns of a 'Board' written with a 2D representation
+// by 'writeData': those named by a single letter.
+static const unsigned int MAX_PICTURE_SIZE = 26;
+
 Board::Board(unsigned int width, unsigned int height): 
   width(width), 
-  height(height), 
-  grid(height, vector<Cell>(width)),
-  total_letters(0)
+  height(height)
 {}
 
+uint64_t Board::keyOf(Position position) {
+    return (uint64_t) position.getY() << 32 | (uint32_t) position.getX();
+}
+
 void Board::loadWords(istream &save) {
-    char x, y, orientation_char;
-    string word_str;
+    string coordinates, word_str;
+    char orientation_char;
 
-    while(save >> y >> x >> orientation_char >> word_str) {
+    while(save >> coordinates >> orientation_char >> word_str) {
         // If can't parse position, stop loading.
-        if(x < 'a' || x > 'z' || y < 'A' || y > 'Z') break;
-        Position position(x, y);
+        Position position;
+        if(!Position::parse(coordinates, position)) break;
         
         Orientation orientation;
         if(orientation_char == 'H') orientation = Horizontal;
@@ -33,7 +42,7 @@ void Board::loadWords(istream &save) {
 }
 
 unsigned int Board::countLetters() const {
-    return total_letters;
+    return (unsigned int) cells.size();
 }
 
 unsigned int Board::countWords() const {
@@ -49,7 +58,8 @@ unsigned int Board::getWidth() const {
 }
 
 const Cell& Board::getCell(Position position) const {
-    return grid[position.getY()][position.getX()];
+    auto found = cells.find(keyOf(position));
+    return found == cells.end() ? EMPTY_CELL : found->second;
 }
 
 void Board::addWord(const Word &word) {
@@ -57,10 +67,8 @@ void Board::addWord(const Word &word) {
     Orientation orientation = word.getOrientation();
 
     for(char letter: word) {
-        Cell &cell = grid[position.getY()][position.getX()];
-        // Only increases letter count if letter didn't exist before.
-        if(cell.isEmpty()) total_letters += 1;
-        cell.setLetter(letter);
+        // Only adds a 'Cell' if letter didn't exist before.
+        cells[keyOf(position)].setLetter(letter);
         position.stepForward(orientation);
     }
 
@@ -151,6 +159,8 @@ void Board::writeData(ostream &out) const {
         out << word << endl;
     }
 
+    if(width > MAX_PICTURE_SIZE || height > MAX_PICTURE_SIZE) return;
+
     // Write a 2D representation of the board at the end.
     // This is similar to 'BoardBuilder::printBoard'. However, this
     // function doesn't call setcolor and prints an extra space between
@@ -167,7 +177,7 @@ void Board::writeData(ostream &out) const {
         out << letter << ' ';
 
         for(unsigned int i = 0; i < width; i++) {
-            out << grid[j][i];
+            out << getCell(Position((int) i, (int) j));
             
             if(i+1 != width) {
                 out << ' ';
@@ -3,6 +3,7 @@
 #include <sstream>
 #include <cctype>
 #include <algorithm>
+#include <limits>
 #include "boardBuilder.h"
 #include "cmd.h"
 
@@ -28,23 +29,43 @@ bool BoardBuilder::parsePosition(istream &input, Position &position) {
         return false;
     }
 
-    if(position_str.size() != 2) {
+    if(!Position::parse(position_str, position)) {
         error_messages << "Couldn't parse '" << position_str
-                << "' as a position. Use an uppercase letter followed by a lowercase one, like 'Aa'.\n";
+                << "' as a position. Use uppercase letters for the row followed by lowercase ones"
+                << " for the column, like 'Aa' or 'ABcd'.\n";
         return false;
     }
 
-    char x_char = position_str[1];
-    char y_char = position_str[0];
-    
-    if(x_char < 'a' || x_char > 'z' || y_char < 'A' || y_char > 'Z') {
-        error_messages << "Couldn't parse '" << position_str
-                << "' as a position. Use an uppercase letter followed by a lowercase one, like 'Aa'.\n";
+    return true;
+}
+
+bool BoardBuilder::parseViewCommand(istream &input) {
+    streampos start = input.tellg();
+    string command;
+    input >> command;
+    transform(command.begin(), command.end(), command.begin(), [](char c) { return (char) tolower(c); });
+    if(command != "view") {
+        input.clear();
+        input.seekg(start);
         return false;
     }
 
-    position = Position(x_char, y_char);
+    ostream &error_messages = displayer.getErrorStream();
+    Position position;
+    if(!parsePosition(input, position)) return true;
+    if(!position.inLimits(board.getWidth(), board.getHeight())) {
+        error_messages << "Position '" << position << "' is outside the board.\n";
+        return true;
+    }
 
+    string unexpected;
+    input >> unexpected;
+    if(unexpected.size() != 0) {
+        error_messages << "Unexpected: '" << unexpected << "'\n";
+        return true;
+    }
+
+    displayer.centerOn(position);
     return true;
 }
 
@@ -87,7 +108,7 @@ bool BoardBuilder::parseWordStr(istream &input, string &word_str) {
     }
 
     // Check if string can really be a word (may only have ASCII alphabetic characters).
-    auto is_alpha_lambda = [](char c) { return (char) isalpha(c); };
+    auto is_alpha_lambda = [](char c) { return isalpha((unsigned char) c) != 0; };
     auto invalid_char = find_if_not(word_str.begin(), word_str.end(), is_alpha_lambda);
     if(invalid_char != word_str.end()) {            
         error_messages << "Only allowed words with ASCII alphabetic letters.\n";
@@ -111,15 +132,15 @@ bool BoardBuilder::parseWordStr(istream &input, string &word_str) {
 }
 
 void BoardBuilder::run() {
-    clrscr();
-    // Board is only fully printed once, at the start, because afterwards
-    // it can be reused, only updating 'Cell's that change.
-    displayer.printBoard(board);
+    displayer.clearScreen();
 
     while(true) {
-        // Update state and screen.
+        // Update state and screen. The board is printed every time, in
+        // case it scrolled or the console was resized, but only 'Cell's
+        // that changed on screen are written.
         max_players = min(4u, board.countLetters()/7);
 
+        displayer.printBoard(board);
         displayer.printBoardInfo(board_name, board, max_players);
         displayer.printPrompt(max_players, board.countLetters());
         displayer.clearErrors();
@@ -136,6 +157,9 @@ void BoardBuilder::run() {
         }
         stringstream input_stream(input);
 
+        // 'view Ab' scrolls the board instead of placing a word.
+        if(parseViewCommand(input_stream)) continue;
+
         // Parse input.
         Position position;
         Orientation orientation;
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <climits>
 #include <chrono>
 #include <thread>
 #include "boardBuilderDisplayer.h"
@@ -16,12 +17,61 @@ const Color BoardBuilderDisplayer::LETTER_COLOR = BLACK;
 const Color BoardBuilderDisplayer::BOARD_BACKGROUND = LIGHTGRAY;
 
 const int BoardBuilderDisplayer::ADD_LETTER_TO_BOARD_DELAY = 200;
+const unsigned int BoardBuilderDisplayer::BOARD_INFO_WIDTH = 80;
+const unsigned int BoardBuilderDisplayer::MIN_BOARD_INFO_WIDTH = 32;
+const unsigned int BoardBuilderDisplayer::PROMPT_HEIGHT = 13;
+const unsigned int BoardBuilderDisplayer::MIN_VIEWPORT_SIZE = 5;
+const unsigned int BoardBuilderDisplayer::MAX_VIEWPORT_SIZE = 26;
+
+// Returns the character on line 'line' of 'name' written downwards, so that
+// names written in 'lines' lines all end on the last one ('name' must fit).
+static char getLabelCharacter(const string &name, int line, int lines) {
+    int index = line - (lines - (int) name.size());
+    return index < 0 ? ' ' : name[index];
+}
 
 BoardBuilderDisplayer::BoardBuilderDisplayer(unsigned int board_width, unsigned int board_height):
+    viewport(board_width, board_height),
+    label_width((unsigned int) Position::rowName((int) board_height - 1).size()),
+    label_height((unsigned int) Position::columnName((int) board_width - 1).size()),
+    board_info_x_offset(0),
+    prompt_y_offset(0),
+    screen(0, 0, TEXT_COLOR)
+{
+    fitToConsole();
+}
+
+bool BoardBuilderDisplayer::fitToConsole() {
+    unsigned int view_width = MAX_VIEWPORT_SIZE, view_height = MAX_VIEWPORT_SIZE;
+    unsigned int screen_width = UINT_MAX;
+    int columns, lines;
+    if(getConsoleSize(columns, lines)) {
+        // A column is left between the board and its properties, and a
+        // line between the board and the prompt.
+        int free_columns = columns - (int) (MIN_BOARD_INFO_WIDTH + label_width) - 1;
+        int free_lines = lines - (int) (PROMPT_HEIGHT + label_height) - 1;
+        view_width = max(MIN_VIEWPORT_SIZE, (unsigned int) max(free_columns / 2, 0));
+        view_height = max(MIN_VIEWPORT_SIZE, (unsigned int) max(free_lines, 0));
+        // Nothing is drawn past the last column, where it would wrap.
+        screen_width = (unsigned int) columns;
+    }
+    viewport.resize(view_width, view_height);
+
     // Offsets are calculated based on the size of the board on screen.
-    board_info_x_offset(board_width*2 + 2),
-    prompt_y_offset(max(8u, board_height + 2)) // Must not be smaller than 8 because of height of board properties
-{}
+    unsigned int new_board_info_x_offset = label_width + viewport.getWidth()*2 + 1;
+    // Must not be smaller than 8 because of height of board properties.
+    unsigned int new_prompt_y_offset = max(8u, label_height + viewport.getHeight() + 1);
+    screen_width = min(new_board_info_x_offset + BOARD_INFO_WIDTH, screen_width);
+    if(new_board_info_x_offset == board_info_x_offset && new_prompt_y_offset == prompt_y_offset
+            && (int) screen_width == screen.getWidth()) {
+        return false;
+    }
+
+    board_info_x_offset = new_board_info_x_offset;
+    prompt_y_offset = new_prompt_y_offset;
+    screen = Screen((int) screen_width, (int) prompt_y_offset, TEXT_COLOR);
+    return true;
+}
 
 std::ostream& BoardBuilderDisplayer::getErrorStream() {
     return error_messages;
@@ -31,77 +81,88 @@ void BoardBuilderDisplayer::clearErrors() {
     error_messages.str("");
 }
 
-void BoardBuilderDisplayer::printBoard(const Board &board) const {
-    setcolor(TEXT_COLOR);
-    cout << ' ';
-    for(unsigned int i = 0; i < board.getWidth(); i++) {
-        char letter = (char) i + 'a';
-        cout << letter << ' ';
+void BoardBuilderDisplayer::clearScreen() {
+    clrscr();
+    screen.clear();
+}
+
+void BoardBuilderDisplayer::printBoard(const Board &board) {
+    if(fitToConsole()) clearScreen();
+    drawLabels();
+
+    for(int j = viewport.getY(); j < viewport.getY() + viewport.getHeight(); j++) {
+        for(int i = viewport.getX(); i < viewport.getX() + viewport.getWidth(); i++) {
+            Position position(i, j);
+            drawCell(position, board.getCell(position));
+        }
     }
-    cout << '\n';
-
-    for(unsigned int j = 0; j < board.getHeight(); j++) {
-        char letter = (char) j + 'A';
-        cout << letter;
-        
-        setcolor(LETTER_COLOR, BOARD_BACKGROUND);
-        for(unsigned int i = 0; i < board.getWidth(); i++) {
-            Position position((int) i, (int) j);
-            cout << board.getCell(position);
-            
-            if(i+1 != board.getWidth()) {
-                cout << ' ';
-            }
+    screen.flush();
+}
+
+void BoardBuilderDisplayer::centerOn(Position position) {
+    viewport.centerOn(position);
+}
+
+void BoardBuilderDisplayer::drawLabels() {
+    // Every character of the labels is drawn, so no letter of a longer
+    // name is left behind when scrolling.
+    for(int i = 0; i < viewport.getWidth(); i++) {
+        string name = Position::columnName(viewport.getX() + i);
+        for(int line = 0; line < (int) label_height; line++) {
+            screen.put((int) label_width + i*2, line, getLabelCharacter(name, line, (int) label_height), TEXT_COLOR);
         }
-        setcolor(TEXT_COLOR);
-        cout << '\n';
     }
+    for(int j = 0; j < viewport.getHeight(); j++) {
+        string name = Position::rowName(viewport.getY() + j);
+        name.resize(label_width, ' ');
+        screen.print(0, (int) label_height + j, name, TEXT_COLOR);
+    }
+}
+
+void BoardBuilderDisplayer::drawCell(Position position, const Cell &cell) {
+    // Find the position in screen given position in board.
+    int x = (position.getX() - viewport.getX())*2 + (int) label_width;
+    int y = position.getY() - viewport.getY() + (int) label_height;
+    screen.put(x, y, cell.getLetter(), LETTER_COLOR, BOARD_BACKGROUND);
+
+    // The last 'Cell' shown of a row has no space after it.
+    if(position.getX() + 1 != viewport.getX() + viewport.getWidth()) {
+        screen.put(x + 1, y, ' ', LETTER_COLOR, BOARD_BACKGROUND);
+    }
+}
+
+void BoardBuilderDisplayer::drawBoardInfoLine(int y, const string &label, const string &value, Color value_color) {
+    int x = (int) board_info_x_offset;
+    screen.erase(x, y, (int) BOARD_INFO_WIDTH);
+    x = screen.print(x, y, label, TEXT_COLOR_DARK);
+    screen.print(x, y, value, value_color);
 }
 
-void BoardBuilderDisplayer::printBoardInfo(const string &board_name, const Board &board, unsigned int max_players) const {
+void BoardBuilderDisplayer::printBoardInfo(const string &board_name, const Board &board, unsigned int max_players) {
     // Board name
-    gotoxy(board_info_x_offset, 1);
-    setcolor(TEXT_COLOR_DARK);
-    cout << "Board name: "; 
-    setcolor(TEXT_COLOR);
-    cout << board_name;
+    drawBoardInfoLine(1, "Board name: ", board_name, TEXT_COLOR);
 
     // Playable by
-    gotoxy(board_info_x_offset, 2);
     switch(max_players) {
         case 0:
         case 1:
             // 0 and 1 are below minimum number (2)
-            setcolor(ERROR_COLOR);
-            cout << "Not playable yet";
+            drawBoardInfoLine(2, "", "Not playable yet", ERROR_COLOR);
             break;
         case 2:
-            setcolor(TEXT_COLOR_DARK);
-            cout << "Playable by "; 
-            setcolor(TEXT_COLOR);
-            cout << "2 players";
+            drawBoardInfoLine(2, "Playable by ", "2 players", TEXT_COLOR);
             break;
         default:
-            setcolor(TEXT_COLOR_DARK);
-            cout << "Playable by "; 
-            setcolor(TEXT_COLOR);
-            cout << "2-" << max_players << " players";
+            drawBoardInfoLine(2, "Playable by ", "2-" + to_string(max_players) + " players", TEXT_COLOR);
             break;
     }
 
     // Number of letters
-    gotoxy(board_info_x_offset, 4);
-    setcolor(TEXT_COLOR_DARK);
-    cout << "Number of letters: ";
-    setcolor(TEXT_COLOR);
-    cout << board.countLetters(); 
+    drawBoardInfoLine(4, "Number of letters: ", to_string(board.countLetters()), TEXT_COLOR);
 
     // Number of words
-    gotoxy(board_info_x_offset, 5);
-    setcolor(TEXT_COLOR_DARK);
-    cout << "Number of words: ";
-    setcolor(TEXT_COLOR);
-    cout << board.countWords(); 
+    drawBoardInfoLine(5, "Number of words: ", to_string(board.countWords()), TEXT_COLOR);
+    screen.flush();
 }
 
 void BoardBuilderDisplayer::printPrompt(unsigned int max_players, unsigned int total_letters) const {
@@ -140,7 +201,11 @@ void BoardBuilderDisplayer::printPrompt(unsigned int max_players, unsigned int t
     cout << "Inputs must be in the form 'Aa H WORD': " << endl
             << "  - The starting position of the word;" << endl
             << "  - The orientation ('H' for horizontal, 'V' for vertical);" << endl
-            << "  - A valid word to place on the board." << endl << endl;
+            << "  - A valid word to place on the board." << endl;
+    if(viewport.isPartial()) {
+        cout << "Type 'view Ab' to look at another part of the board." << endl;
+    }
+    cout << endl;
 
     // Error messages.
     setcolor(ERROR_COLOR);
@@ -151,28 +216,26 @@ void BoardBuilderDisplayer::printPrompt(unsigned int max_players, unsigned int t
     cout << "Enter valid position in the form described above: ";
 }
 
-void BoardBuilderDisplayer::printNewWord(const Word &word, const Board &board) const {
+void BoardBuilderDisplayer::printNewWord(const Word &word, const Board &board) {
     Position position = word.getStart();
     Orientation orientation = word.getOrientation();
     
     int letters = board.countLetters();
 
+    if(!viewport.contains(position)) {
+        viewport.centerOn(position);
+        printBoard(board);
+    }
+
     for(char c: word) {
         // Only print letters that weren't already in board
         if(board.getCell(position).isEmpty()) {
-            // Find the position in screen given position in board.
-            int x = position.getX()*2 + 1;
-            int y = position.getY() + 1;
-
-            gotoxy(x, y);
-            setcolor(LETTER_COLOR, BOARD_BACKGROUND);
-            cout << c;
+            if(viewport.contains(position)) drawCell(position, Cell(c));
 
             // increase letters counter.
             letters += 1;
-            gotoxy(board_info_x_offset+19, 4);
-            setcolor(TEXT_COLOR);
-            cout << letters;
+            drawBoardInfoLine(4, "Number of letters: ", to_string(letters), TEXT_COLOR);
+            screen.flush();
 
             // Small delay between letters.
             this_thread::sleep_for(chrono::milliseconds(ADD_LETTER_TO_BOARD_DELAY));
@@ -182,7 +245,6 @@ void BoardBuilderDisplayer::printNewWord(const Word &word, const Board &board) c
     }
 
     // Increase word counter.
-    gotoxy(board_info_x_offset+17, 5);
-    setcolor(TEXT_COLOR);
-    cout << board.countWords() + 1;
+    drawBoardInfoLine(5, "Number of words: ", to_string(board.countWords() + 1), TEXT_COLOR);
+    screen.flush();
 }
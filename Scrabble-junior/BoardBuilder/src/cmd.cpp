@@ -1,9 +1,46 @@
 // Adapted from the file supplied by the teacher on Moodle.
 
+#include <iostream>
 #include "cmd.h"
 
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/ioctl.h>
+#endif
+
 using namespace std;
 
+// Returns the ANSI number of 'color' (0 to 7), whose bits are red, green
+// and blue, while the bits of 'Color' are blue, green and red.
+static int ansiColor(Color color) {
+    return ((color & 1) << 2) | (color & 2) | ((color & 4) >> 2);
+}
+
+void ansiGotoxy(string &sequence, int x, int y) {
+    sequence += "\x1b[";
+    sequence += to_string(y + 1);
+    sequence += ';';
+    sequence += to_string(x + 1);
+    sequence += 'H';
+}
+
+void ansiSetcolor(string &sequence, Color color, Color background_color) {
+    // Bright colors have their own codes. A black background is left as
+    // the default of the terminal, which is what the console shows too.
+    sequence += "\x1b[";
+    sequence += to_string((color & 8 ? 90 : 30) + ansiColor(color));
+    sequence += ';';
+    if(background_color == BLACK) sequence += "49";
+    else sequence += to_string((background_color & 8 ? 100 : 40) + ansiColor(background_color));
+    sequence += 'm';
+}
+
+#ifdef _WIN32
+
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+
 void clrscr(int x, int y) {
     COORD coordScreen;
     coordScreen.X = (SHORT) x;
@@ -18,7 +55,7 @@ void clrscr(int x, int y) {
     FillConsoleOutputCharacter(hCon, TEXT(' '), dwConSize, coordScreen, &cCharsWritten);
     GetConsoleScreenBufferInfo(hCon, &csbi);
     FillConsoleOutputAttribute(hCon, csbi.wAttributes, dwConSize, coordScreen, &cCharsWritten);
-    
+
     SetConsoleCursorPosition(hCon, coordScreen);
 }
 
@@ -37,3 +74,55 @@ void setcolor(Color color, Color background_color) {
         SetConsoleTextAttribute(hCon, (WORD) (color | (background_color << 4)));
     }
 }
+
+bool getConsoleSize(int &width, int &height) {
+    CONSOLE_SCREEN_BUFFER_INFO csbi;
+    if(!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi)) return false;
+    width = csbi.srWindow.Right - csbi.srWindow.Left + 1;
+    height = csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
+    return true;
+}
+
+bool enableAnsi() {
+    // Only Windows 10 and later understand them.
+    HANDLE hCon = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode;
+    if(!GetConsoleMode(hCon, &mode)) return false;
+    return SetConsoleMode(hCon, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING) != 0;
+}
+
+#else
+
+void clrscr(int x, int y) {
+    // Erases from the cursor to the end of the screen, leaving it there.
+    string sequence;
+    ansiGotoxy(sequence, x, y);
+    sequence += "\x1b[J";
+    cout << sequence;
+}
+
+void gotoxy(int x, int y) {
+    string sequence;
+    ansiGotoxy(sequence, x, y);
+    cout << sequence;
+}
+
+void setcolor(Color color, Color background_color) {
+    string sequence;
+    ansiSetcolor(sequence, color, background_color);
+    cout << sequence;
+}
+
+bool getConsoleSize(int &width, int &height) {
+    winsize size;
+    if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_col == 0 || size.ws_row == 0) return false;
+    width = size.ws_col;
+    height = size.ws_row;
+    return true;
+}
+
+bool enableAnsi() {
+    return true;
+}
+
+#endif
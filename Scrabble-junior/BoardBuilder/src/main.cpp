@@ -113,10 +113,9 @@ bool promptSize(int &size, const char *prompt, const char *dimension) {
             continue;
         }
 
-        // Maximum size in a board is 20.
-        if(size > 20) {
+        if(size > (int) Board::MAX_SIZE) {
             setcolor(ERROR_COLOR);
-            cout << dimension << " can only be at most 20." << endl;
+            cout << dimension << " can only be at most " << Board::MAX_SIZE << "." << endl;
             continue;
         } 
 
@@ -184,7 +183,8 @@ int main() {
             board_file >> board_height >> _x >> board_width;            
 
             // At least width and height must be valid to be able to open the board.
-            if(board_file.fail() || board_height == 0 || board_height > 20 || board_width == 0 || board_width > 20) {
+            if(board_file.fail() || board_height <= 0 || board_height > (int) Board::MAX_SIZE
+                    || board_width <= 0 || board_width > (int) Board::MAX_SIZE) {
                 setcolor(ERROR_COLOR);
                 cout << "Board could not be loaded. Contents of the file may have been corrupted." << endl;
             } else {
@@ -0,0 +1,66 @@
+#ifndef ACTION_H
+#define ACTION_H
+
+#include <ostream>
+#include "position.h"
+
+// The kind of an 'Action'.
+enum ActionType {
+    // Cover the 'Cell' at a 'Position'.
+    ACTION_MOVE,
+    // Exchange one letter with the pool.
+    ACTION_EXCHANGE_ONE,
+    // Exchange two letters with the pool.
+    ACTION_EXCHANGE_TWO,
+    // End the turn (when no more moves can be made, or the turn is skipped).
+    ACTION_END_TURN,
+};
+
+// Represents a single decision of the current player, as accepted by
+// 'GameState::applyAction'.
+class Action {
+    // Overload of the insertion operator.
+    // Inserts this 'Action' in the same form a player would type it
+    // (for example, 'Ab' for a move or 'A B' for an exchange).
+    friend std::ostream& operator<<(std::ostream &out, const Action &action);
+
+    // The kind of this 'Action'.
+    ActionType type;
+    // Where to move. Only meaningful for 'ACTION_MOVE'.
+    Position position;
+    // Letters to exchange. Only meaningful for exchanges
+    // ('letter2' only for 'ACTION_EXCHANGE_TWO').
+    char letter1, letter2;
+
+    // Constructs an 'Action' with all its fields.
+    Action(ActionType type, Position position, char letter1, char letter2);
+
+    public:
+    // Default constructor. Constructs an 'ACTION_END_TURN'.
+    Action();
+
+    // Returns an 'Action' to cover the 'Cell' at 'position'.
+    static Action move(Position position);
+    // Returns an 'Action' to exchange 'letter' with the pool.
+    static Action exchange(char letter);
+    // Returns an 'Action' to exchange 'letter1' and 'letter2' with the pool.
+    static Action exchange(char letter1, char letter2);
+    // Returns an 'Action' to end the turn.
+    static Action endTurn();
+
+    // Returns the kind of this 'Action'.
+    ActionType getType() const;
+    // Returns the 'Position' of a move.
+    Position getPosition() const;
+    // Returns the first letter of an exchange.
+    char getLetter1() const;
+    // Returns the second letter of an exchange of two letters.
+    char getLetter2() const;
+
+    // Overload of the equality operator.
+    bool operator==(const Action &other) const;
+};
+
+std::ostream& operator<<(std::ostream &out, const Action &action);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+// Counts the memory allocations made by each thread, to check that the
+// turns of a game don't allocate once everything has been set up.
+//
+// Counting replaces the global 'operator new', so it is only compiled
+// in when 'SCRABBLE_COUNT_ALLOCATIONS' is defined. Otherwise every count
+// is zero and 'isEnabled' returns false.
+class AllocationCounter {
+    public:
+    // Returns whether allocations are being counted.
+    static bool isEnabled();
+    // Returns how many allocations the calling thread has made so far.
+    static uint64_t count();
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+
+// Times operations and summarizes how long they take.
+//
+// Every operation is first run a few times to find how many calls make
+// a sample long enough to be timed precisely, then for 'warmup' samples
+// that are discarded (to fill caches and let the clock speed settle) and
+// finally for 'repetitions' samples that are kept.
+//
+// Results are saved as JSON lines, one object per benchmark, so a run
+// can be kept as a baseline and later runs compared against it.
+class Benchmark {
+    public:
+    // The summary of the samples of a benchmark, in nanoseconds per operation.
+    struct Result {
+        // Name of the benchmark, unique within a run.
+        std::string name;
+        // Number of operations timed in each sample.
+        unsigned long operations;
+        // Number of samples kept.
+        unsigned int samples;
+        double min;
+        double median;
+        double mean;
+        double stddev;
+        // 90% of the samples took at most this long.
+        double p90;
+    };
+
+    // The code timed by a benchmark. Must run the operation 'calls' times.
+    typedef std::function<void (unsigned long calls)> Body;
+
+    private:
+    // Number of samples discarded before the ones kept.
+    unsigned int warmup;
+    // Number of samples kept.
+    unsigned int repetitions;
+    // Shortest time a sample may take, in seconds.
+    double min_sample_seconds;
+    // The result of every benchmark run, in order.
+    std::vector<Result> results;
+
+    // Returns the seconds 'body' takes to make 'calls'.
+    static double time(const Body &body, unsigned long calls);
+
+    public:
+    // Makes sure 'value' is computed, so the compiler can't
+    // skip an operation whose result isn't used otherwise.
+    static void keep(uint64_t value);
+
+    // Constructs a runner taking 'repetitions' samples of at least
+    // 'min_sample_seconds' after 'warmup' samples.
+    Benchmark(unsigned int warmup, unsigned int repetitions, double min_sample_seconds);
+
+    // Times 'body', where each call makes 'operations_per_call' operations,
+    // and records the result as 'name'.
+    const Result& run(const std::string &name, unsigned long operations_per_call, const Body &body);
+    // Returns the result of every benchmark run, in order.
+    const std::vector<Result>& getResults() const;
+
+    // Writes 'result' as a line of a table (see 'printHeader').
+    static void print(std::ostream &out, const Result &result);
+    // Writes the header of the table of 'print'.
+    static void printHeader(std::ostream &out);
+    // Writes every result to 'out', one JSON object per line.
+    void writeJson(std::ostream &out) const;
+    // Reads results written by 'writeJson' from 'in' to 'results'.
+    // Returns whether it was successful; if not, 'error' explains why.
+    static bool readJson(std::istream &in, std::vector<Result> &results, std::string &error);
+
+    // Compares the median of every result with the one of the same name
+    // in 'baseline', reporting those that are more than 'tolerance_percent'
+    // slower or faster. Returns the number of regressions (slower results).
+    unsigned int compare(const std::vector<Result> &baseline, double tolerance_percent, std::ostream &out) const;
+};
+
+#endif
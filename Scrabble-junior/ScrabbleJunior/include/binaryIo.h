@@ -0,0 +1,16 @@
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <istream>
+#include <ostream>
+#include <cstdint>
+
+// Helpers to read and write the binary files of the game (journals,
+// datasets...), which are little-endian on every platform.
+
+// Writes the 'num_bytes' lowest bytes of 'value' to 'out', least significant first.
+void writeInt(std::ostream &out, uint64_t value, int num_bytes);
+// Reads an integer of 'num_bytes' written by 'writeInt' from 'in'.
+uint64_t readInt(std::istream &in, int num_bytes);
+
+#endif
@@ -2,49 +2,195 @@
 #define BOARD_H
 
 #include <istream>
+#include <string>
 #include <vector>
+#include <memory>
+#include <cstdint>
 #include "cell.h"
 #include "position.h"
 #include "orientation.h"
 #include "word.h"
 #include "hand.h"
 
+// Everything needed to undo a move made with 'Board::makeMove'.
+//
+// Covering a 'Cell' changes at most three 'Cell's (the covered one and
+// the next 'Cell' of each of its words), so the record is small and
+// never allocates memory.
+class BoardUndo {
+    friend class Board;
+
+    // Maximum number of 'Cell's changed by a move.
+    static const int MAX_CHANGES = 3;
+
+    // The 'Position' that was covered.
+    Position position;
+    // Index of each changed 'Cell' in the letters of the 'Board'
+    // (see 'Board::getLetterPositions'), in the order they were changed.
+    int letters[MAX_CHANGES];
+    // The state of each changed 'Cell' before the move.
+    Cell cells[MAX_CHANGES];
+    // How many 'Cell's were changed.
+    int num_changes;
+    // Bit 'orientation' is set when the move completed the 'Word'
+    // with that 'Orientation'.
+    int completed;
+
+    // Auxiliary method to remember the state of 'cell', the letter at
+    // 'letter', before changing it.
+    void save(int letter, const Cell &cell);
+
+    public:
+    // Constructs an empty record.
+    BoardUndo();
+
+    // Returns the 'Position' that was covered.
+    Position getPosition() const;
+    // Returns the letter that was covered.
+    char getLetter() const;
+    // Returns how many 'Word's the move completed (0, 1 or 2).
+    int countCompletedWords() const;
+    // Returns whether the move completed the 'Word' with given 'Orientation'.
+    bool hasCompleted(Orientation orientation) const;
+};
+
 // Represents a Scrabble board.
+//
+// Only letters take memory, so a 'Board' may be far bigger than the
+// console (up to 'MAX_SIZE' in each direction) as long as most of it is
+// empty. Letters are numbered in the order they were added (the order of
+// 'getLetterPositions'), and everything about a letter is found by its
+// number: its 'Cell', the next letter in each 'Orientation' and its 'Word's.
+// A hash table of the occupied 'Position's finds the number of a letter,
+// so loading, moving and finding moves cost the same for any area.
+//
+// What never changes during a game (where the letters and 'Word's are) is
+// shared between copies of a 'Board', which only copy their 'Cell's.
 class Board {
+    public:
+    // The largest width and height of a 'Board': every row and column
+    // has a name in board coordinates (see 'Position').
+    static const unsigned int MAX_SIZE = 26 + 26*26 + 26*26*26;
+    // Number of a letter that isn't there, like the one after the
+    // last letter of a row.
+    static constexpr int NO_LETTER = -1;
+
+    private:
+    // Log2 of the number of slots of the hash table of a new 'Board'.
+    static constexpr int MIN_TABLE_BITS = 6;
+    // Key of a slot of the hash table that is free.
+    static constexpr uint32_t FREE_KEY = 0xFFFFFFFF;
+
+    // Where the letters of a 'Word' are kept in 'word_letters'.
+    struct WordSpan {
+        // The 'Position' where the 'Word' starts.
+        Position start;
+        // The 'Orientation' of the 'Word'.
+        Orientation orientation;
+        // Index of its first letter in 'word_letters'.
+        unsigned int offset;
+        // Number of letters of the 'Word'.
+        unsigned int length;
+    };
+
+    // A slot of the hash table of occupied 'Position's.
+    struct Slot {
+        // The 'keyOf' the 'Position', or 'FREE_KEY' if the slot is free.
+        uint32_t key;
+        // The number of the letter there.
+        int letter;
+    };
+
+    // How a letter is linked to the rest of the 'Board', by 'Orientation'.
+    struct LetterLinks {
+        // Number of the letter right after it, or 'NO_LETTER' if
+        // that 'Cell' is empty.
+        int next[2];
+        // Index in 'words' of the 'Word' that has it, or -1 if none.
+        int word_index[2];
+    };
+
+    // Where the letters and 'Word's of a 'Board' are.
+    struct Layout {
+        // Hash table of the occupied 'Position's, with linear probing.
+        std::vector<Slot> table;
+        // Log2 of the number of slots of 'table'.
+        int table_bits;
+        // The 'Position' of every letter, by number.
+        std::vector<Position> letter_positions;
+        // The links of every letter, by number.
+        std::vector<LetterLinks> links;
+        // The letters of every 'Word', one after another, so 'findWord'
+        // returns 'Word's that view them instead of copying them.
+        std::string word_letters;
+        // Every 'Word', in the order they were added.
+        std::vector<WordSpan> words;
+    };
+
     // The width of the 'Board'.
     unsigned int width;
     // The height of the 'Board'.
     unsigned int height;
 
-    // The matrix of cells that form this 'Board'.
-    std::vector<std::vector<Cell>> grid;
+    // Where the letters and 'Word's are. Copies of a 'Board' share it
+    // until a 'Word' is added to one of them.
+    std::shared_ptr<Layout> layout;
+    // The 'Cell' of every letter, by number.
+    std::vector<Cell> cells;
 
-    // The total number of letters (non-empty cells) 
-    // that this 'Board' contains.
-    unsigned int total_letters;
     // The total number of letters that have been covered
     // in this board.
     unsigned int total_covered;
+
+    // How many coverable 'Cell's have each letter, indexed by 'letter - 'A''.
+    unsigned int coverable_count[26];
+    // Bit 'i' is set whenever at least one coverable 'Cell' has letter 'A' + i
+    // (same layout as 'Hand::getLetterMask'), so checking whether a 'Hand' can
+    // move is a single mask intersection.
+    uint32_t coverable_mask;
+
+    // Returns the key of 'position' in the hash table, which must be
+    // within the limits of the 'Board'.
+    static uint32_t keyOf(Position position);
+    // Returns the slot of the hash table where the search for 'key' starts.
+    static size_t slotOf(uint32_t key, int table_bits);
+    // Auxiliary method to insert 'letter', at 'position', in the hash
+    // table of 'layout', which must have a free slot.
+    static void insertLetter(Layout &layout, Position position, int letter);
+    // Internal method to add a letter at 'position' and link it to the
+    // letters next to it. Returns its number.
+    int addLetter(Position position, char letter);
+    // Internal method to find the first letter after 'letter' in given
+    // 'Orientation' that is not covered, or 'NO_LETTER' if an empty 'Cell'
+    // comes first.
+    int findUncovered(int letter, Orientation orientation) const;
+
+    // Internal method to make 'cell' coverable as a part of a word in given
+    // 'Orientation' (see 'Cell::allowMove'), keeping 'coverable_count' and
+    // 'coverable_mask' up to date.
+    void allowMove(Cell &cell, Orientation orientation);
     
     // Internal method to unlock the next 'Cell' in a 'Word'
     // after covering a previous 'Cell'.
     //
-    // Given the position of the new covered 'Cell' and the
+    // Given the number of the new covered letter and the
     // 'Orientation' of the 'Word', tries to find the next
     // uncovered 'Cell' in that 'Word', making it coverable.
     //
     // Returns whether a 'Cell' was found and made coverable.
-    bool propagate(Position position, Orientation orientation);
+    // Remembers the state of the 'Cell' before changing it in 'undo'.
+    bool propagate(int letter, Orientation orientation, BoardUndo &undo);
     // Internal method to find what would be the next coverable 'Cell' in a 'Word'
-    // if current coverable 'Cell' was coverable.
+    // if the 'Cell' of 'letter' was covered.
     //
     // If no such cell is found, returns 'nullptr'.
     //
     // This method is mainly useful for the 'mustPlayTwiceEdgeCase'.
-    const Cell* getNextUncoveredCell(Position position, Orientation orientation) const;
+    const Cell* getNextUncoveredCell(int letter, Orientation orientation) const;
 
     public:
-    // Constructs a 'Board' with given width and height.
+    // Constructs an empty 'Board' with given width and height,
+    // which must be at most 'MAX_SIZE'.
     Board(unsigned int width, unsigned int height);
     // Loads 'Words' from a stream until either the stream ends or
     // a line can't be parsed.
@@ -53,12 +199,18 @@ class Board {
     // words (doesn't have a line for board dimensions, for example)
     // and this list forms a valid 'Board' (so 'Word's are valid and
     // don't appear in invalid positions). Each line must contain the 
-    // information of a 'Word', following the specification of a board file.
+    // information of a 'Word', following the specification of a board file,
+    // with its 'Position' in board coordinates of any length (see 'Position').
     //
     // The stream may have a 2D representation of the board at the end
     // because 'Word's stop being loaded as soon as a line can't be
-    // parsed as a 'Word'.
+    // parsed as a 'Word', which includes any 'Word' with a letter that
+    // is not an uppercase 'A-Z'.
     void loadWords(std::istream &save);
+    // Reads a board file from 'file': its size (like "15 x 15", height
+    // first) followed by its 'Word's (see 'loadWords'). Returns 'nullptr'
+    // if the size is invalid, explaining why in 'error'.
+    static std::unique_ptr<Board> load(std::istream &file, std::string &error);
     
     // Get the list of letters used in this board.
     // Useful for constructing a 'Pool'.
@@ -66,22 +218,41 @@ class Board {
     // Returns the total number of letters (non-empty cells) 
     // that this 'Board' contains.
     unsigned int countLetters() const;
+    // Returns the total number of 'Word's in this 'Board'. Every one
+    // of them scores a point when it is completed.
+    unsigned int countWords() const;
     // Returns whether all letters in this 'Board' have been covered.
     bool isFullyCovered() const;
     // Returns the height of this 'Board'.
     unsigned int getHeight() const;
     // Returns the 'width' of this 'Board'.
     unsigned int getWidth() const;
-    // Returns the 'Cell' at the given 'Position'.
+    // Returns the 'Cell' at the given 'Position', which is empty
+    // if it has no letter.
     const Cell& getCell(Position position) const;
+    // Returns the 'Position' of every letter in this 'Board', in the
+    // order they were added. The number of a letter is its index.
+    const std::vector<Position>& getLetterPositions() const;
+    // Returns the 'Cell' of the letter with given number. Faster than
+    // 'getCell' when going through the letters.
+    const Cell& getLetterCell(int letter) const;
+    // Returns the number of the letter at 'position', which may be
+    // outside the 'Board', or 'NO_LETTER' if its 'Cell' is empty.
+    int getLetterAt(Position position) const;
+
+    // Restores the state of every letter (see 'Cell::getState'), given in
+    // the order of 'getLetterPositions'. Meant to restore a saved game
+    // on a 'Board' loaded from the same file.
+    void setCellStates(const uint8_t *states);
 
     // Adds given 'Word' to the 'Board'.
     //
     // Word is assumed to be valid and to be placed at a
     // valid position of the 'Board'.
-    void addWord(Word &word);
+    void addWord(const Word &word);
     // Finds the word that has a letter at given 'Position'
-    // and has the given 'Orientation'.
+    // and has the given 'Orientation'. The 'Word' views letters
+    // kept by this 'Board', so it never allocates memory.
     //
     // Must only be called if such 'Position' is known to belong
     // to a 'Word' with that 'Orientation'.
@@ -91,11 +262,27 @@ class Board {
     // checking if it 'isCoverable'.
     //
     // By covering the 'Cell' at given positon, this function is also 
-    // unlocking the next 'Cell' in the same 'Word's, if applicable. 
-    // If any 'Word' has been completed, it is pushed to 'completed_words'. 
-    void cover(Position position, std::vector<Word> &completed_words);
+    // unlocking the next 'Cell' in the same 'Word's, if applicable.
+    // Returns a record of what changed, including which 'Word's were
+    // completed (see 'findWord'). The move can be undone exactly by
+    // passing the record to 'unmakeMove'.
+    BoardUndo makeMove(Position position);
+    // Undoes a move made with 'makeMove'. Moves must be undone in the
+    // reverse order they were made.
+    void unmakeMove(const BoardUndo &undo);
+    // Finds which 'Cell's would become coverable by covering the coverable
+    // 'Cell' at 'position' (at most one for each orientation), without
+    // changing the 'Board'. 'Cell's that are already coverable are not listed.
+    //
+    // Stores their positions in 'unlocked' and returns how many were found.
+    int getUnlockedBy(Position position, Position unlocked[2]) const;
     // Returns whether the given 'Hand' can make a move.
-    bool hasMove(const Hand &hand) const;    
+    bool hasMove(const Hand &hand) const;
+    // Returns a mask with the bit of every letter that some coverable
+    // 'Cell' has (see 'Hand::letterBit').
+    uint32_t getCoverableMask() const;
+    // Returns how many coverable 'Cell's have 'letter' (in range 'A-Z').
+    unsigned int countCoverable(char letter) const;
 
     // Checks for the specific edge case where otherwise legal moves
     // can't be made by the 'Player' because it would unallow them
@@ -103,7 +290,7 @@ class Board {
     //
     // Returns true if the edge case is applicable. In that case,
     // pushes the list of legal positions to 'legal_positions'.
-    bool mustPlayTwiceEdgeCase(const Hand &hand, std::vector<Position> &legal_positions);
+    bool mustPlayTwiceEdgeCase(const Hand &hand, std::vector<Position> &legal_positions) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+#ifndef BOARD_GENERATOR_H
+#define BOARD_GENERATOR_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include "position.h"
+#include "orientation.h"
+#include "rng.h"
+
+// Generates random valid boards, for benchmarks and tests that need
+// boards of any size and density instead of the ones made by hand.
+//
+// 'Word's are placed following the same rules as 'BoardBuilder': they
+// fit in the board, only cross other 'Word's on equal letters and never
+// touch another 'Word' side by side or end to end, so the result can be
+// loaded like any board file. They also never overlap a 'Word' with the
+// same 'Orientation' (like "BED" over "BE"), which would make it ambiguous.
+class BoardGenerator {
+    public:
+    // A 'Word' placed by the generator.
+    struct PlacedWord {
+        // The 'Position' where the word starts.
+        Position start;
+        // The 'Orientation' of the word.
+        Orientation orientation;
+        // The letters of the word, in range 'A-Z'.
+        std::string letters;
+    };
+
+    private:
+    // Attempts to place a 'Word' for every 'Cell' of the board,
+    // before giving up on reaching the density asked for.
+    static const unsigned int ATTEMPTS_PER_CELL = 40;
+
+    // The words that may be placed, in range 'A-Z'.
+    std::vector<std::string> dictionary;
+    // Makes every random choice.
+    Rng rng;
+
+    // The board being generated: its size, its letters by 'keyOf' their
+    // 'Position' (only 'Cell's with a letter are kept, so boards of any
+    // size take as much memory as their letters) and its 'Word's.
+    unsigned int width;
+    unsigned int height;
+    std::unordered_map<uint64_t, char> cells;
+    std::vector<PlacedWord> placed;
+
+    // Returns the key of 'position' in 'cells'.
+    static uint64_t keyOf(Position position);
+
+    // Returns the letter at 'position', or a space if it is empty or
+    // outside the board.
+    char letterAt(Position position) const;
+    // Returns whether 'letters' can be placed at 'start' with 'orientation'
+    // (see 'BoardBuilder' for the rules). Returns how many of its letters
+    // would be new in 'new_letters'.
+    bool canPlace(Position start, Orientation orientation, const std::string &letters,
+            unsigned int &new_letters) const;
+    // Places 'letters' at 'start' with 'orientation', which must be valid.
+    // Returns how many letters were new.
+    unsigned int place(Position start, Orientation orientation, const std::string &letters);
+
+    public:
+    // Returns a small built-in list of common words.
+    static const std::vector<std::string>& getDefaultDictionary();
+    // Reads a list of words, one per line (like 'WORDS.txt' of 'BoardBuilder'),
+    // keeping those of 2 to 26 letters in range 'a-z' or 'A-Z', in uppercase.
+    static std::vector<std::string> readDictionary(std::istream &in);
+
+    // Constructs a generator placing words of 'dictionary', which must
+    // not be empty, making random choices with 'rng'.
+    BoardGenerator(const std::vector<std::string> &dictionary, Rng rng);
+    // Makes the random choices with 'rng' from now on.
+    void setRng(Rng rng);
+
+    // Generates a board of 'width' by 'height' with letters in about
+    // 'density' (from 0 to 1) of its 'Cell's, or as many as could be
+    // placed. Half of the 'Word's are placed crossing a letter already
+    // there, so they form crosswords like the boards made by hand.
+    // Returns the 'Word's, in the order they were placed.
+    const std::vector<PlacedWord>& generate(unsigned int width, unsigned int height, double density);
+    // Returns the number of letters of the last board generated.
+    unsigned int countLetters() const;
+
+    // Writes the last board generated in the format of a board file.
+    void write(std::ostream &out) const;
+    // Writes only the 'Word's of the last board generated, one per line
+    // (see 'Board::loadWords').
+    void writeWords(std::ostream &out) const;
+};
+
+#endif
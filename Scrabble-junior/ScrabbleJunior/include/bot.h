@@ -0,0 +1,71 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include "gameState.h"
+#include "turn.h"
+#include "rng.h"
+#include "endgameSolver.h"
+
+// A strategy that plays the turns of a 'Player' automatically.
+//
+// Bots look at the consequences of their choices with 'GameState::makeTurn'
+// and 'unmakeTurn' (or on copies of the 'GameState'), so the 'GameState'
+// they are given is left exactly as it was.
+//
+// Once the 'Pool' is empty, bots may play perfectly with an 'EndgameSolver'
+// instead of their own strategy. The solver gets half of the time budget
+// of the decision, and the strategy decides if it gives up.
+class Bot {
+    // Time allowed for each decision, solving the endgame included.
+    std::chrono::milliseconds time_budget;
+    // When the current decision must be made (see 'chooseTurn').
+    std::chrono::steady_clock::time_point deadline;
+    // Whether this bot uses 'solver' in the endgame.
+    bool solves_endgame;
+    // The solver for the endgame, created the first time it is needed.
+    std::unique_ptr<EndgameSolver> solver;
+    // The final scores found by 'solver'. Unused.
+    std::vector<unsigned int> final_scores;
+
+    protected:
+    // Constructs a bot that decides within 'time_budget_ms' milliseconds,
+    // using an 'EndgameSolver' in the endgame if 'solves_endgame'.
+    Bot(bool solves_endgame, int time_budget_ms);
+
+    // Returns when the current decision must be made, for strategies
+    // that search until then.
+    std::chrono::steady_clock::time_point getDeadline() const;
+
+    // Chooses one of 'turns' by the strategy of this bot
+    // (see 'chooseTurn').
+    virtual Turn decideTurn(GameState &state, const TurnList &turns) = 0;
+
+    public:
+    virtual ~Bot() = default;
+
+    // Returns the name of this strategy, as accepted by 'createBot'.
+    virtual const char* getName() const = 0;
+    // Prepares this bot for a new game, making its random choices with
+    // 'rng' from now on. Lets a bot play many games without being created
+    // again, with the same choices as a new bot given 'rng'.
+    virtual void reset(Rng rng) = 0;
+    // Chooses one of 'turns', the legal turns of the current player of
+    // 'state' (see 'GameState::getLegalTurns'). 'turns' is never empty.
+    Turn chooseTurn(GameState &state, const TurnList &turns);
+};
+
+// Returns the names of every strategy 'createBot' knows.
+const std::vector<std::string>& getBotNames();
+// Creates the bot with given name (see 'getBotNames'), using 'rng' for its
+// random decisions and deciding within 'time_budget_ms' milliseconds.
+// Bots that search on several threads use 'search_threads' (0 for one per
+// hardware thread); callers that already play games on every hardware
+// thread should give 1. Returns 'nullptr' if there is no such bot.
+std::unique_ptr<Bot> createBot(const std::string &name, Rng rng, int time_budget_ms = 200,
+        unsigned int search_threads = 0);
+
+#endif
@@ -2,6 +2,7 @@
 #define CELL_H
 
 #include <ostream>
+#include <cstdint>
 #include "orientation.h"
 
 // Represents a single space for a letter in the board.
@@ -30,6 +31,12 @@ class Cell {
     bool propagates_vertically;
     
     public:
+    // Bits of the state of a 'Cell' (see 'getState').
+    static const uint8_t STATE_COVERED = 1;
+    static const uint8_t STATE_COVERABLE = 2;
+    static const uint8_t STATE_PROPAGATES_HORIZONTALLY = 4;
+    static const uint8_t STATE_PROPAGATES_VERTICALLY = 8;
+
     // Constructs a 'Cell' with given letter.
     //
     // Argument passed must be a letter in range 'A-Z'. If
@@ -57,6 +64,12 @@ class Cell {
     // Returns whether 'Cell' can be covered by a 'Player' (so it's not
     // empty and it's the next uncovered letter in a word).
     bool isCoverable() const;
+    // Returns everything that changes in this 'Cell' during a game
+    // (whether it is covered, coverable and propagates in each
+    // 'Orientation') as a combination of the 'STATE_' bits.
+    uint8_t getState() const;
+    // Restores a state returned by 'getState'.
+    void setState(uint8_t state);
     // Returns whether this cell has a letter.
     bool isEmpty() const;
     // Returns whether covering this 'Cell' may unlock other 
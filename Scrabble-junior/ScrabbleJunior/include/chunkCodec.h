@@ -0,0 +1,28 @@
+#ifndef CHUNK_CODEC_H
+#define CHUNK_CODEC_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Compresses chunks of fixed-size records, like the positions of a
+// dataset (see 'DatasetWriter').
+//
+// Consecutive positions of a game differ in a few bits, so each record
+// is first replaced by its XOR with the one before it, which is mostly
+// zero bytes. Then runs of zeros are stored as their length: the result
+// is a sequence of (zeros, literals) pairs, each count a variable-length
+// integer (7 bits per byte) and the literals copied as they are.
+class ChunkCodec {
+    public:
+    // Compresses 'size' bytes of 'records' (each of 'record_size' bytes),
+    // appending the result to 'out'.
+    static void compress(const uint8_t *records, size_t size, size_t record_size, std::vector<uint8_t> &out);
+    // Decompresses the 'compressed_size' bytes of 'compressed' into the
+    // 'size' bytes of 'records' (each of 'record_size' bytes). Returns
+    // false if 'compressed' is not a valid chunk of that size.
+    static bool decompress(const uint8_t *compressed, size_t compressed_size, uint8_t *records, size_t size,
+            size_t record_size);
+};
+
+#endif
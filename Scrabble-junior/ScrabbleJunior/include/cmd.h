@@ -3,11 +3,19 @@
 
 // Adapted from the file supplied by the teacher on Moodle.
 // Provides an easy way of controlling the console colors and cursor, and to clear the screen.
+//
+// On Windows the console is controlled through its API. Everywhere else
+// ANSI escape sequences are written to 'std::cout', which every terminal
+// understands (and so does the Windows console, once 'enableAnsi' is called).
 
+#include <string>
+
+#ifdef _WIN32
 #ifndef NOMINMAX
 #define NOMINMAX
 #endif
 #include <windows.h>
+#endif
 
 enum Color {
     BLACK = 0,
@@ -16,7 +24,7 @@ enum Color {
     CYAN = 3,
     RED = 4,
     MAGENTA = 5,
-    BROWN = 6, 
+    BROWN = 6,
     LIGHTGRAY = 7,
     DARKGRAY = 8,
     LIGHTBLUE = 9,
@@ -28,14 +36,29 @@ enum Color {
     WHITE = 15
 };
 
-// Clears the screen. If 'x' and 'y' are given, only clears the 
+// Clears the screen. If 'x' and 'y' are given, only clears the
 // part of the screen to the right of 'x' and below 'y', inclusive.
 void clrscr(int x = 0, int y = 0);
 
 // Position the cursor at column 'x', line 'y'.
 void gotoxy(int x, int y);
 
-// Set text color and background.
+// Set text color and background. Does nothing when the output is not a
+// console, so that output saved to files or piped has no colors.
 void setcolor(Color color, Color background_color = BLACK);
 
-#endif
\ No newline at end of file
+// Finds the number of columns and lines the console shows. Returns
+// whether it could, which it can't when the output isn't a console.
+bool getConsoleSize(int &width, int &height);
+
+// Makes the console understand ANSI escape sequences, like those appended
+// by 'ansiGotoxy' and 'ansiSetcolor'. Returns whether it does.
+bool enableAnsi();
+
+// Appends to 'sequence' the ANSI escape sequence that does the same as 'gotoxy'.
+void ansiGotoxy(std::string &sequence, int x, int y);
+
+// Appends to 'sequence' the ANSI escape sequence that does the same as 'setcolor'.
+void ansiSetcolor(std::string &sequence, Color color, Color background_color = BLACK);
+
+#endif
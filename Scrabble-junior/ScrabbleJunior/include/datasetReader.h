@@ -0,0 +1,57 @@
+#ifndef DATASET_READER_H
+#define DATASET_READER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+#include "positionEncoder.h"
+#include "datasetWriter.h"
+
+// Reads any record of a dataset file written by 'DatasetWriter', only
+// decompressing the chunk it is in (the last chunk read is kept).
+class DatasetReader {
+    // The file being read.
+    std::ifstream file;
+    // Decodes the records, with the layout saved in the file.
+    std::unique_ptr<PositionEncoder> encoder;
+    // Number of records in each chunk (but the last).
+    size_t records_per_chunk;
+    // Every chunk of the file.
+    std::vector<DatasetChunk> chunks;
+    // Number of records in the file.
+    uint64_t num_records;
+    // Index of the chunk in 'chunk', or -1 if none.
+    long loaded_chunk;
+    // The records of the chunk 'loaded_chunk'.
+    std::vector<uint8_t> chunk;
+    // Scratch space to read a compressed chunk.
+    std::vector<uint8_t> compressed;
+
+    // Reads and decompresses chunk 'index' into 'chunk'. Returns whether it was successful.
+    bool loadChunk(size_t index);
+
+    public:
+    // Constructs a reader without a file.
+    DatasetReader();
+
+    // Opens the dataset file 'name', reading its layout and index.
+    // Returns whether it is a valid dataset.
+    bool open(const std::string &name);
+
+    // Returns the encoder of the records of the file. Must only be
+    // called after 'open' is successful.
+    const PositionEncoder& getEncoder() const;
+    // Returns the number of records in the file.
+    uint64_t countRecords() const;
+    // Returns the number of chunks in the file.
+    size_t countChunks() const;
+
+    // Copies record 'index' (less than 'countRecords') to 'record', which
+    // must have room for its size. Returns whether it was read successfully.
+    bool read(uint64_t index, uint8_t *record);
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef DATASET_WRITER_H
+#define DATASET_WRITER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+#include "positionEncoder.h"
+
+// Where a chunk of records is in a dataset file.
+struct DatasetChunk {
+    // Offset of the compressed chunk from the start of the file.
+    uint64_t offset;
+    // Size of the compressed chunk, in bytes.
+    uint32_t compressed_size;
+    // Number of records in the chunk.
+    uint32_t num_records;
+};
+
+// Writes the positions of many games, with their outcomes, to a dataset
+// file for training bots (read with 'DatasetReader').
+//
+// The file starts with "SJD", a version byte, the layout of the records
+// (see 'PositionEncoder::save'), the record size and the records per
+// chunk. Then come the chunks, each compressed on its own (see
+// 'ChunkCodec') so any record can be read by decompressing only its
+// chunk, and an index with a 'DatasetChunk' for each of them. The file
+// ends with the offset of the index, the number of chunks and of records,
+// and "SJDE". Integers are little-endian.
+//
+// Games may be added by many threads and in any order: they are written
+// in the order of their index, so the file only depends on the games.
+class DatasetWriter {
+    // Encodes the records of the games.
+    const PositionEncoder &encoder;
+    // Number of records in each chunk (but the last).
+    size_t records_per_chunk;
+    // The file being written.
+    std::ofstream file;
+    // Protects everything below, since games are added by many threads.
+    std::mutex mutex;
+    // Index of the next game to write.
+    unsigned long next_game;
+    // The records of games that were added before the ones before them.
+    std::map<unsigned long, std::vector<uint8_t>> pending_games;
+    // The records of the chunk being filled.
+    std::vector<uint8_t> chunk;
+    // Scratch space to compress 'chunk'.
+    std::vector<uint8_t> compressed;
+    // Every chunk written.
+    std::vector<DatasetChunk> chunks;
+    // Number of records written or in 'chunk'.
+    uint64_t num_records;
+
+    // Adds the records of a game to 'chunk', writing it whenever it is full.
+    void appendRecords(const std::vector<uint8_t> &records);
+    // Compresses and writes the records of 'chunk', if any.
+    void writeChunk();
+
+    public:
+    // Default number of records in each chunk.
+    static const size_t DEFAULT_RECORDS_PER_CHUNK = 4096;
+
+    // Constructs a writer of records of 'encoder', with 'records_per_chunk'.
+    DatasetWriter(const PositionEncoder &encoder, size_t records_per_chunk = DEFAULT_RECORDS_PER_CHUNK);
+
+    // Creates the file 'name' and writes its header. Returns whether it was successful.
+    bool open(const std::string &name);
+    // Adds the records of game 'game_index' (encoded by 'encoder', one
+    // after another), taking them from 'records'. Every game from 0 up
+    // must be added (with no records, if it has none to add).
+    void addGame(unsigned long game_index, std::vector<uint8_t> &records);
+    // Writes what is left and the index, and closes the file. Returns
+    // whether everything was written successfully.
+    bool close();
+
+    // Returns the encoder of the records.
+    const PositionEncoder& getEncoder() const;
+    // Returns the number of records added.
+    uint64_t countRecords() const;
+};
+
+#endif
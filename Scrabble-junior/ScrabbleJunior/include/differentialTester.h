@@ -0,0 +1,121 @@
+#ifndef DIFFERENTIAL_TESTER_H
+#define DIFFERENTIAL_TESTER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "action.h"
+#include "turn.h"
+#include "gameState.h"
+#include "referenceGame.h"
+#include "rng.h"
+
+// Plays games on 'GameState' and 'ReferenceGame' side by side and checks
+// that they never disagree, to prove that making 'Board', 'Hand' and
+// 'Pool' faster didn't change the rules.
+//
+// After every 'Action', it compares the letters and whether each one is
+// covered or coverable, the words completed, the hands, the pool, the
+// scores, whose turn it is, what they must do and every legal 'Action'
+// and 'Turn'. Random 'Action's (most of them illegal) are also tried, to
+// compare why they are rejected.
+//
+// A game that makes them disagree can be shrunk to a smaller one (see
+// 'shrink') and saved as a 'Journal' to reproduce it. Removing anything
+// changes the letters drawn afterwards, so 'Action's that became illegal
+// are dropped while shrinking.
+class DifferentialTester {
+    public:
+    // A game to check.
+    struct Case {
+        // Contents of the board file.
+        std::string board_text;
+        // Number of players.
+        unsigned int num_players;
+        // The generator of the game, before the hands are dealt.
+        Rng rng;
+        // Every 'Action', in order. The last one may be illegal, when
+        // both engines disagree on why.
+        std::vector<Action> actions;
+    };
+
+    // The result of checking a 'Case'.
+    enum Outcome {
+        // Both engines agree after every 'Action'.
+        CASE_AGREES,
+        // Both engines disagree (see 'getMismatch').
+        CASE_MISMATCH,
+        // Some 'Action' is illegal for both, or the board is invalid, so
+        // the 'Case' isn't a game.
+        CASE_INVALID,
+    };
+
+    private:
+    // Most 'Action's of a random game, in case it never ends.
+    static const unsigned int MAX_ACTIONS = 20000;
+    // Most 'Case's checked while shrinking one.
+    static const unsigned int MAX_SHRINK_CHECKS = 20000;
+    // Random games played on a board while shrinking, looking for one
+    // that makes the engines disagree.
+    static const unsigned int SHRINK_REPLAYS = 16;
+
+    // Scratch space for the legal 'Turn's of 'GameState'.
+    std::unique_ptr<TurnList> turns;
+    // Scratch space for the legal 'Action's of 'GameState'.
+    std::vector<Action> actions;
+    // Number of states compared.
+    unsigned long num_states;
+    // How the engines disagreed the last time they did.
+    std::string mismatch;
+    // Number of 'Action's applied when they disagreed.
+    size_t mismatch_step;
+
+    class WordRecorder;
+
+    // Returns a number that identifies 'action'.
+    static uint64_t getActionKey(const Action &action);
+    // Returns a number that identifies 'turn' in 'reference', which
+    // is the same for two moves that may be made in either order.
+    static uint64_t getTurnKey(const Turn &turn, const ReferenceGame &reference);
+
+    // Records that the engines disagree after 'step' 'Action's because of 'what'.
+    bool fail(size_t step, const std::string &what);
+    // Compares everything both engines show, after 'step' 'Action's.
+    // Returns whether they agree.
+    bool compare(const GameState &state, const ReferenceGame &reference, size_t step);
+    // Checks 'action' on both engines and applies it if it is legal,
+    // comparing the words completed and the states after it, which
+    // is 'step' 'Action's into the game. Returns whether they agree;
+    // 'legal' tells whether it was applied.
+    bool apply(GameState &state, ReferenceGame &reference, WordRecorder &recorder, const Action &action,
+            size_t step, bool &legal);
+
+    // Plays the 'Action's of 'game' on both engines, keeping only those
+    // up to where they disagree. If 'skip_illegal', 'Action's illegal for
+    // both are removed from 'game' instead of making it invalid.
+    Outcome replay(Case &game, bool skip_illegal);
+
+    public:
+    // Constructs a tester.
+    DifferentialTester();
+
+    // Plays a random game of 'game' (whose 'Action's are ignored) choosing
+    // 'Action's with 'chooser', and stores the 'Action's played in 'game'.
+    // Returns whether the board was valid and the engines agreed; if they
+    // disagreed, 'game' ends with the 'Action' that made them disagree.
+    Outcome play(Case &game, Rng chooser);
+    // Plays the 'Action's of 'game' on both engines.
+    Outcome check(const Case &game);
+    // Returns the smallest 'Case' found, by removing 'Action's and words
+    // of the board and by playing new random games on what is left, that
+    // still makes the engines disagree. 'game' must make them disagree.
+    Case shrink(const Case &game);
+
+    // Returns how the engines disagreed the last time they did.
+    const std::string& getMismatch() const;
+    // Returns the number of states compared so far.
+    unsigned long countStates() const;
+};
+
+#endif
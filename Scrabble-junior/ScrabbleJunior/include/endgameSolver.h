@@ -0,0 +1,118 @@
+#ifndef ENDGAME_SOLVER_H
+#define ENDGAME_SOLVER_H
+
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include "gameState.h"
+#include "turn.h"
+
+// Finds the perfect play of a game whose 'Pool' is empty.
+//
+// Once the 'Pool' is empty every remaining letter is in a known 'Hand', so
+// the rest of the game has no hidden information nor chance. The solver
+// searches every 'Turn' until the end, with alpha-beta on the difference of
+// points for two players and max-n (each player maximizes their own points)
+// for more. Positions reached through different orders of moves are only
+// solved once, thanks to a transposition table keyed on a Zobrist hash of
+// the covered 'Cell's, the 'Hand's and the player to move.
+//
+// Only the points still to be scored are searched and stored, since they
+// don't depend on the points scored before.
+class EndgameSolver {
+    // An entry of the transposition table.
+    struct Entry {
+        // Hash of the position.
+        uint64_t key;
+        // The search that stored the entry (see 'generation'). Entries
+        // of older searches are unused.
+        uint16_t generation;
+        // Points each player scores from the position, with perfect play.
+        // With two players, only 'points[0]' is used: the points of the
+        // player to move minus those of the other one (or a bound of it).
+        int16_t points[GameState::MAX_PLAYERS];
+        // Index of the best 'Turn' in 'GameState::getLegalTurns', or -1.
+        int16_t best_turn;
+        // Whether 'points[0]' is exact, a lower bound or an upper bound.
+        uint8_t bound;
+    };
+
+    // Number of different letters ('A-Z').
+    static const int ALPHABET_SIZE = 26;
+    // Maximum number of letters in a 'Hand'.
+    static const int HAND_SIZE = 7;
+
+    // Log2 of the number of entries of 'table'.
+    int table_bits;
+    // The transposition table. Allocated on the first search.
+    std::vector<Entry> table;
+    // Number of the current search. Entries of other searches are ignored,
+    // so the table is emptied in constant time.
+    uint16_t generation;
+    // Maximum number of positions searched by 'solve' before giving up.
+    unsigned long max_nodes;
+    // When the current search must give up.
+    std::chrono::steady_clock::time_point deadline;
+    // Number of positions searched by the current (or last) search.
+    unsigned long nodes;
+    // Whether the current search has given up.
+    bool aborted;
+
+    // Zobrist keys of each letter 'Cell' being covered, indexed like
+    // 'Board::getLetterPositions'.
+    std::vector<uint64_t> cell_keys;
+    // Zobrist keys of the i-th instance of each letter in each player's 'Hand'.
+    uint64_t letter_keys[GameState::MAX_PLAYERS][ALPHABET_SIZE][HAND_SIZE];
+    // Zobrist keys of each player being the one to move.
+    uint64_t player_keys[GameState::MAX_PLAYERS];
+    // Zobrist key of the player to move having already moved once.
+    uint64_t moved_once_key;
+
+    // The turns listed at each ply of the search, so nothing is allocated
+    // after the deepest ply has been reached once.
+    std::vector<std::unique_ptr<TurnList>> turn_lists;
+
+    // Prepares the keys and the table for 'state'.
+    void prepare(const GameState &state);
+    // Returns the hash of 'state', computed from scratch.
+    uint64_t hash(const GameState &state) const;
+    // Returns the hash of 'state' right after the player at 'player_index',
+    // with 'old_moves_left', played 'turn' on a position with 'old_hash'.
+    uint64_t hashAfter(const GameState &state, uint64_t old_hash, const Turn &turn,
+            unsigned int player_index, unsigned int old_moves_left) const;
+    // Returns the list of turns for 'ply', creating it if needed.
+    TurnList& getTurnList(int ply);
+    // Returns whether the search must give up.
+    bool countNode();
+
+    // Returns the points of the player to move minus those of the other
+    // one (with two players), from 'state' with 'hash', if it is within
+    // 'alpha' and 'beta'. Otherwise, returns a bound beyond them.
+    int alphaBeta(GameState &state, uint64_t hash, int alpha, int beta, int ply);
+    // Stores in 'points' the points each player scores from 'state' with
+    // 'hash', when each player maximizes their own.
+    void maxN(GameState &state, uint64_t hash, int ply, int *points);
+
+    public:
+    // Constructs a solver with a transposition table of '2^table_bits'
+    // entries, that gives up after searching 'max_nodes' positions.
+    EndgameSolver(int table_bits = 19, unsigned long max_nodes = 5000000);
+
+    // Returns whether 'state' can be solved: its 'Pool' is empty.
+    static bool canSolve(const GameState &state);
+
+    // Solves 'state', which must be solvable (see 'canSolve'). Stores the
+    // best 'Turn' of the current player in 'best_turn' and the final score
+    // of each player with perfect play in 'final_scores'.
+    //
+    // Returns false if the search gave up, after 'max_nodes' positions or
+    // at 'deadline'. 'state' is left as it was given.
+    bool solve(GameState &state, Turn &best_turn, std::vector<unsigned int> &final_scores,
+            std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    // Returns how many positions the last call to 'solve' searched.
+    unsigned long getNodes() const;
+};
+
+#endif
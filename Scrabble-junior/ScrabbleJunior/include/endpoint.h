@@ -0,0 +1,38 @@
+#ifndef ENDPOINT_H
+#define ENDPOINT_H
+
+#include <string>
+
+// Where a 'GameServer' listens and its clients connect: a TCP port
+// or the path of a Unix socket. Only available on Linux ('isSupported').
+class Endpoint {
+    // The path of the Unix socket. Empty for a TCP port.
+    std::string unix_path;
+    // The TCP port. Only meaningful if 'unix_path' is empty.
+    int port;
+
+    public:
+    // Constructs the endpoint of TCP 'port' (on every address when
+    // listening, and on this machine when connecting).
+    Endpoint(int port);
+    // Constructs the endpoint of the Unix socket at 'unix_path'.
+    Endpoint(const std::string &unix_path);
+
+    // Returns whether sockets are available on this platform.
+    static bool isSupported();
+    // Makes the socket 'fd' non-blocking. Returns whether it was successful.
+    static bool setNonBlocking(int fd);
+
+    // Returns a non-blocking socket listening on this endpoint, or -1 if
+    // it couldn't be opened. A Unix socket left by a previous server is replaced.
+    int listen() const;
+    // Returns a socket connected to this endpoint, or -1 if it couldn't
+    // connect. The socket is made non-blocking once connected.
+    int connect() const;
+
+    // Returns this endpoint as it would be given in the command line,
+    // like 'port 7777' or 'socket /tmp/scrabble.sock'.
+    std::string describe() const;
+};
+
+#endif
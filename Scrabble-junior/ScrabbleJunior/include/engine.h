@@ -0,0 +1,64 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <istream>
+#include <ostream>
+#include "board.h"
+#include "session.h"
+#include "action.h"
+#include "jsonObject.h"
+
+// Plays games for scripts: reads requests as JSON lines and answers each
+// with a single JSON line, with nothing drawn and no delays.
+//
+// Every request is an object with a "cmd" (and an optional "id", copied
+// to the answer). Answers have "ok" and, if it is false, an "error".
+// - {"cmd": "load_board", "path": "BOARD.txt"}: loads the 'Board' of the games.
+// - {"cmd": "new_game", "players": 2, "seed": 7}: deals a new game.
+// - {"cmd": "legal_actions"}: answers "actions", every legal 'Action' of
+//   the current player, like {"type": "move", "position": "Ab"},
+//   {"type": "exchange", "letters": "AB"} or {"type": "end_turn"}.
+// - {"cmd": "apply", "type": ..., ...}: applies an 'Action' given like in
+//   "actions". Answers whether it ended the turn ("turn_ended") and the
+//   game ("over"), or the name of its 'ActionError' if it is illegal.
+// - {"cmd": "state"}: answers the whole state of the game. The 'Board' is
+//   given by its letters ("cells"), like {"Ab": "C", "Ac": "a"}, with
+//   covered ones in lowercase.
+class Engine {
+    // The 'Board' of the games. May be 'nullptr'.
+    std::unique_ptr<Board> board;
+    // The game being played. May be 'nullptr'.
+    std::unique_ptr<Session> session;
+    // The request being answered.
+    JsonObject request;
+    // The legal 'Action's of a request, kept to reuse its memory.
+    std::vector<Action> legal_actions;
+
+    // Answers "load_board". Returns false if it failed, explaining why in 'error'.
+    bool loadBoard(std::ostream &out, std::string &error);
+    // Answers "new_game".
+    bool newGame(std::ostream &out, std::string &error);
+    // Answers "legal_actions".
+    bool listLegalActions(std::ostream &out, std::string &error);
+    // Answers "apply".
+    bool apply(std::ostream &out, std::string &error);
+    // Answers "state".
+    bool writeState(std::ostream &out, std::string &error);
+
+    // Reads the 'Action' given in 'request' to 'action'. Returns whether it is well formed.
+    bool readAction(Action &action, std::string &error) const;
+    // Writes 'action' to 'out' as an object, as listed by "legal_actions".
+    static void writeAction(std::ostream &out, const Action &action);
+
+    public:
+    // Answers the request 'line', writing a line to 'out'.
+    void handleLine(std::string_view line, std::ostream &out);
+    // Answers every line of 'in' until it ends.
+    void run(std::istream &in, std::ostream &out);
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef EXPECTIMAX_SOLVER_H
+#define EXPECTIMAX_SOLVER_H
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include "board.h"
+#include "gameState.h"
+#include "turn.h"
+
+// Computes the exact expected score of each player of a game on a small
+// 'Board', from the deal to the end, when every player plays to maximize
+// their own expected score.
+//
+// Unlike the 'EndgameSolver', every draw from the 'Pool' is a chance node.
+// Draws are merged into multisets of letters (the order of the letters
+// drawn doesn't matter), each weighted by its hypergeometric probability.
+// Positions are memoized on a canonical encoding of the covered 'Cell's,
+// the letters in each 'Hand' and the player to move (the 'Pool' is what is
+// left), shared by every thread. The first player's possible starting
+// 'Hand's are split between the threads.
+//
+// Only 'Board's with at most 62 letters (and few different letters) can
+// be solved (see 'canSolve').
+class ExpectimaxSolver {
+    // Number of different letters ('A-Z').
+    static const int ALPHABET_SIZE = 26;
+    // Maximum number of letters in a 'Hand'. 'constexpr' since 'std::min'
+    // takes it by reference, which needs a definition.
+    static constexpr int HAND_SIZE = Hand::HAND_SIZE;
+    // Number of 64-bit words of a 'Key'.
+    static const int KEY_WORDS = 4;
+    // Number of bits of a count of letters in a 'Key'.
+    static const int COUNT_BITS = 3;
+    // Number of independent parts of the memo, to lower lock contention.
+    static const int NUM_SHARDS = 64;
+
+    // Canonical encoding of a position at the start of a turn.
+    struct Key {
+        // Covered 'Cell's (one bit for each of 'Board::getLetterPositions')
+        // and the player to move (last two bits) in the first word, then the
+        // count of each letter of the 'Board' in each 'Hand'.
+        uint64_t words[KEY_WORDS];
+
+        bool operator==(const Key &other) const;
+    };
+
+    // Hash function for 'Key', to use it in the memo.
+    struct KeyHash {
+        size_t operator()(const Key &key) const;
+    };
+
+    // Expected points each player scores from a position.
+    typedef std::array<double, GameState::MAX_PLAYERS> Values;
+
+    // A part of the memo, with its own lock.
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<Key, Values, KeyHash> values;
+    };
+
+    // Everything a thread needs while searching.
+    struct Worker {
+        // The turns listed at each ply of the search.
+        std::vector<std::unique_ptr<TurnList>> turn_lists;
+        // The positions being searched, from the deal to the current one.
+        std::unordered_set<Key, KeyHash> path;
+    };
+
+    // Number of threads to search with.
+    unsigned int num_threads;
+    // The memo of every position solved.
+    std::vector<Shard> shards;
+    // Whether each letter is in the 'Board' (and so in the encoding of a 'Hand').
+    bool in_board[ALPHABET_SIZE];
+    // Number of positions found again while they were being searched.
+    std::atomic<unsigned long> repeated_positions;
+
+    // Returns the canonical encoding of 'state'.
+    Key makeKey(const GameState &state) const;
+    // Finds the 'values' of 'key' in the memo, returning whether it was found.
+    bool lookup(const Key &key, Values &values);
+    // Stores the 'values' of 'key' in the memo.
+    void store(const Key &key, const Values &values);
+    // Returns the list of turns for 'ply', creating it if needed.
+    static TurnList& getTurnList(Worker &worker, int ply);
+
+    // Calls 'leaf(probability)' for every multiset of 'count' letters the
+    // player at 'player_index' may draw from the 'Pool', with the letters
+    // drawn in their 'Hand'. 'excluded' counts letters of the 'Pool' that
+    // can't be drawn. Letters from 'letter' on are drawn, and 'probability'
+    // is that of the letters already drawn.
+    template<typename Leaf>
+    static void forEachDraw(GameState &state, unsigned int player_index, int count,
+            const int *excluded, int letter, double probability, Leaf &leaf);
+    // Deals the starting 'Hand' of the player at 'player_index' and of
+    // the ones after them, storing the expected points in 'values'.
+    void deal(Worker &worker, GameState &state, unsigned int player_index, Values &values);
+    // Stores in 'values' the expected points from 'state', at the start of a turn.
+    void decide(Worker &worker, GameState &state, int ply, Values &values);
+    // Stores in 'values' the expected points from 'state' if 'turn' is played.
+    void play(Worker &worker, GameState &state, const Turn &turn, int ply, Values &values);
+
+    public:
+    // Constructs a solver that uses 'num_threads' threads (0 for one per
+    // hardware thread).
+    ExpectimaxSolver(unsigned int num_threads = 0);
+
+    // Returns whether a game with 'num_players' on 'board' can be solved.
+    static bool canSolve(const Board &board, unsigned int num_players);
+
+    // Solves a game with 'num_players' on 'board', which must be solvable
+    // (see 'canSolve'). Stores the expected score of each player in
+    // 'expected_scores'.
+    void solve(const Board &board, unsigned int num_players, std::vector<double> &expected_scores);
+
+    // Returns how many positions the last call to 'solve' memoized.
+    unsigned long countPositions() const;
+    // Returns how many times the last call to 'solve' found a position
+    // while it was still being searched (every player exchanging letters
+    // until a position repeats). Those count as scoring no more points,
+    // so the result is only exact if there were none.
+    unsigned long countRepeatedPositions() const;
+};
+
+#endif
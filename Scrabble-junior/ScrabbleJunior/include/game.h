@@ -2,100 +2,156 @@
 #define GAME_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <ostream>
-#include <random>
 #include "player.h"
 #include "board.h"
-#include "pool.h"
 #include "position.h"
+#include "gameState.h"
+#include "session.h"
+#include "gameObserver.h"
 #include "gameDisplayer.h"
+#include "rng.h"
+#include "turn.h"
+#include "bot.h"
+#include "endgameSolver.h"
+#include "journal.h"
+#include "snapshot.h"
 
-// Represents what the current player must do
-// in that turn.
-enum TurnState {
-    // Must choose a cell to cover.
-    MUST_MOVE,
-    // Must choose two letters to exchange with the pool.
-    MUST_EXCHANGE_TWO,
-    // Must choose one letter to exchange with the pool.
-    MUST_EXCHANGE_ONE,
-    // They can't move anymore. Their turn is over.
-    MUST_END_TURN,
-    // They can't move nor exchange at the start of the turn. Their turn is skipped.
-    MUST_SKIP_TURN,
-};
-
-// Manages the game itself.
-class Game {
-    // The board of the game.
-    Board &board;
-    // The pool of the game.
-    Pool pool;
-    // The players of the game.
-    std::vector<Player> players;
+// Manages an interactive game on the console.
+//
+// The game itself is a 'Session', and 'Game' is just where its 'Action's
+// come from: it reads input, validates it with user-friendly messages,
+// asks the 'Bot's and displays what happens (it observes its own
+// 'Session' to animate moves, exchanges and refills).
+class Game: public GameObserver {
+    // The game being played.
+    Session session;
     // Helper class to help display and animate the state of the game.
     GameDisplayer displayer;
-    // The index of current player.
-    unsigned int current_player_index;
-    // Number of moves left this turn.
-    unsigned int moves_left;
+    // The 'Bot' playing each seat, or 'nullptr' for seats played by people.
+    std::vector<Bot*> bots;
+    // The legal turns of a 'Bot', listed before it chooses.
+    TurnList bot_turns;
+    // Whether the edge case of forcing to play twice applies to the
+    // current move (see 'updateLegalMoves').
+    bool must_play_twice;
+    // The only legal positions of the current move, if 'must_play_twice'.
+    std::vector<Position> legal_positions;
+    // Whether the board must scroll to the legal moves before they are
+    // drawn again. Only after a move, so looking around isn't undone.
+    bool must_follow_legal_moves;
+    // The last line typed by the player, kept to reuse its memory.
+    std::string input;
+    // Solves the endgame, to show the result of perfect play.
+    EndgameSolver solver;
+    // The final scores with perfect play from the start of the current
+    // turn. Empty until the 'Pool' is empty, or if it couldn't be solved.
+    std::vector<unsigned int> perfect_scores;
+    // Whether the current turn has yet to be solved.
+    bool must_solve_turn;
+    // Where every 'Action' is recorded. May be 'nullptr'.
+    Journal *journal;
+    // The file where a 'Snapshot' is saved at the end of every turn.
+    // Empty if the game isn't saved.
+    std::string snapshot_name;
+    // The file of the 'Board', to be saved in the 'Snapshot'.
+    std::string board_name;
+    // The hash of the contents of the file of the 'Board' (see 'Journal::hashFile').
+    uint64_t board_hash;
+    // The file where 'journal' is saved with every 'Snapshot'.
+    std::string journal_name;
 
-    // Returns whether this game is over.
-    bool isOver() const;
-    // Returns the current player.
-    const Player& getCurrentPlayer() const;
-    // Returns the current player.
-    Player& getCurrentPlayer();
-    // Returns the ID of the winners. Must only be called after
-    // game is over. Assumes that the players have already been
-    // sorted for the leaderboard.
-    std::vector<int> getWinnersId() const;
+    // Returns the ID of the winners, given the players sorted
+    // for the leaderboard. Must only be called after game is over.
+    static std::vector<int> getWinnersId(const std::vector<Player> &sorted_players);
 
-    // Returns what current player must do in current turn.
-    TurnState getTurnState() const;
     // Starts the game loop until it is over.
-    bool playLoop(std::default_random_engine &rng);
+    bool playLoop();
+    // Reads one line typed by the current player and feeds the 'Session'
+    // what it asks for, given the 'TurnState' of the current player.
+    // Returns false if stdin has failed.
+    bool playConsoleInput(TurnState turn_state);
+    // Returns whether 'input' asks to undo the last move.
+    static bool isUndoCommand(std::string_view input);
+    // Returns whether 'input' asks to look at another part of the board,
+    // like 'view Ab'. If so, scrolls there, or explains what is wrong in
+    // the error messages.
+    bool parseViewCommand(std::string_view input);
+    // Called once the turn of a player has ended.
+    void onTurnEnd();
+    // Saves the game (see 'setAutosave') at the end of a turn.
+    void autosave();
+    // Saves the finished game's 'journal' and removes its 'Snapshot'.
+    void finishAutosave();
+    // Solves the current turn if it is in the endgame and hasn't been
+    // solved yet, updating 'perfect_scores'.
+    void solveEndgame();
+    // Lets 'bot' choose and play the turn of the current player,
+    // showing each of its actions.
+    void playBotTurn(Bot &bot);
 
     // Checks whether this move must be restricted by the edge case of forcing to play twice
-    // (see 'Board::mustPlayTwiceEdgeCase'), returning the correct checker for whether a move
-    // is legal or not.
-    //
-    // Passes whether the edge case is detected to 'must_play_twice'.
-    GameDisplayer::CheckLegalMove getCheckLegalMove(bool &must_play_twice) const;
+    // (see 'Board::mustPlayTwiceEdgeCase'), updating 'legal_positions' and 'must_play_twice'
+    // for 'isLegalMove'.
+    void updateLegalMoves();
+    // Returns whether a move to 'cell', at 'position', is legal, as of the
+    // last call to 'updateLegalMoves'. Used to highlight legal moves.
+    bool isLegalMove(Position position, const Cell &cell) const;
     // Tries to parse 'position' from 'input', returning whether it was successful.
-    bool parsePosition(std::istream &input, Position &position);
+    bool parsePosition(std::string_view input, Position &position);
     // Returns whether a move to 'position' by the current player would be valid.
-    //
-    // If 'must_play_twice', checks 'is_legal' for the edge case.
-    bool validateMove(Position position, bool must_play_twice, GameDisplayer::CheckLegalMove is_legal);
-    // Covers the 'Cell' at 'position'. Should only be called if that move has been validated.
-    void move(Position position);
-    
+    // If not, explains why in the error messages.
+    bool validateMove(Position position);
+
     // Tries to parse 'letter' from 'input', returning whether it was successful.
-    bool parseLetter(std::istream &input, char &letter);
+    bool parseLetter(std::string_view input, char &letter);
     // Returns whether current player may exchange 'letter' with the 'Pool'.
+    // If not, explains why in the error messages.
     bool validateExchange(char letter);
-    // Exchanges 'letter' with the 'Pool'. Should only be called if that exchange has been validated.
-    void exchange(char letter, std::default_random_engine &rng);
-    
+
     // Tries to parse two letters from 'input', returning whether it was successful.
-    bool parseLetters(std::istream &input, char &letter1, char &letter2);
+    bool parseLetters(std::string_view input, char &letter1, char &letter2);
     // Returns whether current player may exchange 'letter1' and 'letter2' with the 'Pool'.
+    // If not, explains why in the error messages.
     bool validateExchange(char letter1, char letter2);
-    // Exchanges 'letter1' and 'letter2' with the 'Pool'. Should only be called if that exchange has been validated.
-    void exchange(char letter1, char letter2, std::default_random_engine &rng);
-
-    // Advance to the next turn.
-    void nextTurn();
 
     public:
-    // Constructs a game with given 'Board' and number of players.
-    Game(Board &board, unsigned int num_players);
+    // Constructs a game with given 'Board', number of players and the
+    // generator for every draw from the pool. 'bots' has the 'Bot' for
+    // each seat that isn't played by a person ('nullptr' otherwise); seats
+    // beyond its size are played by people. The bots are not owned.
+    Game(const Board &board, unsigned int num_players, Rng rng, const std::vector<Bot*> &bots = {});
+
+    // Sets where every 'Action' is recorded. May be 'nullptr'. Must be
+    // set before 'play', with a 'Journal' started with the same generator.
+    void setJournal(Journal *journal);
+
+    // Saves the game at the end of every turn: a 'Snapshot' to the file
+    // 'snapshot_name' (for a game on the 'Board' of file 'board_name',
+    // whose contents hash to 'board_hash') and the 'Journal' (if any) to
+    // the file 'journal_name'. Once the game is over, the 'Snapshot' is removed.
+    void setAutosave(const std::string &snapshot_name, const std::string &board_name, uint64_t board_hash,
+            const std::string &journal_name);
+    // Continues the game saved in 'snapshot' instead of dealing new hands.
+    // Must be called before 'play'. Returns whether it was restored exactly.
+    bool restore(const Snapshot &snapshot);
 
     // Starts the game and plays it. Returns true if it ended successfuly,
     // and false if stdin has failed.
-    bool play(std::default_random_engine &rng);
+    bool play();
+
+    // Animates words completed by the current player.
+    void onWordsCompleted(const GameState &state, const Word *completed_words, int count) override;
+    // Notifies that the current player is exchanging letters.
+    void onExchange(const GameState &state, const char *letters, int count) override;
+    // Animates a letter put in the current player's 'Hand'.
+    void onLetterDrawn(const GameState &state, int index, char letter) override;
+    // Updates the screen to prepare for refilling the current player's 'Hand'.
+    void onRefillStart(const GameState &state) override;
+    // Notifies that the refill is over.
+    void onRefillEnd(const GameState &state) override;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -11,8 +11,19 @@
 #include "player.h"
 #include "word.h"
 #include "cmd.h"
+#include "screen.h"
+#include "viewport.h"
+#include "profiler.h"
 
 // Helps to display and animate the state of the game to the user.
+//
+// The board, the scoreboard and the information of the turn are drawn
+// to a 'Screen', so redrawing them after every move only writes what
+// changed. Everything below them is written to the console directly.
+//
+// A board that doesn't fit in the console is shown through a 'Viewport',
+// sized again whenever the console is, so drawing a frame costs the same
+// for any board.
 class GameDisplayer {
     // Color of each player, in the order of id's.
     static const Color PLAYERS_COLOR[];
@@ -40,17 +51,39 @@ class GameDisplayer {
     // Horizontal offset until the column where player's hand is printed.
     // This is needed to know where to update letters in the player hand.
     static const unsigned int current_player_hand_x_offset;
+    // Width of the scoreboard (and of the leaderboard) on screen.
+    static const unsigned int SCOREBOARD_WIDTH;
+    // Width and height of the information of the turn on screen.
+    static const unsigned int TURN_INFO_WIDTH;
+    static const unsigned int TURN_INFO_HEIGHT;
+    // Lines left below the information of the turn for errors and prompts.
+    static const unsigned int MESSAGE_HEIGHT;
+    // Fewest columns and rows of the board shown, however small the console.
+    static const unsigned int MIN_VIEWPORT_SIZE;
+    // Most columns and rows of the board shown when the size of the console
+    // is unknown, and printed by 'printBoard': those named by a single letter.
+    static const unsigned int MAX_PRINTED_SIZE;
 
     // The stream of error messages printed immediately
     // before prompting user for input.
     std::ostringstream error_messages;
+    // The part of the board shown.
+    Viewport viewport;
+    // Columns taken by the names of the rows, on the left of the board,
+    // and lines taken by the names of the columns, written downwards
+    // above it (see 'Position').
+    unsigned int label_width;
+    unsigned int label_height;
     // Horizontal offset before starting the zone of the
     // screen that shows the scoreboard (or leaderboard,
     // when game is over).
-    const unsigned int scoreboard_x_offset;
+    unsigned int scoreboard_x_offset;
     // Vertical offset before starting the zone of the
     // screen where the information of the turn is printed.
-    const unsigned int turn_info_y_offset;
+    unsigned int turn_info_y_offset;
+    // What the board, the scoreboard and the information of the turn look
+    // like on screen, from the top left corner down to the error messages.
+    Screen screen;
 
     // Auxiliary method to print the given id in the respective
     // player's color. Optionally, a prefix can be added, which will
@@ -59,11 +92,28 @@ class GameDisplayer {
     // This function guarantees to set the terminal color to 
     // 'TEXT_COLOR' at the end.
     static void printColoredId(int id, const char *prefix = "");
+    // Auxiliary method to draw the given id at column 'x', line 'y' in the
+    // respective player's color, after 'prefix'. Returns the column after it.
+    int drawColoredId(int x, int y, int id, const char *prefix = "");
 
-    // Auxiliary method to print the given word, possibly with delay
-    // between each letter. This is used to highlight a completed word
+    // Auxiliary method to draw the given word with 'color', possibly showing
+    // each letter with a delay. This is used to highlight a completed word
     // and turn it back to normal.
-    static void printWord(const Word &word, bool delay_each_letter);
+    void drawWord(const Word &word, Color color, bool delay_each_letter);
+    // Auxiliary method to wait 'milliseconds' during an animation.
+    static void pause(int milliseconds);
+    // Auxiliary method to find the colors of 'cell' on the board, which
+    // has a highlighted background if 'highlighted'.
+    static void getCellColors(const Cell &cell, bool highlighted, Color &color, Color &background);
+    // Auxiliary method to size the 'Viewport' and the zones of the screen
+    // for the console. Returns whether anything moved, so that everything
+    // must be drawn again.
+    bool fitToConsole();
+    // Auxiliary methods of 'drawBoard' to draw the labels of the rows and
+    // columns shown, and to draw 'cell' at 'position', which must be
+    // shown (see 'getCellColors').
+    void drawLabels();
+    void drawCell(Position position, const Cell &cell, bool highlighted);
 
     public:
     // Normal text color.
@@ -85,13 +135,6 @@ class GameDisplayer {
     // Color of the background of the board when highlighted.
     static const Color BOARD_HIGHLIGHTED_BACKGROUND;
     
-    // A callback to check whether a move to the given Position
-    // (where exists the given 'Cell') is legal.
-    //
-    // This is used to find out whether the board must highlight
-    // such 'Cell' as being playable.
-    typedef std::function<bool (Position, Cell)> CheckLegalMove;
-
     // Constructs a displayer for a 'Board' with given width and height.
     GameDisplayer(unsigned int board_width, unsigned int board_height); 
 
@@ -101,23 +144,56 @@ class GameDisplayer {
     // Clears all errors in the stream of error messages.
     void clearErrors();
 
-    // Prints the given 'Board' to screen.
-    // If 'check_legal_move' is passed, highlights 'Cell's recognized as legal.
-    static void printBoard(const Board &board, CheckLegalMove check_legal_move = nullptr);
-    // Prints the scoreboard.
-    void printScoreboard(const std::vector<Player> &players) const;
-    // Prints the information of the turn.
-    void printTurnInfo(const Player &current_player, unsigned int moves_left) const;
-    // Print the leaderboard. Should only be called when game is over.
+    // Clears the console, to draw everything again.
+    void clearScreen();
+    // Writes what changed on screen since it was last refreshed.
+    void refresh();
+
+    // Prints the given 'Board' where the cursor is, without highlighting
+    // any 'Cell', as part of some text. Of a 'Board' larger than
+    // 'MAX_PRINTED_SIZE', only as much as that is printed, from its first
+    // row and column with a letter.
+    static void printBoard(const Board &board);
+    // Draws the part of the given 'Board' that is shown, highlighting the
+    // 'Cell's where a move is legal: 'check_legal_move' is called with the
+    // 'Position' and the 'Cell' of each letter shown, and returns whether
+    // it is legal. Any callable works, so checking never needs to allocate
+    // memory.
+    template<typename CheckLegalMove>
+    void drawBoard(const Board &board, CheckLegalMove check_legal_move);
+    // Draws the given 'Board' on screen, without highlighting any 'Cell'.
+    void drawBoard(const Board &board);
+    // Scrolls to some 'Cell' where a move is legal (see 'drawBoard'), unless
+    // one is already shown. Those shown are checked first, so the others
+    // are only checked when none of them is legal.
+    template<typename CheckLegalMove>
+    void followLegalMoves(const Board &board, CheckLegalMove check_legal_move);
+    // Scrolls to 'position' if it isn't shown.
+    void showPosition(Position position);
+    // Scrolls so 'position' is in the middle of the part of the board shown.
+    void centerOn(Position position);
+    // Returns whether only part of the board is shown.
+    bool isBoardPartial() const;
+    // Draws the scoreboard.
+    void drawScoreboard(const std::vector<Player> &players);
+    // Draws the information of the turn and refreshes the screen, printing
+    // the error messages below it.
+    void printTurnInfo(const Player &current_player, unsigned int moves_left);
+    // Prints the final score of each player if everyone plays perfectly
+    // from now on (see 'EndgameSolver').
+    void printPerfectPlay(const std::vector<unsigned int> &final_scores) const;
+    // Draws the leaderboard. Should only be called when game is over.
     // Players are assumed to be sorted.
-    void printLeaderboard(const std::vector<Player> &players) const;
-    // Declares the winners of the game, given their ids and the total number of players.
-    void declareWinners(const std::vector<int> &winners_id, int num_players) const;
+    void drawLeaderboard(const std::vector<Player> &players);
+    // Refreshes the screen and declares the winners of the game below the
+    // board, given their ids and the total number of players.
+    void declareWinners(const std::vector<int> &winners_id, int num_players);
 
-    // Returns a callback to animate a letter being exchanged or inserted in 'Hand'.
-    Hand::SwapLetterAnimator getSwapLetterCallback() const;
-    // Animates the given words ('words_completed') being completed by the given 'player'.
-    void animateWordComplete(const Player &player, const std::vector<Word> &words_completed) const;
+    // Animates a letter being exchanged or inserted in the 'Hand' of the current
+    // player, given the index of the slot and the new letter.
+    void animateSwapLetter(int index, char letter);
+    // Animates the given 'count' words ('words_completed') being completed by the given 'player'.
+    void animateWordComplete(const Player &player, const Word *words_completed, int count);
 
     // Prints a notice to the screen, in warning colors delaying for some time.
     // The duration of the delay is shorter if 'short_delay' is true.
@@ -127,4 +203,42 @@ class GameDisplayer {
     void afterRefill(bool depleted_pool) const;
 };
 
+template<typename CheckLegalMove>
+void GameDisplayer::drawBoard(const Board &board, CheckLegalMove check_legal_move) {
+    PROFILE_SCOPE("GameDisplayer::drawBoard");
+    if(fitToConsole()) clearScreen();
+    drawLabels();
+
+    for(int j = viewport.getY(); j < viewport.getY() + viewport.getHeight(); j++) {
+        for(int i = viewport.getX(); i < viewport.getX() + viewport.getWidth(); i++) {
+            Position position(i, j);
+            const Cell &cell = board.getCell(position);
+            bool highlighted = !cell.isEmpty() && check_legal_move(position, cell);
+            drawCell(position, cell, highlighted);
+        }
+    }
+}
+
+template<typename CheckLegalMove>
+void GameDisplayer::followLegalMoves(const Board &board, CheckLegalMove check_legal_move) {
+    PROFILE_SCOPE("GameDisplayer::followLegalMoves");
+    if(!viewport.isPartial()) return;
+
+    for(int j = viewport.getY(); j < viewport.getY() + viewport.getHeight(); j++) {
+        for(int i = viewport.getX(); i < viewport.getX() + viewport.getWidth(); i++) {
+            Position position(i, j);
+            const Cell &cell = board.getCell(position);
+            if(!cell.isEmpty() && check_legal_move(position, cell)) return;
+        }
+    }
+
+    const std::vector<Position> &positions = board.getLetterPositions();
+    for(int i = 0; i < (int) positions.size(); i++) {
+        if(check_legal_move(positions[i], board.getLetterCell(i))) {
+            viewport.centerOn(positions[i]);
+            return;
+        }
+    }
+}
+
 #endif
\ No newline at end of file
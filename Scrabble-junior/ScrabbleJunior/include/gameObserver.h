@@ -0,0 +1,39 @@
+#ifndef GAME_OBSERVER_H
+#define GAME_OBSERVER_H
+
+#include "position.h"
+#include "word.h"
+
+class GameState;
+
+// Receives the events of a 'GameState' as they happen, for example to
+// display or animate them. Every method does nothing by default, so
+// observers only override the events they care about.
+//
+// Events are emitted while the 'GameState' is being changed, so the
+// state passed may be in the middle of an update (this is documented
+// for each event).
+class GameObserver {
+    public:
+    virtual ~GameObserver() = default;
+
+    // Called after the current player covered a 'Cell' and completed
+    // 'count' words (1 or 2), in 'completed_words'. Their score already
+    // includes the new points.
+    virtual void onWordsCompleted(const GameState &state, const Word *completed_words, int count);
+    // Called before the current player exchanges 'count' letters
+    // (1 or 2) with the pool.
+    virtual void onExchange(const GameState &state, const char *letters, int count);
+    // Called every time a letter is put in the current player's 'Hand'
+    // (when exchanging or refilling), with the index of the slot and the
+    // new letter.
+    virtual void onLetterDrawn(const GameState &state, int index, char letter);
+    // Called at the end of a turn, before refilling the current player's
+    // 'Hand'. Only called if the 'Hand' is not full and the game is not over.
+    virtual void onRefillStart(const GameState &state);
+    // Called after refilling the current player's 'Hand'. Only called if
+    // the pool wasn't empty when the refill started.
+    virtual void onRefillEnd(const GameState &state);
+};
+
+#endif
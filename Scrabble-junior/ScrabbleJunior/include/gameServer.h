@@ -0,0 +1,152 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cstdint>
+#include "board.h"
+#include "session.h"
+#include "action.h"
+#include "endpoint.h"
+
+// Hosts many games at once on a 'Board' for players connected over
+// sockets, on a single thread (an epoll loop, so only on Linux).
+//
+// The protocol is made of text lines. Every request is answered, in
+// order, by exactly one line starting with 'OK', 'ERROR' or 'LEGAL',
+// sent after the updates the request caused. Requests:
+// - 'JOIN': waits for a game. Once enough players joined, each of them
+//   gets 'GAME <id> <seat> <players> <width> <height>', a 'CELL' for each
+//   letter of the 'Board' and the whole state.
+// - 'STATE': sends the whole state again ('CELL's and every update).
+// - 'LEGAL': answers 'LEGAL' followed by what the current player may send
+//   right now: positions for 'MOVE', letters for 'EXCHANGE', or nothing.
+// - 'MOVE Ab': covers a 'Cell' (see 'Position').
+// - 'EXCHANGE AB' or 'EXCHANGE A': exchanges letters with the pool.
+// - 'END': ends the turn, when no more moves are possible or it is skipped.
+// Actions are checked by the rules of 'GameState::checkAction'; an illegal
+// one is answered with 'ERROR' and the name of its 'ActionError'.
+//
+// Only what changed is sent after an action, to every player of the game:
+// - 'CELL <position> <letter>': a letter of the 'Board', lowercase if it is
+//   covered. Only sent with the whole state; empty 'Cell's never are.
+// - 'COVER <player> <position>': a player covered a 'Cell'.
+// - 'SCORE <player> <score>', 'POOL <letters in the pool>'.
+// - 'HAND <letters>': the letters of the player receiving it.
+// - 'TURN <turn> <player> <moves left> <MOVE|EXCHANGE2|EXCHANGE1|END>':
+//   who plays now and what they must do, after every action.
+// - 'OVER <score>...': the game is over, with the final score of each player.
+// - 'ABORT': a player left, so the game is over.
+// Players are numbered from 0, as are seats.
+class GameServer {
+    // A connected client.
+    struct Client {
+        // The socket.
+        int fd;
+        // What was received but doesn't make a whole line yet.
+        std::string input;
+        // What is waiting to be sent.
+        std::string output;
+        // The game played, if any (see 'games').
+        unsigned long game_id;
+        // The seat in that game.
+        unsigned int seat;
+        // Whether the client is playing a game.
+        bool playing;
+        // Whether the client joined and waits for a game.
+        bool waiting;
+        // Whether the socket is watched for being writable.
+        bool watching_output;
+    };
+
+    // A game being played.
+    struct HostedGame {
+        // The game.
+        std::unique_ptr<Session> session;
+        // The socket of the player of each seat.
+        std::vector<int> seats;
+        // The score of each player, as last sent.
+        std::vector<unsigned int> scores;
+        // The letters of each 'Hand', as last sent to its player.
+        std::vector<std::string> hands;
+        // The letters in the pool, as last sent.
+        unsigned int pool_size;
+    };
+
+    // The 'Board' every game is played on.
+    const Board &board;
+    // Number of players of each game.
+    unsigned int num_players;
+    // Seed of the generators of the games (see 'Rng(uint64_t, uint64_t)').
+    uint64_t seed;
+    // The listening socket, or -1.
+    int listen_fd;
+    // The epoll instance, or -1.
+    int epoll_fd;
+    // Every connected client, by socket.
+    std::map<int, Client> clients;
+    // Every game being played, by id.
+    std::map<unsigned long, HostedGame> games;
+    // The sockets of the clients waiting for a game, in the order they joined.
+    std::vector<int> waiting;
+    // Number of games started so far (the id of the next one).
+    unsigned long games_started;
+    // Number of games that ended.
+    unsigned long games_finished;
+    // Number of actions applied.
+    unsigned long actions_applied;
+    // The legal 'Action's of a 'LEGAL' request, kept to reuse its memory.
+    std::vector<Action> legal_actions;
+
+    // Accepts every pending connection.
+    void acceptClients();
+    // Reads what 'client' sent and handles every whole line. Returns false
+    // if the connection was closed (or misbehaved) and must be dropped.
+    bool receive(Client &client);
+    // Sends as much of the output of 'client' as possible, watching the
+    // socket for being writable if some is left. Returns false if the
+    // connection was lost.
+    bool flush(Client &client);
+    // Closes the connection of the client with socket 'fd', aborting its game.
+    void drop(int fd);
+
+    // Handles the request 'line' of 'client'.
+    void handleRequest(Client &client, std::string_view line);
+    // Starts a game with the first clients waiting, if there are enough.
+    void startGames();
+    // Applies 'action' of 'client' to its game, answering it and sending the updates.
+    void play(Client &client, const Action &action);
+    // Appends the whole state of 'game' to the output of the player of 'seat'.
+    void sendState(HostedGame &game, unsigned int seat);
+    // Appends what changed in 'game' since last sent to the output of every player.
+    void sendUpdates(HostedGame &game);
+    // Returns the 'TURN' line of 'game'.
+    static std::string getTurnLine(const HostedGame &game);
+    // Appends 'line' to the output of every player of 'game'.
+    void broadcast(const HostedGame &game, const std::string &line);
+    // Ends the game 'game_id', which was finished or aborted.
+    void endGame(unsigned long game_id);
+
+    public:
+    // Constructs a server of games on 'board' with 'num_players', whose
+    // draws are decided by 'seed'. The 'Board' is not owned.
+    GameServer(const Board &board, unsigned int num_players, uint64_t seed);
+    // Closes every connection.
+    ~GameServer();
+
+    // Starts listening on 'endpoint'. Returns whether it was successful.
+    bool open(const Endpoint &endpoint);
+    // Serves clients until 'max_games' games have ended (forever if 0).
+    // Returns false if the event loop failed.
+    bool run(unsigned long max_games = 0);
+
+    // Returns the number of games that ended.
+    unsigned long countFinishedGames() const;
+    // Returns the number of actions applied.
+    unsigned long countActions() const;
+};
+
+#endif
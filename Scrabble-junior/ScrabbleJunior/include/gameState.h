@@ -0,0 +1,260 @@
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include <vector>
+#include "board.h"
+#include "pool.h"
+#include "player.h"
+#include "position.h"
+#include "action.h"
+#include "turn.h"
+#include "gameObserver.h"
+#include "rng.h"
+
+// Represents what the current player must do
+// in that turn.
+enum TurnState {
+    // Must choose a cell to cover.
+    MUST_MOVE,
+    // Must choose two letters to exchange with the pool.
+    MUST_EXCHANGE_TWO,
+    // Must choose one letter to exchange with the pool.
+    MUST_EXCHANGE_ONE,
+    // They can't move anymore. Their turn is over.
+    MUST_END_TURN,
+    // They can't move nor exchange at the start of the turn. Their turn is skipped.
+    MUST_SKIP_TURN,
+};
+
+// Why an 'Action' can't be applied to a 'GameState'.
+enum ActionError {
+    // The 'Action' is legal.
+    ACTION_OK,
+    // The 'Action' is not what the current 'TurnState' asks for.
+    ACTION_NOT_ALLOWED_NOW,
+    // The 'Position' is outside the limits of the 'Board'.
+    MOVE_OUT_OF_LIMITS,
+    // The 'Cell' has no letter.
+    MOVE_EMPTY_CELL,
+    // The 'Cell' has already been covered.
+    MOVE_ALREADY_COVERED,
+    // The 'Cell' is not the next uncovered letter of a word.
+    MOVE_NOT_COVERABLE,
+    // The current player doesn't have the letter of the 'Cell'.
+    MOVE_LETTER_NOT_IN_HAND,
+    // Another move would allow the current player to play twice this turn
+    // (see 'Board::mustPlayTwiceEdgeCase').
+    MOVE_WOULD_PLAY_ONCE,
+    // A character to exchange is not a letter.
+    EXCHANGE_NOT_A_LETTER,
+    // The current player doesn't have the letter to exchange.
+    EXCHANGE_LETTER_NOT_IN_HAND,
+    // The same letter was given twice but the current player only has one.
+    EXCHANGE_ONLY_ONE_IN_HAND,
+};
+
+// Returns the name of 'error' as it is written above, like "MOVE_EMPTY_CELL".
+const char* getActionErrorName(ActionError error);
+
+// Everything needed to undo a move made with 'GameState::makeMove'.
+class MoveUndo {
+    friend class GameState;
+
+    // What changed in the 'Board'.
+    BoardUndo board_undo;
+    // The slot of the 'Hand' the letter was taken from.
+    int hand_index;
+    // The letter used.
+    char letter;
+
+    public:
+    // Constructs an empty record.
+    MoveUndo();
+
+    // Returns what changed in the 'Board'.
+    const BoardUndo& getBoardUndo() const;
+    // Returns how many 'Word's the move completed (the points scored).
+    int countCompletedWords() const;
+};
+
+// Everything needed to undo a turn made with 'GameState::makeTurn'.
+class TurnUndo {
+    friend class GameState;
+
+    // The moves made, in order.
+    MoveUndo moves[2];
+    // How many moves were made.
+    int num_moves;
+    // Index of the player who played the turn.
+    unsigned int player_index;
+    // Number of moves they had left before the turn.
+    unsigned int moves_left;
+
+    public:
+    // Constructs an empty record.
+    TurnUndo();
+
+    // Returns how many 'Word's the turn completed (the points scored).
+    int countCompletedWords() const;
+};
+
+// The whole state of a game of Scrabble Junior, and the rules to change it.
+//
+// This is the engine of the game: it knows nothing about the console and
+// never waits. Front-ends (the interactive 'Game', bots, simulations) read
+// the state, choose 'Action's and apply them. A 'GameObserver' may be
+// attached to be told about what happens (for example, to animate it).
+class GameState {
+    // Saves and restores the whole state.
+    friend class Snapshot;
+
+    public:
+    // The maximum number of players of a game.
+    static const unsigned int MAX_PLAYERS = 4;
+
+    private:
+    // The board of the game.
+    Board board;
+    // The pool of the game.
+    Pool pool;
+    // The players of the game.
+    std::vector<Player> players;
+    // The index of current player.
+    unsigned int current_player_index;
+    // Number of moves left this turn.
+    unsigned int moves_left;
+    // The generator for every draw from the 'Pool'.
+    Rng rng;
+    // Who is told about the events of the game. May be 'nullptr'.
+    GameObserver *observer;
+
+    // Returns the callback that tells 'observer' about letters drawn,
+    // or 'nullptr' when there is no 'observer'.
+    Hand::SwapLetterAnimator getLetterDrawnCallback();
+
+    public:
+    // Constructs a game with given 'Board' (which is copied), number of
+    // players (up to 'MAX_PLAYERS') and generator. Every 'Hand' starts empty (see 'dealHands').
+    GameState(const Board &board, unsigned int num_players, Rng rng);
+
+    // Sets who is told about the events of the game. May be 'nullptr'.
+    void setObserver(GameObserver *observer);
+
+    // Gives each player a starting 'Hand'. Must be called once, before
+    // any 'Action' is applied.
+    void dealHands();
+
+    // Returns the board of the game.
+    const Board& getBoard() const;
+    // Returns the pool of the game.
+    const Pool& getPool() const;
+    // Returns the players of the game, in the order they play.
+    const std::vector<Player>& getPlayers() const;
+    // Returns the current player.
+    const Player& getCurrentPlayer() const;
+    // Returns the index of the current player in 'getPlayers'.
+    unsigned int getCurrentPlayerIndex() const;
+    // Returns the number of moves left this turn.
+    unsigned int getMovesLeft() const;
+
+    // Returns whether this game is over.
+    bool isOver() const;
+    // Returns a hash of everything in this state (the covered 'Cell's,
+    // the 'Pool', every 'Hand' and score, the turn and the generator), so
+    // two runs of a game can be checked to end in exactly the same state.
+    uint64_t getChecksum() const;
+    // Returns what current player must do in current turn.
+    TurnState getTurnState() const;
+
+    // Checks whether this move must be restricted by the edge case of forcing
+    // to play twice (see 'Board::mustPlayTwiceEdgeCase'). If so, returns true
+    // and pushes the only legal positions to 'legal_positions'.
+    bool mustPlayTwice(std::vector<Position> &legal_positions) const;
+
+    // Returns whether the current player may cover the 'Cell' at 'position'.
+    ActionError checkMove(Position position) const;
+    // Returns whether the current player may exchange 'letter' with the 'Pool'.
+    ActionError checkExchange(char letter) const;
+    // Returns whether the current player may exchange 'letter1' and 'letter2' with the 'Pool'.
+    ActionError checkExchange(char letter1, char letter2) const;
+    // Returns whether the current player may apply 'action'.
+    ActionError checkAction(const Action &action) const;
+
+    // Pushes every legal 'Action' of the current player to 'actions'.
+    // Exchanges of the same letters are only listed once.
+    void getLegalActions(std::vector<Action> &actions) const;
+    // Lists every legal 'Turn' the current player can play until their
+    // turn ends, replacing the contents of 'turns'. Only allocates memory
+    // when 'turns' needs more room than it ever had, past the first
+    // 'TurnList::RESERVED_TURNS' turns and 'TurnList::RESERVED_FIRST_MOVES'
+    // first moves, so a 'TurnList' reused between calls soon stops allocating.
+    //
+    // Two moves that could be made in either order (leading to the same
+    // state) are only listed once, and single moves are only listed when
+    // no 'Turn' with two moves exists, because players must play twice
+    // whenever possible. If one move has already been made this turn,
+    // lists the possible second moves.
+    void getLegalTurns(TurnList &turns) const;
+
+    // Covers the 'Cell' at 'position' with a letter of the current player.
+    // Should only be called if that move has been checked.
+    //
+    // Doesn't end the turn, even if there are no moves left. Returns the
+    // record to undo the move with 'unmakeMove'.
+    MoveUndo applyMove(Position position);
+    // Exchanges 'letter' with the 'Pool'. Should only be called if that
+    // exchange has been checked. Doesn't end the turn.
+    void applyExchange(char letter);
+    // Exchanges 'letter1' and 'letter2' with the 'Pool'. Should only be
+    // called if that exchange has been checked. Doesn't end the turn.
+    void applyExchange(char letter1, char letter2);
+    // Ends the turn: refills the current player's 'Hand' and advances
+    // to the next player.
+    void endTurn();
+
+    // Applies every 'Action' of 'turn' (which should have been listed by
+    // 'getLegalTurns') and ends the turn.
+    void applyTurn(const Turn &turn);
+    // Applies 'action' (which should have been checked), ending the turn
+    // when it is over: after the second move, after an exchange or when
+    // 'action' is 'ACTION_END_TURN'.
+    void applyAction(const Action &action);
+
+    // Same as 'applyMove', but without telling the observer. Meant for
+    // searches, which make and undo moves many times without copying.
+    MoveUndo makeMove(Position position);
+    // Undoes a move made with 'makeMove' (or 'applyMove'), restoring the
+    // 'Board', the 'Hand', the score and the moves left exactly. Moves
+    // must be undone in the reverse order they were made, and before the
+    // turn ends.
+    void unmakeMove(const MoveUndo &undo);
+    // Plays 'turn' and advances to the next player, like 'applyTurn', but
+    // without refilling the 'Hand' nor telling the observer, so it can be
+    // undone with 'unmakeTurn'. Hands are only kept exact if the pool is
+    // empty (refilling would draw nothing). 'turn' can't be an exchange.
+    TurnUndo makeTurn(const Turn &turn);
+    // Undoes a turn made with 'makeTurn'. Turns must be undone in the
+    // reverse order they were made.
+    void unmakeTurn(const TurnUndo &undo);
+
+    // Moves 'letter' from the 'Pool' to the empty 'slot' (or the first empty
+    // slot, if -1) of the 'Hand' of the player at 'player_index', as if they
+    // had drawn it. Returns the slot. Meant for searches that go through
+    // every possible draw instead of sampling one (see 'ExpectimaxSolver').
+    // The 'Pool' must have 'letter'.
+    int drawLetter(unsigned int player_index, char letter, int slot = -1);
+    // Moves 'letter' from 'slot' (or the first slot with it, if -1) of the
+    // 'Hand' of the player at 'player_index' back to the 'Pool'. Returns
+    // the slot. Undoes 'drawLetter' (and the other way around).
+    int returnLetter(unsigned int player_index, char letter, int slot = -1);
+
+    // Replaces what the player at 'viewer_index' can't see with a random
+    // guess consistent with what they can: the letters of the other
+    // players' 'Hand's and of the 'Pool' are shuffled between them (each
+    // 'Hand' keeping its size), and the generator of future draws is
+    // replaced by one split from 'rng'. Meant for searches over hidden
+    // information, on a copy of the real 'GameState'.
+    void determinize(unsigned int viewer_index, Rng &rng);
+};
+
+#endif
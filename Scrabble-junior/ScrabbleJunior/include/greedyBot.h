@@ -0,0 +1,29 @@
+#ifndef GREEDY_BOT_H
+#define GREEDY_BOT_H
+
+#include "bot.h"
+
+// A 'Bot' that plays the turn that completes the most words right away.
+// Ties are broken by how many 'Cell's the turn leaves it able to cover,
+// and then at random.
+class GreedyBot: public Bot {
+    // The generator to break ties.
+    Rng rng;
+
+    public:
+    // Constructs a 'GreedyBot' that breaks ties with 'rng' and gives up
+    // solving the endgame within 'time_budget_ms' milliseconds.
+    GreedyBot(Rng rng, int time_budget_ms);
+
+    const char* getName() const override;
+    void reset(Rng rng) override;
+
+    // Returns how many coverable 'Cell's of 'board' have a letter in 'hand'.
+    // Used by bots to prefer positions with more options for later turns.
+    static int countMoves(const Board &board, const Hand &hand);
+
+    protected:
+    Turn decideTurn(GameState &state, const TurnList &turns) override;
+};
+
+#endif
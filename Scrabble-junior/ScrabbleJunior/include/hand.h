@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <ostream>
+#include <cstdint>
 #include "pool.h"
 
 // Represents the letters a 'Player' holds in the game.
@@ -11,18 +12,34 @@ class Hand {
     // Inserts this 'Hand', with a space after every letter.
     // When a slot is empty, it is represented by an underscore ('_').
     friend std::ostream& operator<<(std::ostream& out, const Hand& hand); 
-    
+
+    public:
     // Players may have up to 7 letters in their 'Hand'.
     static const int HAND_SIZE = 7;
+
+    private:
     // 'char' that represents a slot without a letter.
     static const char EMPTY;
 
-    // The letters in 'Hand'.
+    // Number of different letters ('A-Z').
+    static const int ALPHABET_SIZE = 26;
+
+    // The letters in 'Hand', in the order of the slots shown
+    // to the player.
     char hand[HAND_SIZE];
+    // How many of each letter 'Hand' holds, indexed by 'letter - 'A''.
+    unsigned char letter_count[ALPHABET_SIZE];
+    // Bit 'i' is set whenever 'Hand' holds at least one letter 'A' + i.
+    // Kept in sync with 'letter_count' so letter queries are a single bit test.
+    uint32_t letter_mask;
 
     // Auxiliary function to calculate the index of an element
     // based on its position in memory.
     int indexOf(char* element) const;
+    // Auxiliary function to put 'letter' in the slot pointed by 'element',
+    // keeping 'letter_count' and 'letter_mask' up to date. The slot may
+    // hold a letter before, which is removed from the counts.
+    void setSlot(char *element, char letter);
 
     public:
     // A callback to animate a letter being exchanged or inserted in 'Hand'.
@@ -31,17 +48,21 @@ class Hand {
     // The second argument is the new letter.
     typedef std::function<void (int, char)> SwapLetterAnimator;
 
+    // Returns the bit that represents 'letter' in a letter mask (see 'getLetterMask'),
+    // or 0 if 'letter' is not in range 'A-Z'.
+    static uint32_t letterBit(char letter);
+
     // Constructs a new 'Hand' with every slot empty.
     Hand();
 
     // Returns whether this 'Hand' is full (has no empty slot).
     bool isFull() const;
-    // Refills every empty slot in 'Hand' with a letter from 'Pool',
+    // Refills every empty slot in 'Hand' with a random letter from 'Pool',
     // until 'Hand' is full or 'Pool' is empty.
     //
     // If a 'SwapLetterAnimator' is given, it is called every time
     // a new letter is put in 'Hand'.
-    void refill(Pool &pool, SwapLetterAnimator swap_hand = nullptr);
+    void refill(Pool &pool, Rng &rng, SwapLetterAnimator swap_hand = nullptr);
     // Finds the first letter in 'Hand' that matches the given letter
     // and exchanges it with the 'Pool'.
     //
@@ -49,7 +70,7 @@ class Hand {
     //
     // If a 'SwapLetterAnimator' is given, it is called every time
     // a new letter is put in 'Hand'.
-    void exchange(Pool &pool, char letter, SwapLetterAnimator swap_hand = nullptr);
+    void exchange(Pool &pool, Rng &rng, char letter, SwapLetterAnimator swap_hand = nullptr);
     // Finds the first letters in 'Hand' that match the given letters
     // and exchanges them with the 'Pool'.
     //
@@ -57,16 +78,34 @@ class Hand {
     //
     // If a 'SwapLetterAnimator' is given, it is called every time
     // a new letter is put in 'Hand'.
-    void exchange(Pool &pool, char letter1, char letter2, SwapLetterAnimator swap_hand = nullptr);
+    void exchange(Pool &pool, Rng &rng, char letter1, char letter2, SwapLetterAnimator swap_hand = nullptr);
 
     // Returns whether player has given letter.
     bool hasLetter(char letter) const;
+    // Returns a mask with the bit of every letter this 'Hand' has (see 'letterBit').
+    uint32_t getLetterMask() const;
+    // Returns the letter in the slot at 'index' (from 0 to 'HAND_SIZE' - 1),
+    // or an underscore ('_') if it is empty.
+    char getSlot(int index) const;
     // Returns the amount of letters this 'Hand' has that are equal to given letter.
     int countLetter(char letter) const;
     // Uses the given letter (i.e. removes one instance of it from 'Hand').
     //
-    // Should only be called if 'Hand' has given letter.
-    void useLetter(char letter);
+    // Should only be called if 'Hand' has given letter. Returns the index
+    // of the slot the letter was taken from (or -1 if it wasn't found), so
+    // it can be put back with 'putLetter'.
+    int useLetter(char letter);
+    // Puts 'letter' in the empty slot at 'index'. Meant to undo 'useLetter'.
+    void putLetter(int index, char letter);
+    // Puts 'letter' in the first empty slot, returning its index (or -1
+    // if 'Hand' is full).
+    int addLetter(char letter);
+    // Empties the slot at 'index'.
+    void clearSlot(int index);
+    // Returns how many letters this 'Hand' holds (its non-empty slots).
+    int countLetters() const;
+    // Puts every letter of this 'Hand' back in 'pool', emptying every slot.
+    void returnLetters(Pool &pool);
 };
 
 std::ostream& operator<<(std::ostream& out, const Hand& hand); 
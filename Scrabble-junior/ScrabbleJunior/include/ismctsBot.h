@@ -0,0 +1,107 @@
+#ifndef ISMCTS_BOT_H
+#define ISMCTS_BOT_H
+
+#include <vector>
+#include <memory>
+#include <chrono>
+#include "bot.h"
+
+// A 'Bot' that plays by Information Set Monte Carlo Tree Search.
+//
+// The letters of the 'Pool' and of the other players' 'Hand's are hidden,
+// so every iteration of the search starts by guessing them (see
+// 'GameState::determinize') and then descends a tree of turns shared by
+// every guess, only considering the turns legal in that guess. A few
+// random turns are played after leaving the tree, and each player is
+// rewarded by their lead in score.
+//
+// The search runs on several threads at once, each with its own tree
+// (root parallelization), whose visits are added together at the end.
+// Nodes come from arenas allocated once, when the 'IsmctsBot' is created.
+class IsmctsBot: public Bot {
+    // A node of a search tree: the 'Turn' that leads to it and its statistics.
+    struct Node {
+        // The 'Turn' played to reach this node.
+        Turn turn;
+        // Index of the player who played 'turn'.
+        unsigned int player_index;
+        // Indexes in the arena of the parent, the first child and the next
+        // sibling, or -1 if there is none.
+        int parent, first_child, next_sibling;
+        // How many iterations went through this node.
+        unsigned int visits;
+        // How many iterations could have chosen this node (it was legal).
+        unsigned int availability;
+        // Sum of the rewards of 'player_index' in those iterations.
+        double reward;
+    };
+
+    // Everything a search thread needs, kept between decisions.
+    struct Worker {
+        // The nodes of the tree. The root is always at index 0.
+        std::vector<Node> arena;
+        // How many nodes of 'arena' are in use.
+        int num_nodes;
+        // The turns listed at each step of an iteration.
+        TurnList turns;
+        // The children of the node being visited, indexed by their 'Turn'
+        // (see 'indexChildren'): a hash table of their indexes in 'arena',
+        // or -1 for free slots. Its size is a power of two.
+        std::vector<int> children_by_turn;
+        // The child of each of 'turns', or -1 if it has no node yet.
+        std::vector<int> turn_children;
+        // The generator for guesses and random turns.
+        Rng rng;
+        // How many iterations this thread made in the last search.
+        unsigned long iterations;
+        // The state of the current iteration. Created by the first search
+        // and assigned from then on, which reuses its memory.
+        std::unique_ptr<GameState> state;
+    };
+
+    // The generator to seed the workers and break ties.
+    Rng rng;
+    // One worker per search thread.
+    std::vector<Worker> workers;
+    // A copy of the state of the current decision, for the workers to
+    // search. Reused like 'Worker::state'.
+    std::unique_ptr<GameState> root_state;
+    // The visits of each legal turn, over every tree.
+    std::vector<unsigned long> visits;
+
+    // Copies 'source' to 'copy', creating it the first time and reusing
+    // its memory afterwards.
+    static void copyState(std::unique_ptr<GameState> &copy, const GameState &source);
+
+    // Adds a child of 'parent' for 'turn' to the tree of 'worker',
+    // returning its index or -1 if the arena is full.
+    static int addNode(Worker &worker, int parent, const Turn &turn, unsigned int player_index);
+    // Fills 'Worker::children_by_turn' with the children of 'node'.
+    static void indexChildren(Worker &worker, int node);
+    // Returns the index of the child for 'turn' of the last node given to
+    // 'indexChildren', or -1 if there is none.
+    static int findChild(const Worker &worker, const Turn &turn);
+    // Runs iterations from 'root_state', as seen by the player at
+    // 'viewer_index', on the tree of 'worker' until 'deadline'.
+    static void search(Worker &worker, const GameState &root_state, unsigned int viewer_index,
+            std::chrono::steady_clock::time_point deadline);
+    // Runs a single iteration on 'state', which must already be a guess.
+    static void iterate(Worker &worker, GameState &state);
+
+    public:
+    // Constructs an 'IsmctsBot' seeded with 'rng', that decides within
+    // 'time_budget_ms' milliseconds using 'num_threads' threads (0 for one
+    // per hardware thread), each with room for 'nodes_per_thread' nodes.
+    IsmctsBot(Rng rng, int time_budget_ms, unsigned int num_threads = 0, int nodes_per_thread = 100000);
+
+    const char* getName() const override;
+    void reset(Rng rng) override;
+
+    // Returns how many iterations were made in the last decision, over all threads.
+    unsigned long getLastIterations() const;
+
+    protected:
+    Turn decideTurn(GameState &state, const TurnList &turns) override;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include "action.h"
+#include "gameState.h"
+#include "rng.h"
+
+// The record of a game: which 'Board' it was played on, the number of
+// players, the generator of the 'GameState' before the hands were dealt
+// and every 'Action' applied. Since the generator decides every draw,
+// that is enough to play the game again exactly (see 'Replayer').
+//
+// Journals are saved in a compact binary form: a header followed by one
+// byte for each 'Action' (plus its position or letters), ending with the
+// checksum of the final 'GameState' if the game was finished.
+class Journal {
+    // Name of the file of the 'Board'.
+    std::string board_name;
+    // Hash of the contents of the file of the 'Board' (see 'hashFile').
+    uint64_t board_hash;
+    // Number of players of the game.
+    unsigned int num_players;
+    // State of the generator of the 'GameState' before the hands were dealt.
+    uint64_t rng_state[Rng::STATE_SIZE];
+    // Every 'Action' applied, in order.
+    std::vector<Action> actions;
+    // Whether the game was finished (see 'finish').
+    bool finished;
+    // 'GameState::getChecksum' at the end of the game. Only meaningful if 'finished'.
+    uint64_t final_checksum;
+
+    public:
+    // Returns a hash of the whole contents of 'file' (FNV-1a),
+    // to detect a 'Board' file that has changed.
+    static uint64_t hashFile(std::istream &file);
+
+    // Constructs an empty journal, to be loaded with 'load'.
+    Journal();
+    // Starts the journal of a game on the 'Board' of file 'board_name'
+    // (whose contents hash to 'board_hash') with 'num_players', where
+    // 'rng' is the generator given to the 'GameState'.
+    Journal(const std::string &board_name, uint64_t board_hash, unsigned int num_players, const Rng &rng);
+
+    // Records that 'action' was applied.
+    void record(const Action &action);
+    // Forgets the last 'Action' recorded, which must be a move that was
+    // undone (see 'GameState::unmakeMove'). Undoing a move restores the
+    // state exactly, so the game is the same as if it was never made.
+    void forgetLast();
+    // Forgets every 'Action' after the first 'count', to go back to
+    // the game as it was then (see 'Snapshot').
+    void truncate(size_t count);
+    // Records that the game ended in 'state'.
+    void finish(const GameState &state);
+
+    // Returns the name of the file of the 'Board'.
+    const std::string& getBoardName() const;
+    // Returns the hash of the contents of the file of the 'Board'.
+    uint64_t getBoardHash() const;
+    // Returns the number of players of the game.
+    unsigned int getNumPlayers() const;
+    // Returns the generator of the 'GameState' before the hands were dealt.
+    Rng getRng() const;
+    // Returns every 'Action' applied, in order.
+    const std::vector<Action>& getActions() const;
+    // Returns whether the game was finished.
+    bool isFinished() const;
+    // Returns the checksum of the final 'GameState'. Only meaningful if 'isFinished'.
+    uint64_t getFinalChecksum() const;
+
+    // Writes this journal to 'out'. Returns whether it was successful.
+    bool save(std::ostream &out) const;
+    // Writes this journal to the file 'name', replacing it atomically
+    // (see 'Snapshot::writeFileAtomically'). Returns whether it was successful.
+    bool saveAtomically(const std::string &name) const;
+    // Reads a journal written by 'save' from 'in', replacing this one.
+    // Returns false if 'in' doesn't hold a valid journal.
+    bool load(std::istream &in);
+};
+
+#endif
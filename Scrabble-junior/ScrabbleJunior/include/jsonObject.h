@@ -0,0 +1,46 @@
+#ifndef JSON_OBJECT_H
+#define JSON_OBJECT_H
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <ostream>
+
+// A flat JSON object, like '{"cmd": "new_game", "seed": 7}': every value
+// is a string, a number, a boolean or null. Nested objects and arrays
+// aren't needed by the requests of the 'Engine', so they aren't supported.
+class JsonObject {
+    // A value of the object.
+    struct Value {
+        // Whether the value is a string.
+        bool is_string;
+        // The string, without quotes or escapes, or the value as written otherwise.
+        std::string text;
+    };
+
+    // The value of each member.
+    std::map<std::string, Value> values;
+
+    public:
+    // Parses 'text' as a flat object, replacing this one. Returns whether
+    // it was successful; if not, 'error' explains why.
+    bool parse(std::string_view text, std::string &error);
+
+    // Returns whether the member 'name' is present.
+    bool has(const std::string &name) const;
+    // Reads the string member 'name' to 'value'. Returns whether it is a string.
+    bool getString(const std::string &name, std::string &value) const;
+    // Reads the integer member 'name' to 'value'. Returns whether it is an
+    // integer that fits in a 'long long'.
+    bool getInt(const std::string &name, long long &value) const;
+    // Reads the number member 'name' to 'value'. Returns whether it is a number.
+    bool getNumber(const std::string &name, double &value) const;
+    // Writes the member 'name' to 'out' as JSON, exactly as it was given.
+    // Writes null if it is not present.
+    void writeValue(std::ostream &out, const std::string &name) const;
+
+    // Writes 'text' to 'out' as a JSON string, with quotes and escapes.
+    static void writeString(std::ostream &out, std::string_view text);
+};
+
+#endif
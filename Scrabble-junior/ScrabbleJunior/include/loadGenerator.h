@@ -0,0 +1,98 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ostream>
+#include <chrono>
+#include "endpoint.h"
+#include "rng.h"
+
+// Connects many clients to a 'GameServer' that play random legal actions
+// as fast as they can, to measure how many turns it serves per second and
+// how long it takes to answer a request. Every client runs on a single
+// thread (an epoll loop, so only on Linux).
+class LoadGenerator {
+    // A client playing games on the server.
+    struct Connection {
+        // The socket.
+        int fd;
+        // What was received but doesn't make a whole line yet.
+        std::string input;
+        // What is waiting to be sent.
+        std::string output;
+        // The seat in the game being played.
+        int seat;
+        // Whether the client is playing a game.
+        bool playing;
+        // Whether it is the turn of this client.
+        bool my_turn;
+        // What the current player must do, as in the last 'TURN'.
+        std::string prompt;
+        // The number of the turn in the last 'TURN'.
+        unsigned long turn_number;
+        // Whether a request waits for its answer.
+        bool awaiting;
+        // When the request waiting for its answer was sent.
+        std::chrono::steady_clock::time_point sent_at;
+        // Whether the socket is watched for being writable.
+        bool watching_output;
+    };
+
+    // Where the server listens.
+    Endpoint endpoint;
+    // Number of clients.
+    unsigned int num_clients;
+    // Chooses the actions of every client.
+    Rng rng;
+    // The epoll instance, or -1.
+    int epoll_fd;
+    // Every client.
+    std::vector<Connection> connections;
+    // Whether clients may still join new games.
+    bool joining;
+
+    // Time each request took to be answered, in microseconds.
+    std::vector<double> latencies;
+    // Number of requests answered with an error.
+    unsigned long errors;
+    // Number of turns played (counted by the client of seat 0).
+    unsigned long turns;
+    // Number of games that ended (counted by the client of seat 0).
+    unsigned long games;
+    // Number of games aborted because a player left.
+    unsigned long aborted_games;
+    // How long the clients played, in seconds.
+    double elapsed_seconds;
+    // Why the run failed. Empty if it didn't.
+    std::string error;
+
+    // Sends 'request' from 'connection', which must not be waiting for an answer.
+    void request(Connection &connection, const std::string &request);
+    // Handles the line 'line' received by 'connection'.
+    void handleLine(Connection &connection, std::string_view line);
+    // Reads what 'connection' received and handles every whole line.
+    // Returns false if the connection was lost.
+    bool receive(Connection &connection);
+    // Sends as much of the output of 'connection' as possible. Returns
+    // false if the connection was lost.
+    bool flush(Connection &connection);
+
+    public:
+    // Constructs a load generator of 'num_clients' connecting to
+    // 'endpoint', choosing actions with 'rng'.
+    LoadGenerator(const Endpoint &endpoint, unsigned int num_clients, Rng rng);
+    // Closes every connection.
+    ~LoadGenerator();
+
+    // Plays for 'seconds', then lets the games being played end. Returns
+    // whether it was successful (if not, 'getError' explains why).
+    bool run(double seconds);
+    // Returns why the run failed.
+    const std::string& getError() const;
+    // Prints the turns per second and the latency of the requests.
+    void print(std::ostream &out) const;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef LOOKAHEAD_BOT_H
+#define LOOKAHEAD_BOT_H
+
+#include <vector>
+#include "bot.h"
+
+// A 'Bot' that searches several of its own turns ahead, choosing the turn
+// that leads to the most words completed over all of them.
+//
+// The letters drawn in the future are unknown, so the search assumes the
+// 'Hand' is not refilled and that the other players pass. The search deepens
+// one turn at a time while there is time left, and the deepest finished
+// search decides.
+class LookaheadBot: public Bot {
+    // The generator to break ties.
+    Rng rng;
+    // The maximum number of turns to look ahead.
+    int max_depth;
+    // Whether the current search ran out of time.
+    bool timed_out;
+    // Nodes visited since the clock was last checked.
+    int nodes_since_check;
+    // The turns listed at each depth of the search, so nothing is
+    // allocated while searching.
+    std::vector<TurnList> turn_lists;
+    // The value of each turn of the current decision, kept to reuse its memory.
+    std::vector<double> values;
+
+    // Returns whether the search must stop. Checks the clock every few nodes.
+    bool isTimeUp();
+    // Returns the value of 'state' for the player to move, looking
+    // 'depth' turns ahead. The value is the number of words they can
+    // complete, plus a fraction for the moves left in their 'Hand'.
+    double search(GameState &state, int depth);
+    // Makes the other players pass, so the player who just played
+    // moves again. Records the passes in 'undos' and returns how many.
+    static int passOthers(GameState &state, unsigned int player_index, TurnUndo *undos);
+
+    public:
+    // Constructs a 'LookaheadBot' that breaks ties with 'rng', looks up to
+    // 'max_depth' turns ahead and decides within 'time_budget_ms' milliseconds.
+    LookaheadBot(Rng rng, int max_depth, int time_budget_ms);
+
+    const char* getName() const override;
+    void reset(Rng rng) override;
+
+    protected:
+    Turn decideTurn(GameState &state, const TurnList &turns) override;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <climits>
+
+// The options of a command line mode, like '--games 1000 BOARD.txt'.
+//
+// Every argument starting with '--' is an option and takes the next
+// argument as its value, except for flags (given to the constructor),
+// which take none. The other arguments are positional.
+class Options {
+    // The value of each option given.
+    std::map<std::string, std::string> values;
+    // The positional arguments, in order.
+    std::vector<std::string> positional;
+    // The first problem found while parsing. Empty if there was none.
+    std::string error;
+
+    public:
+    // Parses 'argc' arguments from 'argv'. 'flags' are the options
+    // without a value (stored as "1" if given).
+    Options(int argc, char **argv, const std::vector<std::string> &flags = {});
+
+    // Returns whether the arguments were parsed successfully.
+    // If not, 'getError' explains why.
+    bool isValid() const;
+    // Returns why the arguments couldn't be parsed.
+    const std::string& getError() const;
+
+    // Returns whether option 'name' (without '--') was given.
+    bool has(const std::string &name) const;
+    // Returns the value of option 'name', or 'default_value' if not given.
+    std::string getString(const std::string &name, const std::string &default_value = "") const;
+    // Returns the value of option 'name' as an integer, or 'default_value'
+    // if not given. Invalidates the options if it isn't an integer.
+    long long getInt(const std::string &name, long long default_value);
+    // Like 'getInt', but also invalidates the options if the value is
+    // below 'min_value' or above 'max_value'.
+    long long getInt(const std::string &name, long long default_value, long long min_value,
+            long long max_value = LLONG_MAX);
+    // Returns the values of option 'name' separated by commas,
+    // or 'default_values' if not given.
+    std::vector<std::string> getList(const std::string &name, const std::vector<std::string> &default_values = {}) const;
+    // Returns the positional arguments, in order.
+    const std::vector<std::string>& getPositional() const;
+};
+
+#endif
@@ -31,6 +31,9 @@ class Player {
     unsigned int getScore() const;
     // Adds given points to the current score of this 'Player'.
     void addScore(unsigned int points);
+    // Removes given points from the current score of this 'Player'.
+    // Meant to undo 'addScore'.
+    void removeScore(unsigned int points);
 };
 
 #endif
\ No newline at end of file
@@ -2,39 +2,56 @@
 #define POOL_H
 
 #include <vector>
-#include <random>
+#include "rng.h"
 
 // Represents a 'bag' of letters 'Player's can draw from.
+//
+// The 'Pool' only stores how many of each letter it has, so it never needs
+// to be shuffled: every draw picks a letter at random, weighted by those
+// counts, which is the same as drawing from a freshly shuffled bag.
 class Pool {
-    // Letters in 'Pool'. 
-    std::vector<char> letters;
+    // Number of different letters ('A-Z').
+    static const int ALPHABET_SIZE = 26;
+
+    // How many of each letter the 'Pool' has, indexed by 'letter - 'A''.
+    unsigned int letter_count[ALPHABET_SIZE];
+    // Total number of letters in the 'Pool'.
+    unsigned int total;
 
     public:
-    // Creates a 'Pool' by moving the given vector of 'letters'.
+    // Creates a 'Pool' with the given 'letters'.
     //
     // Letters should be in range 'A-Z'.
-    Pool(std::vector<char> &&letters);
+    Pool(const std::vector<char> &letters);
 
-    // Removes and returns a letter from the 'Pool'.
-    char popLetter();
-    // Swaps a letter in the 'Pool' with the given letter.
+    // Removes and returns a random letter from the 'Pool'.
     //
-    // This exchange is not randomized. 'Pool' should be shuffled
-    // afterwards.
-    void exchange(char *letter);
-    // Swaps two different letters in the 'Pool' with given letters. 
+    // Should only be called if 'Pool' is not empty.
+    char drawLetter(Rng &rng);
+    // Removes the given letter from the 'Pool', instead of a random one.
+    // Meant for searches that go through every possible draw.
     //
-    // This exchange is not randomized. 'Pool' should be shuffled
-    // afterwards.
-    void exchange(char *letter1, char *letter2);
-
-    // Shuffles the letters inside the pool.
-    void shuffle(std::default_random_engine &rng);
+    // Should only be called if 'Pool' has given letter.
+    void takeLetter(char letter);
+    // Puts the given letter back in the 'Pool'.
+    void returnLetter(char letter);
+    // Swaps the given letter with a random letter from the 'Pool'.
+    //
+    // The letter is only put in the 'Pool' after drawing, so it is
+    // never drawn back.
+    void exchange(char *letter, Rng &rng);
+    // Swaps two letters with two random letters from the 'Pool'.
+    //
+    // The letters are only put in the 'Pool' after drawing, so they
+    // are never drawn back.
+    void exchange(char *letter1, char *letter2, Rng &rng);
 
     // Returns whether 'Pool' is empty (has no letters left).
     bool isEmpty() const;
     // Returns how many letters the 'Pool' still has.
     int size() const;
+    // Returns how many instances of given letter the 'Pool' still has.
+    int countLetter(char letter) const;
 };
 
-#endif
\ No newline at end of file
+#endif
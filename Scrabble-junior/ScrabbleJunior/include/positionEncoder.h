@@ -0,0 +1,97 @@
+#ifndef POSITION_ENCODER_H
+#define POSITION_ENCODER_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+#include "board.h"
+#include "gameState.h"
+
+// A position decoded by a 'PositionEncoder'.
+struct DecodedPosition {
+    // Whether each letter of the 'Board' is covered, in the order of
+    // 'Board::getLetterPositions'.
+    std::vector<bool> covered;
+    // Index of the current player.
+    unsigned int current_player;
+    // Moves the current player has left this turn.
+    unsigned int moves_left;
+    // How many of each letter (see 'PositionEncoder::getLetters') each player has.
+    std::vector<std::vector<unsigned int>> hands;
+    // How many of each letter the 'Pool' has.
+    std::vector<unsigned int> pool;
+    // Score of each player.
+    std::vector<unsigned int> scores;
+    // Score of each player at the end of the game.
+    std::vector<unsigned int> final_scores;
+};
+
+// Packs the positions of games on a 'Board' into a fixed number of bits,
+// to store many of them for training bots.
+//
+// A record has, in order and using just enough bits for the largest
+// value each field can have on that 'Board':
+// - one bit for each letter of the 'Board', set if it is covered;
+// - the current player (2 bits) and the moves they have left (2 bits);
+// - for each player, how many of each letter of the 'Board' they hold;
+// - how many of each letter the 'Pool' has;
+// - the score of each player;
+// - the score of each player at the end of the game (see 'setOutcome').
+// Bits are packed from the lowest bit of the first byte up.
+class PositionEncoder {
+    // The different letters of the 'Board', in alphabetical order.
+    std::string letters;
+    // How many of each letter the 'Board' has (the most the 'Pool' can have).
+    std::vector<unsigned int> letter_counts;
+    // Number of letters of the 'Board'.
+    unsigned int num_cells;
+    // Number of players of the games.
+    unsigned int num_players;
+    // Number of 'Word's of the 'Board' (the most a player can score).
+    unsigned int num_words;
+
+    // Bits of the count of each letter in a 'Hand'.
+    std::vector<unsigned int> hand_bits;
+    // Bits of the count of each letter in the 'Pool'.
+    std::vector<unsigned int> pool_bits;
+    // Bits of a score.
+    unsigned int score_bits;
+    // Position of the first bit of the final scores.
+    size_t outcome_offset;
+    // Size of a record, in bytes.
+    size_t record_size;
+
+    // Computes the sizes of the fields, once the rest is known.
+    void computeLayout();
+
+    public:
+    // Constructs an encoder of positions of games on 'board' with 'num_players'.
+    PositionEncoder(const Board &board, unsigned int num_players);
+    // Constructs an encoder from a layout saved with 'save'.
+    PositionEncoder(std::istream &in);
+
+    // Returns whether the layout was read successfully (see 'PositionEncoder(std::istream&)').
+    bool isValid() const;
+    // Returns the different letters of the 'Board', in alphabetical order.
+    const std::string& getLetters() const;
+    // Returns the number of players of the games.
+    unsigned int getNumPlayers() const;
+    // Returns the size of a record, in bytes.
+    size_t getRecordSize() const;
+
+    // Packs 'state' into the 'getRecordSize' bytes of 'record'. Its final
+    // scores are left at zero until they are known (see 'setOutcome').
+    void encode(const GameState &state, uint8_t *record) const;
+    // Sets the final scores of 'record' to those of 'players'.
+    void setOutcome(uint8_t *record, const std::vector<Player> &players) const;
+    // Unpacks 'record' into 'position'.
+    void decode(const uint8_t *record, DecodedPosition &position) const;
+
+    // Writes the layout of records to 'out', so they can be decoded without the 'Board'.
+    void save(std::ostream &out) const;
+};
+
+#endif
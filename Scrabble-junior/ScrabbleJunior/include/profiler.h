@@ -0,0 +1,77 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Measures where the time of a game goes: how long named scopes take
+// ('PROFILE_SCOPE') and how often things happen ('PROFILE_COUNT').
+//
+// Profiling is only compiled in when 'SCRABBLE_PROFILE' is defined.
+// Otherwise both macros expand to nothing and 'isEnabled' returns false,
+// so normal builds pay nothing for them. Each thread records to its own
+// buffer, so recording takes no locks. 'writeReport' saves every scope
+// recorded as a Chrome trace (for chrome://tracing or Perfetto) and the
+// latency histogram of each scope, with the total of each counter.
+class Profiler {
+    public:
+    // Most scopes each thread records in the trace. Later ones only
+    // go to the histograms, so long runs don't run out of memory.
+    static const size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+    // Returns whether profiling is compiled in.
+    static bool isEnabled();
+    // Returns the id of the scope or counter named 'name', which must be a
+    // string literal. Sites with the same name share an id.
+    static int registerSite(const char *name);
+    // Returns the time elapsed since the program started, in nanoseconds.
+    static uint64_t now();
+    // Records that the calling thread was in the scope 'site' from 'start' (see 'now') until now.
+    static void recordScope(int site, uint64_t start);
+    // Adds 'amount' to the counter 'site' of the calling thread.
+    static void addCount(int site, uint64_t amount);
+
+    // Writes the trace to '<prefix>.trace.json' and the histograms and
+    // counters to '<prefix>.txt'. Must only be called once every thread
+    // that recorded has stopped. Returns whether it was successful.
+    static bool writeReport(const std::string &prefix);
+};
+
+#ifdef SCRABBLE_PROFILE
+
+// Records the time from its construction until the end of its scope.
+class ProfileScope {
+    // The site recorded.
+    int site;
+    // When the scope started (see 'Profiler::now').
+    uint64_t start;
+
+    public:
+    // Starts measuring the scope 'site'.
+    explicit ProfileScope(int site): site(site), start(Profiler::now()) {}
+    // Records the scope.
+    ~ProfileScope() { Profiler::recordScope(site, start); }
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+// Measures the rest of the enclosing scope as 'name' (a string literal).
+#define PROFILE_SCOPE(name) \
+    static const int PROFILE_CONCAT(profile_site_, __LINE__) = Profiler::registerSite(name); \
+    ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(PROFILE_CONCAT(profile_site_, __LINE__))
+// Adds 'amount' to the counter 'name' (a string literal).
+#define PROFILE_COUNT(name, amount) \
+    do { \
+        static const int profile_site = Profiler::registerSite(name); \
+        Profiler::addCount(profile_site, amount); \
+    } while(false)
+
+#else
+
+#define PROFILE_SCOPE(name) ((void) 0)
+#define PROFILE_COUNT(name, amount) ((void) 0)
+
+#endif
+
+#endif
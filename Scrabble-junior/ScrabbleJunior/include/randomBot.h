@@ -0,0 +1,22 @@
+#ifndef RANDOM_BOT_H
+#define RANDOM_BOT_H
+
+#include "bot.h"
+
+// A 'Bot' that plays any legal turn, uniformly at random.
+class RandomBot: public Bot {
+    // The generator for every choice.
+    Rng rng;
+
+    public:
+    // Constructs a 'RandomBot' that chooses with 'rng'.
+    RandomBot(Rng rng);
+
+    const char* getName() const override;
+    void reset(Rng rng) override;
+
+    protected:
+    Turn decideTurn(GameState &state, const TurnList &turns) override;
+};
+
+#endif
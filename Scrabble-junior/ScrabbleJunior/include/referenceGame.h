@@ -0,0 +1,153 @@
+#ifndef REFERENCE_GAME_H
+#define REFERENCE_GAME_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <istream>
+#include <cstdint>
+#include "position.h"
+#include "orientation.h"
+#include "action.h"
+#include "turn.h"
+#include "gameState.h"
+#include "rng.h"
+
+// A game of Scrabble Junior written as plainly as possible, straight from
+// the rules, to check 'GameState' (and its 'Board', 'Hand' and 'Pool')
+// against (see 'DifferentialTester').
+//
+// Nothing is cached: whether a 'Cell' can be covered is found every time
+// by looking at the letters before it in its words, and whether a move
+// lets the player move again is found by trying it. The 'Pool' is a
+// sorted bag of letters, so drawing the letter at a random index of it
+// draws the same letters as 'Pool' given the same generator.
+class ReferenceGame {
+    public:
+    // A word of the board.
+    struct WordInfo {
+        // The 'Position' of its first letter.
+        Position start;
+        // The 'Orientation' of the word.
+        Orientation orientation;
+        // Number of letters.
+        int length;
+    };
+
+    // 'char' of an empty slot of a hand, as in 'Hand::getSlot'.
+    static const char EMPTY_SLOT = '_';
+
+    private:
+    // What never changes during a game. Shared between copies, so trying
+    // a move on a copy only copies the state of the game.
+    struct Layout {
+        // Size of the board.
+        int width;
+        int height;
+        // The letter of every 'Cell', row after row, or a space if it has none.
+        std::vector<char> letters;
+        // The 'Position' of every letter, row after row.
+        std::vector<Position> letter_positions;
+        // Every word of the board, in the order they were read.
+        std::vector<WordInfo> words;
+        // The words each 'Cell' belongs to, as indices in 'words', row after row.
+        std::vector<std::vector<int>> cell_words;
+    };
+
+    // The board.
+    std::shared_ptr<const Layout> layout;
+    // Whether every 'Cell' is covered, row after row.
+    std::vector<bool> covered;
+
+    // The slots of the hand of each player ('EMPTY_SLOT' if empty).
+    std::vector<std::string> hands;
+    // The score of each player.
+    std::vector<unsigned int> scores;
+    // The letters of the pool, in alphabetical order.
+    std::string bag;
+    // Index of the current player.
+    unsigned int current_player;
+    // Moves left this turn.
+    unsigned int moves_left;
+    // Makes every draw.
+    Rng rng;
+    // Why the board couldn't be read. Empty if it could.
+    std::string error;
+
+    // Returns the index of 'position' in the vectors of 'Cell's.
+    int indexOf(Position position) const;
+    // Returns the 'Position' of letter 'i' of 'word'.
+    static Position letterPosition(const WordInfo &word, int i);
+    // Returns whether every letter of 'word' is covered.
+    bool isComplete(const WordInfo &word) const;
+    // Returns whether 'hand' has 'letter'.
+    static bool hasLetter(const std::string &hand, char letter);
+    // Returns whether a player with 'hand' can cover some 'Cell'.
+    bool canMove(const std::string &hand) const;
+    // Takes a random letter from the bag.
+    char draw();
+    // Puts 'letter' back in the bag.
+    void putBack(char letter);
+    // Returns why 'action' can't be applied now, when the current
+    // player must do what 'turn_state' says, or 'ACTION_OK'.
+    ActionError checkAction(const Action &action, TurnState turn_state) const;
+
+    public:
+    // Starts a game with 'num_players' on the board of 'board_file' (in the
+    // format of a board file), drawing with 'rng'. Hands start empty.
+    ReferenceGame(std::istream &board_file, unsigned int num_players, Rng rng);
+
+    // Returns whether the board was read. If not, 'getError' explains why.
+    bool isValid() const;
+    // Returns why the board couldn't be read.
+    const std::string& getError() const;
+
+    // Returns the width of the board.
+    int getWidth() const;
+    // Returns the height of the board.
+    int getHeight() const;
+    // Returns the 'Position' of every letter, row after row.
+    const std::vector<Position>& getLetterPositions() const;
+    // Returns the letter at 'position' (a space if it has none).
+    char getLetter(Position position) const;
+    // Returns whether the letter at 'position' is covered.
+    bool isCovered(Position position) const;
+    // Returns whether the letter at 'position' can be covered: it isn't
+    // covered and every letter before it in one of its words is.
+    bool isCoverable(Position position) const;
+    // Returns the slots of the hand of player 'index'.
+    const std::string& getHand(unsigned int index) const;
+    // Returns the score of player 'index'.
+    unsigned int getScore(unsigned int index) const;
+    // Returns the letters of the pool, in alphabetical order.
+    const std::string& getBag() const;
+    // Returns the index of the current player.
+    unsigned int getCurrentPlayer() const;
+    // Returns the moves the current player has left this turn.
+    unsigned int getMovesLeft() const;
+    // Returns whether every letter is covered.
+    bool isOver() const;
+
+    // Fills the hand of every player, in order.
+    void dealHands();
+    // Returns what the current player must do.
+    TurnState getTurnState() const;
+    // Returns the 'Cell's the current player may cover now, row after row.
+    // On the first move of a turn, only those that let them move again
+    // if there are any, since players must move twice whenever possible.
+    std::vector<Position> getLegalMoves() const;
+    // Returns why 'action' can't be applied now, or 'ACTION_OK'.
+    ActionError checkAction(const Action &action) const;
+    // Returns every legal 'Action', in no particular order.
+    std::vector<Action> getLegalActions() const;
+    // Returns every legal way to play the rest of the turn. Two moves that
+    // could be made in either order may be listed in both orders.
+    std::vector<Turn> getLegalTurns() const;
+
+    // Applies 'action', which must be legal. Returns the words it completed.
+    std::vector<WordInfo> apply(const Action &action);
+    // Ends the turn of the current player, refilling their hand.
+    void endTurn();
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef REPLAYER_H
+#define REPLAYER_H
+
+#include <string>
+#include <vector>
+#include "board.h"
+#include "gameState.h"
+#include "journal.h"
+
+// Plays the game of a 'Journal' again, without a console and as fast as
+// possible, checking that every 'Action' is legal and that it ends in
+// exactly the same 'GameState'.
+//
+// Every few turns, the 'GameState' is kept as a keyframe, so the state
+// at the start of any turn can be found quickly with 'seek': from the
+// closest keyframe before it, only a few turns have to be played.
+class Replayer {
+    // The journal of the game.
+    const Journal &journal;
+    // The 'Board' of the game, before any move.
+    const Board &board;
+    // Number of turns between keyframes.
+    unsigned int keyframe_interval;
+    // Index in 'journal' of the first 'Action' of each turn, plus (once
+    // the last turn is complete) the number of 'Action's.
+    std::vector<size_t> turn_starts;
+    // The state at the start of every 'keyframe_interval' turns.
+    std::vector<GameState> keyframes;
+    // The state after every 'Action' of 'journal'.
+    GameState final_state;
+    // Why the replay failed. Empty if it didn't.
+    std::string error;
+
+    public:
+    // Prepares to replay 'journal' on 'board', which must be the 'Board'
+    // the game was played on, keeping a keyframe every 'keyframe_interval' turns.
+    Replayer(const Journal &journal, const Board &board, unsigned int keyframe_interval = 16);
+
+    // Replays the whole game. Returns whether every 'Action' was legal and
+    // the game ended as recorded; if not, 'getError' explains why.
+    bool run();
+    // Returns why the replay failed.
+    const std::string& getError() const;
+
+    // Returns the number of complete turns replayed.
+    unsigned int countTurns() const;
+    // Returns the state after every 'Action' replayed.
+    const GameState& getFinalState() const;
+    // Returns the state at the start of 'turn' (counted from 0, up to
+    // 'countTurns', the state after the last complete turn).
+    GameState seek(unsigned int turn) const;
+};
+
+#endif
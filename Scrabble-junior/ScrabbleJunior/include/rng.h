@@ -0,0 +1,57 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+// A fast pseudo-random generator (xoshiro256**).
+//
+// Satisfies the requirements of a 'UniformRandomBitGenerator', so it
+// can also be used with the standard distributions and algorithms.
+// The same seed (and stream) always produces the same sequence, on
+// any platform.
+class Xoshiro256 {
+    // The internal state of the generator. Must never be all zeros.
+    uint64_t state[4];
+
+    public:
+    // Type of the numbers generated.
+    typedef uint64_t result_type;
+
+    // Number of 64-bit words in the state (see 'getState').
+    static const int STATE_SIZE = 4;
+
+    // Constructs a generator from a 'seed'. Different 'stream's with the
+    // same 'seed' produce independent sequences, so a simulation can give
+    // each game its own stream and stay reproducible no matter how games
+    // are split between threads.
+    explicit Xoshiro256(uint64_t seed = 0, uint64_t stream = 0);
+
+    // Smallest value that can be generated.
+    static constexpr result_type min() { return 0; }
+    // Largest value that can be generated.
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    // Generates the next number.
+    result_type operator()();
+    // Returns a number uniformly distributed in range '[0, bound)'.
+    // 'bound' must be positive.
+    uint32_t below(uint32_t bound);
+    // Returns a new generator seeded from this one. Both generators can
+    // be used independently afterwards.
+    Xoshiro256 split();
+
+    // Copies the internal state to 'out', which must have 'STATE_SIZE' words.
+    void getState(uint64_t *out) const;
+    // Restores an internal state copied with 'getState'.
+    void setState(const uint64_t *in);
+
+    // Returns whether both generators will produce the same sequence.
+    bool operator==(const Xoshiro256 &other) const;
+};
+
+// The generator used by the game. Every random decision (drawing from
+// the 'Pool', bots, simulations) goes through this type, so another
+// generator can be plugged in by changing this alias.
+typedef Xoshiro256 Rng;
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "board.h"
+#include "gameState.h"
+#include "gameObserver.h"
+#include "action.h"
+#include "turn.h"
+#include "journal.h"
+#include "snapshot.h"
+#include "rng.h"
+
+// What a 'Session' needs before its game can go on.
+enum SessionPrompt {
+    // A 'Position' to cover ('ACTION_MOVE').
+    PROMPT_MOVE,
+    // Two letters to exchange with the pool ('ACTION_EXCHANGE_TWO').
+    PROMPT_EXCHANGE_TWO,
+    // One letter to exchange with the pool ('ACTION_EXCHANGE_ONE').
+    PROMPT_EXCHANGE_ONE,
+    // A confirmation to go on ('ACTION_END_TURN'): the current player
+    // can't make any more moves this turn, or their turn is skipped.
+    PROMPT_END_TURN,
+    // Nothing: the game is over.
+    PROMPT_GAME_OVER,
+};
+
+// A game that is played by feeding it 'Action's, one at a time.
+//
+// A session never waits for input: it tells what it needs next
+// ('getPrompt') and goes on as soon as it is given an 'Action'
+// ('submit'). Where the 'Action's come from (someone typing at the
+// console, a 'Bot', a connection, a 'Journal') is up to whoever drives
+// it, so a single thread can drive as many sessions as it wants.
+class Session {
+    // The state of the game.
+    GameState state;
+    // Where every 'Action' is recorded. May be 'nullptr'.
+    Journal *journal;
+    // Whether the hands have been dealt (or restored from a 'Snapshot').
+    bool started;
+    // The record to undo the first move of the current turn.
+    MoveUndo last_move;
+    // Whether 'last_move' may be undone. Only the first move of a
+    // turn can be undone, before the turn ends.
+    bool can_undo_last_move;
+    // Number of turns that have ended.
+    unsigned long turns_played;
+
+    public:
+    // Constructs a session of a game with given 'Board', number of
+    // players and the generator for every draw from the pool.
+    Session(const Board &board, unsigned int num_players, Rng rng);
+
+    // Sets who is notified of what happens in the game. May be 'nullptr'.
+    void setObserver(GameObserver *observer);
+    // Sets where every 'Action' is recorded. May be 'nullptr'. Must be
+    // set before 'start', with a 'Journal' started with the same generator.
+    void setJournal(Journal *journal);
+
+    // Deals the hands, so the game can be played. Does nothing if it has already started.
+    void start();
+    // Continues the game saved in 'snapshot' instead of dealing new hands.
+    // Must be called before 'start'. Returns whether it was restored exactly.
+    bool restore(const Snapshot &snapshot);
+    // Returns whether the game has started.
+    bool isStarted() const;
+
+    // Returns the state of the game.
+    const GameState& getState() const;
+    // Returns the state of the game, to be searched by a 'Bot' or an
+    // 'EndgameSolver'. It must be left exactly as it was.
+    GameState& getState();
+    // Returns what the game needs to go on.
+    SessionPrompt getPrompt() const;
+    // Returns the number of turns that have ended, to tell when one ends.
+    unsigned long countTurns() const;
+
+    // Applies 'action' for the current player if it is legal, recording it
+    // in the 'Journal'. Returns why it isn't legal otherwise (see
+    // 'GameState::checkAction'), or 'ACTION_NOT_ALLOWED_NOW' if the game
+    // hasn't started or is over.
+    ActionError submit(const Action &action);
+    // Applies every 'Action' of 'turn' (see 'Turn::getActions'), until
+    // the turn ends. Returns the first error, if any.
+    ActionError submit(const Turn &turn);
+    // Returns whether the current player may take back their last move.
+    bool canUndo() const;
+    // Takes back the first move of the current turn, forgetting it in
+    // the 'Journal'. Should only be called if 'canUndo'.
+    void undo();
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef SIMULATION_STATS_H
+#define SIMULATION_STATS_H
+
+#include <vector>
+#include <ostream>
+#include "board.h"
+#include "player.h"
+#include "turn.h"
+
+// What a 'Simulator' learns from the games it plays on a 'Board'.
+//
+// Every statistic is an integer sum or count, so the stats of each thread
+// can be merged in any order with exactly the same result.
+class SimulationStats {
+    // Shares of a win, so that every tie splits it evenly in whole shares
+    // (it's divisible by any number of players).
+    static const unsigned long WIN_SHARES = 12;
+    // Largest width and height of a 'Board' whose heatmap is printed in
+    // the layout of the 'Board'. Larger ones list their letters instead.
+    static const unsigned int MAX_HEATMAP_SIZE = 26;
+
+    // Number of players of each game.
+    unsigned int num_players;
+    // Width of the 'Board'.
+    unsigned int board_width;
+    // Height of the 'Board'.
+    unsigned int board_height;
+    // The 'Position' of each letter of the 'Board', by number
+    // (see 'Board::getLetterPositions').
+    std::vector<Position> letter_positions;
+
+    // Number of games that ended.
+    unsigned long games;
+    // Number of games stopped because they were too long.
+    unsigned long unfinished_games;
+    // Shares of games won by each seat (see 'WIN_SHARES'). A tie splits
+    // the shares of a win between the winners.
+    std::vector<unsigned long> win_shares;
+    // How many games each seat ended with each score.
+    std::vector<std::vector<unsigned long>> score_histogram;
+    // How many games took each number of turns.
+    std::vector<unsigned long> turns_histogram;
+    // Total number of turns of the games that ended.
+    unsigned long turns;
+    // Number of turns of the games that ended that exchanged letters.
+    unsigned long exchanges;
+    // Number of turns of the games that ended that were skipped.
+    unsigned long skips;
+    // Sum of the turns (counted from 0) in which each letter was covered.
+    std::vector<unsigned long> covered_turn_sum;
+    // Number of times each letter was covered.
+    std::vector<unsigned long> covered_count;
+    // Total memory allocations made while playing the turns of the games
+    // that ended (see 'AllocationCounter').
+    unsigned long turn_allocations;
+    // Number of turns of the games that ended that made any memory allocation.
+    // Once every buffer has grown to its final size, turns shouldn't allocate.
+    unsigned long allocating_turns;
+    // The same counts for the game being played, only added to the ones
+    // above if it ends, so that they cover the same games as 'turns'.
+    unsigned long game_exchanges;
+    unsigned long game_skips;
+    unsigned long game_turn_allocations;
+    unsigned long game_allocating_turns;
+
+    // Returns the smallest score that at least 'fraction' of the games of
+    // the seat 'seat' didn't exceed, and at least one game reached.
+    unsigned int getScorePercentile(unsigned int seat, double fraction) const;
+    // Returns the smallest number of turns that at least 'fraction' of
+    // the games didn't exceed, and at least one game took.
+    unsigned int getTurnsPercentile(double fraction) const;
+
+    public:
+    // Constructs empty stats for games on 'board' with 'num_players'.
+    SimulationStats(const Board &board, unsigned int num_players);
+
+    // Records 'turn', played on 'board' as turn number 'turn_number' of
+    // a game (from 0).
+    void recordTurn(const Board &board, const Turn &turn, unsigned int turn_number);
+    // Records that a turn made 'allocations' memory allocations. Only
+    // reported if allocations are counted (see 'AllocationCounter').
+    void recordAllocations(unsigned long allocations);
+    // Records the end of a game, with 'players' as they ended it and
+    // 'num_turns' played.
+    void recordGame(const std::vector<Player> &players, unsigned int num_turns);
+    // Records a game stopped because it was too long. Only the letters
+    // its turns covered are kept.
+    void recordUnfinishedGame();
+    // Adds every statistic of 'other' (of the same 'Board' and number
+    // of players) to these.
+    void merge(const SimulationStats &other);
+
+    // Returns the number of games that ended.
+    unsigned long getGames() const;
+    // Prints a report of every statistic to 'out'.
+    void print(std::ostream &out) const;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "board.h"
+#include "turn.h"
+#include "simulationStats.h"
+#include "bot.h"
+#include "datasetWriter.h"
+
+// Plays many games between bots on a 'Board', without a console, to learn
+// whether the 'Board' is fair and how long its games are.
+//
+// Game 'i' is played with generators seeded from the seed and 'i' only,
+// so the results are the same whatever the number of threads (unless
+// the bots run out of time, which depends on the speed of the machine).
+// Threads take games in small chunks from a shared counter, so a thread
+// that finishes early takes work that would otherwise wait for the others.
+class Simulator {
+    // Number of games a thread takes at once.
+    static const unsigned long CHUNK_SIZE = 16;
+    // Number of turns after which a game is stopped.
+    static const unsigned int MAX_TURNS = 10000;
+
+    // The 'Board' of every game.
+    const Board &board;
+    // Number of players of every game.
+    unsigned int num_players;
+    // Name of the 'Bot' of each seat (see 'createBot').
+    std::vector<std::string> bot_names;
+    // The seed of every generator.
+    uint64_t seed;
+    // Time each 'Bot' has to decide, in milliseconds.
+    int time_budget_ms;
+    // Where the position at the start of every turn is exported. May be 'nullptr'.
+    DatasetWriter *exporter;
+
+    // Plays game 'game_index' between 'bots' (one per seat), with 'turns'
+    // as scratch space, recording it in 'stats'. If there is an 'exporter',
+    // its positions are encoded in 'records' and added to it.
+    void playGame(unsigned long game_index, std::vector<std::unique_ptr<Bot>> &bots, TurnList &turns,
+            SimulationStats &stats, std::vector<uint8_t> &records) const;
+
+    public:
+    // Constructs a simulator of games on 'board' between 'num_players' bots,
+    // named by 'bot_names' (one per seat, which must be valid names for
+    // 'createBot'), seeded with 'seed' and given 'time_budget_ms' to decide.
+    Simulator(const Board &board, unsigned int num_players, const std::vector<std::string> &bot_names,
+            uint64_t seed, int time_budget_ms);
+
+    // Sets where the position at the start of every turn of every game
+    // is exported, with the outcome of the game. Games stopped for being
+    // too long are not exported. May be 'nullptr'.
+    void setExporter(DatasetWriter *exporter);
+
+    // Plays 'num_games' games on 'num_threads' threads (0 for one per
+    // hardware thread) and returns what was learned from them.
+    SimulationStats run(unsigned long num_games, unsigned int num_threads) const;
+};
+
+#endif
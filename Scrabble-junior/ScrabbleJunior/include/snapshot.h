@@ -0,0 +1,129 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "gameState.h"
+
+// A saved game in the middle of being played, to resume it later.
+//
+// A snapshot is a fixed 'Header' (in the byte order of the machine that
+// wrote it, every field aligned to its size) followed by the state of
+// every letter of the 'Board' (one byte each, see 'Cell::getState'), the
+// name of the file of the 'Board' and the name of the file of the
+// 'Journal' of the game. Since nothing in it is a pointer and every field
+// has a fixed offset, the file can be used right where it is read (or
+// mapped) to memory. That's also why its fields aren't converted: a
+// snapshot written with another byte order is refused (see
+// 'Header::byte_order').
+class Snapshot {
+    public:
+    // Version of the format, increased whenever the layout changes.
+    static const uint16_t VERSION = 2;
+    // Value of 'Header::byte_order'.
+    static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    // The fixed part at the start of every snapshot.
+    struct Header {
+        // "SJS" followed by a zero byte.
+        char magic[4];
+        // 'VERSION' of the format it was written with.
+        uint16_t version;
+        // 'sizeof(Header)', to find what follows it.
+        uint16_t header_size;
+        // Size of the whole snapshot, in bytes.
+        uint32_t total_size;
+        // Number of letters of the 'Board' (bytes of cell states).
+        uint32_t num_cells;
+        // Hash of the contents of the file of the 'Board' (see 'Journal::hashFile').
+        uint64_t board_hash;
+        // 'GameState::getChecksum' of the saved state, to check it was restored exactly.
+        uint64_t checksum;
+        // State of the generator of the 'GameState'.
+        uint64_t rng_state[Rng::STATE_SIZE];
+        // How many of each letter the 'Pool' has.
+        uint32_t pool_count[26];
+        // Score of each player.
+        uint32_t scores[GameState::MAX_PLAYERS];
+        // Number of 'Action's in the 'Journal' of the game when it was
+        // saved. The 'Journal' may have more, if it was saved later.
+        uint32_t journal_actions;
+        // Slots of the 'Hand' of each player (see 'Hand::getSlot'), one byte unused.
+        char hands[GameState::MAX_PLAYERS][8];
+        // Name of the 'Bot' of each seat (see 'createBot'), or
+        // empty for people. Zero-terminated.
+        char seats[GameState::MAX_PLAYERS][16];
+        // Number of players of the game.
+        uint8_t num_players;
+        // Index of the current player.
+        uint8_t current_player;
+        // Number of moves the current player has left this turn.
+        uint8_t moves_left;
+        // Length of the name of the file of the 'Board'.
+        uint8_t board_name_size;
+        // Length of the name of the file of the 'Journal'.
+        uint8_t journal_name_size;
+        // Unused, always zero.
+        uint8_t reserved[3];
+        // 'BYTE_ORDER_MARK' in the byte order of the machine that wrote it.
+        uint32_t byte_order;
+    };
+
+    private:
+    // The bytes of the snapshot: the 'Header' and what follows it.
+    std::vector<uint64_t> data;
+
+    // Returns the 'Header' at the start of 'data'.
+    const Header& getHeader() const;
+    // Returns the bytes that follow the 'Header'.
+    const char* getBody() const;
+
+    public:
+    // Constructs an empty (invalid) snapshot.
+    Snapshot();
+
+    // Saves 'state', of a game on the 'Board' of file 'board_name' (whose
+    // contents hash to 'board_hash'), played by 'seats' (the name of the
+    // 'Bot' of each seat, or empty for people) and recorded in the file
+    // 'journal_name', which has 'journal_actions' so far. Names longer
+    // than 255 characters are cut.
+    static Snapshot capture(const GameState &state, const std::string &board_name, uint64_t board_hash,
+            const std::vector<std::string> &seats, const std::string &journal_name, size_t journal_actions);
+
+    // Writes 'size' bytes of 'data' to the file 'name', replacing it
+    // atomically: the file either keeps its old contents or has the new
+    // ones, even if the program stops while writing. Returns whether it
+    // was successful.
+    static bool writeFileAtomically(const std::string &name, const void *data, size_t size);
+
+    // Takes the snapshot in the 'size' bytes of 'bytes'. Returns whether
+    // they hold a valid snapshot of this 'VERSION'.
+    bool parse(const void *bytes, size_t size);
+    // Reads the snapshot saved in the file 'name'. Returns whether it
+    // exists and is valid.
+    bool load(const std::string &name);
+    // Saves this snapshot to the file 'name' (see 'writeFileAtomically').
+    bool save(const std::string &name) const;
+
+    // Returns the name of the file of the 'Board'.
+    std::string getBoardName() const;
+    // Returns the hash of the contents of the file of the 'Board'.
+    uint64_t getBoardHash() const;
+    // Returns the number of players of the game.
+    unsigned int getNumPlayers() const;
+    // Returns the name of the 'Bot' of each seat, or empty for people.
+    std::vector<std::string> getSeats() const;
+    // Returns the name of the file of the 'Journal' of the game.
+    std::string getJournalName() const;
+    // Returns the number of 'Action's in the 'Journal' when it was saved.
+    size_t getJournalActions() const;
+
+    // Restores the saved state to 'state', which must have been created
+    // with the same 'Board' and number of players. Returns whether the
+    // result is exactly the state that was saved.
+    bool restore(GameState &state) const;
+};
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <ostream>
+#include <cstdint>
+#include "board.h"
+#include "gameState.h"
+#include "turn.h"
+#include "bot.h"
+
+// A round-robin tournament between bots, to rate how strong they are.
+//
+// Every group of bots (one for each player count) meets on every 'Board'
+// in a number of rounds. In each round the group plays one game for each
+// rotation of its seats, and every game of the round draws from the
+// 'Pool' with the same seed (shared by every group in that round), so
+// luck of the draw mostly cancels out.
+//
+// Ratings are fitted to the results of every pair of bots in every game
+// (Bradley-Terry, on the Elo scale), so they don't depend on the order
+// games finished. Their confidence intervals come from resampling rounds.
+class Tournament {
+    // Number of turns after which a game is stopped.
+    static const unsigned int MAX_TURNS = 10000;
+    // Shares of a win, so that every tie splits it evenly in whole shares
+    // (it's divisible by any number of players).
+    static const unsigned int WIN_SHARES = 12;
+    // Number of resamples to estimate the confidence intervals.
+    static const int BOOTSTRAP_SAMPLES = 200;
+    // Rating of a bot that is as strong as the average.
+    static constexpr double BASE_RATING = 1500;
+
+    // Some bots meeting on a 'Board'.
+    struct Matchup {
+        // The 'Board' they play on.
+        const Board *board;
+        // Index of each bot in 'bot_names', in the seats of the first game.
+        std::vector<unsigned int> bots;
+    };
+
+    // What happened in the games of a 'Matchup' in one round. Indices are
+    // positions in 'Matchup::bots', not seats.
+    struct RoundResult {
+        // Number of games that ended.
+        unsigned int games;
+        // Number of games stopped because they were too long.
+        unsigned int unfinished_games;
+        // Points of each bot against each other: 2 for each game it ended
+        // with more points than the other, 1 for each tie.
+        unsigned int points[GameState::MAX_PLAYERS][GameState::MAX_PLAYERS];
+        // Shares of games won by each bot (see 'WIN_SHARES').
+        unsigned int win_shares[GameState::MAX_PLAYERS];
+    };
+
+    // Totals of the results between every pair of bots.
+    struct Totals {
+        // Points of each bot against each other (see 'RoundResult::points').
+        std::vector<std::vector<double>> points;
+        // Number of games each pair of bots played together.
+        std::vector<std::vector<double>> games;
+    };
+
+    // Name of each bot (see 'createBot').
+    std::vector<std::string> bot_names;
+    // Every 'Matchup' of the tournament.
+    std::vector<Matchup> matchups;
+    // The seed of every generator.
+    uint64_t seed;
+    // Time each 'Bot' has to decide, in milliseconds.
+    int time_budget_ms;
+
+    // Number of rounds played by each 'Matchup'.
+    unsigned long rounds;
+    // The result of round 'r' of matchup 'm', at 'm * rounds + r'.
+    std::vector<RoundResult> results;
+    // How long 'run' took, in seconds.
+    double elapsed_seconds;
+
+    // Plays round 'round' of 'matchup' with 'bots' (one for each name of
+    // 'bot_names') and 'turns' as scratch space.
+    RoundResult playRound(const Matchup &matchup, unsigned long round,
+            std::vector<std::unique_ptr<Bot>> &bots, TurnList &turns) const;
+    // Adds 'result' of 'matchup' to 'totals'.
+    static void addResult(const Matchup &matchup, const RoundResult &result, Totals &totals);
+    // Returns the rating of each bot that best explains 'totals'.
+    std::vector<double> fitRatings(const Totals &totals) const;
+
+    public:
+    // Constructs a tournament between the bots named by 'bot_names' (which
+    // must be valid names for 'createBot') on every board of 'boards', with
+    // every number of players of 'player_counts' the 'Board' and the
+    // number of bots allow. Bots are given 'time_budget_ms' to decide.
+    Tournament(const std::vector<const Board*> &boards, const std::vector<std::string> &bot_names,
+            const std::vector<unsigned int> &player_counts, uint64_t seed, int time_budget_ms);
+
+    // Returns the number of games in each round.
+    unsigned long countGamesPerRound() const;
+
+    // Plays 'rounds' rounds of every 'Matchup' on 'num_threads' threads
+    // (0 for one per hardware thread).
+    void run(unsigned long rounds, unsigned int num_threads);
+
+    // Prints the ratings, the results of each pair of bots and the speed.
+    void print(std::ostream &out) const;
+};
+
+#endif
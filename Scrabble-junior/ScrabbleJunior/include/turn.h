@@ -0,0 +1,133 @@
+#ifndef TURN_H
+#define TURN_H
+
+#include <ostream>
+#include <vector>
+#include "position.h"
+#include "action.h"
+
+// The kind of a 'Turn'.
+enum TurnType {
+    // Cover two 'Cell's.
+    TURN_MOVE_TWICE,
+    // Cover a single 'Cell', because no second move is possible
+    // (or because one move was already made this turn).
+    TURN_MOVE_ONCE,
+    // Exchange two letters with the pool.
+    TURN_EXCHANGE_TWO,
+    // Exchange one letter with the pool.
+    TURN_EXCHANGE_ONE,
+    // Don't do anything else: the turn is skipped, or it is over
+    // after a single move.
+    TURN_END,
+};
+
+// Represents everything the current player does until their turn ends,
+// as listed by 'GameState::getLegalTurns' and applied by 'GameState::applyTurn'.
+class Turn {
+    // Overload of the insertion operator.
+    // Inserts the 'Action's of this 'Turn', separated by commas.
+    friend std::ostream& operator<<(std::ostream &out, const Turn &turn);
+
+    // The kind of this 'Turn'.
+    TurnType type;
+    // The 'Position's covered by moves, in order.
+    Position first, second;
+    // The letters exchanged.
+    char letter1, letter2;
+
+    // Constructs a 'Turn' with all its fields.
+    Turn(TurnType type, Position first, Position second, char letter1, char letter2);
+
+    public:
+    // The most 'Action's a 'Turn' is made of (see 'getActions').
+    static const int MAX_ACTIONS = 2;
+
+    // Default constructor. Constructs a 'TURN_END'.
+    Turn();
+
+    // Returns a 'Turn' that covers 'first' and then 'second'.
+    static Turn moveTwice(Position first, Position second);
+    // Returns a 'Turn' that only covers 'position'.
+    static Turn moveOnce(Position position);
+    // Returns a 'Turn' that exchanges 'letter' with the pool.
+    static Turn exchange(char letter);
+    // Returns a 'Turn' that exchanges 'letter1' and 'letter2' with the pool.
+    static Turn exchange(char letter1, char letter2);
+    // Returns a 'Turn' that does nothing else.
+    static Turn end();
+
+    // Returns the kind of this 'Turn'.
+    TurnType getType() const;
+    // Returns how many 'Cell's this 'Turn' covers (0, 1 or 2).
+    int countMoves() const;
+    // Returns the first 'Position' covered.
+    Position getFirst() const;
+    // Returns the second 'Position' covered.
+    Position getSecond() const;
+    // Returns the first letter exchanged.
+    char getLetter1() const;
+    // Returns the second letter exchanged.
+    char getLetter2() const;
+
+    // Returns the first 'Action' of this 'Turn'. A 'Turn' of two moves
+    // is followed by the move to 'getSecond'; every other 'Turn' is over
+    // after this 'Action' (or after ending the turn, for a single move).
+    Action getFirstAction() const;
+    // Puts the 'Action's of this 'Turn' in 'actions', in order, and returns
+    // how many there are. A single move is followed by ending the turn,
+    // which isn't needed if that move ended the turn (or the game) by itself.
+    int getActions(Action actions[MAX_ACTIONS]) const;
+
+    // Overload of the equality operator.
+    bool operator==(const Turn &other) const;
+};
+
+std::ostream& operator<<(std::ostream &out, const Turn &turn);
+
+// A list of 'Turn's that keeps its memory when cleared, so listing turns
+// only allocates memory until the list has grown to the most needed.
+// Meant to be reused between calls.
+class TurnList {
+    // Only it uses 'first_moves'.
+    friend class GameState;
+
+    public:
+    // How many 'Turn's a 'TurnList' holds before it has to grow.
+    static const int RESERVED_TURNS = 4096;
+    // How many first moves 'first_moves' holds before it has to grow.
+    static const int RESERVED_FIRST_MOVES = 256;
+
+    private:
+    // The 'Turn's in the list.
+    std::vector<Turn> turns;
+    // Scratch space of 'GameState::getLegalTurns' for the 'Cell's that
+    // can be covered first, kept for the same reason as 'turns'.
+    std::vector<int> first_moves;
+
+    public:
+    // Alias for iterator type.
+    typedef std::vector<Turn>::const_iterator const_iterator;
+
+    // Constructs an empty list.
+    TurnList();
+
+    // Empties the list.
+    void clear();
+    // Adds 'turn' to the end of the list.
+    void push(const Turn &turn);
+
+    // Returns the number of 'Turn's in the list.
+    int size() const;
+    // Returns whether the list is empty.
+    bool isEmpty() const;
+    // Returns the 'Turn' at 'index'.
+    const Turn& operator[](int index) const;
+
+    // Returns iterator to the first 'Turn'.
+    const_iterator begin() const;
+    // Returns iterator past the last 'Turn'.
+    const_iterator end() const;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef VIEWPORT_H
+#define VIEWPORT_H
+
+#include "position.h"
+
+// The rectangle of a board that is shown on screen, which is only part
+// of it when the whole board doesn't fit in the console.
+//
+// Only the 'Cell's inside are drawn, so drawing costs the same for any
+// board. It scrolls to show a 'Position' when asked to.
+class Viewport {
+    // Size of the board.
+    int board_width;
+    int board_height;
+    // The first column and row shown.
+    int x;
+    int y;
+    // Number of columns and rows shown.
+    int width;
+    int height;
+
+    // Moves the first column and row shown as little as needed for the
+    // rectangle to be inside the board.
+    void clamp();
+
+    public:
+    // Constructs a viewport that shows the whole board, with given width and height.
+    Viewport(unsigned int board_width, unsigned int board_height);
+
+    // Returns the first column shown.
+    int getX() const;
+    // Returns the first row shown.
+    int getY() const;
+    // Returns the number of columns shown.
+    int getWidth() const;
+    // Returns the number of rows shown.
+    int getHeight() const;
+    // Returns whether some 'Cell's of the board aren't shown.
+    bool isPartial() const;
+    // Returns whether 'position' is shown.
+    bool contains(Position position) const;
+
+    // Shows at most 'width' columns and 'height' rows, keeping the same
+    // first column and row if possible. Returns whether anything changed.
+    bool resize(unsigned int width, unsigned int height);
+    // Scrolls so 'position' is in the middle, as far as the board allows.
+    void centerOn(Position position);
+    // Scrolls to 'position' (see 'centerOn') if it isn't shown.
+    void show(Position position);
+};
+
+#endif
@@ -1,26 +1,29 @@
 #ifndef WORD_H
 #define WORD_H
 
-#include <string>
+#include <string_view>
 #include "position.h"
 #include "orientation.h"
 
 // Represents a word placed in the board.
+//
+// The letters are not copied: they are viewed where they are stored
+// (for words found in a 'Board', in the 'Board' itself), so they must
+// outlive the word.
 class Word {
     // The 'Position' where the word starts.
-    const Position start;
+    Position start;
     // The 'Orientation' of the word.
-    const Orientation orientation;
-    // 'string' that contains the word itself.
-    const std::string word;
+    Orientation orientation;
+    // The letters of the word.
+    std::string_view word;
 
     public:
     // Alias for iterator type.
-    typedef std::string::const_iterator const_iterator;
+    typedef std::string_view::const_iterator const_iterator;
     
-    // Constructs a word with given 'Position', 'Orientation' and 'string'.
-    // The string passed is moved.
-    Word(Position start, Orientation orientation, std::string &word);
+    // Constructs a word with given 'Position', 'Orientation' and letters.
+    Word(Position start, Orientation orientation, std::string_view word);
 
     // Returns the 'Position' where the word starts.
     Position getStart() const;
@@ -33,4 +36,4 @@ class Word {
     const_iterator end() const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,64 @@
+#include "action.h"
+
+using namespace std;
+
+Action::Action(ActionType type, Position position, char letter1, char letter2):
+    type(type),
+    position(position),
+    letter1(letter1),
+    letter2(letter2)
+{}
+
+Action::Action(): Action(ACTION_END_TURN, Position(), 0, 0) {}
+
+Action Action::move(Position position) {
+    return Action(ACTION_MOVE, position, 0, 0);
+}
+
+Action Action::exchange(char letter) {
+    return Action(ACTION_EXCHANGE_ONE, Position(), letter, 0);
+}
+
+Action Action::exchange(char letter1, char letter2) {
+    return Action(ACTION_EXCHANGE_TWO, Position(), letter1, letter2);
+}
+
+Action Action::endTurn() {
+    return Action();
+}
+
+ActionType Action::getType() const {
+    return type;
+}
+
+Position Action::getPosition() const {
+    return position;
+}
+
+char Action::getLetter1() const {
+    return letter1;
+}
+
+char Action::getLetter2() const {
+    return letter2;
+}
+
+bool Action::operator==(const Action &other) const {
+    if(type != other.type) return false;
+
+    switch(type) {
+        case ACTION_MOVE: return position == other.position;
+        case ACTION_EXCHANGE_ONE: return letter1 == other.letter1;
+        case ACTION_EXCHANGE_TWO: return letter1 == other.letter1 && letter2 == other.letter2;
+        default: return true;
+    }
+}
+
+ostream& operator<<(ostream &out, const Action &action) {
+    switch(action.type) {
+        case ACTION_MOVE: return out << action.position;
+        case ACTION_EXCHANGE_ONE: return out << action.letter1;
+        case ACTION_EXCHANGE_TWO: return out << action.letter1 << ' ' << action.letter2;
+        default: return out << "-";
+    }
+}
@@ -0,0 +1,47 @@
+#include <new>
+#include <cstdlib>
+#include "allocationCounter.h"
+
+using namespace std;
+
+#ifdef SCRABBLE_COUNT_ALLOCATIONS
+
+// Allocations of each thread, so counting needs no synchronization.
+static thread_local uint64_t num_allocations = 0;
+
+// Every other form of 'new' (arrays, 'nothrow') ends up calling this one,
+// and every form of 'delete' the unsized or sized one below.
+void* operator new(size_t size) {
+    num_allocations++;
+    void *pointer = malloc(size == 0 ? 1 : size);
+    if(pointer == nullptr) throw bad_alloc();
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    free(pointer);
+}
+
+bool AllocationCounter::isEnabled() {
+    return true;
+}
+
+uint64_t AllocationCounter::count() {
+    return num_allocations;
+}
+
+#else
+
+bool AllocationCounter::isEnabled() {
+    return false;
+}
+
+uint64_t AllocationCounter::count() {
+    return 0;
+}
+
+#endif
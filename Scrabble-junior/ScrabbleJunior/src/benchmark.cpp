@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include "benchmark.h"
+#include "jsonObject.h"
+
+using namespace std;
+
+// Where 'Benchmark::keep' puts the values it is given.
+static volatile uint64_t sink;
+
+// Most calls a sample may make while finding how many make it long enough.
+static const unsigned long MAX_CALLS = 1ul << 30;
+
+void Benchmark::keep(uint64_t value) {
+    sink = sink + value;
+}
+
+Benchmark::Benchmark(unsigned int warmup, unsigned int repetitions, double min_sample_seconds):
+    warmup(warmup),
+    repetitions(max(1u, repetitions)),
+    min_sample_seconds(min_sample_seconds) {}
+
+double Benchmark::time(const Body &body, unsigned long calls) {
+    auto start = chrono::steady_clock::now();
+    body(calls);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+const Benchmark::Result& Benchmark::run(const string &name, unsigned long operations_per_call, const Body &body) {
+    // Grow the number of calls until a sample is long enough, aiming a bit
+    // above the shortest time so samples don't fall below it by noise.
+    unsigned long calls = 1;
+    double seconds = time(body, calls);
+    while(seconds < min_sample_seconds && calls < MAX_CALLS) {
+        double factor = seconds > 0 ? 1.2 * min_sample_seconds / seconds : 10;
+        calls = (unsigned long) min((double) MAX_CALLS, max(calls * 2.0, ceil(calls * min(factor, 100.0))));
+        seconds = time(body, calls);
+    }
+
+    for(unsigned int i = 0; i < warmup; i++) time(body, calls);
+
+    unsigned long operations = calls * operations_per_call;
+    vector<double> samples(repetitions);
+    for(double &sample: samples) sample = time(body, calls) * 1e9 / operations;
+    sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = name;
+    result.operations = operations;
+    result.samples = repetitions;
+    result.min = samples.front();
+    size_t middle = samples.size() / 2;
+    result.median = samples.size() % 2 == 1 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+    double sum = 0;
+    for(double sample: samples) sum += sample;
+    result.mean = sum / samples.size();
+    double squares = 0;
+    for(double sample: samples) squares += (sample - result.mean) * (sample - result.mean);
+    result.stddev = samples.size() > 1 ? sqrt(squares / (samples.size() - 1)) : 0;
+    // Nearest rank: the smallest sample with at least 90% of them at or below it.
+    result.p90 = samples[(size_t) ceil(0.9 * samples.size()) - 1];
+
+    results.push_back(result);
+    return results.back();
+}
+
+const vector<Benchmark::Result>& Benchmark::getResults() const {
+    return results;
+}
+
+// Writes 'nanoseconds' with a unit that keeps it short.
+static void printTime(ostream &out, double nanoseconds) {
+    out << fixed << setprecision(2);
+    if(nanoseconds < 1e3) out << setw(8) << nanoseconds << " ns";
+    else if(nanoseconds < 1e6) out << setw(8) << nanoseconds / 1e3 << " us";
+    else out << setw(8) << nanoseconds / 1e6 << " ms";
+}
+
+void Benchmark::printHeader(ostream &out) {
+    out << left << setw(44) << "Benchmark" << right << setw(11) << "median" << setw(11) << "min"
+            << setw(11) << "p90" << setw(9) << "stddev" << endl;
+}
+
+void Benchmark::print(ostream &out, const Result &result) {
+    out << left << setw(44) << result.name << right;
+    printTime(out, result.median);
+    printTime(out, result.min);
+    printTime(out, result.p90);
+    double relative = result.mean > 0 ? 100 * result.stddev / result.mean : 0;
+    out << setw(8) << setprecision(1) << relative << '%' << endl;
+}
+
+void Benchmark::writeJson(ostream &out) const {
+    out << fixed << setprecision(3);
+    for(const Result &result: results) {
+        out << "{\"name\": ";
+        JsonObject::writeString(out, result.name);
+        out << ", \"operations\": " << result.operations << ", \"samples\": " << result.samples
+                << ", \"min_ns\": " << result.min << ", \"median_ns\": " << result.median
+                << ", \"mean_ns\": " << result.mean << ", \"stddev_ns\": " << result.stddev
+                << ", \"p90_ns\": " << result.p90 << "}\n";
+    }
+}
+
+bool Benchmark::readJson(istream &in, vector<Result> &results, string &error) {
+    string line;
+    unsigned long line_number = 0;
+    while(getline(in, line)) {
+        line_number++;
+        if(line.find_first_not_of(" \t\r") == string::npos) continue;
+
+        JsonObject object;
+        string parse_error;
+        if(!object.parse(line, parse_error)) {
+            error = "Line " + to_string(line_number) + ": " + parse_error;
+            return false;
+        }
+
+        Result result;
+        long long operations, samples;
+        if(!object.getString("name", result.name) || !object.getInt("operations", operations)
+                || !object.getInt("samples", samples) || !object.getNumber("min_ns", result.min)
+                || !object.getNumber("median_ns", result.median) || !object.getNumber("mean_ns", result.mean)
+                || !object.getNumber("stddev_ns", result.stddev) || !object.getNumber("p90_ns", result.p90)) {
+            error = "Line " + to_string(line_number) + ": missing or invalid member.";
+            return false;
+        }
+        result.operations = (unsigned long) operations;
+        result.samples = (unsigned int) samples;
+        results.push_back(result);
+    }
+    return true;
+}
+
+unsigned int Benchmark::compare(const vector<Result> &baseline, double tolerance_percent, ostream &out) const {
+    map<string, const Result*> by_name;
+    for(const Result &result: baseline) by_name[result.name] = &result;
+
+    out << left << setw(44) << "Benchmark" << right << setw(11) << "baseline" << setw(11) << "median"
+            << setw(9) << "change" << endl;
+    unsigned int regressions = 0;
+    for(const Result &result: results) {
+        auto found = by_name.find(result.name);
+        out << left << setw(44) << result.name << right;
+        if(found == by_name.end()) {
+            out << setw(11) << "-";
+            printTime(out, result.median);
+            out << "   (new)" << endl;
+            continue;
+        }
+
+        double before = found->second->median;
+        double change = before > 0 ? 100 * (result.median - before) / before : 0;
+        printTime(out, before);
+        printTime(out, result.median);
+        out << setw(8) << showpos << setprecision(1) << change << '%' << noshowpos;
+        if(change > tolerance_percent) {
+            out << "  REGRESSION";
+            regressions++;
+        } else if(change < -tolerance_percent) {
+            out << "  faster";
+        }
+        out << endl;
+    }
+    return regressions;
+}
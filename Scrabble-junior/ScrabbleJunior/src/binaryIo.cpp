@@ -0,0 +1,13 @@
+#include "binaryIo.h"
+
+using namespace std;
+
+void writeInt(ostream &out, uint64_t value, int num_bytes) {
+    for(int i = 0; i < num_bytes; i++) out.put((char) ((value >> (8 * i)) & 0xFF));
+}
+
+uint64_t readInt(istream &in, int num_bytes) {
+    uint64_t value = 0;
+    for(int i = 0; i < num_bytes; i++) value |= (uint64_t) (unsigned char) in.get() << (8 * i);
+    return value;
+}
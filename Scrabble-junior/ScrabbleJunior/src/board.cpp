@@ -1,32 +1,205 @@
 #include <algorithm>
+#include <cassert>
 #include "board.h"
+#include "profiler.h"
 
 using namespace std;
 
+// The 'Cell' of every 'Position' without a letter.
+static const Cell EMPTY_CELL;
+
+BoardUndo::BoardUndo(): num_changes(0), completed(0) {}
+
+void BoardUndo::save(int letter, const Cell &cell) {
+    letters[num_changes] = letter;
+    cells[num_changes] = cell;
+    num_changes++;
+}
+
+Position BoardUndo::getPosition() const {
+    return position;
+}
+
+char BoardUndo::getLetter() const {
+    // The covered 'Cell' is always the first one saved.
+    return cells[0].getLetter();
+}
+
+int BoardUndo::countCompletedWords() const {
+    return (completed & 1) + ((completed >> 1) & 1);
+}
+
+bool BoardUndo::hasCompleted(Orientation orientation) const {
+    return (completed >> orientation) & 1;
+}
+
 Board::Board(unsigned int width, unsigned int height): 
   width(width), 
   height(height), 
-  grid(height, vector<Cell>(width)),
-  total_letters(0),
-  total_covered(0)
-{}
+  layout(make_shared<Layout>()),
+  total_covered(0),
+  coverable_mask(0)
+{
+    fill(begin(coverable_count), end(coverable_count), 0);
+    layout->table_bits = MIN_TABLE_BITS;
+    layout->table.assign((size_t) 1 << MIN_TABLE_BITS, Slot{FREE_KEY, NO_LETTER});
+}
+
+uint32_t Board::keyOf(Position position) {
+    // 'MAX_SIZE' is less than 2^16, so every 'Position' has its own key.
+    return (uint32_t) position.getY() << 16 | (uint32_t) position.getX();
+}
+
+size_t Board::slotOf(uint32_t key, int table_bits) {
+    // Multiplying by a large odd constant mixes the row and the column
+    // into the high bits, which are the ones kept.
+    return (size_t) ((key * 0x9E3779B1u) >> (32 - table_bits));
+}
+
+void Board::insertLetter(Layout &layout, Position position, int letter) {
+    uint32_t key = keyOf(position);
+    size_t mask = layout.table.size() - 1;
+    size_t slot = slotOf(key, layout.table_bits);
+    while(layout.table[slot].key != FREE_KEY) slot = (slot + 1) & mask;
+
+    layout.table[slot] = Slot{key, letter};
+}
+
+int Board::getLetterAt(Position position) const {
+    if(!position.inLimits(width, height)) return NO_LETTER;
+
+    uint32_t key = keyOf(position);
+    const vector<Slot> &table = layout->table;
+    size_t mask = table.size() - 1;
+    // The table is never full, so a free slot always ends the search.
+    for(size_t slot = slotOf(key, layout->table_bits); table[slot].key != FREE_KEY; slot = (slot + 1) & mask) {
+        if(table[slot].key == key) return table[slot].letter;
+    }
+    return NO_LETTER;
+}
+
+int Board::addLetter(Position position, char letter) {
+    // The table is kept at most half full, so searches stay short.
+    if((layout->letter_positions.size() + 1) * 2 > layout->table.size()) {
+        layout->table_bits++;
+        layout->table.assign((size_t) 1 << layout->table_bits, Slot{FREE_KEY, NO_LETTER});
+        for(size_t i = 0; i < layout->letter_positions.size(); i++) {
+            insertLetter(*layout, layout->letter_positions[i], (int) i);
+        }
+    }
+
+    int number = (int) cells.size();
+    cells.push_back(Cell(letter));
+    layout->letter_positions.push_back(position);
+    insertLetter(*layout, position, number);
+
+    // Link the new letter to the letters right before and after it.
+    LetterLinks links = {{NO_LETTER, NO_LETTER}, {-1, -1}};
+    for(Orientation orientation: {Vertical, Horizontal}) {
+        Position previous = position, next = position;
+        int previous_letter = getLetterAt(previous.stepBackwards(orientation));
+        if(previous_letter != NO_LETTER) layout->links[previous_letter].next[orientation] = number;
+        links.next[orientation] = getLetterAt(next.stepForward(orientation));
+    }
+    layout->links.push_back(links);
+
+    return number;
+}
+
+// Returns the index of 'letter' in 'Board::coverable_count'. 'loadWords'
+// only accepts words of letters from 'A' to 'Z'.
+static int letterIndex(char letter) {
+    assert(letter >= 'A' && letter <= 'Z');
+    return letter - 'A';
+}
+
+int Board::findUncovered(int letter, Orientation orientation) const {
+    // Letters are linked until an empty 'Cell', so the search always ends.
+    const vector<LetterLinks> &links = layout->links;
+    do {
+        letter = links[letter].next[orientation];
+    } while(letter != NO_LETTER && cells[letter].isCovered());
+    return letter;
+}
+
+void Board::allowMove(Cell &cell, Orientation orientation) {
+    // Only count the 'Cell' the first time it becomes coverable,
+    // since it may be unlocked by words in both orientations.
+    if(!cell.isCoverable()) {
+        char letter = cell.getLetter();
+        coverable_count[letterIndex(letter)] += 1;
+        coverable_mask |= Hand::letterBit(letter);
+    }
+
+    cell.allowMove(orientation);
+}
+
+void Board::setCellStates(const uint8_t *states) {
+    total_covered = 0;
+    coverable_mask = 0;
+    fill(begin(coverable_count), end(coverable_count), 0);
+
+    for(size_t i = 0; i < cells.size(); i++) {
+        Cell &cell = cells[i];
+        cell.setState(states[i]);
+
+        if(cell.isCovered()) total_covered += 1;
+        if(cell.isCoverable()) {
+            char letter = cell.getLetter();
+            coverable_count[letterIndex(letter)] += 1;
+            coverable_mask |= Hand::letterBit(letter);
+        }
+    }
+}
+
+unique_ptr<Board> Board::load(istream &file, string &error) {
+    unsigned int width, height;
+    file >> height;
+    if(file.fail() || height == 0 || height > MAX_SIZE) {
+        error = "Failed to parse height in given file.";
+        return nullptr;
+    }
+
+    char _x; // Ignored
+    file >> _x;
+
+    file >> width;
+    if(file.fail() || width == 0 || width > MAX_SIZE) {
+        error = "Failed to parse width in given file.";
+        return nullptr;
+    }
+
+    unique_ptr<Board> board(new Board(width, height));
+    board->loadWords(file);
+    return board;
+}
 
 void Board::loadWords(istream &save) {
-    char x, y, orientation_char;
-    string word_str;
+    string coordinates, word_str;
+    char orientation_char;
 
-    while(save >> y >> x >> orientation_char >> word_str) {
+    while(save >> coordinates >> orientation_char >> word_str) {
         // If can't parse position, stop loading.
-        if(x < 'a' || x > 'z' || y < 'A' || y > 'Z') break;
-        Position position(x, y);
+        Position position;
+        if(!Position::parse(coordinates, position)) break;
         
         Orientation orientation;
         if(orientation_char == 'H') orientation = Horizontal;
         else if(orientation_char == 'V') orientation = Vertical;
         else break; // If can't parse orientation, stop loading.
 
+        // Letters index arrays of every letter, so anything else can't be loaded.
+        bool valid_letters = true;
+        for(char letter: word_str) valid_letters &= letter >= 'A' && letter <= 'Z';
+        if(!valid_letters) break;
+
         Word word(position, orientation, word_str);
 
+        // A 'Word' that doesn't fit the 'Board' can't be valid.
+        Position end = position;
+        for(size_t i = 1; i < word_str.size(); i++) end.stepForward(orientation);
+        if(!end.inLimits(width, height)) break;
+
         // Word could be parsed so it is assumed to be valid.
         // It will always be valid if the stream comes from
         // a board file generated by 'BoardBuilder'.
@@ -36,23 +209,21 @@ void Board::loadWords(istream &save) {
 
 vector<char> Board::getLettersInBoard() const {
     vector<char> letters;
-    // Go through all 'Cell's in this 'Board' and
-    // fill the vector 'letters' with every letter
-    // found.
-    for(auto &row: grid) {
-        for(auto &cell: row) {
-            if(!cell.isEmpty()) letters.push_back(cell.getLetter());
-        }
-    }
+    letters.reserve(cells.size());
+    for(const Cell &cell: cells) letters.push_back(cell.getLetter());
     return letters;
 }
 
 unsigned int Board::countLetters() const {
-    return total_letters;
+    return (unsigned int) cells.size();
+}
+
+unsigned int Board::countWords() const {
+    return (unsigned int) layout->words.size();
 }
 
 bool Board::isFullyCovered() const {
-    return total_covered == total_letters;
+    return total_covered == cells.size();
 }
 
 unsigned int Board::getHeight() const {
@@ -64,130 +235,175 @@ unsigned int Board::getWidth() const {
 }
 
 const Cell& Board::getCell(Position position) const {
-    return grid[position.getY()][position.getX()];
+    int letter = getLetterAt(position);
+    if(letter == NO_LETTER) return EMPTY_CELL;
+    return cells[letter];
+}
+
+const vector<Position>& Board::getLetterPositions() const {
+    return layout->letter_positions;
+}
+
+const Cell& Board::getLetterCell(int letter) const {
+    return cells[letter];
 }
 
-void Board::addWord(Word &word) {
+void Board::addWord(const Word &word) {
+    // Copies that share the 'Layout' keep it as it was.
+    if(layout.use_count() > 1) layout = make_shared<Layout>(*layout);
+
     Position position = word.getStart();
     Orientation orientation = word.getOrientation();
+    int word_number = (int) layout->words.size();
+    WordSpan span = {position, orientation, (unsigned int) layout->word_letters.size(), 0};
+    int first_letter = NO_LETTER;
 
-    Cell &start_cell = grid[position.getY()][position.getX()];
-    // The first letter in a 'Word' already starts coverable.
-    start_cell.allowMove(orientation);
-
+    int number = NO_LETTER;
     for(char letter: word) {
-        Cell &cell = grid[position.getY()][position.getX()];
-        // Only increases letter count if letter didn't exist before.
-        if(cell.isEmpty()) total_letters += 1;
-        cell.setLetter(letter);
+        // The letter linked after the previous one is the one at 'position',
+        // so only the first letter needs the hash table.
+        number = number == NO_LETTER ? getLetterAt(position) : layout->links[number].next[orientation];
+        // Only adds a letter if it didn't exist before.
+        if(number == NO_LETTER) number = addLetter(position, letter);
+        else cells[number].setLetter(letter);
+        if(first_letter == NO_LETTER) first_letter = number;
+
+        layout->word_letters.push_back(letter);
+        layout->links[number].word_index[orientation] = word_number;
+        span.length++;
         position.stepForward(orientation);
     }
+    layout->words.push_back(span);
+
+    // The first letter in a 'Word' already starts coverable.
+    // This is only done after setting the letters because the
+    // coverable letters are counted by letter.
+    allowMove(cells[first_letter], orientation);
 }
 
 Word Board::findWord(Position position, Orientation orientation) const {
-    // Find the start of the word by stepping backwards
-    // until a letter is not found.
-    while(position.inLimits(width, height) && !getCell(position).isEmpty()) {
-        position.stepBackwards(orientation);
-    }
-
-    // 'Position' right now points to the place where a letter
-    // wasn't found. Must step forward to be at the start of the 'Word'.
-    position.stepForward(orientation);
-    Position start = position;
-
-    // Read 'Word' until the end to get its full string.
-    string word;
-    while(position.inLimits(width, height) && !getCell(position).isEmpty()) {
-        word.push_back(getCell(position).getLetter());
-        position.stepForward(orientation);
-    }
-
-    return Word(start, orientation, word);
+    const WordSpan &span = layout->words[layout->links[getLetterAt(position)].word_index[orientation]];
+    return Word(span.start, orientation, string_view(layout->word_letters).substr(span.offset, span.length));
 }
 
-void Board::cover(Position position, vector<Word> &completed_words) {
-    Cell &cell = grid[position.getY()][position.getX()];
+BoardUndo Board::makeMove(Position position) {
+    PROFILE_SCOPE("Board::makeMove");
+    BoardUndo undo;
+    undo.position = position;
+    int number = getLetterAt(position);
+    Cell &cell = cells[number];
+    undo.save(number, cell);
+
+    if(cell.isCoverable()) {
+        char letter = cell.getLetter();
+        // Last coverable 'Cell' with this letter clears its bit.
+        if(--coverable_count[letterIndex(letter)] == 0) coverable_mask &= ~Hand::letterBit(letter);
+    }
 
     cell.cover();
     total_covered += 1;
 
     // Unlock (make coverable) the next 'Cell' horizontally, if applicable
     if(cell.propagatesHorizontally()) {
-        if(!propagate(position, Horizontal)) {
+        if(!propagate(number, Horizontal, undo)) {
             // If propagation didn't happen although 'Cell'
             // 'propagatesHorizontally', it's because the end
             // of the 'Word' was reached.
-            completed_words.push_back(findWord(position, Horizontal));
+            undo.completed |= 1 << Horizontal;
         }
     }
 
     // Unlock (make coverable) the next 'Cell' vertically, if applicable
     if(cell.propagatesVertically()) {
-        if(!propagate(position, Vertical)) {
+        if(!propagate(number, Vertical, undo)) {
             // If propagation didn't happen although 'Cell'
             // 'propagatesVertically', it's because the end
             // of the 'Word' was reached.
-            completed_words.push_back(findWord(position, Vertical));
+            undo.completed |= 1 << Vertical;
         }
     }
+
+    return undo;
 }
 
-bool Board::propagate(Position position, Orientation orientation) {
-    Cell *cell;
-    // First, try to find a 'Cell' ahead of 'position' that
-    // is not yet covered.
-    do {
-        position.stepForward(orientation);
-        // Out of limits means such 'Cell' couldn't be found.
-        if(!position.inLimits(width, height)) return false;
-        cell = &grid[position.getY()][position.getX()];
-    } while(cell->isCovered());
-
-    // Cell was found. If it is not empty, it should be made
-    // coverable.
-    if(!cell->isEmpty()) {
-        cell->allowMove(orientation);
+void Board::unmakeMove(const BoardUndo &undo) {
+    // Restore 'Cell's in the reverse order they were changed,
+    // keeping the coverable letters up to date.
+    for(int i = undo.num_changes - 1; i >= 0; i--) {
+        Cell &cell = cells[undo.letters[i]];
+        const Cell &previous = undo.cells[i];
+        char letter = cell.getLetter();
+
+        if(cell.isCoverable() && !previous.isCoverable()) {
+            if(--coverable_count[letterIndex(letter)] == 0) coverable_mask &= ~Hand::letterBit(letter);
+        } else if(!cell.isCoverable() && previous.isCoverable()) {
+            coverable_count[letterIndex(letter)] += 1;
+            coverable_mask |= Hand::letterBit(letter);
+        }
+
+        cell = previous;
     }
 
-    return !cell->isEmpty();
+    total_covered -= 1;
 }
 
-const Cell* Board::getNextUncoveredCell(Position position, Orientation orientation) const {
-    const Cell *cell;
-    // First, try to find a 'Cell' ahead of 'position' that
-    // is not yet covered.
-    // This algorithm is very similar to the one found in
-    // 'propagate', but notice in this case it happens in
-    // a 'const' context: the 'Cell' won't be modified.
-    do {
-        position.stepForward(orientation);
-        // Out of limits means such 'Cell' couldn't be found.
-        if(!position.inLimits(width, height)) return nullptr;
-        cell = &getCell(position);
-    } while(cell->isCovered());
+bool Board::propagate(int letter, Orientation orientation, BoardUndo &undo) {
+    // First, find the letter ahead that is not yet covered. If there
+    // is one, it is the next letter of the 'Word' and it should be
+    // made coverable.
+    int next = findUncovered(letter, orientation);
+    if(next == NO_LETTER) return false;
 
-    // Cell only belongs to the 'Word' if it is non-empty.
-    if(cell->isEmpty()) {
-        return nullptr;
-    }
+    undo.save(next, cells[next]);
+    allowMove(cells[next], orientation);
+    return true;
+}
 
-    return cell;
+const Cell* Board::getNextUncoveredCell(int letter, Orientation orientation) const {
+    int next = findUncovered(letter, orientation);
+    if(next == NO_LETTER) return nullptr;
+    return &cells[next];
 }
 
-bool Board::hasMove(const Hand &hand) const {
-    for(auto &row: grid) {
-        for(auto &cell: row) {
-            char letter = cell.getLetter();
-            if(cell.isCoverable() && hand.hasLetter(letter)) return true;
+int Board::getUnlockedBy(Position position, Position unlocked[2]) const {
+    int letter = getLetterAt(position);
+    const Cell &cell = cells[letter];
+    int count = 0;
+
+    if(cell.propagatesHorizontally()) {
+        int next = findUncovered(letter, Horizontal);
+        if(next != NO_LETTER && !cells[next].isCoverable()) {
+            unlocked[count++] = layout->letter_positions[next];
         }
     }
 
-    // No cell can currently be covered with 'hand'.
-    return false;
+    if(cell.propagatesVertically()) {
+        int next = findUncovered(letter, Vertical);
+        if(next != NO_LETTER && !cells[next].isCoverable()) {
+            unlocked[count++] = layout->letter_positions[next];
+        }
+    }
+
+    return count;
 }
 
-bool Board::mustPlayTwiceEdgeCase(const Hand &hand, vector<Position> &legal_positions) {
+bool Board::hasMove(const Hand &hand) const {
+    // A move exists if some coverable 'Cell' has a letter in 'hand'.
+    // Too quick to be timed, so it is only counted.
+    PROFILE_COUNT("Board::hasMove", 1);
+    return (coverable_mask & hand.getLetterMask()) != 0;
+}
+
+uint32_t Board::getCoverableMask() const {
+    return coverable_mask;
+}
+
+unsigned int Board::countCoverable(char letter) const {
+    return coverable_count[letterIndex(letter)];
+}
+
+bool Board::mustPlayTwiceEdgeCase(const Hand &hand, vector<Position> &legal_positions) const {
+    PROFILE_SCOPE("Board::mustPlayTwiceEdgeCase");
     // This edge case happens when:
     // 1- All possible moves are with the same letter
     // 2- Player has just one such letter in hand
@@ -198,54 +414,59 @@ bool Board::mustPlayTwiceEdgeCase(const Hand &hand, vector<Position> &legal_posi
     // a cell in the next move: rules say that players must always move
     // twice per turn whenever possible.
 
+    // Conditions '1' and '2' can be checked without going through
+    // the 'Board': the letters that can be played must be a single
+    // letter, of which 'hand' has only one.
+    uint32_t playable_mask = coverable_mask & hand.getLetterMask();
+    bool single_letter = playable_mask != 0 && (playable_mask & (playable_mask - 1)) == 0;
+    if(!single_letter) return false;
+
     char letter = 0; // in this context, 0 means 'unknown' 
-    for(unsigned int j = 0; j < height; j++) {
-        for(unsigned int i = 0; i < width; i++) {
-            Cell &cell = grid[j][i];
+    for(int i = 0; i < (int) cells.size(); i++) {
+        const Cell &cell = cells[i];
 
-            if(!cell.isCoverable() || !hand.hasLetter(cell.getLetter())) {
-                // Skip cells that aren't possible moves anyway.
-                continue;
-            }
+        if(!cell.isCoverable() || !hand.hasLetter(cell.getLetter())) {
+            // Skip cells that aren't possible moves anyway.
+            continue;
+        }
 
-            if(!letter) { // If letter was still 'unknown'
-                letter = cell.getLetter();
-                // Check condition '2'
-                if(hand.countLetter(letter) >= 2) return false;
-            } else if(letter != cell.getLetter()) { // Check condition '1'
-                return false; 
-            }
+        if(!letter) { // If letter was still 'unknown'
+            letter = cell.getLetter();
+            // Check condition '2'
+            if(hand.countLetter(letter) >= 2) return false;
+        } else if(letter != cell.getLetter()) { // Check condition '1'
+            return false; 
+        }
 
-            // Check condition '3'
-            Position position((int) i, (int) j);
-
-            if(cell.propagatesHorizontally()) {
-                // See if 'cell' would uncover another that 'hand'
-                // can cover in the second move.
-                const Cell *next_cell = getNextUncoveredCell(position, Horizontal);
-                if(next_cell) {
-                    char next_letter = next_cell->getLetter();
-
-                    if(next_letter != letter && hand.hasLetter(next_letter)) {
-                        // Yes, it would, so this is a legal position
-                        // in this edge case.
-                        legal_positions.push_back(position);
-                    }
+        // Check condition '3'
+        Position position = layout->letter_positions[i];
+
+        if(cell.propagatesHorizontally()) {
+            // See if 'cell' would uncover another that 'hand'
+            // can cover in the second move.
+            const Cell *next_cell = getNextUncoveredCell(i, Horizontal);
+            if(next_cell) {
+                char next_letter = next_cell->getLetter();
+
+                if(next_letter != letter && hand.hasLetter(next_letter)) {
+                    // Yes, it would, so this is a legal position
+                    // in this edge case.
+                    legal_positions.push_back(position);
                 }
             }
+        }
 
-            if(cell.propagatesVertically()) {
-                // See if 'cell' would uncover another that 'hand'
-                // can cover in the second move.
-                const Cell *next_cell = getNextUncoveredCell(position, Vertical);
-                if(next_cell) {
-                    char next_letter = next_cell->getLetter();
-
-                    if(next_letter != letter && hand.hasLetter(next_letter)) {
-                        // Yes, it would, so this is a legal position
-                        // in this edge case.
-                        legal_positions.push_back(position);
-                    }
+        if(cell.propagatesVertically()) {
+            // See if 'cell' would uncover another that 'hand'
+            // can cover in the second move.
+            const Cell *next_cell = getNextUncoveredCell(i, Vertical);
+            if(next_cell) {
+                char next_letter = next_cell->getLetter();
+
+                if(next_letter != letter && hand.hasLetter(next_letter)) {
+                    // Yes, it would, so this is a legal position
+                    // in this edge case.
+                    legal_positions.push_back(position);
                 }
             }
         }
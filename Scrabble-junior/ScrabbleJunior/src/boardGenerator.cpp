@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cctype>
+#include "boardGenerator.h"
+
+using namespace std;
+
+const vector<string>& BoardGenerator::getDefaultDictionary() {
+    static const vector<string> words = {
+        "AT", "BE", "GO", "HE", "IN", "IS", "IT", "ME", "NO", "ON", "TO", "UP", "WE",
+        "ANT", "BAT", "BED", "BUS", "CAR", "CAT", "COW", "DOG", "EGG", "FAN", "FOX",
+        "HAT", "HEN", "JAM", "KEY", "LEG", "MAP", "NET", "OWL", "PEN", "PIG", "RAT",
+        "SUN", "TOY", "VAN", "WEB", "ZOO", "BALL", "BIRD", "BOAT", "CAKE", "DUCK",
+        "FISH", "FROG", "GAME", "HAND", "KITE", "LAMP", "LION", "MILK", "MOON", "NEST",
+        "PARK", "QUIZ", "RAIN", "ROSE", "SHIP", "SOCK", "STAR", "TREE", "WIND", "WOLF",
+        "APPLE", "BEACH", "BREAD", "CHAIR", "CLOCK", "CLOUD", "DANCE", "EARTH", "FRUIT",
+        "GRAPE", "HORSE", "HOUSE", "JUICE", "LEMON", "MOUSE", "MUSIC", "OCEAN", "PIANO",
+        "PLANT", "QUEEN", "RIVER", "ROBOT", "SNAKE", "TABLE", "TIGER", "TRAIN", "WATER",
+        "ZEBRA", "ANIMAL", "BASKET", "CASTLE", "DRAGON", "FLOWER", "FOREST", "GARDEN",
+        "JUNGLE", "KITTEN", "MONKEY", "ORANGE", "PENCIL", "PLANET", "RABBIT", "SCHOOL",
+        "SPIDER", "TURTLE", "WINDOW", "BALLOON", "BICYCLE", "CHICKEN", "DOLPHIN",
+        "ELEPHANT", "DINOSAUR", "MOUNTAIN", "SANDWICH", "BUTTERFLY", "CROCODILE",
+        "STRAWBERRY", "WATERMELON",
+    };
+    return words;
+}
+
+vector<string> BoardGenerator::readDictionary(istream &in) {
+    vector<string> words;
+    string line;
+    while(getline(in, line)) {
+        // Lines may end with '\r' if the file comes from Windows.
+        while(!line.empty() && isspace((unsigned char) line.back())) line.pop_back();
+        if(line.size() < 2 || line.size() > 26) continue;
+
+        bool valid = true;
+        for(char &c: line) {
+            if(!isalpha((unsigned char) c)) {
+                valid = false;
+                break;
+            }
+            c = (char) toupper((unsigned char) c);
+        }
+        if(valid) words.push_back(line);
+    }
+    return words;
+}
+
+BoardGenerator::BoardGenerator(const vector<string> &dictionary, Rng rng):
+    dictionary(dictionary),
+    rng(rng),
+    width(0),
+    height(0) {}
+
+void BoardGenerator::setRng(Rng rng) {
+    this->rng = rng;
+}
+
+uint64_t BoardGenerator::keyOf(Position position) {
+    return (uint64_t) position.getY() << 32 | (uint32_t) position.getX();
+}
+
+char BoardGenerator::letterAt(Position position) const {
+    if(!position.inLimits(width, height)) return ' ';
+    auto found = cells.find(keyOf(position));
+    return found == cells.end() ? ' ' : found->second;
+}
+
+bool BoardGenerator::canPlace(Position start, Orientation orientation, const string &letters,
+        unsigned int &new_letters) const
+{
+    if(!start.inLimits(width, height)) return false;
+
+    // Nothing may touch the word right before it starts or after it ends.
+    Position position = start;
+    if(letterAt(position.stepBackwards(orientation)) != ' ') return false;
+
+    new_letters = 0;
+    bool crossed_previous = false;
+    for(char letter: letters) {
+        position.stepForward(orientation);
+        if(!position.inLimits(width, height)) return false;
+
+        char current = letterAt(position);
+        if(current == ' ') {
+            // A new letter doesn't cross any word, so nothing may touch it from the sides.
+            pair<Position, Position> laterals = position.laterals(orientation);
+            if(letterAt(laterals.first) != ' ' || letterAt(laterals.second) != ' ') return false;
+            new_letters++;
+            crossed_previous = false;
+        } else {
+            // Two letters in a row that are already there belong to a word with the
+            // same 'Orientation', which this one would extend instead of crossing.
+            if(current != letter || crossed_previous) return false;
+            crossed_previous = true;
+        }
+    }
+
+    if(letterAt(position.stepForward(orientation)) != ' ') return false;
+    // A word that is already there would only be placed again.
+    return new_letters > 0;
+}
+
+unsigned int BoardGenerator::place(Position start, Orientation orientation, const string &letters) {
+    unsigned int new_letters = 0;
+    Position position = start;
+    for(char letter: letters) {
+        if(cells.emplace(keyOf(position), letter).second) new_letters++;
+        position.stepForward(orientation);
+    }
+    placed.push_back({start, orientation, letters});
+    return new_letters;
+}
+
+const vector<BoardGenerator::PlacedWord>& BoardGenerator::generate(unsigned int width, unsigned int height,
+        double density)
+{
+    this->width = width;
+    this->height = height;
+    cells.clear();
+    placed.clear();
+
+    uint64_t num_cells = (uint64_t) width * height;
+    unsigned int target = (unsigned int) (density * (double) num_cells);
+    unsigned int num_letters = 0;
+    unsigned int new_letters;
+
+    for(uint64_t attempt = 0; attempt < ATTEMPTS_PER_CELL * num_cells && num_letters < target; attempt++) {
+        const string &letters = dictionary[rng.below((uint32_t) dictionary.size())];
+        if(letters.size() > max(width, height)) continue;
+        Orientation orientation = rng.below(2) == 0 ? Horizontal : Vertical;
+
+        Position start;
+        if(!placed.empty() && rng.below(2) == 0) {
+            // Cross a random letter already placed, on one of the same letters of the word.
+            const PlacedWord &other = placed[rng.below((uint32_t) placed.size())];
+            unsigned int crossed = rng.below((uint32_t) other.letters.size());
+            size_t index = letters.find(other.letters[crossed]);
+            if(index == string::npos) continue;
+
+            int x = other.start.getX(), y = other.start.getY();
+            if(other.orientation == Horizontal) x += (int) crossed;
+            else y += (int) crossed;
+            if(orientation == Horizontal) x -= (int) index;
+            else y -= (int) index;
+            start = Position(x, y);
+        } else {
+            unsigned int max_x = width, max_y = height;
+            if(orientation == Horizontal) max_x -= (unsigned int) letters.size() - 1;
+            else max_y -= (unsigned int) letters.size() - 1;
+            if(max_x == 0 || max_y == 0) continue;
+            start = Position((int) rng.below(max_x), (int) rng.below(max_y));
+        }
+
+        if(canPlace(start, orientation, letters, new_letters)) {
+            num_letters += place(start, orientation, letters);
+        }
+    }
+
+    return placed;
+}
+
+unsigned int BoardGenerator::countLetters() const {
+    return (unsigned int) cells.size();
+}
+
+void BoardGenerator::write(ostream &out) const {
+    // Height comes first, like in every board file.
+    out << height << " x " << width << '\n';
+    writeWords(out);
+}
+
+void BoardGenerator::writeWords(ostream &out) const {
+    for(const PlacedWord &word: placed) {
+        out << word.start << ' ' << (word.orientation == Horizontal ? 'H' : 'V') << ' ' << word.letters << '\n';
+    }
+}
@@ -0,0 +1,47 @@
+#include "bot.h"
+#include "randomBot.h"
+#include "greedyBot.h"
+#include "lookaheadBot.h"
+#include "ismctsBot.h"
+
+using namespace std;
+
+// How many turns 'createBot' lets a 'LookaheadBot' look ahead.
+const int LOOKAHEAD_MAX_DEPTH = 3;
+
+Bot::Bot(bool solves_endgame, int time_budget_ms):
+    time_budget(time_budget_ms),
+    solves_endgame(solves_endgame)
+{}
+
+chrono::steady_clock::time_point Bot::getDeadline() const {
+    return deadline;
+}
+
+Turn Bot::chooseTurn(GameState &state, const TurnList &turns) {
+    auto start = chrono::steady_clock::now();
+    deadline = start + time_budget;
+    if(solves_endgame && turns.size() > 1 && EndgameSolver::canSolve(state)) {
+        if(!solver) solver.reset(new EndgameSolver());
+
+        // If the endgame is too big to solve in half of the budget, the
+        // strategy decides in the rest.
+        Turn best_turn;
+        if(solver->solve(state, best_turn, final_scores, start + time_budget / 2)) return best_turn;
+    }
+
+    return decideTurn(state, turns);
+}
+
+const vector<string>& getBotNames() {
+    static const vector<string> names = {"random", "greedy", "lookahead", "ismcts"};
+    return names;
+}
+
+unique_ptr<Bot> createBot(const string &name, Rng rng, int time_budget_ms, unsigned int search_threads) {
+    if(name == "random") return unique_ptr<Bot>(new RandomBot(rng));
+    if(name == "greedy") return unique_ptr<Bot>(new GreedyBot(rng, time_budget_ms));
+    if(name == "lookahead") return unique_ptr<Bot>(new LookaheadBot(rng, LOOKAHEAD_MAX_DEPTH, time_budget_ms));
+    if(name == "ismcts") return unique_ptr<Bot>(new IsmctsBot(rng, time_budget_ms, search_threads));
+    return nullptr;
+}
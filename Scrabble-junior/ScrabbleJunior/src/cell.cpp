@@ -46,6 +46,20 @@ bool Cell::isCoverable() const {
     return coverable;
 }
 
+uint8_t Cell::getState() const {
+    return (covered ? STATE_COVERED : 0)
+            | (coverable ? STATE_COVERABLE : 0)
+            | (propagates_horizontally ? STATE_PROPAGATES_HORIZONTALLY : 0)
+            | (propagates_vertically ? STATE_PROPAGATES_VERTICALLY : 0);
+}
+
+void Cell::setState(uint8_t state) {
+    covered = (state & STATE_COVERED) != 0;
+    coverable = (state & STATE_COVERABLE) != 0;
+    propagates_horizontally = (state & STATE_PROPAGATES_HORIZONTALLY) != 0;
+    propagates_vertically = (state & STATE_PROPAGATES_VERTICALLY) != 0;
+}
+
 bool Cell::isEmpty() const {
     return letter == EMPTY;
 }
@@ -0,0 +1,67 @@
+#include "chunkCodec.h"
+
+using namespace std;
+
+// Appends 'value' to 'out' as a variable-length integer.
+static void writeVarint(vector<uint8_t> &out, size_t value) {
+    while(value >= 0x80) {
+        out.push_back((uint8_t) (value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t) value);
+}
+
+// Reads a variable-length integer from 'data' at 'offset' (moving it past
+// it), without reading beyond 'size'. Returns false if it doesn't fit.
+static bool readVarint(const uint8_t *data, size_t size, size_t &offset, size_t &value) {
+    value = 0;
+    for(int shift = 0; shift < 64; shift += 7) {
+        if(offset >= size) return false;
+        uint8_t byte = data[offset++];
+        value |= (size_t) (byte & 0x7F) << shift;
+        if(!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+void ChunkCodec::compress(const uint8_t *records, size_t size, size_t record_size, vector<uint8_t> &out) {
+    // The byte of the delta at 'i': the record XOR the one before it.
+    auto delta = [&](size_t i) -> uint8_t {
+        return i < record_size ? records[i] : records[i] ^ records[i - record_size];
+    };
+
+    size_t i = 0;
+    while(i < size) {
+        size_t zeros_start = i;
+        while(i < size && delta(i) == 0) i++;
+        size_t zeros = i - zeros_start;
+
+        // Literals continue until the next run of at least two zeros,
+        // since a single zero costs less as a literal.
+        size_t literals_start = i;
+        while(i < size && !(delta(i) == 0 && (i + 1 == size || delta(i + 1) == 0))) i++;
+
+        writeVarint(out, zeros);
+        writeVarint(out, i - literals_start);
+        for(size_t j = literals_start; j < i; j++) out.push_back(delta(j));
+    }
+}
+
+bool ChunkCodec::decompress(const uint8_t *compressed, size_t compressed_size, uint8_t *records, size_t size,
+        size_t record_size)
+{
+    size_t offset = 0, i = 0;
+    while(i < size) {
+        size_t zeros, literals;
+        if(!readVarint(compressed, compressed_size, offset, zeros)) return false;
+        if(!readVarint(compressed, compressed_size, offset, literals)) return false;
+        if(zeros > size - i || literals > size - i - zeros || literals > compressed_size - offset) return false;
+
+        for(size_t end = i + zeros; i < end; i++) records[i] = i < record_size ? 0 : records[i - record_size];
+        for(size_t end = i + literals; i < end; i++) {
+            uint8_t byte = compressed[offset++];
+            records[i] = i < record_size ? byte : byte ^ records[i - record_size];
+        }
+    }
+    return offset == compressed_size;
+}
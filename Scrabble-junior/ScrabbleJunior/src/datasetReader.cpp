@@ -0,0 +1,86 @@
+#include <cstring>
+#include "datasetReader.h"
+#include "chunkCodec.h"
+#include "binaryIo.h"
+
+using namespace std;
+
+// Size of the end of a dataset file: the index offset, the number of
+// chunks and of records, and "SJDE".
+static const int FOOTER_SIZE = 8 + 8 + 8 + 4;
+
+DatasetReader::DatasetReader(): records_per_chunk(0), num_records(0), loaded_chunk(-1) {}
+
+bool DatasetReader::open(const string &name) {
+    file.open(name, ios::binary);
+    if(!file.is_open()) return false;
+
+    char magic[4];
+    if(!file.read(magic, 4) || memcmp(magic, "SJD\1", 4) != 0) return false;
+    encoder.reset(new PositionEncoder(file));
+    size_t record_size = (size_t) readInt(file, 4);
+    records_per_chunk = (size_t) readInt(file, 4);
+    if(!file || !encoder->isValid() || record_size != encoder->getRecordSize() || records_per_chunk == 0) {
+        return false;
+    }
+
+    file.seekg(-FOOTER_SIZE, ios::end);
+    uint64_t index_offset = readInt(file, 8);
+    uint64_t num_chunks = readInt(file, 8);
+    num_records = readInt(file, 8);
+    if(!file.read(magic, 4) || memcmp(magic, "SJDE", 4) != 0) return false;
+    if(num_chunks != (num_records + records_per_chunk - 1) / records_per_chunk) return false;
+
+    file.seekg((streamoff) index_offset);
+    chunks.resize((size_t) num_chunks);
+    for(DatasetChunk &info: chunks) {
+        info.offset = readInt(file, 8);
+        info.compressed_size = (uint32_t) readInt(file, 4);
+        info.num_records = (uint32_t) readInt(file, 4);
+    }
+    loaded_chunk = -1;
+    return file.good();
+}
+
+const PositionEncoder& DatasetReader::getEncoder() const {
+    return *encoder;
+}
+
+uint64_t DatasetReader::countRecords() const {
+    return num_records;
+}
+
+size_t DatasetReader::countChunks() const {
+    return chunks.size();
+}
+
+bool DatasetReader::loadChunk(size_t index) {
+    const DatasetChunk &info = chunks[index];
+    size_t record_size = encoder->getRecordSize();
+
+    compressed.resize(info.compressed_size);
+    file.clear();
+    file.seekg((streamoff) info.offset);
+    if(!file.read(reinterpret_cast<char*>(compressed.data()), (streamsize) compressed.size())) return false;
+
+    chunk.resize(info.num_records * record_size);
+    if(!ChunkCodec::decompress(compressed.data(), compressed.size(), chunk.data(), chunk.size(), record_size)) {
+        loaded_chunk = -1;
+        return false;
+    }
+    loaded_chunk = (long) index;
+    return true;
+}
+
+bool DatasetReader::read(uint64_t index, uint8_t *record) {
+    if(index >= num_records) return false;
+
+    size_t chunk_index = (size_t) (index / records_per_chunk);
+    if(loaded_chunk != (long) chunk_index && !loadChunk(chunk_index)) return false;
+
+    size_t record_size = encoder->getRecordSize();
+    size_t offset = (size_t) (index % records_per_chunk) * record_size;
+    if(offset + record_size > chunk.size()) return false;
+    memcpy(record, chunk.data() + offset, record_size);
+    return true;
+}
@@ -0,0 +1,99 @@
+#include "datasetWriter.h"
+#include "chunkCodec.h"
+#include "binaryIo.h"
+
+using namespace std;
+
+DatasetWriter::DatasetWriter(const PositionEncoder &encoder, size_t records_per_chunk):
+    encoder(encoder),
+    records_per_chunk(records_per_chunk),
+    next_game(0),
+    num_records(0) {}
+
+bool DatasetWriter::open(const string &name) {
+    file.open(name, ios::binary | ios::trunc);
+    if(!file.is_open()) return false;
+
+    file.write("SJD\1", 4);
+    encoder.save(file);
+    writeInt(file, encoder.getRecordSize(), 4);
+    writeInt(file, records_per_chunk, 4);
+    chunk.reserve(records_per_chunk * encoder.getRecordSize());
+    return file.good();
+}
+
+void DatasetWriter::appendRecords(const vector<uint8_t> &records) {
+    size_t record_size = encoder.getRecordSize();
+    size_t chunk_size = records_per_chunk * record_size;
+
+    for(size_t offset = 0; offset < records.size(); ) {
+        size_t size = min(records.size() - offset, chunk_size - chunk.size());
+        chunk.insert(chunk.end(), records.begin() + offset, records.begin() + offset + size);
+        offset += size;
+        if(chunk.size() == chunk_size) writeChunk();
+    }
+    num_records += records.size() / record_size;
+}
+
+void DatasetWriter::writeChunk() {
+    if(chunk.empty()) return;
+
+    compressed.clear();
+    ChunkCodec::compress(chunk.data(), chunk.size(), encoder.getRecordSize(), compressed);
+
+    DatasetChunk info;
+    info.offset = (uint64_t) file.tellp();
+    info.compressed_size = (uint32_t) compressed.size();
+    info.num_records = (uint32_t) (chunk.size() / encoder.getRecordSize());
+    chunks.push_back(info);
+
+    file.write(reinterpret_cast<const char*>(compressed.data()), (streamsize) compressed.size());
+    chunk.clear();
+}
+
+void DatasetWriter::addGame(unsigned long game_index, vector<uint8_t> &records) {
+    lock_guard<std::mutex> lock(mutex);
+
+    if(game_index != next_game) {
+        pending_games[game_index].swap(records);
+        return;
+    }
+
+    appendRecords(records);
+    next_game++;
+
+    // The games waiting for this one can be written now.
+    for(auto pending = pending_games.begin(); pending != pending_games.end() && pending->first == next_game; ) {
+        appendRecords(pending->second);
+        next_game++;
+        pending = pending_games.erase(pending);
+    }
+}
+
+bool DatasetWriter::close() {
+    lock_guard<std::mutex> lock(mutex);
+    writeChunk();
+
+    uint64_t index_offset = (uint64_t) file.tellp();
+    for(const DatasetChunk &info: chunks) {
+        writeInt(file, info.offset, 8);
+        writeInt(file, info.compressed_size, 4);
+        writeInt(file, info.num_records, 4);
+    }
+    writeInt(file, index_offset, 8);
+    writeInt(file, chunks.size(), 8);
+    writeInt(file, num_records, 8);
+    file.write("SJDE", 4);
+
+    bool ok = file.good() && pending_games.empty();
+    file.close();
+    return ok;
+}
+
+const PositionEncoder& DatasetWriter::getEncoder() const {
+    return encoder;
+}
+
+uint64_t DatasetWriter::countRecords() const {
+    return num_records;
+}
@@ -0,0 +1,413 @@
+#include <algorithm>
+#include <sstream>
+#include "differentialTester.h"
+#include "board.h"
+#include "gameObserver.h"
+
+using namespace std;
+
+// One in how many 'Action's of a random game is a random one, most likely illegal.
+static const uint32_t PROBE_ONE_IN = 8;
+
+// Remembers the words completed by the moves of a 'GameState'.
+class DifferentialTester::WordRecorder: public GameObserver {
+    public:
+    // A word completed.
+    struct CompletedWord {
+        Position start;
+        Orientation orientation;
+        std::string letters;
+    };
+
+    // The words completed since the last 'clear'.
+    std::vector<CompletedWord> words;
+
+    void onWordsCompleted(const GameState&, const Word *completed_words, int count) override {
+        for(int i = 0; i < count; i++) {
+            const Word &word = completed_words[i];
+            words.push_back({word.getStart(), word.getOrientation(), string(word.begin(), word.end())});
+        }
+    }
+};
+
+// Returns a number that identifies a word by its start and 'Orientation'.
+static uint64_t getWordKey(Position start, Orientation orientation) {
+    return ((uint64_t) (uint16_t) start.getY() << 32) | ((uint64_t) (uint16_t) start.getX() << 16) | orientation;
+}
+
+uint64_t DifferentialTester::getActionKey(const Action &action) {
+    uint64_t key = (uint64_t) action.getType() << 56;
+    if(action.getType() == ACTION_MOVE) {
+        key |= ((uint64_t) (uint16_t) action.getPosition().getY() << 16) | (uint16_t) action.getPosition().getX();
+    } else {
+        key |= ((uint64_t) (unsigned char) action.getLetter1() << 8) | (unsigned char) action.getLetter2();
+    }
+    return key;
+}
+
+uint64_t DifferentialTester::getTurnKey(const Turn &turn, const ReferenceGame &reference) {
+    uint64_t key = (uint64_t) turn.getType() << 56;
+    if(turn.getType() == TURN_MOVE_TWICE || turn.getType() == TURN_MOVE_ONCE) {
+        Position first = turn.getFirst(), second = turn.getSecond();
+        if(turn.getType() == TURN_MOVE_ONCE) second = Position();
+        // Two 'Cell's that can both be covered now may be covered in either order.
+        bool either_order = turn.getType() == TURN_MOVE_TWICE && reference.isCoverable(second);
+        uint64_t first_key = ((uint64_t) (uint16_t) first.getY() << 12) | (uint16_t) first.getX();
+        uint64_t second_key = ((uint64_t) (uint16_t) second.getY() << 12) | (uint16_t) second.getX();
+        if(either_order && second_key < first_key) swap(first_key, second_key);
+        key |= (first_key << 24) | second_key;
+    } else {
+        key |= ((uint64_t) (unsigned char) turn.getLetter1() << 8) | (unsigned char) turn.getLetter2();
+    }
+    return key;
+}
+
+DifferentialTester::DifferentialTester(): turns(new TurnList()), num_states(0), mismatch_step(0) {}
+
+const string& DifferentialTester::getMismatch() const {
+    return mismatch;
+}
+
+unsigned long DifferentialTester::countStates() const {
+    return num_states;
+}
+
+bool DifferentialTester::fail(size_t step, const string &what) {
+    mismatch_step = step;
+    ostringstream out;
+    out << "After " << step << " actions: " << what;
+    mismatch = out.str();
+    return false;
+}
+
+bool DifferentialTester::compare(const GameState &state, const ReferenceGame &reference, size_t step) {
+    num_states++;
+    const Board &board = state.getBoard();
+    ostringstream what;
+
+    if((int) board.getWidth() != reference.getWidth() || (int) board.getHeight() != reference.getHeight()) {
+        what << "size is " << board.getWidth() << "x" << board.getHeight() << ", expected "
+                << reference.getWidth() << "x" << reference.getHeight() << ".";
+        return fail(step, what.str());
+    }
+    if(board.countLetters() != reference.getLetterPositions().size()) {
+        what << "board has " << board.countLetters() << " letters, expected "
+                << reference.getLetterPositions().size() << ".";
+        return fail(step, what.str());
+    }
+
+    for(Position position: reference.getLetterPositions()) {
+        const Cell &cell = board.getCell(position);
+        if(cell.getLetter() != reference.getLetter(position)) {
+            what << "letter at " << position << " is '" << cell.getLetter() << "', expected '"
+                    << reference.getLetter(position) << "'.";
+            return fail(step, what.str());
+        }
+        if(cell.isCovered() != reference.isCovered(position)) {
+            what << position << " is " << (cell.isCovered() ? "" : "not ") << "covered, expected the opposite.";
+            return fail(step, what.str());
+        }
+        if(cell.isCoverable() != reference.isCoverable(position)) {
+            what << position << " is " << (cell.isCoverable() ? "" : "not ") << "coverable, expected the opposite.";
+            return fail(step, what.str());
+        }
+    }
+
+    if(state.isOver() != reference.isOver()) {
+        what << "game is " << (state.isOver() ? "" : "not ") << "over, expected the opposite.";
+        return fail(step, what.str());
+    }
+    if(state.getCurrentPlayerIndex() != reference.getCurrentPlayer() || state.getMovesLeft() != reference.getMovesLeft()) {
+        what << "player " << state.getCurrentPlayerIndex() + 1 << " has " << state.getMovesLeft()
+                << " moves left, expected player " << reference.getCurrentPlayer() + 1 << " with "
+                << reference.getMovesLeft() << ".";
+        return fail(step, what.str());
+    }
+
+    const vector<Player> &players = state.getPlayers();
+    for(unsigned int i = 0; i < players.size(); i++) {
+        if(players[i].getScore() != reference.getScore(i)) {
+            what << "player " << i + 1 << " scored " << players[i].getScore() << ", expected "
+                    << reference.getScore(i) << ".";
+            return fail(step, what.str());
+        }
+        string hand;
+        for(int slot = 0; slot < Hand::HAND_SIZE; slot++) hand.push_back(players[i].getHand().getSlot(slot));
+        if(hand != reference.getHand(i)) {
+            what << "player " << i + 1 << " holds " << hand << ", expected " << reference.getHand(i) << ".";
+            return fail(step, what.str());
+        }
+    }
+
+    const string &bag = reference.getBag();
+    for(char letter = 'A'; letter <= 'Z'; letter++) {
+        int expected = (int) count(bag.begin(), bag.end(), letter);
+        if(state.getPool().countLetter(letter) != expected) {
+            what << "pool has " << state.getPool().countLetter(letter) << " of '" << letter << "', expected "
+                    << expected << ".";
+            return fail(step, what.str());
+        }
+    }
+
+    if(state.getTurnState() != reference.getTurnState()) {
+        what << "turn state is " << state.getTurnState() << ", expected " << reference.getTurnState() << ".";
+        return fail(step, what.str());
+    }
+
+    // Both engines must allow exactly the same 'Action's...
+    actions.clear();
+    state.getLegalActions(actions);
+    vector<pair<uint64_t, Action>> found, expected;
+    for(const Action &action: actions) found.push_back({getActionKey(action), action});
+    for(const Action &action: reference.getLegalActions()) expected.push_back({getActionKey(action), action});
+    sort(found.begin(), found.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    sort(expected.begin(), expected.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    for(size_t i = 0; i < max(found.size(), expected.size()); i++) {
+        if(i < found.size() && i < expected.size() && found[i].first == expected[i].first) continue;
+        bool extra = i < found.size() && (i >= expected.size() || found[i].first < expected[i].first);
+        what << "action '" << (extra ? found[i].second : expected[i].second) << "' is "
+                << (extra ? "legal, expected illegal." : "illegal, expected legal.");
+        return fail(step, what.str());
+    }
+
+    // ... and the same 'Turn's, counting two moves that may be made in either order once.
+    state.getLegalTurns(*turns);
+    vector<pair<uint64_t, Turn>> found_turns, expected_turns;
+    for(const Turn &turn: *turns) found_turns.push_back({getTurnKey(turn, reference), turn});
+    for(const Turn &turn: reference.getLegalTurns()) expected_turns.push_back({getTurnKey(turn, reference), turn});
+    sort(found_turns.begin(), found_turns.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    sort(expected_turns.begin(), expected_turns.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    auto same_key = [](const auto &a, const auto &b) { return a.first == b.first; };
+    if(adjacent_find(found_turns.begin(), found_turns.end(), same_key) != found_turns.end()) {
+        what << "turn '" << adjacent_find(found_turns.begin(), found_turns.end(), same_key)->second
+                << "' is listed twice.";
+        return fail(step, what.str());
+    }
+    expected_turns.erase(unique(expected_turns.begin(), expected_turns.end(), same_key), expected_turns.end());
+    for(size_t i = 0; i < max(found_turns.size(), expected_turns.size()); i++) {
+        if(i < found_turns.size() && i < expected_turns.size() && found_turns[i].first == expected_turns[i].first) {
+            continue;
+        }
+        bool extra = i < found_turns.size()
+                && (i >= expected_turns.size() || found_turns[i].first < expected_turns[i].first);
+        what << "turn '" << (extra ? found_turns[i].second : expected_turns[i].second) << "' is "
+                << (extra ? "legal, expected illegal." : "illegal, expected legal.");
+        return fail(step, what.str());
+    }
+
+    return true;
+}
+
+bool DifferentialTester::apply(GameState &state, ReferenceGame &reference, WordRecorder &recorder,
+        const Action &action, size_t step, bool &legal)
+{
+    ActionError error = state.checkAction(action);
+    ActionError expected_error = reference.checkAction(action);
+    if(error != expected_error) {
+        ostringstream what;
+        what << "action '" << action << "' is " << getActionErrorName(error) << ", expected "
+                << getActionErrorName(expected_error) << ".";
+        return fail(step, what.str());
+    }
+    legal = error == ACTION_OK;
+    if(!legal) return true;
+
+    recorder.words.clear();
+    state.applyAction(action);
+    vector<ReferenceGame::WordInfo> completed = reference.apply(action);
+
+    // The same words must have been completed, with the same letters.
+    vector<uint64_t> found, expected;
+    for(const WordRecorder::CompletedWord &word: recorder.words) {
+        found.push_back(getWordKey(word.start, word.orientation));
+        Position position = word.start;
+        for(char letter: word.letters) {
+            if(!position.inLimits(reference.getWidth(), reference.getHeight())
+                    || reference.getLetter(position) != letter) {
+                ostringstream what;
+                what << "word '" << word.letters << "' completed at " << word.start << " has the wrong letters.";
+                return fail(step, what.str());
+            }
+            position.stepForward(word.orientation);
+        }
+    }
+    for(const ReferenceGame::WordInfo &word: completed) expected.push_back(getWordKey(word.start, word.orientation));
+    sort(found.begin(), found.end());
+    sort(expected.begin(), expected.end());
+    if(found != expected) {
+        ostringstream what;
+        what << "action '" << action << "' completed " << found.size() << " words, expected " << expected.size()
+                << (found.size() == expected.size() ? " different ones." : ".");
+        return fail(step, what.str());
+    }
+
+    return compare(state, reference, step);
+}
+
+DifferentialTester::Outcome DifferentialTester::play(Case &game, Rng chooser) {
+    game.actions.clear();
+    if(game.num_players < 2 || game.num_players > GameState::MAX_PLAYERS) return CASE_INVALID;
+
+    istringstream board_in(game.board_text), reference_in(game.board_text);
+    string error;
+    unique_ptr<Board> board = Board::load(board_in, error);
+    ReferenceGame reference(reference_in, game.num_players, game.rng);
+    if(board == nullptr || !reference.isValid()) return CASE_INVALID;
+
+    WordRecorder recorder;
+    GameState state(*board, game.num_players, game.rng);
+    state.setObserver(&recorder);
+    state.dealHands();
+    reference.dealHands();
+    if(!compare(state, reference, 0)) return CASE_MISMATCH;
+
+    while(!reference.isOver() && game.actions.size() < MAX_ACTIONS) {
+        Action action;
+        if(chooser.below(PROBE_ONE_IN) == 0) {
+            // Any 'Action' at all, in or just around the board, with letters or the characters around them.
+            auto random_char = [&]() { return (char) ('A' - 1 + chooser.below(28)); };
+            switch(chooser.below(4)) {
+                case 0: {
+                    int x = (int) chooser.below(reference.getWidth() + 2) - 1;
+                    int y = (int) chooser.below(reference.getHeight() + 2) - 1;
+                    action = Action::move(Position(x, y));
+                    break;
+                }
+                case 1:
+                    action = Action::exchange(random_char());
+                    break;
+                case 2:
+                    action = Action::exchange(random_char(), random_char());
+                    break;
+                default:
+                    action = Action::endTurn();
+                    break;
+            }
+        } else {
+            // 'compare' just checked that both engines list the same legal 'Action's.
+            action = actions[chooser.below((uint32_t) actions.size())];
+        }
+
+        bool legal;
+        game.actions.push_back(action);
+        if(!apply(state, reference, recorder, action, game.actions.size(), legal)) return CASE_MISMATCH;
+        if(!legal) game.actions.pop_back();
+    }
+
+    return CASE_AGREES;
+}
+
+DifferentialTester::Outcome DifferentialTester::check(const Case &game) {
+    Case replayed = game;
+    return replay(replayed, false);
+}
+
+DifferentialTester::Outcome DifferentialTester::replay(Case &game, bool skip_illegal) {
+    if(game.num_players < 2 || game.num_players > GameState::MAX_PLAYERS) return CASE_INVALID;
+
+    istringstream board_in(game.board_text), reference_in(game.board_text);
+    string error;
+    unique_ptr<Board> board = Board::load(board_in, error);
+    ReferenceGame reference(reference_in, game.num_players, game.rng);
+    if(board == nullptr || !reference.isValid()) return CASE_INVALID;
+
+    WordRecorder recorder;
+    GameState state(*board, game.num_players, game.rng);
+    state.setObserver(&recorder);
+    state.dealHands();
+    reference.dealHands();
+    if(!compare(state, reference, 0)) {
+        game.actions.clear();
+        return CASE_MISMATCH;
+    }
+
+    // The 'Action's applied so far, which are all of them unless skipped.
+    size_t num_applied = 0;
+    for(size_t i = 0; i < game.actions.size(); i++) {
+        bool legal;
+        if(!apply(state, reference, recorder, game.actions[i], num_applied + 1, legal)) {
+            game.actions[num_applied++] = game.actions[i];
+            game.actions.resize(num_applied);
+            return CASE_MISMATCH;
+        }
+        if(legal) game.actions[num_applied++] = game.actions[i];
+        else if(!skip_illegal) return CASE_INVALID;
+    }
+    game.actions.resize(num_applied);
+    return CASE_AGREES;
+}
+
+DifferentialTester::Case DifferentialTester::shrink(const Case &game) {
+    unsigned int num_checks = 0;
+    // Replays 'candidate', whose 'Action's that became illegal (because the
+    // hands and the pool changed with what was removed) are dropped, and
+    // keeps only the 'Action's up to where the engines disagree.
+    auto still_fails = [&](Case &candidate) {
+        return num_checks++ < MAX_SHRINK_CHECKS && replay(candidate, true) == CASE_MISMATCH;
+    };
+    // Plays new random games of 'candidate' until one makes the engines
+    // disagree in fewer than 'max_actions' 'Action's, which is stored in it.
+    auto play_fails = [&](Case &candidate, size_t max_actions) {
+        for(uint64_t seed = 0; seed < SHRINK_REPLAYS && num_checks < MAX_SHRINK_CHECKS; seed++) {
+            num_checks++;
+            Case played = candidate;
+            if(play(played, Rng(seed, num_checks)) == CASE_MISMATCH && played.actions.size() < max_actions) {
+                candidate = played;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    Case best = game;
+    if(!still_fails(best)) return game;
+
+    bool changed = true;
+    while(changed && num_checks < MAX_SHRINK_CHECKS) {
+        changed = false;
+
+        // A shorter random game on the same board may show the same mistake.
+        if(play_fails(best, best.actions.size())) changed = true;
+
+        // Remove runs of 'Action's, from long ones to single 'Action's.
+        for(size_t run = max<size_t>(1, best.actions.size() / 2); run > 0; run /= 2) {
+            for(size_t start = 0; start < best.actions.size();) {
+                Case candidate = best;
+                auto first = candidate.actions.begin() + start;
+                candidate.actions.erase(first, first + min(run, candidate.actions.size() - start));
+                if(still_fails(candidate)) {
+                    best = candidate;
+                    changed = true;
+                } else {
+                    start += run;
+                }
+            }
+        }
+
+        // Remove words of the board, one at a time (the first line is its size).
+        // Without them the 'Action's are a different game, so if it no longer
+        // fails, new games are played on the smaller board.
+        vector<string> lines;
+        istringstream board_in(best.board_text);
+        string line;
+        while(getline(board_in, line)) {
+            if(!line.empty()) lines.push_back(line);
+        }
+        for(size_t i = lines.size(); i-- > 1;) {
+            Case candidate = best;
+            candidate.board_text.clear();
+            for(size_t j = 0; j < lines.size(); j++) {
+                if(j != i) candidate.board_text += lines[j] + "\n";
+            }
+            if(still_fails(candidate) || play_fails(candidate, SIZE_MAX)) {
+                best = candidate;
+                lines.erase(lines.begin() + i);
+                changed = true;
+            }
+        }
+    }
+
+    // Leave 'mismatch' describing the 'Case' returned.
+    check(best);
+    return best;
+}
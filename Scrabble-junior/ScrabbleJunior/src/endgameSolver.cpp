@@ -0,0 +1,293 @@
+#include <algorithm>
+#include "endgameSolver.h"
+#include "rng.h"
+
+using namespace std;
+
+// What the value of an 'Entry' is, with two players.
+enum Bound: uint8_t {
+    BOUND_EXACT,
+    // The value is at least the one stored.
+    BOUND_LOWER,
+    // The value is at most the one stored.
+    BOUND_UPPER,
+};
+
+// More points than any game can have, to open the window of alpha-beta.
+const int INFINITE_POINTS = 30000;
+
+// How many positions are searched between checks of the clock.
+const unsigned long NODES_PER_CHECK = 1024;
+
+// Seed of the Zobrist keys. Any value works, as long as it is always the same.
+const uint64_t ZOBRIST_SEED = 0x5c4abb1e;
+
+EndgameSolver::EndgameSolver(int table_bits, unsigned long max_nodes):
+    table_bits(table_bits),
+    generation(0),
+    max_nodes(max_nodes),
+    nodes(0),
+    aborted(false)
+{
+    Rng rng(ZOBRIST_SEED);
+    for(auto &player_keys: letter_keys) {
+        for(auto &letter: player_keys) {
+            for(uint64_t &key: letter) key = rng();
+        }
+    }
+    for(uint64_t &key: player_keys) key = rng();
+    moved_once_key = rng();
+}
+
+bool EndgameSolver::canSolve(const GameState &state) {
+    return state.getPool().isEmpty() && !state.isOver();
+}
+
+unsigned long EndgameSolver::getNodes() const {
+    return nodes;
+}
+
+void EndgameSolver::prepare(const GameState &state) {
+    // Entries of an older search may be of another 'Board', and keeping
+    // them would make the turn chosen among equals depend on earlier searches.
+    if(table.empty()) table.resize((size_t) 1 << table_bits, Entry());
+    generation++;
+    if(generation == 0) {
+        // Only when the generations wrap around must the table be emptied.
+        fill(table.begin(), table.end(), Entry());
+        generation = 1;
+    }
+
+    // Cell keys come from their own generator, so they are the
+    // same for every search of the same 'Board'.
+    Rng rng(ZOBRIST_SEED + 1);
+    cell_keys.resize(state.getBoard().countLetters());
+    for(uint64_t &key: cell_keys) key = rng();
+
+    nodes = 0;
+    aborted = false;
+}
+
+uint64_t EndgameSolver::hash(const GameState &state) const {
+    const Board &board = state.getBoard();
+    uint64_t result = 0;
+
+    for(int i = 0; i < (int) board.countLetters(); i++) {
+        if(board.getLetterCell(i).isCovered()) result ^= cell_keys[i];
+    }
+
+    const vector<Player> &players = state.getPlayers();
+    for(size_t p = 0; p < players.size(); p++) {
+        const Hand &hand = players[p].getHand();
+        for(int letter = 0; letter < ALPHABET_SIZE; letter++) {
+            int count = hand.countLetter((char) ('A' + letter));
+            for(int i = 0; i < count; i++) result ^= letter_keys[p][letter][i];
+        }
+    }
+
+    result ^= player_keys[state.getCurrentPlayerIndex()];
+    if(state.getMovesLeft() == 1) result ^= moved_once_key;
+    return result;
+}
+
+uint64_t EndgameSolver::hashAfter(const GameState &state, uint64_t old_hash, const Turn &turn,
+        unsigned int player_index, unsigned int old_moves_left) const
+{
+    const Board &board = state.getBoard();
+    const Hand &hand = state.getPlayers()[player_index].getHand();
+    uint64_t result = old_hash;
+
+    char letters[2];
+    int num_moves = turn.countMoves();
+    for(int i = 0; i < num_moves; i++) {
+        Position position = i == 0 ? turn.getFirst() : turn.getSecond();
+        int letter = board.getLetterAt(position);
+        result ^= cell_keys[letter];
+        letters[i] = board.getLetterCell(letter).getLetter();
+    }
+
+    // The instances of a letter are numbered from 0, so using one removes
+    // the key of the last one ('countLetter' after the move).
+    if(num_moves == 2 && letters[0] == letters[1]) {
+        int count = hand.countLetter(letters[0]);
+        result ^= letter_keys[player_index][letters[0] - 'A'][count];
+        result ^= letter_keys[player_index][letters[0] - 'A'][count + 1];
+    } else {
+        for(int i = 0; i < num_moves; i++) {
+            result ^= letter_keys[player_index][letters[i] - 'A'][hand.countLetter(letters[i])];
+        }
+    }
+
+    result ^= player_keys[player_index] ^ player_keys[state.getCurrentPlayerIndex()];
+    if(old_moves_left == 1) result ^= moved_once_key;
+    return result;
+}
+
+TurnList& EndgameSolver::getTurnList(int ply) {
+    while((int) turn_lists.size() <= ply) turn_lists.emplace_back(new TurnList());
+    return *turn_lists[ply];
+}
+
+bool EndgameSolver::countNode() {
+    if(++nodes > max_nodes) aborted = true;
+    else if(nodes % NODES_PER_CHECK == 0 && chrono::steady_clock::now() >= deadline) aborted = true;
+    return aborted;
+}
+
+int EndgameSolver::alphaBeta(GameState &state, uint64_t hash, int alpha, int beta, int ply) {
+    if(state.isOver() || countNode()) return 0;
+
+    int original_alpha = alpha;
+    int best_turn_hint = -1;
+    Entry &entry = table[hash & (table.size() - 1)];
+    if(entry.key == hash && entry.generation == generation) {
+        int value = entry.points[0];
+        if(entry.bound == BOUND_EXACT) return value;
+        if(entry.bound == BOUND_LOWER) alpha = max(alpha, value);
+        if(entry.bound == BOUND_UPPER) beta = min(beta, value);
+        if(alpha >= beta) return value;
+        best_turn_hint = entry.best_turn;
+    }
+
+    TurnList &turns = getTurnList(ply);
+    state.getLegalTurns(turns);
+    unsigned int player_index = state.getCurrentPlayerIndex();
+    unsigned int moves_left = state.getMovesLeft();
+
+    int best = -INFINITE_POINTS, best_index = -1;
+    // The best turn of an earlier search is tried first, since it
+    // is likely to still be the best (and to cut the others).
+    for(int k = best_turn_hint < 0 ? 0 : -1; k < turns.size(); k++) {
+        if(k == best_turn_hint) continue;
+        int i = k < 0 ? best_turn_hint : k;
+
+        TurnUndo undo = state.makeTurn(turns[i]);
+        int points = undo.countCompletedWords();
+        uint64_t child_hash = hashAfter(state, hash, turns[i], player_index, moves_left);
+        int value = points - alphaBeta(state, child_hash, points - beta, points - alpha, ply + 1);
+        state.unmakeTurn(undo);
+        if(aborted) return 0;
+
+        if(value > best) {
+            best = value;
+            best_index = i;
+        }
+        if(best > alpha) alpha = best;
+        if(alpha >= beta) break;
+    }
+
+    entry.key = hash;
+    entry.generation = generation;
+    entry.points[0] = (int16_t) best;
+    entry.best_turn = (int16_t) best_index;
+    if(best <= original_alpha) entry.bound = BOUND_UPPER;
+    else if(best >= beta) entry.bound = BOUND_LOWER;
+    else entry.bound = BOUND_EXACT;
+
+    return best;
+}
+
+void EndgameSolver::maxN(GameState &state, uint64_t hash, int ply, int *points) {
+    unsigned int num_players = (unsigned int) state.getPlayers().size();
+    fill(points, points + num_players, 0);
+    if(state.isOver() || countNode()) return;
+
+    Entry &entry = table[hash & (table.size() - 1)];
+    if(entry.key == hash && entry.generation == generation) {
+        copy(entry.points, entry.points + num_players, points);
+        return;
+    }
+
+    TurnList &turns = getTurnList(ply);
+    state.getLegalTurns(turns);
+    unsigned int player_index = state.getCurrentPlayerIndex();
+    unsigned int moves_left = state.getMovesLeft();
+
+    int best_index = -1;
+    int child_points[GameState::MAX_PLAYERS];
+    for(int i = 0; i < turns.size(); i++) {
+        TurnUndo undo = state.makeTurn(turns[i]);
+        uint64_t child_hash = hashAfter(state, hash, turns[i], player_index, moves_left);
+        maxN(state, child_hash, ply + 1, child_points);
+        child_points[player_index] += undo.countCompletedWords();
+        state.unmakeTurn(undo);
+        if(aborted) return;
+
+        // Ties keep the first turn, so the result doesn't depend on the table.
+        if(best_index < 0 || child_points[player_index] > points[player_index]) {
+            copy(child_points, child_points + num_players, points);
+            best_index = i;
+        }
+    }
+
+    entry.key = hash;
+    entry.generation = generation;
+    copy(points, points + num_players, entry.points);
+    entry.best_turn = (int16_t) best_index;
+    entry.bound = BOUND_EXACT;
+}
+
+bool EndgameSolver::solve(GameState &state, Turn &best_turn, vector<unsigned int> &final_scores,
+        chrono::steady_clock::time_point deadline)
+{
+    prepare(state);
+    this->deadline = deadline;
+    uint64_t root_hash = hash(state);
+
+    const vector<Player> &players = state.getPlayers();
+    unsigned int num_players = (unsigned int) players.size();
+    unsigned int player_index = state.getCurrentPlayerIndex();
+    unsigned int moves_left = state.getMovesLeft();
+
+    // Every 'Word' is completed by someone before the end, so the
+    // points left are the 'Word's not yet completed.
+    int points_left = (int) state.getBoard().countWords();
+    for(const Player &player: players) points_left -= player.getScore();
+
+    TurnList &turns = getTurnList(0);
+    state.getLegalTurns(turns);
+
+    // The root is searched here, to know which 'Turn' is the best.
+    int best_index = -1;
+    int points[GameState::MAX_PLAYERS] = {0};
+    int best_points[GameState::MAX_PLAYERS] = {0};
+    int best_difference = -INFINITE_POINTS;
+    for(int i = 0; i < turns.size(); i++) {
+        TurnUndo undo = state.makeTurn(turns[i]);
+        int turn_points = undo.countCompletedWords();
+        uint64_t child_hash = hashAfter(state, root_hash, turns[i], player_index, moves_left);
+
+        if(num_players == 2) {
+            // Only a better difference than the best so far matters.
+            int beta = turn_points - best_difference;
+            int difference = turn_points - alphaBeta(state, child_hash, -INFINITE_POINTS, beta, 1);
+            if(!aborted && difference > best_difference) {
+                best_difference = difference;
+                best_index = i;
+            }
+        } else {
+            maxN(state, child_hash, 1, points);
+            points[player_index] += turn_points;
+            if(!aborted && (best_index < 0 || points[player_index] > best_points[player_index])) {
+                copy(points, points + num_players, best_points);
+                best_index = i;
+            }
+        }
+
+        state.unmakeTurn(undo);
+        if(aborted) return false;
+    }
+
+    if(num_players == 2) {
+        // Both players score every point left between them.
+        best_points[player_index] = (points_left + best_difference) / 2;
+        best_points[1 - player_index] = (points_left - best_difference) / 2;
+    }
+
+    best_turn = turns[best_index];
+    final_scores.resize(num_players);
+    for(unsigned int i = 0; i < num_players; i++) {
+        final_scores[i] = players[i].getScore() + best_points[i];
+    }
+    return true;
+}
@@ -0,0 +1,132 @@
+#include <cstring>
+#include "endpoint.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#endif
+
+using namespace std;
+
+// How many connections may wait to be accepted.
+static const int LISTEN_BACKLOG = 1024;
+
+Endpoint::Endpoint(int port): port(port) {}
+
+Endpoint::Endpoint(const string &unix_path): unix_path(unix_path), port(0) {}
+
+#ifdef __linux__
+
+bool Endpoint::isSupported() {
+    return true;
+}
+
+bool Endpoint::setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+int Endpoint::listen() const {
+    int fd;
+    if(unix_path.empty()) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if(fd < 0) return -1;
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons((uint16_t) port);
+        if(bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(fd);
+            return -1;
+        }
+    } else {
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if(unix_path.size() >= sizeof(address.sun_path)) return -1;
+        strcpy(address.sun_path, unix_path.c_str());
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(fd < 0) return -1;
+        unlink(unix_path.c_str());
+        if(bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+
+    if(::listen(fd, LISTEN_BACKLOG) != 0 || !setNonBlocking(fd)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int Endpoint::connect() const {
+    int fd;
+    int result;
+    if(unix_path.empty()) {
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons((uint16_t) port);
+
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if(fd < 0) return -1;
+        // Requests are single short lines, which shouldn't wait to be merged.
+        int no_delay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        result = ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    } else {
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if(unix_path.size() >= sizeof(address.sun_path)) return -1;
+        strcpy(address.sun_path, unix_path.c_str());
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(fd < 0) return -1;
+        result = ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    }
+
+    if(result != 0 || !setNonBlocking(fd)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+#else
+
+bool Endpoint::isSupported() {
+    return false;
+}
+
+bool Endpoint::setNonBlocking(int) {
+    return false;
+}
+
+int Endpoint::listen() const {
+    return -1;
+}
+
+int Endpoint::connect() const {
+    return -1;
+}
+
+#endif
+
+string Endpoint::describe() const {
+    if(unix_path.empty()) return "port " + to_string(port);
+    return "socket " + unix_path;
+}
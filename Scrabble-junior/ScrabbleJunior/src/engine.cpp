@@ -0,0 +1,246 @@
+#include <fstream>
+#include <sstream>
+#include <cctype>
+#include "engine.h"
+
+using namespace std;
+
+// Returns the name of 'prompt', as written in "state".
+static const char* getPromptName(SessionPrompt prompt) {
+    switch(prompt) {
+        case PROMPT_MOVE: return "move";
+        case PROMPT_EXCHANGE_TWO: return "exchange_two";
+        case PROMPT_EXCHANGE_ONE: return "exchange_one";
+        case PROMPT_END_TURN: return "end_turn";
+        default: return "game_over";
+    }
+}
+
+void Engine::run(istream &in, ostream &out) {
+    string line;
+    while(getline(in, line)) {
+        // Blank lines are ignored, to be forgiving with scripts.
+        if(line.find_first_not_of(" \t\r") == string::npos) continue;
+        handleLine(line, out);
+        out.flush();
+    }
+}
+
+void Engine::handleLine(string_view line, ostream &out) {
+    string error;
+    out << '{';
+    if(!request.parse(line, error)) {
+        out << "\"ok\":false,\"error\":";
+        JsonObject::writeString(out, error);
+        out << "}\n";
+        return;
+    }
+
+    if(request.has("id")) {
+        out << "\"id\":";
+        request.writeValue(out, "id");
+        out << ',';
+    }
+
+    string command;
+    request.getString("cmd", command);
+    bool ok;
+    // Members of a successful answer are written after "ok", so they go
+    // to their own stream until the outcome is known.
+    ostringstream members;
+    if(command == "load_board") ok = loadBoard(members, error);
+    else if(command == "new_game") ok = newGame(members, error);
+    else if(command == "legal_actions") ok = listLegalActions(members, error);
+    else if(command == "apply") ok = apply(members, error);
+    else if(command == "state") ok = writeState(members, error);
+    else {
+        ok = false;
+        error = command.empty() ? "Missing \"cmd\"." : "Unknown command '" + command + "'.";
+    }
+
+    if(ok) {
+        out << "\"ok\":true" << members.str();
+    } else {
+        out << "\"ok\":false,\"error\":";
+        JsonObject::writeString(out, error);
+    }
+    out << "}\n";
+}
+
+bool Engine::loadBoard(ostream &out, string &error) {
+    string path;
+    if(!request.getString("path", path)) {
+        error = "Missing \"path\".";
+        return false;
+    }
+
+    ifstream file(path);
+    if(!file.is_open()) {
+        error = "File '" + path + "' does not exist or is unavailable.";
+        return false;
+    }
+    unique_ptr<Board> loaded = Board::load(file, error);
+    if(loaded == nullptr) return false;
+
+    // A game on the old 'Board' can't go on.
+    session.reset();
+    board = move(loaded);
+    out << ",\"width\":" << board->getWidth() << ",\"height\":" << board->getHeight()
+            << ",\"letters\":" << board->countLetters() << ",\"words\":" << board->countWords();
+    return true;
+}
+
+bool Engine::newGame(ostream&, string &error) {
+    long long num_players = 2, seed = 0;
+    if(request.has("players") && !request.getInt("players", num_players)) {
+        error = "\"players\" must be a 64-bit integer.";
+        return false;
+    }
+    if(request.has("seed") && !request.getInt("seed", seed)) {
+        error = "\"seed\" must be a 64-bit integer.";
+        return false;
+    }
+    if(board == nullptr) {
+        error = "No board was loaded.";
+        return false;
+    }
+    if(num_players < 2 || num_players > (long long) GameState::MAX_PLAYERS
+            || board->countLetters() < 7u * (unsigned int) num_players) {
+        error = "The board can't be played by " + to_string(num_players) + " players.";
+        return false;
+    }
+
+    session = make_unique<Session>(*board, (unsigned int) num_players, Rng((uint64_t) seed));
+    session->start();
+    return true;
+}
+
+bool Engine::listLegalActions(ostream &out, string &error) {
+    if(session == nullptr) {
+        error = "No game was started.";
+        return false;
+    }
+
+    legal_actions.clear();
+    if(!session->getState().isOver()) session->getState().getLegalActions(legal_actions);
+
+    out << ",\"actions\":[";
+    for(size_t i = 0; i < legal_actions.size(); i++) {
+        if(i > 0) out << ',';
+        writeAction(out, legal_actions[i]);
+    }
+    out << ']';
+    return true;
+}
+
+bool Engine::apply(ostream &out, string &error) {
+    if(session == nullptr) {
+        error = "No game was started.";
+        return false;
+    }
+
+    Action action;
+    if(!readAction(action, error)) return false;
+
+    unsigned long turns = session->countTurns();
+    ActionError action_error = session->submit(action);
+    if(action_error != ACTION_OK) {
+        error = getActionErrorName(action_error);
+        return false;
+    }
+
+    bool over = session->getState().isOver();
+    out << ",\"turn_ended\":" << (session->countTurns() != turns || over ? "true" : "false")
+            << ",\"over\":" << (over ? "true" : "false");
+    return true;
+}
+
+bool Engine::writeState(ostream &out, string &error) {
+    if(session == nullptr) {
+        error = "No game was started.";
+        return false;
+    }
+
+    const GameState &state = session->getState();
+    const Board &board = state.getBoard();
+    out << ",\"turn\":" << session->countTurns()
+            << ",\"current_player\":" << state.getCurrentPlayerIndex()
+            << ",\"moves_left\":" << state.getMovesLeft()
+            << ",\"prompt\":\"" << getPromptName(session->getPrompt()) << '"'
+            << ",\"over\":" << (state.isOver() ? "true" : "false")
+            << ",\"pool\":" << state.getPool().size();
+
+    out << ",\"scores\":[";
+    const vector<Player> &players = state.getPlayers();
+    for(size_t i = 0; i < players.size(); i++) out << (i == 0 ? "" : ",") << players[i].getScore();
+
+    out << "],\"hands\":[";
+    for(size_t i = 0; i < players.size(); i++) {
+        string letters;
+        for(int slot = 0; slot < Hand::HAND_SIZE; slot++) {
+            char letter = players[i].getHand().getSlot(slot);
+            if(letter >= 'A' && letter <= 'Z') letters += letter;
+        }
+        if(i > 0) out << ',';
+        JsonObject::writeString(out, letters);
+    }
+
+    // Only the letters of the 'Board', by 'Position', lowercase if covered:
+    // whole rows would be mostly empty 'Cell's on large boards.
+    out << "],\"cells\":{";
+    const vector<Position> &positions = board.getLetterPositions();
+    for(size_t i = 0; i < positions.size(); i++) {
+        const Cell &cell = board.getLetterCell((int) i);
+        char letter = cell.isCovered() ? (char) tolower(cell.getLetter()) : cell.getLetter();
+        out << (i == 0 ? "\"" : ",\"") << positions[i] << "\":\"" << letter << '"';
+    }
+    out << '}';
+    return true;
+}
+
+bool Engine::readAction(Action &action, string &error) const {
+    string type;
+    if(!request.getString("type", type)) {
+        error = "Missing \"type\" of the action.";
+        return false;
+    }
+
+    if(type == "move") {
+        string position;
+        Position parsed;
+        if(!request.getString("position", position) || !Position::parse(position, parsed)) {
+            error = "\"position\" must be like \"Ab\" or \"ABcd\".";
+            return false;
+        }
+        action = Action::move(parsed);
+    } else if(type == "exchange") {
+        string letters;
+        if(!request.getString("letters", letters) || letters.empty() || letters.size() > 2) {
+            error = "\"letters\" must have one or two letters.";
+            return false;
+        }
+        action = letters.size() == 1 ? Action::exchange(letters[0]) : Action::exchange(letters[0], letters[1]);
+    } else if(type == "end_turn") {
+        action = Action::endTurn();
+    } else {
+        error = "Unknown action type '" + type + "'.";
+        return false;
+    }
+    return true;
+}
+
+void Engine::writeAction(ostream &out, const Action &action) {
+    switch(action.getType()) {
+        case ACTION_MOVE:
+            out << "{\"type\":\"move\",\"position\":\"" << action.getPosition() << "\"}";
+            break;
+        case ACTION_EXCHANGE_ONE:
+            out << "{\"type\":\"exchange\",\"letters\":\"" << action.getLetter1() << "\"}";
+            break;
+        case ACTION_EXCHANGE_TWO:
+            out << "{\"type\":\"exchange\",\"letters\":\"" << action.getLetter1() << action.getLetter2() << "\"}";
+            break;
+        default:
+            out << "{\"type\":\"end_turn\"}";
+    }
+}
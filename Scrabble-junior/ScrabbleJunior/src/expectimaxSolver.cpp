@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <thread>
+#include <bitset>
+#include "expectimaxSolver.h"
+
+using namespace std;
+
+// Returns the number of ways to choose 'k' of 'n' items.
+static double choose(int n, int k) {
+    double result = 1;
+    for(int i = 1; i <= k; i++) result = result * (n - k + i) / i;
+    return result;
+}
+
+bool ExpectimaxSolver::Key::operator==(const Key &other) const {
+    return equal(begin(words), end(words), begin(other.words));
+}
+
+size_t ExpectimaxSolver::KeyHash::operator()(const Key &key) const {
+    // Mixes each word like splitmix64, so every bit affects the hash.
+    uint64_t hash = 0;
+    for(uint64_t word: key.words) {
+        hash = (hash ^ word) * 0x9e3779b97f4a7c15;
+        hash ^= hash >> 31;
+    }
+    return (size_t) hash;
+}
+
+ExpectimaxSolver::ExpectimaxSolver(unsigned int num_threads):
+    num_threads(num_threads),
+    shards(NUM_SHARDS),
+    repeated_positions(0)
+{
+    if(this->num_threads == 0) this->num_threads = max(1u, thread::hardware_concurrency());
+    fill(begin(in_board), end(in_board), false);
+}
+
+bool ExpectimaxSolver::canSolve(const Board &board, unsigned int num_players) {
+    // The first word of the 'Key' has a bit for each letter and
+    // two for the player to move.
+    if(board.countLetters() > 62) return false;
+
+    bitset<ALPHABET_SIZE> letters;
+    for(char letter: board.getLettersInBoard()) letters.set(letter - 'A');
+
+    // The counts of every 'Hand' must fit in the other words.
+    return num_players * letters.count() <= (KEY_WORDS - 1) * (64 / COUNT_BITS);
+}
+
+unsigned long ExpectimaxSolver::countPositions() const {
+    unsigned long positions = 0;
+    for(const Shard &shard: shards) positions += shard.values.size();
+    return positions;
+}
+
+unsigned long ExpectimaxSolver::countRepeatedPositions() const {
+    return repeated_positions;
+}
+
+ExpectimaxSolver::Key ExpectimaxSolver::makeKey(const GameState &state) const {
+    Key key;
+    fill(begin(key.words), end(key.words), 0);
+
+    const Board &board = state.getBoard();
+    for(int i = 0; i < (int) board.countLetters(); i++) {
+        if(board.getLetterCell(i).isCovered()) key.words[0] |= (uint64_t) 1 << i;
+    }
+
+    key.words[0] |= (uint64_t) state.getCurrentPlayerIndex() << 62;
+
+    // The counts never cross words: 64 is not a multiple of 'COUNT_BITS',
+    // so each word holds as many as fit and the last bits are unused.
+    const int counts_per_word = 64 / COUNT_BITS;
+    int index = 0;
+    for(const Player &player: state.getPlayers()) {
+        const Hand &hand = player.getHand();
+        for(int letter = 0; letter < ALPHABET_SIZE; letter++) {
+            if(!in_board[letter]) continue;
+            uint64_t count = (uint64_t) hand.countLetter((char) ('A' + letter));
+            key.words[1 + index / counts_per_word] |= count << (index % counts_per_word * COUNT_BITS);
+            index++;
+        }
+    }
+
+    return key;
+}
+
+bool ExpectimaxSolver::lookup(const Key &key, Values &values) {
+    Shard &shard = shards[KeyHash()(key) % NUM_SHARDS];
+    lock_guard<mutex> lock(shard.mutex);
+
+    auto found = shard.values.find(key);
+    if(found == shard.values.end()) return false;
+    values = found->second;
+    return true;
+}
+
+void ExpectimaxSolver::store(const Key &key, const Values &values) {
+    Shard &shard = shards[KeyHash()(key) % NUM_SHARDS];
+    lock_guard<mutex> lock(shard.mutex);
+    shard.values[key] = values;
+}
+
+TurnList& ExpectimaxSolver::getTurnList(Worker &worker, int ply) {
+    while((int) worker.turn_lists.size() <= ply) worker.turn_lists.emplace_back(new TurnList());
+    return *worker.turn_lists[ply];
+}
+
+template<typename Leaf>
+void ExpectimaxSolver::forEachDraw(GameState &state, unsigned int player_index, int count,
+        const int *excluded, int letter, double probability, Leaf &leaf)
+{
+    if(count == 0) {
+        leaf(probability);
+        return;
+    }
+
+    const Pool &pool = state.getPool();
+    while(letter < ALPHABET_SIZE && pool.countLetter((char) ('A' + letter)) <= excluded[letter]) letter++;
+    if(letter == ALPHABET_SIZE) return;
+
+    // Draw 0, 1, 2... of this letter, and the rest from the next ones.
+    char drawn_letter = (char) ('A' + letter);
+    int available = pool.countLetter(drawn_letter) - excluded[letter];
+    int max_drawn = min(available, count);
+    int slots[HAND_SIZE];
+
+    for(int drawn = 0; ; drawn++) {
+        forEachDraw(state, player_index, count - drawn, excluded, letter + 1,
+                probability * choose(available, drawn), leaf);
+        if(drawn == max_drawn) break;
+        slots[drawn] = state.drawLetter(player_index, drawn_letter);
+    }
+
+    for(int i = max_drawn - 1; i >= 0; i--) state.returnLetter(player_index, drawn_letter, slots[i]);
+}
+
+void ExpectimaxSolver::deal(Worker &worker, GameState &state, unsigned int player_index, Values &values) {
+    if(player_index == state.getPlayers().size()) {
+        decide(worker, state, 0, values);
+        return;
+    }
+
+    const Pool &pool = state.getPool();
+    int count = min(HAND_SIZE, pool.size());
+    int excluded[ALPHABET_SIZE] = {0};
+
+    values.fill(0);
+    auto leaf = [&](double probability) {
+        Values child;
+        deal(worker, state, player_index + 1, child);
+        for(size_t i = 0; i < values.size(); i++) values[i] += probability * child[i];
+    };
+    forEachDraw(state, player_index, count, excluded, 0, 1 / choose(pool.size(), count), leaf);
+}
+
+void ExpectimaxSolver::decide(Worker &worker, GameState &state, int ply, Values &values) {
+    values.fill(0);
+    if(state.isOver()) return;
+
+    Key key = makeKey(state);
+    if(lookup(key, values)) return;
+    if(!worker.path.insert(key).second) {
+        repeated_positions++;
+        return;
+    }
+
+    TurnList &turns = getTurnList(worker, ply);
+    state.getLegalTurns(turns);
+    unsigned int player_index = state.getCurrentPlayerIndex();
+
+    // The player to move chooses the turn best for them. Ties keep the
+    // first turn, so the result doesn't depend on the threads.
+    Values child;
+    for(int i = 0; i < turns.size(); i++) {
+        play(worker, state, turns[i], ply, child);
+        if(i == 0 || child[player_index] > values[player_index]) values = child;
+    }
+
+    worker.path.erase(key);
+    store(key, values);
+}
+
+void ExpectimaxSolver::play(Worker &worker, GameState &state, const Turn &turn, int ply, Values &values) {
+    unsigned int player_index = state.getCurrentPlayerIndex();
+    const Pool &pool = state.getPool();
+    int excluded[ALPHABET_SIZE] = {0};
+
+    values.fill(0);
+    auto add = [&values](double probability, const Values &child) {
+        for(size_t i = 0; i < values.size(); i++) values[i] += probability * child[i];
+    };
+
+    if(turn.getType() == TURN_EXCHANGE_ONE || turn.getType() == TURN_EXCHANGE_TWO) {
+        // The letters go back to the 'Pool' only after drawing,
+        // so they are excluded from the draw.
+        char letters[2] = {turn.getLetter1(), turn.getLetter2()};
+        int count = turn.getType() == TURN_EXCHANGE_TWO ? 2 : 1;
+        int slots[2];
+        for(int i = 0; i < count; i++) {
+            slots[i] = state.returnLetter(player_index, letters[i]);
+            excluded[letters[i] - 'A']++;
+        }
+
+        auto leaf = [&](double probability) {
+            TurnUndo undo = state.makeTurn(Turn::end());
+            Values child;
+            decide(worker, state, ply + 1, child);
+            state.unmakeTurn(undo);
+            add(probability, child);
+        };
+        forEachDraw(state, player_index, count, excluded, 0, 1 / choose(pool.size() - count, count), leaf);
+
+        for(int i = count - 1; i >= 0; i--) state.drawLetter(player_index, letters[i], slots[i]);
+        return;
+    }
+
+    TurnUndo undo = state.makeTurn(turn);
+    const Hand &hand = state.getPlayers()[player_index].getHand();
+    int count = min(HAND_SIZE - hand.countLetters(), pool.size());
+
+    if(state.isOver() || count == 0) {
+        decide(worker, state, ply + 1, values);
+    } else {
+        // The 'Hand' is refilled at the end of the turn.
+        auto leaf = [&](double probability) {
+            Values child;
+            decide(worker, state, ply + 1, child);
+            add(probability, child);
+        };
+        forEachDraw(state, player_index, count, excluded, 0, 1 / choose(pool.size(), count), leaf);
+    }
+
+    values[player_index] += undo.countCompletedWords();
+    state.unmakeTurn(undo);
+}
+
+void ExpectimaxSolver::solve(const Board &board, unsigned int num_players, vector<double> &expected_scores) {
+    for(Shard &shard: shards) shard.values.clear();
+    repeated_positions = 0;
+
+    fill(begin(in_board), end(in_board), false);
+    for(char letter: board.getLettersInBoard()) in_board[letter - 'A'] = true;
+
+    // Every possible starting 'Hand' of the first player is a task,
+    // taken by the threads in order.
+    GameState root(board, num_players, Rng());
+    vector<vector<char>> first_hands;
+    vector<double> first_probabilities;
+    int count = min(HAND_SIZE, root.getPool().size());
+    int excluded[ALPHABET_SIZE] = {0};
+    auto leaf = [&](double probability) {
+        vector<char> letters;
+        for(int letter = 0; letter < ALPHABET_SIZE; letter++) {
+            int drawn = root.getPlayers()[0].getHand().countLetter((char) ('A' + letter));
+            letters.insert(letters.end(), drawn, (char) ('A' + letter));
+        }
+        first_hands.push_back(letters);
+        first_probabilities.push_back(probability);
+    };
+    forEachDraw(root, 0, count, excluded, 0, 1 / choose(root.getPool().size(), count), leaf);
+
+    atomic<size_t> next_task(0);
+    vector<Values> thread_values(num_threads);
+    auto work = [&](unsigned int thread_index) {
+        Worker worker;
+        GameState state = root;
+        Values &total = thread_values[thread_index];
+        total.fill(0);
+
+        for(size_t task = next_task++; task < first_hands.size(); task = next_task++) {
+            int slots[HAND_SIZE];
+            for(size_t i = 0; i < first_hands[task].size(); i++) {
+                slots[i] = state.drawLetter(0, first_hands[task][i]);
+            }
+
+            Values values;
+            deal(worker, state, 1, values);
+            for(size_t i = 0; i < total.size(); i++) total[i] += first_probabilities[task] * values[i];
+
+            for(int i = (int) first_hands[task].size() - 1; i >= 0; i--) {
+                state.returnLetter(0, first_hands[task][i], slots[i]);
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for(unsigned int i = 1; i < num_threads; i++) threads.emplace_back(work, i);
+    work(0);
+    for(thread &t: threads) t.join();
+
+    expected_scores.assign(num_players, 0);
+    for(const Values &values: thread_values) {
+        for(unsigned int i = 0; i < num_players; i++) expected_scores[i] += values[i];
+    }
+}
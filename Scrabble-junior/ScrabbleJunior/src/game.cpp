@@ -2,45 +2,68 @@
 #include <sstream>
 #include <cctype>
 #include <algorithm>
+#include <cstdio>
 #include "game.h"
 #include "cmd.h"
+#include "profiler.h"
 
 using namespace std;
 
-Game::Game(Board &board, unsigned int num_players):
-    board(board),
-    pool(board.getLettersInBoard()),
-    displayer(board.getWidth(), board.getHeight()),
-    current_player_index(0),
-    moves_left(2)
-{
-    // Initialize players
-    for(unsigned int i = 1; i <= num_players; i++) {
-        Player player(i);
-        players.push_back(player);
-    }
+// How many positions may be searched to show the result of perfect play,
+// so the game never stops for long on big endgames.
+const unsigned long PERFECT_PLAY_MAX_NODES = 1000000;
+
+// Removes the spaces at the start of 'input'.
+static void skipSpaces(string_view &input) {
+    while(!input.empty() && isspace((unsigned char) input.front())) input.remove_prefix(1);
 }
 
-bool Game::isOver() const {
-    // Game ends after covering all letters.
-    return board.isFullyCovered();
+// Reads the next character of 'input' that isn't a space to 'c', removing
+// it, just like 'istream >> char'. Returns whether there was one.
+static bool readChar(string_view &input, char &c) {
+    skipSpaces(input);
+    if(input.empty()) return false;
+    c = input.front();
+    input.remove_prefix(1);
+    return true;
 }
 
-const Player& Game::getCurrentPlayer() const {
-    return players[current_player_index];
+// Reads the next word (up to a space) of 'input', removing it, just like
+// 'istream >> string'. Returns an empty word if there is none. The word
+// views 'input', so nothing is copied.
+static string_view readWord(string_view &input) {
+    skipSpaces(input);
+    size_t size = 0;
+    while(size < input.size() && !isspace((unsigned char) input[size])) size++;
+    string_view word = input.substr(0, size);
+    input.remove_prefix(size);
+    return word;
 }
 
-Player& Game::getCurrentPlayer() {
-    return players[current_player_index];
+Game::Game(const Board &board, unsigned int num_players, Rng rng, const vector<Bot*> &bots):
+    session(board, num_players, rng),
+    displayer(board.getWidth(), board.getHeight()),
+    bots(bots),
+    must_play_twice(false),
+    must_follow_legal_moves(true),
+    solver(19, PERFECT_PLAY_MAX_NODES),
+    must_solve_turn(true),
+    journal(nullptr),
+    board_hash(0)
+{
+    this->bots.resize(num_players, nullptr);
+    legal_positions.reserve(board.countLetters());
+
+    // 'Game' displays what happens in its own 'Session'.
+    session.setObserver(this);
 }
 
-std::vector<int> Game::getWinnersId() const {
-    // Assumes 'players' are sorted, the winners are the first element
-    // and all elements with the same score.
-    int winner_score = players[0].getScore();
+std::vector<int> Game::getWinnersId(const vector<Player> &sorted_players) {
+    // The winners are the first element and all elements with the same score.
+    int winner_score = sorted_players[0].getScore();
     vector<int> winners_id;
 
-    for(const Player &player: players) {
+    for(const Player &player: sorted_players) {
         int score = player.getScore();
         int id = player.getId();
         
@@ -51,304 +74,365 @@ std::vector<int> Game::getWinnersId() const {
     return winners_id;
 }
 
-TurnState Game::getTurnState() const {
-    if(board.hasMove(getCurrentPlayer().getHand())) {
-        // Current player can move.
-        // Must always move if possible.
-        return MUST_MOVE;
-    } else if(moves_left == 1) {
-        // Current player can't move, but already moved once this turn.
-        // The second move is be skipped and turn is over.
-        return MUST_END_TURN;
-    } else if(pool.size() >= 2) {
-        // Current player hasn't moved this turn and can't move.
-        // Must exchange two letters with the pool.
-        return MUST_EXCHANGE_TWO;
-    } else if(pool.size() == 1) {
-        // Current player hasn't moved this turn and can't move.
-        // Pool only has one letter.
-        // Must exchange one letter with the pool.
-        return MUST_EXCHANGE_ONE;
-    } else {
-        // Current player hasn't moved this turn and can't move.
-        // Pool is empty.
-        // There is no choice but to skip the turn.
-        return MUST_SKIP_TURN;
-    }
+void Game::setJournal(Journal *journal) {
+    this->journal = journal;
+    session.setJournal(journal);
 }
 
-bool Game::play(default_random_engine &rng) {
-    // Shuffle the pool
-    pool.shuffle(rng);
-    
+void Game::setAutosave(const string &snapshot_name, const string &board_name, uint64_t board_hash,
+        const string &journal_name)
+{
+    this->snapshot_name = snapshot_name;
+    this->board_name = board_name;
+    this->board_hash = board_hash;
+    this->journal_name = journal_name;
+}
+
+bool Game::restore(const Snapshot &snapshot) {
+    return session.restore(snapshot);
+}
+
+bool Game::play() {
     // Give each player a starting 'Hand'.
-    for(Player &player: players) {
-        player.getHand().refill(pool);
+    if(!session.isStarted()) {
+        session.start();
+        autosave();
     }
 
     // Play the game, exiting if stdin fails.
-    clrscr();
-    if(!playLoop(rng)) return false;
+    displayer.clearScreen();
+    if(!playLoop()) return false;
+    const GameState &state = session.getState();
+    if(journal != nullptr) journal->finish(state);
+    finishAutosave();
 
     // At the end players are ordered by score for the leaderboard
+    vector<Player> players = state.getPlayers();
     stable_sort(players.begin(), players.end(), 
-            [](auto p1, auto p2) { return p1.getScore() > p2.getScore(); });
+            [](const Player &p1, const Player &p2) { return p1.getScore() > p2.getScore(); });
     
     // Draw gameover screen
-    clrscr();
-    displayer.printBoard(board);
-    displayer.printLeaderboard(players);
-    displayer.declareWinners(getWinnersId(), (int) players.size());
+    displayer.clearScreen();
+    displayer.drawBoard(state.getBoard());
+    displayer.drawLeaderboard(players);
+    displayer.declareWinners(getWinnersId(players), (int) players.size());
 
     return true;
 }
 
-bool Game::playLoop(default_random_engine &rng) {
+bool Game::playLoop() {
     ostream &error_messages = displayer.getErrorStream();
+    const GameState &state = session.getState();
 
-    while(!isOver()) {
+    while(session.getPrompt() != PROMPT_GAME_OVER) {
         // Check what must be done in this turn.
-        TurnState turn_state = getTurnState();
-        // Which moves are legal, to highlight in the board.
-        // Only set if player must move. Otherwise, kept as
-        // nullptr so no 'Cell's are highlighted.
-        GameDisplayer::CheckLegalMove is_legal = nullptr;
-        // Whether the edge case for forcing to play twice (see 'Board::mustPlayTwiceEdgeCase')
-        // is happening in this turn.
-        bool must_play_twice = false;
-        
-        if(turn_state == MUST_MOVE) {
-            // If player must move, get the appropriate 'CheckLegalMove', having
-            // in mind the possible edge case for forcing to play twice.
-            // (see 'Board::mustPlayTwiceEdgeCase')
-            is_legal = getCheckLegalMove(must_play_twice);
+        TurnState turn_state = state.getTurnState();
+        const Player &current_player = state.getCurrentPlayer();
+        // Which moves are legal, to highlight in the board. Only
+        // highlighted if player must move, having in mind the possible
+        // edge case for forcing to play twice (see 'Board::mustPlayTwiceEdgeCase').
+        bool highlight_legal = turn_state == MUST_MOVE;
+        if(highlight_legal) updateLegalMoves();
+        if(highlight_legal && must_follow_legal_moves) {
+            displayer.followLegalMoves(state.getBoard(), [this](Position position, const Cell &cell) {
+                return isLegalMove(position, cell);
+            });
         }
+        must_follow_legal_moves = false;
 
         if(turn_state == MUST_EXCHANGE_TWO) {
-            error_messages << "Player " << getCurrentPlayer().getId() << " couldn't make any move.\n"
+            error_messages << "Player " << current_player.getId() << " couldn't make any move.\n"
                     << "Choose two letters to exchange with the Pool this turn.\n";
         } else if(turn_state == MUST_EXCHANGE_ONE) {
-            error_messages << "Player " << getCurrentPlayer().getId() << " couldn't make any move.\n"
+            error_messages << "Player " << current_player.getId() << " couldn't make any move.\n"
                     << "Choose a letter this turn to exchange for the remaining one in the Pool.\n";
         } else if(turn_state == MUST_END_TURN) {
-            error_messages << "Player " << getCurrentPlayer().getId() << " couldn't make any more moves this turn.\n";
+            error_messages << "Player " << current_player.getId() << " couldn't make any more moves this turn.\n";
         } else if(turn_state == MUST_SKIP_TURN) {
-            error_messages << "Player " << getCurrentPlayer().getId() << " couldn't make any move.\n"
+            error_messages << "Player " << current_player.getId() << " couldn't make any move.\n"
                     << "Turn has been skipped.\n";            
         }
 
         // Draw current state of the game.
-        gotoxy(0, 0);
-        displayer.printBoard(board, is_legal);
-        displayer.printScoreboard(players);
-        displayer.printTurnInfo(getCurrentPlayer(), moves_left);
-        displayer.clearErrors();
-
-        setcolor(GameDisplayer::TEXT_COLOR);
-        if(turn_state == MUST_END_TURN || turn_state == MUST_SKIP_TURN) {
-            cout << "Press ENTER to continue . . . " << endl;
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-
-            nextTurn();
-            continue;
-        }
-
-        if(turn_state == MUST_MOVE) {
-            cout << "Enter a valid position on the board to play (in the form 'Ab'): ";
-        } else if(turn_state == MUST_EXCHANGE_TWO) {
-            cout << "Input two letters to exchange with the Pool: ";
-        } else if(turn_state == MUST_EXCHANGE_ONE) {
-            cout << "Input a letter to exchange with the Pool: ";
+        {
+            PROFILE_SCOPE("Game::playLoop draw");
+            displayer.drawBoard(state.getBoard(), [this, highlight_legal](Position position, const Cell &cell) {
+                return highlight_legal && isLegalMove(position, cell);
+            });
+            displayer.drawScoreboard(state.getPlayers());
+            displayer.printTurnInfo(current_player, state.getMovesLeft());
+            displayer.clearErrors();
         }
 
-        string input;
-        getline(cin, input);
-        if(cin.fail()) return false;
-        stringstream input_stream(input);
-
-        if(turn_state == MUST_MOVE) {
-            Position position;
-            if(!parsePosition(input_stream, position)) continue;
-            // Validation takes 'must_play_twice' and 'is_legal' just
-            // to check for the edge case (see 'Board::mustPlayTwiceEdgeCase')
-            // when it may apply.
-            if(!validateMove(position, must_play_twice, is_legal)) continue;
-            
-            move(position);
-            if(moves_left == 0) nextTurn();
-            continue;
-        }
-
-        if(turn_state == MUST_EXCHANGE_TWO) {
-            char letter1, letter2;
-            if(!parseLetters(input_stream, letter1, letter2)) continue;
-            if(!validateExchange(letter1, letter2)) continue;
+        solveEndgame();
+        if(!perfect_scores.empty()) displayer.printPerfectPlay(perfect_scores);
 
-            exchange(letter1, letter2, rng);
-            nextTurn();
-            continue;
+        unsigned long turn_number = session.countTurns();
+        Bot *bot = bots[state.getCurrentPlayerIndex()];
+        if(bot != nullptr) {
+            playBotTurn(*bot);
+        } else if(!playConsoleInput(turn_state)) {
+            return false;
         }
 
-        if(turn_state == MUST_EXCHANGE_ONE) {
-            char letter;
-            if(!parseLetter(input_stream, letter)) continue;
-            if(!validateExchange(letter)) continue;
-            
-            exchange(letter, rng);
-            nextTurn();
-            continue;
-        }
+        if(session.countTurns() != turn_number) onTurnEnd();
     }
 
     return true;
 }
 
-GameDisplayer::CheckLegalMove Game::getCheckLegalMove(bool &must_play_twice) const {
-    vector<Position> legal_positions;
+bool Game::playConsoleInput(TurnState turn_state) {
+    PROFILE_SCOPE("Game::playConsoleInput");
+    setcolor(GameDisplayer::TEXT_COLOR);
+    if(session.canUndo()) {
+        cout << "Type 'undo' to take back your last move." << endl;
+    }
+    if(displayer.isBoardPartial()) {
+        cout << "Type 'view Ab' to look at another part of the board." << endl;
+    }
 
-    if(moves_left == 2) {
-        // Edge case only needs to be checked if player is playing their
-        // first move this turn.
-        const Hand &hand = getCurrentPlayer().getHand();
-        must_play_twice = board.mustPlayTwiceEdgeCase(hand, legal_positions);
+    if(turn_state == MUST_MOVE) {
+        cout << "Enter a valid position on the board to play (in the form 'Ab'): ";
+    } else if(turn_state == MUST_EXCHANGE_TWO) {
+        cout << "Input two letters to exchange with the Pool: ";
+    } else if(turn_state == MUST_EXCHANGE_ONE) {
+        cout << "Input a letter to exchange with the Pool: ";
     } else {
-        must_play_twice = false;
+        cout << "Press ENTER to continue . . . " << endl;
     }
 
-    if(must_play_twice) {
-        // Because of edge case, only certain positions are truly legal.
-        // Those are stored in 'legal_positions'
-        return [legal_positions](Position position, auto) {
-            auto begin = legal_positions.begin();
-            auto end = legal_positions.end();
-            return find(begin, end, position) != end;
-        };
+    getline(cin, input);
+    if(cin.fail()) return false;
+
+    if(session.canUndo() && isUndoCommand(input)) {
+        session.undo();
+        must_follow_legal_moves = true;
+        return true;
+    }
+    if(parseViewCommand(input)) return true;
+
+    if(turn_state == MUST_MOVE) {
+        Position position;
+        if(!parsePosition(input, position)) return true;
+        if(!validateMove(position)) return true;
+        session.submit(Action::move(position));
+        must_follow_legal_moves = true;
+    } else if(turn_state == MUST_EXCHANGE_TWO) {
+        char letter1, letter2;
+        if(!parseLetters(input, letter1, letter2)) return true;
+        if(!validateExchange(letter1, letter2)) return true;
+        session.submit(Action::exchange(letter1, letter2));
+    } else if(turn_state == MUST_EXCHANGE_ONE) {
+        char letter;
+        if(!parseLetter(input, letter)) return true;
+        if(!validateExchange(letter)) return true;
+        session.submit(Action::exchange(letter));
     } else {
-        // Normally this is what needs to be checked for a position to be legal.
-        // The cell must be coverable and player must have the letter to cover it.
-        const Hand &hand = getCurrentPlayer().getHand();
-        return [hand](auto, const Cell &cell) {
-            return cell.isCoverable() && hand.hasLetter(cell.getLetter());
-        };
+        session.submit(Action::endTurn());
     }
+
+    return true;
 }
 
-bool Game::parsePosition(istream &input, Position &position) {
-    ostream &error_messages = displayer.getErrorStream();
-    string position_str;
+bool Game::isUndoCommand(string_view input) {
+    string_view command = readWord(input);
+    string_view unexpected = readWord(input);
 
-    input >> position_str;
-        
-    if(input.fail()) {
-        error_messages << "Expected position in the form 'Aa'.\n";
-        return false;
-    }
+    const string_view undo = "undo";
+    return command.size() == undo.size() && unexpected.empty()
+            && equal(command.begin(), command.end(), undo.begin(),
+                    [](char c, char expected) { return tolower(c) == expected; });
+}
 
-    // Player shouldn't input anything else.
-    std::string unexpected;
-    input >> unexpected;
-    if(unexpected.size() != 0) {
-        error_messages << "Unexpected: '" << unexpected << "'\n";
+bool Game::parseViewCommand(string_view input) {
+    string_view command = readWord(input);
+    const string_view view = "view";
+    if(command.size() != view.size() || !equal(command.begin(), command.end(), view.begin(),
+            [](char c, char expected) { return tolower(c) == expected; })) {
         return false;
     }
 
-    if(position_str.size() != 2) {
-        error_messages << "Couldn't parse '" << position_str
-                << "' as a position.\nUse an uppercase letter followed by a lowercase one, like 'Aa'.\n";
-        return false;
+    Position position;
+    if(!parsePosition(input, position)) return true;
+    const Board &board = session.getState().getBoard();
+    if(!position.inLimits(board.getWidth(), board.getHeight())) {
+        displayer.getErrorStream() << "Position '" << position << "' is outside board limits.\n";
+        return true;
     }
 
-    char x_char = position_str[1];
-    char y_char = position_str[0];
-    
-    if(x_char < 'a' || x_char > 'z' || y_char < 'A' || y_char > 'Z') {
-        error_messages << "Couldn't parse '" << position_str
-                << "' as a position.\nUse an uppercase letter followed by a lowercase one, like 'Aa'.\n";
-        return false;
-    }
+    displayer.centerOn(position);
+    return true;
+}
 
-    position = Position(x_char, y_char);
+void Game::onTurnEnd() {
+    must_solve_turn = true;
+    must_follow_legal_moves = true;
+    if(!session.getState().isOver()) autosave();
+}
 
-    return true;
+void Game::autosave() {
+    if(snapshot_name.empty()) return;
+
+    vector<string> seats;
+    for(Bot *bot: bots) seats.push_back(bot == nullptr ? "" : bot->getName());
+    size_t journal_actions = journal == nullptr ? 0 : journal->getActions().size();
+    Snapshot snapshot = Snapshot::capture(session.getState(), board_name, board_hash, seats, journal_name, journal_actions);
+
+    // The 'Journal' is saved first, so the 'Snapshot' never refers to
+    // turns that the 'Journal' doesn't have. If the program stops in
+    // between, the turns the 'Journal' has beyond it are forgotten when
+    // the game is resumed.
+    if(journal != nullptr && !journal->saveAtomically(journal_name)) return;
+    snapshot.save(snapshot_name);
 }
 
-bool Game::validateMove(Position position, bool must_play_twice, GameDisplayer::CheckLegalMove is_legal) {
-    ostream &error_messages = displayer.getErrorStream();
+void Game::finishAutosave() {
+    if(snapshot_name.empty()) return;
+    if(journal != nullptr) journal->saveAtomically(journal_name);
+    remove(snapshot_name.c_str());
+}
 
-    if(!position.inLimits(board.getWidth(), board.getHeight())) {
-        error_messages << "Position '" << position << "' is outside board limits.\n";
-        return false;
+void Game::solveEndgame() {
+    PROFILE_SCOPE("Game::solveEndgame");
+    GameState &state = session.getState();
+    if(!must_solve_turn || !EndgameSolver::canSolve(state)) return;
+    must_solve_turn = false;
+
+    Turn best_turn;
+    if(!solver.solve(state, best_turn, perfect_scores)) perfect_scores.clear();
+}
+
+void Game::playBotTurn(Bot &bot) {
+    PROFILE_SCOPE("Game::playBotTurn");
+    GameState &state = session.getState();
+    const Player &current_player = state.getCurrentPlayer();
+    stringstream notice;
+    notice << "Player " << current_player.getId() << " (" << bot.getName() << ") is thinking . . .";
+    displayer.notice(notice.str(), true);
+
+    state.getLegalTurns(bot_turns);
+    Turn turn;
+    {
+        PROFILE_SCOPE("Bot::chooseTurn");
+        turn = bot.chooseTurn(state, bot_turns);
     }
 
-    const Cell &cell = board.getCell(position);
+    Action actions[Turn::MAX_ACTIONS];
+    int count = turn.getActions(actions);
+    unsigned long turn_number = session.countTurns();
+
+    for(int i = 0; i < count; i++) {
+        // A single move may end the turn (or the game) by itself.
+        if(session.countTurns() != turn_number || state.isOver()) break;
+
+        if(actions[i].getType() == ACTION_MOVE) {
+            Position position = actions[i].getPosition();
+
+            // Show the move before making it.
+            displayer.showPosition(position);
+            updateLegalMoves();
+            displayer.drawBoard(state.getBoard(), [this](Position position, const Cell &cell) {
+                return isLegalMove(position, cell);
+            });
+            displayer.drawScoreboard(state.getPlayers());
+            displayer.printTurnInfo(current_player, state.getMovesLeft());
+
+            notice.str("");
+            notice << "Player " << current_player.getId() << " covers '" << position << "' . . .";
+            displayer.notice(notice.str(), true);
+        }
 
-    if(cell.isEmpty()) {
-        error_messages << "Position '" << position << "' has no letter.\n";
-        return false;
+        session.submit(actions[i]);
     }
+}
 
-    if(cell.isCovered()) {
-        error_messages << "Position '" << position << "' has already been covered.\n";
-        return false;
+void Game::updateLegalMoves() {
+    const GameState &state = session.getState();
+    legal_positions.clear();
+    must_play_twice = state.mustPlayTwice(legal_positions);
+}
+
+bool Game::isLegalMove(Position position, const Cell &cell) const {
+    if(must_play_twice) {
+        // Because of edge case, only certain positions are truly legal.
+        // Those are stored in 'legal_positions'
+        auto begin = legal_positions.begin();
+        auto end = legal_positions.end();
+        return find(begin, end, position) != end;
     }
 
-    if(!cell.isCoverable()) {
-        error_messages << "Can't cover position '" << position << "'.\n";
+    // Normally this is what needs to be checked for a position to be legal.
+    // The cell must be coverable and player must have the letter to cover it.
+    const Hand &hand = session.getState().getCurrentPlayer().getHand();
+    return cell.isCoverable() && hand.hasLetter(cell.getLetter());
+}
+
+bool Game::parsePosition(string_view input, Position &position) {
+    ostream &error_messages = displayer.getErrorStream();
+    string_view position_str = readWord(input);
+        
+    if(position_str.empty()) {
+        error_messages << "Expected position in the form 'Aa'.\n";
         return false;
     }
 
-    char letter = cell.getLetter();
-    if(!getCurrentPlayer().getHand().hasLetter(letter)) {
-        error_messages << "You don't have letter '" << letter << "' in your hand.\n";
+    // Player shouldn't input anything else.
+    string_view unexpected = readWord(input);
+    if(unexpected.size() != 0) {
+        error_messages << "Unexpected: '" << unexpected << "'\n";
         return false;
     }
 
-    // When the edge case is relevant, 'is_legal' must also be checked.
-    if(must_play_twice && !is_legal(position, board.getCell(position))) {
-        error_messages << "There is at least one move that allows you to play twice this turn.\n" 
-                << "Position '" << position << "' would only allow you to play once.\n";
-
+    if(!Position::parse(position_str, position)) {
+        error_messages << "Couldn't parse '" << position_str
+                << "' as a position.\nUse uppercase letters for the row followed by lowercase ones for the column, like 'Aa' or 'ABcd'.\n";
         return false;
     }
 
     return true;
 }
 
-void Game::move(Position position) {
-    Player &current_player = getCurrentPlayer();
-    char letter = board.getCell(position).getLetter();
-
-    moves_left -= 1;
-    current_player.getHand().useLetter(letter);
-
-    vector<Word> completed_words;
-    board.cover(position, completed_words);
+bool Game::validateMove(Position position) {
+    ostream &error_messages = displayer.getErrorStream();
+    const GameState &state = session.getState();
 
-    if(completed_words.size() != 0) {
-        // Animate word being completed
-        gotoxy(0, 0);
-        displayer.printBoard(board);
-        displayer.printScoreboard(players);
-        displayer.animateWordComplete(current_player, completed_words);
+    switch(state.checkMove(position)) {
+        case MOVE_OUT_OF_LIMITS:
+            error_messages << "Position '" << position << "' is outside board limits.\n";
+            return false;
+        case MOVE_EMPTY_CELL:
+            error_messages << "Position '" << position << "' has no letter.\n";
+            return false;
+        case MOVE_ALREADY_COVERED:
+            error_messages << "Position '" << position << "' has already been covered.\n";
+            return false;
+        case MOVE_NOT_COVERABLE:
+            error_messages << "Can't cover position '" << position << "'.\n";
+            return false;
+        case MOVE_LETTER_NOT_IN_HAND:
+            error_messages << "You don't have letter '" << state.getBoard().getCell(position).getLetter() 
+                    << "' in your hand.\n";
+            return false;
+        case MOVE_WOULD_PLAY_ONCE:
+            error_messages << "There is at least one move that allows you to play twice this turn.\n" 
+                    << "Position '" << position << "' would only allow you to play once.\n";
+            return false;
+        default:
+            return true;
     }
-    
-    current_player.addScore((unsigned int) completed_words.size());
 }
 
-bool Game::parseLetter(istream &input, char &letter) {
+bool Game::parseLetter(string_view input, char &letter) {
     ostream &error_messages = displayer.getErrorStream();
 
-    input >> letter;
-    letter = (char) toupper(letter);
-
-    if(input.fail()) {
+    if(!readChar(input, letter)) {
         error_messages << "Expected one letter.\n";
         return false;
     }
+    letter = (char) toupper(letter);
 
     // Player shouldn't input anything else.
-    std::string unexpected;
-    input >> unexpected;
+    string_view unexpected = readWord(input);
     if(unexpected.size() != 0) {
         error_messages << "Unexpected: '" << unexpected << "'\n";
         return false;
@@ -359,46 +443,32 @@ bool Game::parseLetter(istream &input, char &letter) {
 
 bool Game::validateExchange(char letter) {
     ostream &error_messages = displayer.getErrorStream();
+    const GameState &state = session.getState();
 
-    if(letter < 'A' || letter > 'Z') {
-        error_messages << "Character '" << letter << "' is not a letter.\n";
-        return false;
-    }
-
-    if(!getCurrentPlayer().getHand().hasLetter(letter)) {
-        error_messages << "You don't have letter '" << letter << "' in your hand.\n";
-        return false;
+    switch(state.checkExchange(letter)) {
+        case EXCHANGE_NOT_A_LETTER:
+            error_messages << "Character '" << letter << "' is not a letter.\n";
+            return false;
+        case EXCHANGE_LETTER_NOT_IN_HAND:
+            error_messages << "You don't have letter '" << letter << "' in your hand.\n";
+            return false;
+        default:
+            return true;
     }
-
-    return true;
 }
 
-void Game::exchange(char letter, default_random_engine &rng) {
-    stringstream notice;
-    notice << "Exchanging letter '" << letter << "' . . .";
-    displayer.notice(notice.str(), true);
-    
-    Hand &current_player_hand = getCurrentPlayer().getHand();
-    current_player_hand.exchange(pool, letter, displayer.getSwapLetterCallback());
-
-    pool.shuffle(rng); // Must shuffle again after exchanging.
-}
-
-bool Game::parseLetters(istream &input, char &letter1, char &letter2) {
+bool Game::parseLetters(string_view input, char &letter1, char &letter2) {
     ostream &error_messages = displayer.getErrorStream();
 
-    input >> letter1 >> letter2;
-    letter1 = (char) toupper(letter1);
-    letter2 = (char) toupper(letter2);
-
-    if(input.fail()) {
+    if(!readChar(input, letter1) || !readChar(input, letter2)) {
         error_messages << "Expected two letters.\n";
         return false;
     }
+    letter1 = (char) toupper(letter1);
+    letter2 = (char) toupper(letter2);
 
     // Player shouldn't input anything else.
-    std::string unexpected;
-    input >> unexpected;
+    string_view unexpected = readWord(input);
     if(unexpected.size() != 0) {
         error_messages << "Unexpected: '" << unexpected << "'\n";
         return false;
@@ -409,7 +479,11 @@ bool Game::parseLetters(istream &input, char &letter1, char &letter2) {
 
 bool Game::validateExchange(char letter1, char letter2) {
     ostream &error_messages = displayer.getErrorStream();
+    const GameState &state = session.getState();
 
+    if(state.checkExchange(letter1, letter2) == ACTION_OK) return true;
+
+    // Find out what is wrong with each letter, to explain it.
     if(letter1 < 'A' || letter1 > 'Z') {
         error_messages << "Character '" << letter1 << "' is not a letter.\n";
         return false;
@@ -420,69 +494,64 @@ bool Game::validateExchange(char letter1, char letter2) {
         return false;
     }
 
+    const Hand &hand = state.getCurrentPlayer().getHand();
     if(letter1 == letter2) {
         // Same letter: player must have at least two of it.
-        int hand_count = getCurrentPlayer().getHand().countLetter(letter1);
-        if(hand_count == 0) {
+        if(hand.countLetter(letter1) == 0) {
             error_messages << "You don't have letter '" << letter1 << "' in your hand.\n";
-            return false;
-        } else if(hand_count == 1) {
+        } else {
             error_messages << "You only have one letter '" << letter1 << "' in your hand.\n";
-            return false;
         }
-
-        return true;
     } else {
         // Different letters: player must have both.
-        bool has_letters = true;
-
-        if(!getCurrentPlayer().getHand().hasLetter(letter1)) {
+        if(!hand.hasLetter(letter1)) {
             error_messages << "You don't have letter '" << letter1 << "' in your hand.\n";
-            has_letters = false;
         }
 
-        if(!getCurrentPlayer().getHand().hasLetter(letter2)) {
+        if(!hand.hasLetter(letter2)) {
             error_messages << "You don't have letter '" << letter2 << "' in your hand.\n";
-            has_letters = false;
         }
-
-        return has_letters;
     }
+
+    return false;
+}
+
+void Game::onWordsCompleted(const GameState &state, const Word *completed_words, int count) {
+    // Animate word being completed
+    displayer.showPosition(completed_words[0].getStart());
+    displayer.drawBoard(state.getBoard());
+    displayer.drawScoreboard(state.getPlayers());
+    displayer.animateWordComplete(state.getCurrentPlayer(), completed_words, count);
 }
 
-void Game::exchange(char letter1, char letter2, default_random_engine &rng) {
+void Game::onExchange(const GameState&, const char *letters, int count) {
     stringstream notice;
-    notice << "Exchanging letters '" << letter1 << "' and '" << letter2 << "' . . .";
+    if(count == 1) {
+        notice << "Exchanging letter '" << letters[0] << "' . . .";
+    } else {
+        notice << "Exchanging letters '" << letters[0] << "' and '" << letters[1] << "' . . .";
+    }
     displayer.notice(notice.str(), true);
-    
-    Hand &current_player_hand = getCurrentPlayer().getHand();
-    current_player_hand.exchange(pool, letter1, letter2, displayer.getSwapLetterCallback());
-
-    pool.shuffle(rng); // Must shuffle again after exchanging.
 }
 
-void Game::nextTurn() {
-    Player &current_player = getCurrentPlayer();
-
-    if(!current_player.getHand().isFull() && !isOver()) {
-        // Player hand must be refilled.
-        // Update screen to prepare for that.
-        gotoxy(0, 0);
-        displayer.printBoard(board);
-        displayer.printScoreboard(players);
-        displayer.printTurnInfo(current_player, moves_left);
+void Game::onLetterDrawn(const GameState&, int index, char letter) {
+    displayer.animateSwapLetter(index, letter);
+}
 
-        if(pool.isEmpty()) {
-            displayer.notice("The Pool is empty . . .");
-        } else {
-            displayer.notice("Refilling hand . . .", true);
-            current_player.getHand().refill(pool, displayer.getSwapLetterCallback());
+void Game::onRefillStart(const GameState &state) {
+    // Player hand must be refilled.
+    // Update screen to prepare for that.
+    displayer.drawBoard(state.getBoard());
+    displayer.drawScoreboard(state.getPlayers());
+    displayer.printTurnInfo(state.getCurrentPlayer(), state.getMovesLeft());
 
-            displayer.afterRefill(pool.isEmpty());
-        }
+    if(state.getPool().isEmpty()) {
+        displayer.notice("The Pool is empty . . .");
+    } else {
+        displayer.notice("Refilling hand . . .", true);
     }
-    
-    moves_left = 2;
-    current_player_index++;
-    if(current_player_index == players.size()) current_player_index = 0;
+}
+
+void Game::onRefillEnd(const GameState &state) {
+    displayer.afterRefill(state.getPool().isEmpty());
 }
@@ -1,5 +1,4 @@
 #include <iostream>
-#include <iomanip>
 #include <algorithm>
 #include <chrono>
 #include <thread>
@@ -28,12 +27,63 @@ const int GameDisplayer::SHORT_NOTICE_DELAY = 800;
 const int GameDisplayer::AFTER_REFILL_DELAY = 750;
 
 const unsigned int GameDisplayer::current_player_hand_x_offset = 12;
+const unsigned int GameDisplayer::SCOREBOARD_WIDTH = 28;
+const unsigned int GameDisplayer::TURN_INFO_WIDTH = 40;
+const unsigned int GameDisplayer::TURN_INFO_HEIGHT = 4;
+const unsigned int GameDisplayer::MESSAGE_HEIGHT = 6;
+const unsigned int GameDisplayer::MIN_VIEWPORT_SIZE = 5;
+const unsigned int GameDisplayer::MAX_PRINTED_SIZE = 26;
+
+// Returns the character on line 'line' of 'name' written downwards, so that
+// names written in 'lines' lines all end on the last one ('name' must fit).
+static char getLabelCharacter(const string &name, int line, int lines) {
+    int index = line - (lines - (int) name.size());
+    return index < 0 ? ' ' : name[index];
+}
+
+// Returns 'number' right aligned in 'width' characters, like 'setw'.
+static string alignRight(unsigned int number, size_t width) {
+    string text = to_string(number);
+    if(text.size() < width) text.insert(0, width - text.size(), ' ');
+    return text;
+}
 
 GameDisplayer::GameDisplayer(unsigned int board_width, unsigned int board_height):
+    viewport(board_width, board_height),
+    label_width((unsigned int) Position::rowName((int) board_height - 1).size()),
+    label_height((unsigned int) Position::columnName((int) board_width - 1).size()),
+    scoreboard_x_offset(0),
+    turn_info_y_offset(0),
+    screen(0, 0, TEXT_COLOR)
+{
+    fitToConsole();
+}
+
+bool GameDisplayer::fitToConsole() {
+    unsigned int view_width = MAX_PRINTED_SIZE, view_height = MAX_PRINTED_SIZE;
+    int columns, lines;
+    if(getConsoleSize(columns, lines)) {
+        // A column is left between the board and the scoreboard, and a
+        // line between the board and the information of the turn.
+        int free_columns = columns - (int) (SCOREBOARD_WIDTH + label_width) - 1;
+        int free_lines = lines - (int) (TURN_INFO_HEIGHT + MESSAGE_HEIGHT + label_height) - 1;
+        view_width = max(MIN_VIEWPORT_SIZE, (unsigned int) max(free_columns / 2, 0));
+        view_height = max(MIN_VIEWPORT_SIZE, (unsigned int) max(free_lines, 0));
+    }
+    viewport.resize(view_width, view_height);
+
     // Offsets are calculated based on the size of the board on screen.
-    scoreboard_x_offset(board_width*2 + 2),
-    turn_info_y_offset(max(8u, board_height + 2)) // Must not be smaller than 8 because of height of scoreboard.
-{}
+    unsigned int new_scoreboard_x_offset = label_width + viewport.getWidth()*2 + 1;
+    // Must not be smaller than 8 because of height of scoreboard.
+    unsigned int new_turn_info_y_offset = max(8u, label_height + viewport.getHeight() + 1);
+    if(new_scoreboard_x_offset == scoreboard_x_offset && new_turn_info_y_offset == turn_info_y_offset) return false;
+
+    scoreboard_x_offset = new_scoreboard_x_offset;
+    turn_info_y_offset = new_turn_info_y_offset;
+    screen = Screen((int) max(scoreboard_x_offset + SCOREBOARD_WIDTH, TURN_INFO_WIDTH),
+            (int) (turn_info_y_offset + TURN_INFO_HEIGHT), TEXT_COLOR);
+    return true;
+}
 
 void GameDisplayer::printColoredId(int id, const char *prefix) {
     setcolor(PLAYERS_COLOR[id-1]);
@@ -41,6 +91,11 @@ void GameDisplayer::printColoredId(int id, const char *prefix) {
     setcolor(TEXT_COLOR);
 }
 
+int GameDisplayer::drawColoredId(int x, int y, int id, const char *prefix) {
+    x = screen.print(x, y, prefix, PLAYERS_COLOR[id-1]);
+    return screen.print(x, y, to_string(id), PLAYERS_COLOR[id-1]);
+}
+
 std::ostream& GameDisplayer::getErrorStream() {
     return error_messages;
 }
@@ -49,116 +104,220 @@ void GameDisplayer::clearErrors() {
     error_messages.str("");
 }
 
-void GameDisplayer::printBoard(const Board &board, CheckLegalMove check_legal_move) {
-    setcolor(TEXT_COLOR);
-    cout << ' ';
-    for(unsigned int i = 0; i < board.getWidth(); i++) {
-        char letter = (char) i + 'a';
-        cout << letter << ' ';
+void GameDisplayer::clearScreen() {
+    clrscr();
+    screen.clear();
+}
+
+void GameDisplayer::refresh() {
+    PROFILE_SCOPE("GameDisplayer::refresh");
+    screen.flush();
+}
+
+void GameDisplayer::getCellColors(const Cell &cell, bool highlighted, Color &color, Color &background) {
+    if(cell.isCovered()) {
+        color = LETTER_COVERED_COLOR;
+    } else {
+        color = LETTER_UNCOVERED_COLOR;
     }
-    cout << '\n';
 
-    for(unsigned int j = 0; j < board.getHeight(); j++) {
-        char letter = (char) j + 'A';
-        cout << letter;
-        
-        for(unsigned int i = 0; i < board.getWidth(); i++) {
-            Position position((int) i, (int) j);
-            const Cell cell = board.getCell(position);
-            Color letter_color, letter_background;
-
-            if(cell.isCovered()) {
-                letter_color = LETTER_COVERED_COLOR;
-            } else {
-                letter_color = LETTER_UNCOVERED_COLOR;
-            }
+    if(highlighted) {
+        background = BOARD_HIGHLIGHTED_BACKGROUND;
+    } else {
+        background = BOARD_BACKGROUND;
+    }
+}
 
-            if(check_legal_move && check_legal_move(position, cell)) {
-                letter_background = BOARD_HIGHLIGHTED_BACKGROUND;
-            } else {
-                letter_background = BOARD_BACKGROUND;
-            }
+void GameDisplayer::printBoard(const Board &board) {
+    // The part printed starts at the first row and column with a letter,
+    // which are the first ones of any 'Board' small enough.
+    int first_x = 0, first_y = 0;
+    int width = (int) board.getWidth(), height = (int) board.getHeight();
+    if(board.getWidth() > MAX_PRINTED_SIZE || board.getHeight() > MAX_PRINTED_SIZE) {
+        first_x = board.countLetters() == 0 ? 0 : width;
+        first_y = board.countLetters() == 0 ? 0 : height;
+        for(Position position: board.getLetterPositions()) {
+            first_x = min(first_x, position.getX());
+            first_y = min(first_y, position.getY());
+        }
+        width = min(width - first_x, (int) MAX_PRINTED_SIZE);
+        height = min(height - first_y, (int) MAX_PRINTED_SIZE);
+    }
+    int label_width = (int) Position::rowName(first_y + height - 1).size();
+    int label_height = (int) Position::columnName(first_x + width - 1).size();
+
+    setcolor(TEXT_COLOR);
+    for(int line = 0; line < label_height; line++) {
+        cout << string(label_width, ' ');
+        for(int i = 0; i < width; i++) {
+            cout << getLabelCharacter(Position::columnName(first_x + i), line, label_height) << ' ';
+        }
+        cout << '\n';
+    }
+
+    for(int j = 0; j < height; j++) {
+        string name = Position::rowName(first_y + j);
+        name.resize(label_width, ' ');
+        cout << name;
+
+        // Colors are only set when they change, which is seldom in a row.
+        Color current_color = TEXT_COLOR, current_background = BLACK;
+        for(int i = 0; i < width; i++) {
+            const Cell &cell = board.getCell(Position(first_x + i, first_y + j));
+            Color color, background;
+            getCellColors(cell, false, color, background);
+            if(color != current_color || background != current_background) setcolor(color, background);
+            current_color = color;
+            current_background = background;
 
-            setcolor(letter_color, letter_background);
             cout << cell;
-            
-            if(i+1 != board.getWidth()) {
-                setcolor(BLACK, BOARD_BACKGROUND);
-                cout << ' ';
-            }
+            if(i + 1 != width) cout << ' ';
         }
         setcolor(TEXT_COLOR);
         cout << '\n';
     }
+
+    if(width < (int) board.getWidth() || height < (int) board.getHeight()) {
+        cout << "Showing " << Position(first_x, first_y) << " to " << Position(first_x + width - 1, first_y + height - 1)
+                << " of a board of " << board.getHeight() << " x " << board.getWidth() << ".\n";
+    }
 }
 
-void GameDisplayer::printScoreboard(const std::vector<Player> &players) const {
-    gotoxy(scoreboard_x_offset + 4, 1);
-    setcolor(TEXT_COLOR);
-    cout << "SCORE       LETTERS";
+void GameDisplayer::drawBoard(const Board &board) {
+    drawBoard(board, [](Position, const Cell&) { return false; });
+}
+
+void GameDisplayer::showPosition(Position position) {
+    viewport.show(position);
+}
+
+void GameDisplayer::centerOn(Position position) {
+    viewport.centerOn(position);
+}
+
+bool GameDisplayer::isBoardPartial() const {
+    return viewport.isPartial();
+}
+
+void GameDisplayer::drawLabels() {
+    // Every character of the labels is drawn, so no letter of a longer
+    // name is left behind when scrolling.
+    for(int i = 0; i < viewport.getWidth(); i++) {
+        string name = Position::columnName(viewport.getX() + i);
+        for(int line = 0; line < (int) label_height; line++) {
+            screen.put((int) label_width + i*2, line, getLabelCharacter(name, line, (int) label_height), TEXT_COLOR);
+        }
+    }
+    for(int j = 0; j < viewport.getHeight(); j++) {
+        string name = Position::rowName(viewport.getY() + j);
+        name.resize(label_width, ' ');
+        screen.print(0, (int) label_height + j, name, TEXT_COLOR);
+    }
+}
+
+void GameDisplayer::drawCell(Position position, const Cell &cell, bool highlighted) {
+    // Find the position in screen given position in board.
+    int x = (position.getX() - viewport.getX())*2 + (int) label_width;
+    int y = position.getY() - viewport.getY() + (int) label_height;
+
+    Color letter_color, letter_background;
+    getCellColors(cell, highlighted, letter_color, letter_background);
+    screen.put(x, y, cell.getLetter(), letter_color, letter_background);
+
+    // The last 'Cell' shown of a row has no space after it.
+    if(position.getX() + 1 != viewport.getX() + viewport.getWidth()) {
+        screen.put(x + 1, y, ' ', BLACK, BOARD_BACKGROUND);
+    }
+}
+
+void GameDisplayer::drawScoreboard(const std::vector<Player> &players) {
+    PROFILE_SCOPE("GameDisplayer::drawScoreboard");
+    int x = (int) scoreboard_x_offset;
+    screen.erase(x, 1, (int) SCOREBOARD_WIDTH);
+    screen.print(x + 4, 1, "SCORE       LETTERS", TEXT_COLOR);
 
     for(size_t i = 0; i < players.size(); i++) {
-        gotoxy(scoreboard_x_offset, (int) i+2);
+        int y = (int) i+2;
         unsigned int id = players[i].getId();
         unsigned int score = players[i].getScore();
-        const Hand &hand = players[i].getHand();
+        ostringstream hand;
+        hand << players[i].getHand();
 
-        printColoredId(id, "P");
-        cout << " " << setw(4) << score << "      " << hand;
+        screen.erase(x, y, (int) SCOREBOARD_WIDTH);
+        int end = drawColoredId(x, y, id, "P");
+        screen.print(end, y, " " + alignRight(score, 4) + "      " + hand.str(), TEXT_COLOR);
     }
 }
 
-void GameDisplayer::printTurnInfo(const Player &current_player, unsigned int moves_left) const {
-    clrscr(0, turn_info_y_offset);
+void GameDisplayer::printTurnInfo(const Player &current_player, unsigned int moves_left) {
+    PROFILE_SCOPE("GameDisplayer::printTurnInfo");
+    int y = (int) turn_info_y_offset;
+    for(unsigned int i = 0; i < TURN_INFO_HEIGHT; i++) screen.erase(0, y + (int) i, screen.getWidth());
     unsigned int id = current_player.getId();
 
     // Who is playing.
-    printColoredId(id, "Player ");
-    cout << " is playing this turn." << endl;
+    int end = drawColoredId(0, y, id, "Player ");
+    screen.print(end, y, " is playing this turn.", TEXT_COLOR);
 
     // How many moves left.
     if(moves_left == 0) {
-        cout << "No moves left this turn." << endl;
+        screen.print(0, y + 1, "No moves left this turn.", TEXT_COLOR);
     } else if(moves_left == 1) {
-        cout << "You have 1 move left this turn." << endl;
+        screen.print(0, y + 1, "You have 1 move left this turn.", TEXT_COLOR);
     } else {
-        cout << "You have " << moves_left << " moves left this turn." << endl;
+        screen.print(0, y + 1, "You have " + to_string(moves_left) + " moves left this turn.", TEXT_COLOR);
     }
-    
+
     // Player's hand.
-    cout << "Your hand:  " << current_player.getHand() << endl << endl;
+    ostringstream hand;
+    hand << "Your hand:  " << current_player.getHand();
+    screen.print(0, y + 2, hand.str(), TEXT_COLOR);
+    refresh();
 
-    // Error messages.
+    // Error messages, below whatever was printed last time.
+    clrscr(0, screen.getHeight());
     setcolor(ERROR_COLOR);
     cout << error_messages.str();
 }
 
-void GameDisplayer::printLeaderboard(const std::vector<Player> &players) const {
-    gotoxy(scoreboard_x_offset + 9, 1);
+void GameDisplayer::printPerfectPlay(const std::vector<unsigned int> &final_scores) const {
     setcolor(TEXT_COLOR);
-    cout << "SCORE";
+    cout << "With perfect play, the game ends:";
+    for(size_t i = 0; i < final_scores.size(); i++) {
+        cout << "  ";
+        printColoredId((int) i+1, "P");
+        cout << " " << final_scores[i];
+    }
+    cout << endl;
+}
+
+void GameDisplayer::drawLeaderboard(const std::vector<Player> &players) {
+    int x = (int) scoreboard_x_offset;
+    screen.erase(x, 1, (int) SCOREBOARD_WIDTH);
+    screen.print(x + 9, 1, "SCORE", TEXT_COLOR);
     // A negative value is guaranteed to be different from any score.
     // Needed so first player will always show a 'WINNER_LABEL'.
     int previous_score = -1; 
 
     for(size_t i = 0; i < players.size(); i++) {
-        gotoxy(scoreboard_x_offset, (int) i+2);
+        int y = (int) i+2;
         unsigned int id = players[i].getId();
         unsigned int score = players[i].getScore();
-        
+        screen.erase(x, y, (int) SCOREBOARD_WIDTH);
+
         // Only makes sense to print a label if player is not tied with
         // previous one.
-        if((int) score != previous_score) cout << WINNER_LABELS[i] << "  ";
-        else cout << "     ";
-        
-        printColoredId(id, "P");
-        cout << " " << setw(4) << score;
-        
+        if((int) score != previous_score) screen.print(x, y, WINNER_LABELS[i], TEXT_COLOR);
+
+        int end = drawColoredId(x + 5, y, id, "P");
+        screen.print(end, y, " " + alignRight(score, 4), TEXT_COLOR);
+
         previous_score = score;
     }
 }
 
-void GameDisplayer::declareWinners(const vector<int> &winners_id, int num_players) const {
+void GameDisplayer::declareWinners(const vector<int> &winners_id, int num_players) {
+    refresh();
     gotoxy(0, turn_info_y_offset);
     cout << "GAME OVER" << endl;
 
@@ -191,78 +350,85 @@ void GameDisplayer::declareWinners(const vector<int> &winners_id, int num_player
     cout << endl;
 }
 
-void GameDisplayer::printWord(const Word &word, bool delay_each_letter) {
-    // Find the position in screen given position in board.
-    int x = word.getStart().getX()*2 + 1;
-    int y = word.getStart().getY() + 1;
+void GameDisplayer::pause(int milliseconds) {
+    PROFILE_SCOPE("GameDisplayer::pause");
+    this_thread::sleep_for(chrono::milliseconds(milliseconds));
+}
 
-    for(char c: word) {
-        gotoxy(x, y);
-        cout << c;
+void GameDisplayer::drawWord(const Word &word, Color color, bool delay_each_letter) {
+    Position position = word.getStart();
 
-        if(delay_each_letter) { 
-            this_thread::sleep_for(chrono::milliseconds(WORD_COMPLETED_ANIMATION_DELAY));
+    for(char c: word) {
+        // Only the letters shown are animated.
+        if(viewport.contains(position)) {
+            // Find the position in screen given position in board.
+            int x = (position.getX() - viewport.getX())*2 + (int) label_width;
+            int y = position.getY() - viewport.getY() + (int) label_height;
+            screen.put(x, y, c, color, BOARD_BACKGROUND);
+
+            if(delay_each_letter) { 
+                refresh();
+                pause(WORD_COMPLETED_ANIMATION_DELAY);
+            }
         }
 
-        // Advance position in screen
-        if(word.getOrientation() == Horizontal) x += 2;
-        else y += 1;
+        position.stepForward(word.getOrientation());
     }
 }
 
-Hand::SwapLetterAnimator GameDisplayer::getSwapLetterCallback() const {
-    return [this](int index, char letter) {
-        setcolor(SWAP_LETTER_COLOR);
-        gotoxy(current_player_hand_x_offset + 2*index, turn_info_y_offset+2);
-        cout << letter;
-        setcolor(TEXT_COLOR);
+void GameDisplayer::animateSwapLetter(int index, char letter) {
+    PROFILE_SCOPE("GameDisplayer::animateSwapLetter");
+    screen.put(current_player_hand_x_offset + 2*index, turn_info_y_offset+2, letter, SWAP_LETTER_COLOR);
+    refresh();
 
-        this_thread::sleep_for(chrono::milliseconds(SWAP_LETTER_DELAY));
-    };
+    pause(SWAP_LETTER_DELAY);
 }
 
-void GameDisplayer::animateWordComplete(const Player &player, const vector<Word> &words_completed) const {
-    clrscr(0, turn_info_y_offset);
-    setcolor(SCORE_COLOR);
-    cout << "Score!";
-
-    int score = player.getScore();
+void GameDisplayer::animateWordComplete(const Player &player, const Word *words_completed, int count) {
+    PROFILE_SCOPE("GameDisplayer::animateWordComplete");
+    int y = (int) turn_info_y_offset;
+    for(unsigned int i = 0; i < TURN_INFO_HEIGHT; i++) screen.erase(0, y + (int) i, screen.getWidth());
+    screen.print(0, y, "Score!", SCORE_COLOR);
+    refresh();
+    clrscr(0, screen.getHeight());
+
+    // Score already includes the completed words,
+    // so it is animated increasing from the previous one.
+    int score = player.getScore() - count;
     int id = player.getId();
 
-    for(const Word &word: words_completed) {
+    for(int i = 0; i < count; i++) {
+        const Word &word = words_completed[i];
         // Highlight animation and then back to normal.
-        setcolor(SCORE_COLOR, BOARD_BACKGROUND);
-        printWord(word, true);
-        setcolor(LETTER_COVERED_COLOR, BOARD_BACKGROUND);
-        printWord(word, false);
+        drawWord(word, SCORE_COLOR, true);
+        drawWord(word, LETTER_COVERED_COLOR, false);
 
         // Update score.
         score+=1; 
-        gotoxy(scoreboard_x_offset+3, id+1);
-        setcolor(SCORE_COLOR);
-        cout << setw(4) << score;
+        screen.print(scoreboard_x_offset+3, id+1, alignRight(score, 4), SCORE_COLOR);
+        refresh();
         
         // Delay.
-        this_thread::sleep_for(chrono::milliseconds(SCORE_INCREASE_DELAY));
+        pause(SCORE_INCREASE_DELAY);
     }
-
-    setcolor(TEXT_COLOR);
 }
 
 void GameDisplayer::notice(const string &information, bool short_delay) {
+    PROFILE_SCOPE("GameDisplayer::notice");
     setcolor(WARNING_COLOR);
     cout << information;
 
     int delay = short_delay? SHORT_NOTICE_DELAY : NOTICE_DELAY;
 
-    this_thread::sleep_for(chrono::milliseconds(delay));
+    pause(delay);
 }
 
 void GameDisplayer::afterRefill(bool depleted_pool) const {
+    PROFILE_SCOPE("GameDisplayer::afterRefill");
     if(depleted_pool) {
         gotoxy(0, turn_info_y_offset+6);
         notice("The pool has been depleted.");
     } else {
-        this_thread::sleep_for(chrono::milliseconds(AFTER_REFILL_DELAY));
+        pause(AFTER_REFILL_DELAY);
     }
 }
@@ -0,0 +1,13 @@
+#include "gameObserver.h"
+
+using namespace std;
+
+void GameObserver::onWordsCompleted(const GameState&, const Word*, int) {}
+
+void GameObserver::onExchange(const GameState&, const char*, int) {}
+
+void GameObserver::onLetterDrawn(const GameState&, int, char) {}
+
+void GameObserver::onRefillStart(const GameState&) {}
+
+void GameObserver::onRefillEnd(const GameState&) {}
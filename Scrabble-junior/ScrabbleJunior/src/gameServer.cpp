@@ -0,0 +1,477 @@
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include "gameServer.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+// Longest request accepted. Longer lines drop the connection.
+static const size_t MAX_REQUEST_SIZE = 256;
+// Most events handled by each wait of the event loop.
+static const int MAX_EVENTS = 256;
+
+// Reads the next word (up to a space) of 'input', removing it.
+// Returns an empty word if there is none.
+static string_view readWord(string_view &input) {
+    while(!input.empty() && isspace((unsigned char) input.front())) input.remove_prefix(1);
+    size_t size = 0;
+    while(size < input.size() && !isspace((unsigned char) input[size])) size++;
+    string_view word = input.substr(0, size);
+    input.remove_prefix(size);
+    return word;
+}
+
+// Returns the name of what 'session' needs, as sent in 'TURN'.
+static const char* getPromptName(SessionPrompt prompt) {
+    switch(prompt) {
+        case PROMPT_MOVE: return "MOVE";
+        case PROMPT_EXCHANGE_TWO: return "EXCHANGE2";
+        case PROMPT_EXCHANGE_ONE: return "EXCHANGE1";
+        case PROMPT_END_TURN: return "END";
+        default: return "OVER";
+    }
+}
+
+// Returns the letters of 'hand', without its empty slots.
+static string getHandLetters(const Hand &hand) {
+    string letters;
+    for(int slot = 0; slot < Hand::HAND_SIZE; slot++) {
+        char letter = hand.getSlot(slot);
+        if(letter >= 'A' && letter <= 'Z') letters += letter;
+    }
+    return letters;
+}
+
+GameServer::GameServer(const Board &board, unsigned int num_players, uint64_t seed):
+    board(board),
+    num_players(num_players),
+    seed(seed),
+    listen_fd(-1),
+    epoll_fd(-1),
+    games_started(0),
+    games_finished(0),
+    actions_applied(0)
+{}
+
+unsigned long GameServer::countFinishedGames() const {
+    return games_finished;
+}
+
+unsigned long GameServer::countActions() const {
+    return actions_applied;
+}
+
+#ifdef __linux__
+
+GameServer::~GameServer() {
+    for(auto &entry: clients) close(entry.first);
+    if(listen_fd >= 0) close(listen_fd);
+    if(epoll_fd >= 0) close(epoll_fd);
+}
+
+bool GameServer::open(const Endpoint &endpoint) {
+    listen_fd = endpoint.listen();
+    if(listen_fd < 0) return false;
+
+    epoll_fd = epoll_create1(0);
+    if(epoll_fd < 0) return false;
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = listen_fd;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) == 0;
+}
+
+bool GameServer::run(unsigned long max_games) {
+    epoll_event events[MAX_EVENTS];
+
+    while(max_games == 0 || games_finished < max_games) {
+        int count = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if(count < 0) {
+            if(errno == EINTR) continue;
+            return false;
+        }
+
+        for(int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+            if(fd == listen_fd) {
+                acceptClients();
+                continue;
+            }
+
+            auto found = clients.find(fd);
+            // The client may have been dropped by an earlier event.
+            if(found == clients.end()) continue;
+            Client &client = found->second;
+
+            bool alive = (events[i].events & (EPOLLERR | EPOLLHUP)) == 0;
+            if(alive && (events[i].events & EPOLLIN)) alive = receive(client);
+            if(alive && (events[i].events & EPOLLOUT)) alive = flush(client);
+            if(!alive) drop(fd);
+        }
+
+        // Requests of a client may send lines to every player of its game,
+        // so every output is sent once all events were handled.
+        vector<int> lost;
+        for(auto &entry: clients) {
+            if(!entry.second.output.empty() && !entry.second.watching_output && !flush(entry.second)) {
+                lost.push_back(entry.first);
+            }
+        }
+        for(int fd: lost) drop(fd);
+    }
+
+    return true;
+}
+
+void GameServer::acceptClients() {
+    while(true) {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if(fd < 0) return;
+
+        int no_delay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if(!Endpoint::setNonBlocking(fd) || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            continue;
+        }
+
+        Client &client = clients[fd];
+        client.fd = fd;
+        client.game_id = 0;
+        client.seat = 0;
+        client.playing = false;
+        client.waiting = false;
+        client.watching_output = false;
+    }
+}
+
+bool GameServer::receive(Client &client) {
+    char buffer[4096];
+    while(true) {
+        ssize_t size = recv(client.fd, buffer, sizeof(buffer), 0);
+        if(size == 0) return false;
+        if(size < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if(errno == EINTR) continue;
+            return false;
+        }
+        client.input.append(buffer, (size_t) size);
+
+        // Requests are handled as soon as they are received, so only the
+        // start of one is ever kept, and one too long drops the client
+        // before anything else is read.
+        size_t start = 0;
+        while(true) {
+            size_t end = client.input.find('\n', start);
+            if(end == string::npos) break;
+            string_view line(client.input.data() + start, end - start);
+            if(!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            handleRequest(client, line);
+            start = end + 1;
+        }
+        client.input.erase(0, start);
+        if(client.input.size() > MAX_REQUEST_SIZE) return false;
+    }
+
+    return true;
+}
+
+bool GameServer::flush(Client &client) {
+    while(!client.output.empty()) {
+        ssize_t size = send(client.fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+        if(size < 0) {
+            if(errno == EINTR) continue;
+            if(errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+        client.output.erase(0, (size_t) size);
+    }
+
+    // Only wait for the socket to be writable while there is something to send.
+    bool watch = !client.output.empty();
+    if(watch != client.watching_output) {
+        epoll_event event = {};
+        event.events = watch ? EPOLLIN | EPOLLOUT : EPOLLIN;
+        event.data.fd = client.fd;
+        if(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, client.fd, &event) != 0) return false;
+        client.watching_output = watch;
+    }
+    return true;
+}
+
+void GameServer::drop(int fd) {
+    auto found = clients.find(fd);
+    if(found == clients.end()) return;
+
+    Client &client = found->second;
+    if(client.waiting) waiting.erase(find(waiting.begin(), waiting.end(), fd));
+    if(client.playing) {
+        unsigned long game_id = client.game_id;
+        client.playing = false;
+        auto game = games.find(game_id);
+        if(game != games.end()) {
+            broadcast(game->second, "ABORT\n");
+            endGame(game_id);
+        }
+    }
+
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    clients.erase(found);
+}
+
+#else
+
+GameServer::~GameServer() {}
+
+bool GameServer::open(const Endpoint&) {
+    return false;
+}
+
+bool GameServer::run(unsigned long) {
+    return false;
+}
+
+void GameServer::acceptClients() {}
+
+bool GameServer::receive(Client&) {
+    return false;
+}
+
+bool GameServer::flush(Client&) {
+    return false;
+}
+
+void GameServer::drop(int) {}
+
+#endif
+
+void GameServer::handleRequest(Client &client, string_view line) {
+    string_view command = readWord(line);
+    string_view argument = readWord(line);
+    string_view unexpected = readWord(line);
+    if(!unexpected.empty()) {
+        client.output += "ERROR UNEXPECTED_ARGUMENT\n";
+        return;
+    }
+
+    if(command == "JOIN") {
+        if(client.playing || client.waiting) {
+            client.output += "ERROR ALREADY_JOINED\n";
+            return;
+        }
+        client.waiting = true;
+        waiting.push_back(client.fd);
+        client.output += "OK\n";
+        startGames();
+        return;
+    }
+
+    if(!client.playing) {
+        client.output += "ERROR NOT_PLAYING\n";
+        return;
+    }
+    HostedGame &game = games.at(client.game_id);
+    const GameState &state = game.session->getState();
+
+    if(command == "STATE") {
+        sendState(game, client.seat);
+        client.output += "OK\n";
+    } else if(command == "LEGAL") {
+        legal_actions.clear();
+        if(state.getCurrentPlayerIndex() == client.seat && !state.isOver()) state.getLegalActions(legal_actions);
+
+        client.output += "LEGAL";
+        for(const Action &action: legal_actions) {
+            if(action.getType() == ACTION_END_TURN) continue;
+            client.output += ' ';
+            if(action.getType() == ACTION_MOVE) {
+                client.output += Position::rowName(action.getPosition().getY());
+                client.output += Position::columnName(action.getPosition().getX());
+            } else {
+                client.output += action.getLetter1();
+                if(action.getType() == ACTION_EXCHANGE_TWO) client.output += action.getLetter2();
+            }
+        }
+        client.output += '\n';
+    } else if(command == "MOVE") {
+        Position position;
+        if(!Position::parse(argument, position)) {
+            client.output += "ERROR BAD_POSITION\n";
+            return;
+        }
+        play(client, Action::move(position));
+    } else if(command == "EXCHANGE") {
+        if(argument.size() == 1) {
+            play(client, Action::exchange(argument[0]));
+        } else if(argument.size() == 2) {
+            play(client, Action::exchange(argument[0], argument[1]));
+        } else {
+            client.output += "ERROR BAD_LETTERS\n";
+        }
+    } else if(command == "END") {
+        play(client, Action::endTurn());
+    } else {
+        client.output += "ERROR UNKNOWN_REQUEST\n";
+    }
+}
+
+void GameServer::startGames() {
+    while(waiting.size() >= num_players) {
+        unsigned long game_id = games_started++;
+        HostedGame &game = games[game_id];
+        Rng rng(seed, game_id);
+        game.session = make_unique<Session>(board, num_players, rng.split());
+        game.session->start();
+        game.seats.assign(waiting.begin(), waiting.begin() + num_players);
+        waiting.erase(waiting.begin(), waiting.begin() + num_players);
+
+        // Every player starts with the whole state, so only changes are sent from now on.
+        const GameState &state = game.session->getState();
+        for(const Player &player: state.getPlayers()) {
+            game.scores.push_back(player.getScore());
+            game.hands.push_back(getHandLetters(player.getHand()));
+        }
+        game.pool_size = (unsigned int) state.getPool().size();
+
+        for(unsigned int seat = 0; seat < num_players; seat++) {
+            Client &client = clients.at(game.seats[seat]);
+            client.waiting = false;
+            client.playing = true;
+            client.game_id = game_id;
+            client.seat = seat;
+
+            stringstream header;
+            header << "GAME " << game_id << ' ' << seat << ' ' << num_players << ' '
+                    << board.getWidth() << ' ' << board.getHeight() << '\n';
+            client.output += header.str();
+            sendState(game, seat);
+        }
+    }
+}
+
+void GameServer::play(Client &client, const Action &action) {
+    HostedGame &game = games.at(client.game_id);
+    Session &session = *game.session;
+    const GameState &state = session.getState();
+
+    if(state.getCurrentPlayerIndex() != client.seat) {
+        client.output += "ERROR NOT_YOUR_TURN\n";
+        return;
+    }
+
+    unsigned int player = state.getCurrentPlayerIndex();
+    ActionError error = session.submit(action);
+    if(error != ACTION_OK) {
+        client.output += "ERROR ";
+        client.output += getActionErrorName(error);
+        client.output += '\n';
+        return;
+    }
+    actions_applied++;
+
+    if(action.getType() == ACTION_MOVE) {
+        stringstream line;
+        line << "COVER " << player << ' ' << action.getPosition() << '\n';
+        broadcast(game, line.str());
+    }
+    sendUpdates(game);
+    client.output += "OK\n";
+
+    if(state.isOver()) {
+        stringstream line;
+        line << "OVER";
+        for(const Player &player: state.getPlayers()) line << ' ' << player.getScore();
+        line << '\n';
+        broadcast(game, line.str());
+        games_finished++;
+        endGame(client.game_id);
+    }
+}
+
+void GameServer::sendState(HostedGame &game, unsigned int seat) {
+    const GameState &state = game.session->getState();
+    const Board &board = state.getBoard();
+    const vector<Player> &players = state.getPlayers();
+    stringstream lines;
+
+    const vector<Position> &positions = board.getLetterPositions();
+    for(size_t i = 0; i < positions.size(); i++) {
+        const Cell &cell = board.getLetterCell((int) i);
+        lines << "CELL " << positions[i] << ' '
+                << (cell.isCovered() ? (char) tolower(cell.getLetter()) : cell.getLetter()) << '\n';
+    }
+
+    for(unsigned int i = 0; i < num_players; i++) lines << "SCORE " << i << ' ' << players[i].getScore() << '\n';
+    lines << "HAND " << getHandLetters(players[seat].getHand()) << '\n';
+    lines << "POOL " << state.getPool().size() << '\n';
+    lines << getTurnLine(game);
+
+    clients.at(game.seats[seat]).output += lines.str();
+}
+
+void GameServer::sendUpdates(HostedGame &game) {
+    const GameState &state = game.session->getState();
+    const vector<Player> &players = state.getPlayers();
+
+    for(unsigned int i = 0; i < num_players; i++) {
+        unsigned int score = players[i].getScore();
+        if(score != game.scores[i]) {
+            game.scores[i] = score;
+            broadcast(game, "SCORE " + to_string(i) + ' ' + to_string(score) + '\n');
+        }
+
+        string letters = getHandLetters(players[i].getHand());
+        if(letters != game.hands[i]) {
+            game.hands[i] = letters;
+            clients.at(game.seats[i]).output += "HAND " + letters + '\n';
+        }
+    }
+
+    unsigned int pool_size = (unsigned int) state.getPool().size();
+    if(pool_size != game.pool_size) {
+        game.pool_size = pool_size;
+        broadcast(game, "POOL " + to_string(pool_size) + '\n');
+    }
+
+    broadcast(game, getTurnLine(game));
+}
+
+string GameServer::getTurnLine(const HostedGame &game) {
+    const GameState &state = game.session->getState();
+    stringstream line;
+    line << "TURN " << game.session->countTurns() << ' ' << state.getCurrentPlayerIndex() << ' '
+            << state.getMovesLeft() << ' ' << getPromptName(game.session->getPrompt()) << '\n';
+    return line.str();
+}
+
+void GameServer::broadcast(const HostedGame &game, const string &line) {
+    for(int fd: game.seats) {
+        auto found = clients.find(fd);
+        if(found != clients.end()) found->second.output += line;
+    }
+}
+
+void GameServer::endGame(unsigned long game_id) {
+    auto found = games.find(game_id);
+    if(found == games.end()) return;
+
+    for(int fd: found->second.seats) {
+        auto client = clients.find(fd);
+        if(client != clients.end() && client->second.game_id == game_id) client->second.playing = false;
+    }
+    games.erase(found);
+}
@@ -0,0 +1,520 @@
+#include <algorithm>
+#include "gameState.h"
+
+using namespace std;
+
+const char* getActionErrorName(ActionError error) {
+    switch(error) {
+        case ACTION_OK: return "ACTION_OK";
+        case ACTION_NOT_ALLOWED_NOW: return "ACTION_NOT_ALLOWED_NOW";
+        case MOVE_OUT_OF_LIMITS: return "MOVE_OUT_OF_LIMITS";
+        case MOVE_EMPTY_CELL: return "MOVE_EMPTY_CELL";
+        case MOVE_ALREADY_COVERED: return "MOVE_ALREADY_COVERED";
+        case MOVE_NOT_COVERABLE: return "MOVE_NOT_COVERABLE";
+        case MOVE_LETTER_NOT_IN_HAND: return "MOVE_LETTER_NOT_IN_HAND";
+        case MOVE_WOULD_PLAY_ONCE: return "MOVE_WOULD_PLAY_ONCE";
+        case EXCHANGE_NOT_A_LETTER: return "EXCHANGE_NOT_A_LETTER";
+        case EXCHANGE_LETTER_NOT_IN_HAND: return "EXCHANGE_LETTER_NOT_IN_HAND";
+        case EXCHANGE_ONLY_ONE_IN_HAND: return "EXCHANGE_ONLY_ONE_IN_HAND";
+    }
+    return "UNKNOWN";
+}
+
+MoveUndo::MoveUndo(): hand_index(-1), letter(0) {}
+
+const BoardUndo& MoveUndo::getBoardUndo() const {
+    return board_undo;
+}
+
+int MoveUndo::countCompletedWords() const {
+    return board_undo.countCompletedWords();
+}
+
+TurnUndo::TurnUndo(): num_moves(0), player_index(0), moves_left(0) {}
+
+int TurnUndo::countCompletedWords() const {
+    int completed = 0;
+    for(int i = 0; i < num_moves; i++) completed += moves[i].countCompletedWords();
+    return completed;
+}
+
+GameState::GameState(const Board &board, unsigned int num_players, Rng rng):
+    board(board),
+    pool(board.getLettersInBoard()),
+    current_player_index(0),
+    moves_left(2),
+    rng(rng),
+    observer(nullptr)
+{
+    // Initialize players
+    for(unsigned int i = 1; i <= num_players; i++) {
+        players.push_back(Player(i));
+    }
+}
+
+void GameState::setObserver(GameObserver *observer) {
+    this->observer = observer;
+}
+
+Hand::SwapLetterAnimator GameState::getLetterDrawnCallback() {
+    if(!observer) return nullptr;
+
+    return [this](int index, char letter) {
+        observer->onLetterDrawn(*this, index, letter);
+    };
+}
+
+void GameState::dealHands() {
+    for(Player &player: players) {
+        player.getHand().refill(pool, rng);
+    }
+}
+
+const Board& GameState::getBoard() const {
+    return board;
+}
+
+const Pool& GameState::getPool() const {
+    return pool;
+}
+
+const vector<Player>& GameState::getPlayers() const {
+    return players;
+}
+
+const Player& GameState::getCurrentPlayer() const {
+    return players[current_player_index];
+}
+
+unsigned int GameState::getCurrentPlayerIndex() const {
+    return current_player_index;
+}
+
+unsigned int GameState::getMovesLeft() const {
+    return moves_left;
+}
+
+bool GameState::isOver() const {
+    // Game ends after covering all letters.
+    return board.isFullyCovered();
+}
+
+// Adds 'value' to an FNV-1a 'hash', one byte at a time.
+static void hashValue(uint64_t &hash, uint64_t value) {
+    for(int i = 0; i < 8; i++) {
+        hash ^= (value >> (8 * i)) & 0xFF;
+        hash *= 0x100000001B3ull;
+    }
+}
+
+uint64_t GameState::getChecksum() const {
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for(int i = 0; i < (int) board.countLetters(); i++) {
+        const Cell &cell = board.getLetterCell(i);
+        hashValue(hash, (cell.isCovered() ? 2 : 0) | (cell.isCoverable() ? 1 : 0));
+    }
+    for(char letter = 'A'; letter <= 'Z'; letter++) hashValue(hash, pool.countLetter(letter));
+    for(const Player &player: players) {
+        hashValue(hash, player.getScore());
+        for(int i = 0; i < Hand::HAND_SIZE; i++) hashValue(hash, (unsigned char) player.getHand().getSlot(i));
+    }
+    hashValue(hash, current_player_index);
+    hashValue(hash, moves_left);
+
+    uint64_t rng_state[Rng::STATE_SIZE];
+    rng.getState(rng_state);
+    for(uint64_t word: rng_state) hashValue(hash, word);
+
+    return hash;
+}
+
+TurnState GameState::getTurnState() const {
+    if(board.hasMove(getCurrentPlayer().getHand())) {
+        // Current player can move.
+        // Must always move if possible.
+        return MUST_MOVE;
+    } else if(moves_left == 1) {
+        // Current player can't move, but already moved once this turn.
+        // The second move is be skipped and turn is over.
+        return MUST_END_TURN;
+    } else if(pool.size() >= 2) {
+        // Current player hasn't moved this turn and can't move.
+        // Must exchange two letters with the pool.
+        return MUST_EXCHANGE_TWO;
+    } else if(pool.size() == 1) {
+        // Current player hasn't moved this turn and can't move.
+        // Pool only has one letter.
+        // Must exchange one letter with the pool.
+        return MUST_EXCHANGE_ONE;
+    } else {
+        // Current player hasn't moved this turn and can't move.
+        // Pool is empty.
+        // There is no choice but to skip the turn.
+        return MUST_SKIP_TURN;
+    }
+}
+
+bool GameState::mustPlayTwice(vector<Position> &legal_positions) const {
+    // Edge case only needs to be checked if player is playing their
+    // first move this turn.
+    if(moves_left != 2) return false;
+    return board.mustPlayTwiceEdgeCase(getCurrentPlayer().getHand(), legal_positions);
+}
+
+ActionError GameState::checkMove(Position position) const {
+    if(!position.inLimits(board.getWidth(), board.getHeight())) return MOVE_OUT_OF_LIMITS;
+
+    const Cell &cell = board.getCell(position);
+    if(cell.isEmpty()) return MOVE_EMPTY_CELL;
+    if(cell.isCovered()) return MOVE_ALREADY_COVERED;
+    if(!cell.isCoverable()) return MOVE_NOT_COVERABLE;
+    if(!getCurrentPlayer().getHand().hasLetter(cell.getLetter())) return MOVE_LETTER_NOT_IN_HAND;
+
+    // When the edge case is relevant, only some positions are legal.
+    vector<Position> legal_positions;
+    if(mustPlayTwice(legal_positions)) {
+        auto end = legal_positions.end();
+        if(find(legal_positions.begin(), end, position) == end) return MOVE_WOULD_PLAY_ONCE;
+    }
+
+    return ACTION_OK;
+}
+
+ActionError GameState::checkExchange(char letter) const {
+    if(getTurnState() != MUST_EXCHANGE_ONE) return ACTION_NOT_ALLOWED_NOW;
+    if(letter < 'A' || letter > 'Z') return EXCHANGE_NOT_A_LETTER;
+    if(!getCurrentPlayer().getHand().hasLetter(letter)) return EXCHANGE_LETTER_NOT_IN_HAND;
+
+    return ACTION_OK;
+}
+
+ActionError GameState::checkExchange(char letter1, char letter2) const {
+    if(getTurnState() != MUST_EXCHANGE_TWO) return ACTION_NOT_ALLOWED_NOW;
+    if(letter1 < 'A' || letter1 > 'Z' || letter2 < 'A' || letter2 > 'Z') return EXCHANGE_NOT_A_LETTER;
+
+    const Hand &hand = getCurrentPlayer().getHand();
+    if(!hand.hasLetter(letter1) || !hand.hasLetter(letter2)) return EXCHANGE_LETTER_NOT_IN_HAND;
+    // Same letter: player must have at least two of it.
+    if(letter1 == letter2 && hand.countLetter(letter1) < 2) return EXCHANGE_ONLY_ONE_IN_HAND;
+
+    return ACTION_OK;
+}
+
+ActionError GameState::checkAction(const Action &action) const {
+    switch(action.getType()) {
+        case ACTION_MOVE:
+            return checkMove(action.getPosition());
+        case ACTION_EXCHANGE_ONE:
+            return checkExchange(action.getLetter1());
+        case ACTION_EXCHANGE_TWO:
+            return checkExchange(action.getLetter1(), action.getLetter2());
+        default: {
+            TurnState turn_state = getTurnState();
+            if(turn_state != MUST_END_TURN && turn_state != MUST_SKIP_TURN) return ACTION_NOT_ALLOWED_NOW;
+            return ACTION_OK;
+        }
+    }
+}
+
+void GameState::getLegalActions(vector<Action> &actions) const {
+    TurnState turn_state = getTurnState();
+    const Hand &hand = getCurrentPlayer().getHand();
+
+    if(turn_state == MUST_MOVE) {
+        vector<Position> legal_positions;
+        if(mustPlayTwice(legal_positions)) {
+            // A 'Cell' may be listed once for each orientation.
+            for(size_t i = 0; i < legal_positions.size(); i++) {
+                auto begin = legal_positions.begin();
+                if(find(begin, begin + i, legal_positions[i]) == begin + i) {
+                    actions.push_back(Action::move(legal_positions[i]));
+                }
+            }
+            return;
+        }
+
+        const vector<Position> &letter_positions = board.getLetterPositions();
+        for(int i = 0; i < (int) letter_positions.size(); i++) {
+            const Cell &cell = board.getLetterCell(i);
+            if(cell.isCoverable() && hand.hasLetter(cell.getLetter())) {
+                actions.push_back(Action::move(letter_positions[i]));
+            }
+        }
+    } else if(turn_state == MUST_EXCHANGE_TWO) {
+        // Every pair of letters in 'hand', without repeating pairs.
+        for(char letter1 = 'A'; letter1 <= 'Z'; letter1++) {
+            if(!hand.hasLetter(letter1)) continue;
+            if(hand.countLetter(letter1) >= 2) actions.push_back(Action::exchange(letter1, letter1));
+
+            for(char letter2 = (char) (letter1 + 1); letter2 <= 'Z'; letter2++) {
+                if(hand.hasLetter(letter2)) actions.push_back(Action::exchange(letter1, letter2));
+            }
+        }
+    } else if(turn_state == MUST_EXCHANGE_ONE) {
+        for(char letter = 'A'; letter <= 'Z'; letter++) {
+            if(hand.hasLetter(letter)) actions.push_back(Action::exchange(letter));
+        }
+    } else {
+        actions.push_back(Action::endTurn());
+    }
+}
+
+void GameState::getLegalTurns(TurnList &turns) const {
+    turns.clear();
+    TurnState turn_state = getTurnState();
+    const Hand &hand = getCurrentPlayer().getHand();
+
+    if(turn_state == MUST_EXCHANGE_TWO) {
+        // Every pair of letters in 'hand', without repeating pairs.
+        for(char letter1 = 'A'; letter1 <= 'Z'; letter1++) {
+            if(!hand.hasLetter(letter1)) continue;
+            if(hand.countLetter(letter1) >= 2) turns.push(Turn::exchange(letter1, letter1));
+
+            for(char letter2 = (char) (letter1 + 1); letter2 <= 'Z'; letter2++) {
+                if(hand.hasLetter(letter2)) turns.push(Turn::exchange(letter1, letter2));
+            }
+        }
+        return;
+    } else if(turn_state == MUST_EXCHANGE_ONE) {
+        for(char letter = 'A'; letter <= 'Z'; letter++) {
+            if(hand.hasLetter(letter)) turns.push(Turn::exchange(letter));
+        }
+        return;
+    } else if(turn_state != MUST_MOVE) {
+        turns.push(Turn::end());
+        return;
+    }
+
+    // Every 'Cell' the current player can cover right now, as indices
+    // in 'letter_positions'.
+    vector<int> &first_moves = turns.first_moves;
+    first_moves.clear();
+
+    const vector<Position> &letter_positions = board.getLetterPositions();
+    for(int i = 0; i < (int) letter_positions.size(); i++) {
+        const Cell &cell = board.getLetterCell(i);
+        if(cell.isCoverable() && hand.hasLetter(cell.getLetter())) first_moves.push_back(i);
+    }
+    int num_first_moves = (int) first_moves.size();
+
+    if(moves_left == 1) {
+        // Only the second move is left.
+        for(int i = 0; i < num_first_moves; i++) turns.push(Turn::moveOnce(letter_positions[first_moves[i]]));
+        return;
+    }
+
+    for(int i = 0; i < num_first_moves; i++) {
+        Position first = letter_positions[first_moves[i]];
+        char first_letter = board.getLetterCell(first_moves[i]).getLetter();
+        // Whether the hand still has 'first_letter' after the first move.
+        bool has_first_letter_twice = hand.countLetter(first_letter) >= 2;
+
+        // Second move to a 'Cell' that was already coverable. Covering two
+        // such 'Cell's in either order leads to the same state, so each pair
+        // is only listed once (in the order they were found).
+        for(int j = i + 1; j < num_first_moves; j++) {
+            Position second = letter_positions[first_moves[j]];
+            char second_letter = board.getLetterCell(first_moves[j]).getLetter();
+            if(second_letter != first_letter || has_first_letter_twice) {
+                turns.push(Turn::moveTwice(first, second));
+            }
+        }
+
+        // Second move to a 'Cell' that only the first move unlocks.
+        Position unlocked[2];
+        int num_unlocked = board.getUnlockedBy(first, unlocked);
+        for(int k = 0; k < num_unlocked; k++) {
+            char second_letter = board.getCell(unlocked[k]).getLetter();
+            if(hand.hasLetter(second_letter) && (second_letter != first_letter || has_first_letter_twice)) {
+                turns.push(Turn::moveTwice(first, unlocked[k]));
+            }
+        }
+    }
+
+    // Players must move twice whenever possible. Only if no first move allows
+    // a second one can they move once.
+    if(!turns.isEmpty()) return;
+    for(int i = 0; i < num_first_moves; i++) turns.push(Turn::moveOnce(letter_positions[first_moves[i]]));
+}
+
+MoveUndo GameState::applyMove(Position position) {
+    MoveUndo undo = makeMove(position);
+
+    if(observer && undo.countCompletedWords() == 2) {
+        Word completed_words[2] = {board.findWord(position, Horizontal), board.findWord(position, Vertical)};
+        observer->onWordsCompleted(*this, completed_words, 2);
+    } else if(observer && undo.countCompletedWords() == 1) {
+        Orientation orientation = undo.board_undo.hasCompleted(Horizontal) ? Horizontal : Vertical;
+        Word completed_word = board.findWord(position, orientation);
+        observer->onWordsCompleted(*this, &completed_word, 1);
+    }
+
+    return undo;
+}
+
+MoveUndo GameState::makeMove(Position position) {
+    Player &current_player = players[current_player_index];
+    MoveUndo undo;
+
+    undo.board_undo = board.makeMove(position);
+    undo.letter = undo.board_undo.getLetter();
+    undo.hand_index = current_player.getHand().useLetter(undo.letter);
+
+    moves_left -= 1;
+    current_player.addScore((unsigned int) undo.countCompletedWords());
+    return undo;
+}
+
+void GameState::unmakeMove(const MoveUndo &undo) {
+    Player &current_player = players[current_player_index];
+
+    current_player.removeScore((unsigned int) undo.countCompletedWords());
+    moves_left += 1;
+
+    board.unmakeMove(undo.board_undo);
+    current_player.getHand().putLetter(undo.hand_index, undo.letter);
+}
+
+TurnUndo GameState::makeTurn(const Turn &turn) {
+    TurnUndo undo;
+    undo.player_index = current_player_index;
+    undo.moves_left = moves_left;
+
+    if(turn.getType() == TURN_MOVE_TWICE || turn.getType() == TURN_MOVE_ONCE) {
+        undo.moves[undo.num_moves++] = makeMove(turn.getFirst());
+    }
+    if(turn.getType() == TURN_MOVE_TWICE) {
+        undo.moves[undo.num_moves++] = makeMove(turn.getSecond());
+    }
+
+    moves_left = 2;
+    current_player_index++;
+    if(current_player_index == players.size()) current_player_index = 0;
+
+    return undo;
+}
+
+void GameState::unmakeTurn(const TurnUndo &undo) {
+    // The moves were made by the player who played the turn.
+    current_player_index = undo.player_index;
+    moves_left = undo.moves_left - undo.num_moves;
+
+    for(int i = undo.num_moves - 1; i >= 0; i--) unmakeMove(undo.moves[i]);
+}
+
+void GameState::applyExchange(char letter) {
+    if(observer) observer->onExchange(*this, &letter, 1);
+
+    Hand &hand = players[current_player_index].getHand();
+    hand.exchange(pool, rng, letter, getLetterDrawnCallback());
+}
+
+void GameState::applyExchange(char letter1, char letter2) {
+    if(observer) {
+        char letters[] = {letter1, letter2};
+        observer->onExchange(*this, letters, 2);
+    }
+
+    Hand &hand = players[current_player_index].getHand();
+    hand.exchange(pool, rng, letter1, letter2, getLetterDrawnCallback());
+}
+
+void GameState::endTurn() {
+    Hand &hand = players[current_player_index].getHand();
+
+    if(!hand.isFull() && !isOver()) {
+        // Player hand must be refilled.
+        bool pool_was_empty = pool.isEmpty();
+        if(observer) observer->onRefillStart(*this);
+
+        hand.refill(pool, rng, getLetterDrawnCallback());
+
+        if(observer && !pool_was_empty) observer->onRefillEnd(*this);
+    }
+
+    moves_left = 2;
+    current_player_index++;
+    if(current_player_index == players.size()) current_player_index = 0;
+}
+
+void GameState::applyTurn(const Turn &turn) {
+    switch(turn.getType()) {
+        case TURN_MOVE_TWICE:
+            applyMove(turn.getFirst());
+            applyMove(turn.getSecond());
+            break;
+        case TURN_MOVE_ONCE:
+            applyMove(turn.getFirst());
+            break;
+        case TURN_EXCHANGE_TWO:
+            applyExchange(turn.getLetter1(), turn.getLetter2());
+            break;
+        case TURN_EXCHANGE_ONE:
+            applyExchange(turn.getLetter1());
+            break;
+        case TURN_END:
+            break;
+    }
+
+    endTurn();
+}
+
+void GameState::applyAction(const Action &action) {
+    switch(action.getType()) {
+        case ACTION_MOVE:
+            applyMove(action.getPosition());
+            if(moves_left == 0) endTurn();
+            break;
+        case ACTION_EXCHANGE_ONE:
+            applyExchange(action.getLetter1());
+            endTurn();
+            break;
+        case ACTION_EXCHANGE_TWO:
+            applyExchange(action.getLetter1(), action.getLetter2());
+            endTurn();
+            break;
+        case ACTION_END_TURN:
+            endTurn();
+            break;
+    }
+}
+
+int GameState::drawLetter(unsigned int player_index, char letter, int slot) {
+    pool.takeLetter(letter);
+
+    Hand &hand = players[player_index].getHand();
+    if(slot < 0) return hand.addLetter(letter);
+    hand.putLetter(slot, letter);
+    return slot;
+}
+
+int GameState::returnLetter(unsigned int player_index, char letter, int slot) {
+    Hand &hand = players[player_index].getHand();
+    if(slot < 0) slot = hand.useLetter(letter);
+    else hand.clearSlot(slot);
+
+    pool.returnLetter(letter);
+    return slot;
+}
+
+void GameState::determinize(unsigned int viewer_index, Rng &rng) {
+    // Every letter the viewer can't see goes back to the 'Pool'...
+    int hand_sizes[MAX_PLAYERS] = {0};
+    for(unsigned int i = 0; i < players.size(); i++) {
+        if(i == viewer_index) continue;
+        Hand &hand = players[i].getHand();
+        hand_sizes[i] = hand.countLetters();
+        hand.returnLetters(pool);
+    }
+
+    // ... and the other 'Hand's are dealt again from it.
+    for(unsigned int i = 0; i < players.size(); i++) {
+        Hand &hand = players[i].getHand();
+        for(int slot = 0; slot < hand_sizes[i]; slot++) {
+            hand.putLetter(slot, pool.drawLetter(rng));
+        }
+    }
+
+    this->rng = rng.split();
+}
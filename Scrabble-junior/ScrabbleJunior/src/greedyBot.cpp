@@ -0,0 +1,77 @@
+#include "greedyBot.h"
+
+using namespace std;
+
+GreedyBot::GreedyBot(Rng rng, int time_budget_ms): Bot(true, time_budget_ms), rng(rng) {}
+
+const char* GreedyBot::getName() const {
+    return "greedy";
+}
+
+void GreedyBot::reset(Rng rng) {
+    this->rng = rng;
+}
+
+int GreedyBot::countMoves(const Board &board, const Hand &hand) {
+    // The 'Board' counts its coverable 'Cell's by letter, so only the
+    // letters both have are looked at, however many letters it has.
+    uint32_t letters = board.getCoverableMask() & hand.getLetterMask();
+    int moves = 0;
+    for(char letter = 'A'; letters != 0; letter++, letters >>= 1) {
+        if(letters & 1) moves += (int) board.countCoverable(letter);
+    }
+    return moves;
+}
+
+Turn GreedyBot::decideTurn(GameState &state, const TurnList &turns) {
+    // Exchanges and skips can't be compared without knowing the pool.
+    if(turns[0].countMoves() == 0) return turns[(int) rng.below((uint32_t) turns.size())];
+
+    int best_score = -1, best_moves = -1;
+    int best_index = 0;
+    // Number of turns tied with the best so far, to choose
+    // uniformly between them (reservoir sampling).
+    uint32_t ties = 0;
+    const Hand &hand = state.getCurrentPlayer().getHand();
+
+    // Turns with the same first move are listed together, so the first
+    // move is only made again when it changes.
+    bool first_made = false;
+    Position first;
+    MoveUndo first_undo;
+    for(int i = 0; i < turns.size(); i++) {
+        const Turn &turn = turns[i];
+        if(first_made && !(turn.getFirst() == first)) {
+            state.unmakeMove(first_undo);
+            first_made = false;
+        }
+        if(!first_made) {
+            first = turn.getFirst();
+            first_undo = state.makeMove(first);
+            first_made = true;
+        }
+
+        int score = first_undo.countCompletedWords(), moves;
+        if(turn.getType() == TURN_MOVE_TWICE) {
+            MoveUndo second_undo = state.makeMove(turn.getSecond());
+            score += second_undo.countCompletedWords();
+            moves = countMoves(state.getBoard(), hand);
+            state.unmakeMove(second_undo);
+        } else {
+            moves = countMoves(state.getBoard(), hand);
+        }
+
+        if(score > best_score || (score == best_score && moves > best_moves)) {
+            best_score = score;
+            best_moves = moves;
+            best_index = i;
+            ties = 1;
+        } else if(score == best_score && moves == best_moves) {
+            ties++;
+            if(rng.below(ties) == 0) best_index = i;
+        }
+    }
+    if(first_made) state.unmakeMove(first_undo);
+
+    return turns[best_index];
+}
@@ -1,44 +1,71 @@
 #include <iterator>
 #include <algorithm>
 #include "hand.h"
+#include "profiler.h"
 
 // As an implementation detail, an empty slot is
 // represented by an underscore ('_'). This is
 // convenient to overload 'operator<<'.
 const char Hand::EMPTY = '_';
 
-Hand::Hand() {
+uint32_t Hand::letterBit(char letter) {
+    if(letter < 'A' || letter > 'Z') return 0;
+    return (uint32_t) 1 << (letter - 'A');
+}
+
+Hand::Hand(): letter_mask(0) {
     std::fill(std::begin(hand), std::end(hand), EMPTY);
+    std::fill(std::begin(letter_count), std::end(letter_count), 0);
 }
 
 int Hand::indexOf(char *element) const {
     return (int) (element - std::begin(hand));
 }
 
+void Hand::setSlot(char *element, char letter) {
+    char old_letter = *element;
+    if(old_letter != EMPTY) {
+        // Last instance of the old letter clears its bit.
+        if(--letter_count[old_letter - 'A'] == 0) letter_mask &= ~letterBit(old_letter);
+    }
+
+    *element = letter;
+    if(letter != EMPTY) {
+        letter_count[letter - 'A'] += 1;
+        letter_mask |= letterBit(letter);
+    }
+}
+
 bool Hand::isFull() const {
     // 'Hand' is full if it is not possible to find an empty slot.
     return std::find(std::begin(hand), std::end(hand), EMPTY) == std::end(hand);
 }
 
-void Hand::refill(Pool &pool, SwapLetterAnimator swap_hand) {
+void Hand::refill(Pool &pool, Rng &rng, SwapLetterAnimator swap_hand) {
+    PROFILE_SCOPE("Hand::refill");
     for(auto &letter: hand) {
         // Refill must stop as soon as the 'Pool' is empty
         if(pool.isEmpty()) break;
-        
+
         if(letter == EMPTY) {
-            letter = pool.popLetter();
+            setSlot(&letter, pool.drawLetter(rng));
             if(swap_hand) swap_hand(indexOf(&letter), letter);
         }
     }
 }
 
-void Hand::exchange(Pool &pool, char letter, SwapLetterAnimator swap_hand) {
+void Hand::exchange(Pool &pool, Rng &rng, char letter, SwapLetterAnimator swap_hand) {
     char *element = std::find(std::begin(hand), std::end(hand), letter);
-    pool.exchange(element);
+
+    // Exchange a copy of the slot, so counts are updated by 'setSlot'.
+    char new_letter = *element;
+    pool.exchange(&new_letter, rng);
+    setSlot(element, new_letter);
+
     if(swap_hand) swap_hand(indexOf(element), *element);
 }
 
-void Hand::exchange(Pool &pool, char letter1, char letter2, SwapLetterAnimator swap_hand) {
+void Hand::exchange(Pool &pool, Rng &rng, char letter1, char letter2, SwapLetterAnimator swap_hand) {
     char *element1, *element2;
     element1 = std::find(std::begin(hand), std::end(hand), letter1);
 
@@ -53,30 +80,73 @@ void Hand::exchange(Pool &pool, char letter1, char letter2, SwapLetterAnimator s
         element2 = std::find(std::begin(hand), std::end(hand), letter2);
     }
 
-    pool.exchange(element1, element2);
+    // Exchange copies of the slots, so counts are updated by 'setSlot'.
+    char new_letter1 = *element1, new_letter2 = *element2;
+    pool.exchange(&new_letter1, &new_letter2, rng);
+    setSlot(element1, new_letter1);
+    setSlot(element2, new_letter2);
+
     if(swap_hand) {
-        swap_hand((int) (element1 - std::begin(hand)), *element1);
-        swap_hand((int) (element2 - std::begin(hand)), *element2);
+        swap_hand(indexOf(element1), *element1);
+        swap_hand(indexOf(element2), *element2);
     }
 }
 
 bool Hand::hasLetter(char letter) const {
-    return std::find(std::begin(hand), std::end(hand), letter) != std::end(hand);
+    return (letter_mask & letterBit(letter)) != 0;
+}
+
+uint32_t Hand::getLetterMask() const {
+    return letter_mask;
+}
+
+char Hand::getSlot(int index) const {
+    return hand[index];
 }
 
 int Hand::countLetter(char letter) const {
-    return (int) std::count(std::begin(hand), std::end(hand), letter);
+    if(!letterBit(letter)) return 0;
+    return letter_count[letter - 'A'];
 }
 
-void Hand::useLetter(char letter) {
+int Hand::useLetter(char letter) {
+    if(!hasLetter(letter)) return -1;
     char *l = std::find(std::begin(hand), std::end(hand), letter);
-    if(l != std::end(hand)) *l = EMPTY;
+    setSlot(l, EMPTY);
+    return indexOf(l);
+}
+
+void Hand::putLetter(int index, char letter) {
+    setSlot(&hand[index], letter);
+}
+
+int Hand::addLetter(char letter) {
+    char *slot = std::find(std::begin(hand), std::end(hand), EMPTY);
+    if(slot == std::end(hand)) return -1;
+    setSlot(slot, letter);
+    return indexOf(slot);
+}
+
+void Hand::clearSlot(int index) {
+    setSlot(&hand[index], EMPTY);
+}
+
+int Hand::countLetters() const {
+    return HAND_SIZE - (int) std::count(std::begin(hand), std::end(hand), EMPTY);
+}
+
+void Hand::returnLetters(Pool &pool) {
+    for(auto &letter: hand) {
+        if(letter == EMPTY) continue;
+        pool.returnLetter(letter);
+        setSlot(&letter, EMPTY);
+    }
 }
 
 std::ostream& operator<<(std::ostream& out, const Hand& hand) {
     for(char letter: hand.hand) {
         out << letter << " ";
     }
-    
+
     return out;
 }
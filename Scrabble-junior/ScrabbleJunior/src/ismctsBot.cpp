@@ -0,0 +1,250 @@
+#include <cmath>
+#include <thread>
+#include <algorithm>
+#include "ismctsBot.h"
+
+using namespace std;
+
+// Weight of exploration in the choice of a child (UCB1).
+const double EXPLORATION = 0.7;
+// How many random turns are played after leaving the tree. Short playouts
+// are much cheaper on big boards, and the score is already a good guide.
+const int PLAYOUT_TURNS = 8;
+
+// Returns a hash of 'turn', the same for every 'Turn' equal to it.
+static uint64_t hashTurn(const Turn &turn) {
+    // Coordinates are below 'Board::MAX_SIZE', which fits in 15 bits.
+    uint64_t key = turn.getType();
+    switch(turn.getType()) {
+        case TURN_MOVE_TWICE:
+            key = key << 30 | (uint64_t) turn.getSecond().getX() << 15 | (uint64_t) turn.getSecond().getY();
+            key = key << 30 | (uint64_t) turn.getFirst().getX() << 15 | (uint64_t) turn.getFirst().getY();
+            break;
+        case TURN_MOVE_ONCE:
+            key = key << 30 | (uint64_t) turn.getFirst().getX() << 15 | (uint64_t) turn.getFirst().getY();
+            break;
+        case TURN_EXCHANGE_TWO:
+            key = key << 16 | (uint64_t) (unsigned char) turn.getLetter1() << 8 | (unsigned char) turn.getLetter2();
+            break;
+        case TURN_EXCHANGE_ONE:
+            key = key << 8 | (unsigned char) turn.getLetter1();
+            break;
+        default:
+            break;
+    }
+    // Spreads the key over the high bits, which pick the slot.
+    return key * 0x9E3779B97F4A7C15ull;
+}
+
+IsmctsBot::IsmctsBot(Rng rng, int time_budget_ms, unsigned int num_threads, int nodes_per_thread):
+    Bot(true, time_budget_ms),
+    rng(rng)
+{
+    if(num_threads == 0) num_threads = max(1u, thread::hardware_concurrency());
+
+    visits.reserve(TurnList::RESERVED_TURNS);
+    workers.resize(num_threads);
+    for(Worker &worker: workers) {
+        worker.arena.resize(nodes_per_thread);
+        worker.num_nodes = 0;
+        worker.rng = this->rng.split();
+        worker.iterations = 0;
+    }
+}
+
+const char* IsmctsBot::getName() const {
+    return "ismcts";
+}
+
+void IsmctsBot::reset(Rng rng) {
+    this->rng = rng;
+    for(Worker &worker: workers) worker.rng = this->rng.split();
+}
+
+unsigned long IsmctsBot::getLastIterations() const {
+    unsigned long iterations = 0;
+    for(const Worker &worker: workers) iterations += worker.iterations;
+    return iterations;
+}
+
+void IsmctsBot::copyState(unique_ptr<GameState> &copy, const GameState &source) {
+    if(copy) *copy = source;
+    else copy.reset(new GameState(source));
+}
+
+int IsmctsBot::addNode(Worker &worker, int parent, const Turn &turn, unsigned int player_index) {
+    if(worker.num_nodes == (int) worker.arena.size()) return -1;
+
+    int index = worker.num_nodes++;
+    Node &node = worker.arena[index];
+    node.turn = turn;
+    node.player_index = player_index;
+    node.parent = parent;
+    node.first_child = -1;
+    node.visits = 0;
+    node.availability = 0;
+    node.reward = 0;
+
+    if(parent >= 0) {
+        node.next_sibling = worker.arena[parent].first_child;
+        worker.arena[parent].first_child = index;
+    } else {
+        node.next_sibling = -1;
+    }
+
+    return index;
+}
+
+void IsmctsBot::indexChildren(Worker &worker, int node) {
+    const vector<Node> &arena = worker.arena;
+    int num_children = 0;
+    for(int child = arena[node].first_child; child >= 0; child = arena[child].next_sibling) num_children++;
+
+    // At most half full, so the chains of slots stay short.
+    size_t size = 16;
+    while(size < 2 * (size_t) num_children) size *= 2;
+    worker.children_by_turn.assign(size, -1);
+
+    size_t mask = size - 1;
+    for(int child = arena[node].first_child; child >= 0; child = arena[child].next_sibling) {
+        size_t slot = hashTurn(arena[child].turn) >> 32 & mask;
+        while(worker.children_by_turn[slot] >= 0) slot = (slot + 1) & mask;
+        worker.children_by_turn[slot] = child;
+    }
+}
+
+int IsmctsBot::findChild(const Worker &worker, const Turn &turn) {
+    size_t mask = worker.children_by_turn.size() - 1;
+    for(size_t slot = hashTurn(turn) >> 32 & mask; worker.children_by_turn[slot] >= 0; slot = (slot + 1) & mask) {
+        int child = worker.children_by_turn[slot];
+        if(worker.arena[child].turn == turn) return child;
+    }
+    return -1;
+}
+
+void IsmctsBot::iterate(Worker &worker, GameState &state) {
+    vector<Node> &arena = worker.arena;
+    TurnList &turns = worker.turns;
+    vector<int> &turn_children = worker.turn_children;
+    int current = 0;
+
+    // Selection and expansion: descend through the turns legal in this guess.
+    while(!state.isOver()) {
+        state.getLegalTurns(turns);
+        unsigned int player_index = state.getCurrentPlayerIndex();
+        indexChildren(worker, current);
+
+        // Every child legal in this guess was available to be chosen.
+        int best = -1;
+        int num_untried = 0;
+        turn_children.resize(turns.size());
+        for(int i = 0; i < turns.size(); i++) {
+            int child = findChild(worker, turns[i]);
+            turn_children[i] = child;
+            if(child < 0) { num_untried++; continue; }
+
+            Node &node = arena[child];
+            node.availability++;
+            if(best < 0) { best = child; continue; }
+
+            double value = node.reward / node.visits
+                    + EXPLORATION * sqrt(log((double) node.availability) / node.visits);
+            const Node &best_node = arena[best];
+            double best_value = best_node.reward / best_node.visits
+                    + EXPLORATION * sqrt(log((double) best_node.availability) / best_node.visits);
+            if(value > best_value) best = child;
+        }
+
+        if(num_untried > 0) {
+            // Some legal turn has no node yet: try one of them at random.
+            int untried = (int) worker.rng.below((uint32_t) num_untried);
+            int i = 0;
+            while(turn_children[i] >= 0 || untried-- > 0) i++;
+
+            // With the arena full the tree can't grow, so the playout starts
+            // from 'current', which is then the last node rewarded.
+            int child = addNode(worker, current, turns[i], player_index);
+            if(child < 0) break;
+
+            arena[child].availability = 1;
+            state.applyTurn(turns[i]);
+            current = child;
+            break;
+        }
+
+        state.applyTurn(arena[best].turn);
+        current = best;
+    }
+
+    // Simulation: a few random turns.
+    for(int i = 0; i < PLAYOUT_TURNS && !state.isOver(); i++) {
+        state.getLegalTurns(turns);
+        state.applyTurn(turns[(int) worker.rng.below((uint32_t) turns.size())]);
+    }
+
+    // Each player is rewarded by their lead over the average of the others,
+    // relative to every point scored: 0.5 when even, and 1 when they scored
+    // every point (with two players, 0 when the other one did).
+    const vector<Player> &players = state.getPlayers();
+    double total_score = 0;
+    for(const Player &player: players) total_score += player.getScore();
+
+    // Backpropagation: each node is rewarded for the player who chose it.
+    for(int node = current; node >= 0; node = arena[node].parent) {
+        double score = players[arena[node].player_index].getScore();
+        double others_score = (total_score - score) / (players.size() - 1);
+
+        arena[node].visits++;
+        if(total_score == 0) arena[node].reward += 0.5;
+        else arena[node].reward += 0.5 + (score - others_score) / (2 * total_score);
+    }
+}
+
+void IsmctsBot::search(Worker &worker, const GameState &root_state, unsigned int viewer_index,
+        chrono::steady_clock::time_point deadline)
+{
+    worker.num_nodes = 0;
+    worker.iterations = 0;
+    addNode(worker, -1, Turn::end(), viewer_index);
+
+    // The state is assigned from 'root_state' every iteration, which reuses its memory.
+    do {
+        copyState(worker.state, root_state);
+        worker.state->determinize(viewer_index, worker.rng);
+        iterate(worker, *worker.state);
+        worker.iterations++;
+    } while(chrono::steady_clock::now() < deadline);
+}
+
+Turn IsmctsBot::decideTurn(GameState &state, const TurnList &turns) {
+    if(turns.size() == 1) return turns[0];
+
+    // Searches never tell the observer of the real game.
+    copyState(root_state, state);
+    root_state->setObserver(nullptr);
+    unsigned int viewer_index = state.getCurrentPlayerIndex();
+    auto deadline = getDeadline();
+
+    vector<thread> threads;
+    for(size_t i = 1; i < workers.size(); i++) {
+        threads.emplace_back(search, ref(workers[i]), cref(*root_state), viewer_index, deadline);
+    }
+    search(workers[0], *root_state, viewer_index, deadline);
+    for(thread &t: threads) t.join();
+
+    // Play the turn visited the most, over every tree.
+    visits.assign(turns.size(), 0);
+    for(Worker &worker: workers) {
+        indexChildren(worker, 0);
+        for(int i = 0; i < turns.size(); i++) {
+            int child = findChild(worker, turns[i]);
+            if(child >= 0) visits[i] += worker.arena[child].visits;
+        }
+    }
+
+    int best_index = (int) rng.below((uint32_t) turns.size());
+    for(int i = 0; i < turns.size(); i++) {
+        if(visits[i] > visits[best_index]) best_index = i;
+    }
+    return turns[best_index];
+}
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <sstream>
+#include "journal.h"
+#include "snapshot.h"
+#include "binaryIo.h"
+
+using namespace std;
+
+// First bytes of every journal: "SJJ" and the version of the format.
+static const char MAGIC[4] = {'S', 'J', 'J', 2};
+// Bytes of each coordinate of a move in the current version. Version 1
+// had a single byte, which only fits boards of up to 256 by 256.
+static const int COORDINATE_BYTES = 2;
+// Record that ends a finished game, followed by the final checksum.
+// Other records are the 'ActionType' of an 'Action'.
+static const unsigned char FINISHED_RECORD = 0xFF;
+
+uint64_t Journal::hashFile(istream &file) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    char buffer[4096];
+    while(file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        for(streamsize i = 0; i < file.gcount(); i++) {
+            hash ^= (unsigned char) buffer[i];
+            hash *= 0x100000001B3ull;
+        }
+    }
+    return hash;
+}
+
+Journal::Journal(): board_hash(0), num_players(0), finished(false), final_checksum(0) {
+    fill(begin(rng_state), end(rng_state), 0);
+}
+
+Journal::Journal(const string &board_name, uint64_t board_hash, unsigned int num_players, const Rng &rng):
+    board_name(board_name),
+    board_hash(board_hash),
+    num_players(num_players),
+    finished(false),
+    final_checksum(0)
+{
+    rng.getState(rng_state);
+}
+
+void Journal::record(const Action &action) {
+    actions.push_back(action);
+}
+
+void Journal::forgetLast() {
+    actions.pop_back();
+}
+
+void Journal::truncate(size_t count) {
+    if(count < actions.size()) actions.resize(count);
+    finished = false;
+}
+
+void Journal::finish(const GameState &state) {
+    finished = true;
+    final_checksum = state.getChecksum();
+}
+
+const string& Journal::getBoardName() const {
+    return board_name;
+}
+
+uint64_t Journal::getBoardHash() const {
+    return board_hash;
+}
+
+unsigned int Journal::getNumPlayers() const {
+    return num_players;
+}
+
+Rng Journal::getRng() const {
+    Rng rng;
+    rng.setState(rng_state);
+    return rng;
+}
+
+const vector<Action>& Journal::getActions() const {
+    return actions;
+}
+
+bool Journal::isFinished() const {
+    return finished;
+}
+
+uint64_t Journal::getFinalChecksum() const {
+    return final_checksum;
+}
+
+bool Journal::save(ostream &out) const {
+    out.write(MAGIC, sizeof(MAGIC));
+    writeInt(out, board_name.size(), 2);
+    out << board_name;
+    writeInt(out, board_hash, 8);
+    writeInt(out, num_players, 1);
+    for(uint64_t word: rng_state) writeInt(out, word, 8);
+
+    for(const Action &action: actions) {
+        out.put((char) action.getType());
+        switch(action.getType()) {
+            case ACTION_MOVE:
+                writeInt(out, action.getPosition().getX(), COORDINATE_BYTES);
+                writeInt(out, action.getPosition().getY(), COORDINATE_BYTES);
+                break;
+            case ACTION_EXCHANGE_TWO:
+                out.put(action.getLetter1());
+                out.put(action.getLetter2());
+                break;
+            case ACTION_EXCHANGE_ONE:
+                out.put(action.getLetter1());
+                break;
+            case ACTION_END_TURN:
+                break;
+        }
+    }
+
+    if(finished) {
+        out.put((char) FINISHED_RECORD);
+        writeInt(out, final_checksum, 8);
+    }
+
+    out.flush();
+    return out.good();
+}
+
+bool Journal::saveAtomically(const string &name) const {
+    ostringstream out;
+    if(!save(out)) return false;
+    string bytes = out.str();
+    return Snapshot::writeFileAtomically(name, bytes.data(), bytes.size());
+}
+
+bool Journal::load(istream &in) {
+    // Journals of version 1 are still read.
+    char magic[sizeof(MAGIC)];
+    if(!in.read(magic, sizeof(magic)) || !equal(begin(magic), end(magic) - 1, begin(MAGIC))) return false;
+    char version = magic[sizeof(MAGIC) - 1];
+    if(version != 1 && version != MAGIC[sizeof(MAGIC) - 1]) return false;
+    int coordinate_bytes = version == 1 ? 1 : COORDINATE_BYTES;
+
+    board_name.assign(readInt(in, 2), ' ');
+    in.read(&board_name[0], (streamsize) board_name.size());
+    board_hash = readInt(in, 8);
+    num_players = (unsigned int) readInt(in, 1);
+    for(uint64_t &word: rng_state) word = readInt(in, 8);
+    if(!in || num_players < 2 || num_players > GameState::MAX_PLAYERS) return false;
+
+    actions.clear();
+    finished = false;
+    while(true) {
+        int record = in.get();
+        if(record == EOF) break;
+
+        if(record == FINISHED_RECORD) {
+            final_checksum = readInt(in, 8);
+            finished = true;
+            // Nothing may follow the end of the game.
+            return in.good() && in.peek() == EOF;
+        }
+
+        switch(record) {
+            case ACTION_MOVE: {
+                int x = (int) readInt(in, coordinate_bytes);
+                int y = (int) readInt(in, coordinate_bytes);
+                actions.push_back(Action::move(Position(x, y)));
+                break;
+            }
+            case ACTION_EXCHANGE_TWO: {
+                char letter1 = (char) in.get();
+                char letter2 = (char) in.get();
+                actions.push_back(Action::exchange(letter1, letter2));
+                break;
+            }
+            case ACTION_EXCHANGE_ONE:
+                actions.push_back(Action::exchange((char) in.get()));
+                break;
+            case ACTION_END_TURN:
+                actions.push_back(Action::endTurn());
+                break;
+            default:
+                return false;
+        }
+        if(!in) return false;
+    }
+
+    // A journal without its end is a game that wasn't finished.
+    return true;
+}
@@ -0,0 +1,229 @@
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include "jsonObject.h"
+
+using namespace std;
+
+// Removes the spaces at the start of 'input'.
+static void skipSpaces(string_view &input) {
+    while(!input.empty() && isspace((unsigned char) input.front())) input.remove_prefix(1);
+}
+
+// Reads a JSON string (starting at its opening quote) from 'input' to
+// 'value', removing it. Escapes of characters beyond ASCII become '?'.
+// Returns whether it was valid.
+static bool readString(string_view &input, string &value) {
+    value.clear();
+    if(input.empty() || input.front() != '"') return false;
+    input.remove_prefix(1);
+
+    while(!input.empty()) {
+        char c = input.front();
+        input.remove_prefix(1);
+        if(c == '"') return true;
+        if(c != '\\') {
+            value += c;
+            continue;
+        }
+
+        if(input.empty()) return false;
+        char escape = input.front();
+        input.remove_prefix(1);
+        switch(escape) {
+            case '"': case '\\': case '/': value += escape; break;
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'u': {
+                if(input.size() < 4) return false;
+                unsigned int code = 0;
+                for(int i = 0; i < 4; i++) {
+                    if(!isxdigit((unsigned char) input[i])) return false;
+                    code = code * 16 + (unsigned int) (isdigit((unsigned char) input[i])
+                            ? input[i] - '0' : tolower(input[i]) - 'a' + 10);
+                }
+                input.remove_prefix(4);
+                value += code < 0x80 ? (char) code : '?';
+                break;
+            }
+            default: return false;
+        }
+    }
+    return false;
+}
+
+// Returns whether 'text' is a number by the JSON grammar: an optional '-',
+// an integer part without leading zeros, an optional fraction and an
+// optional exponent, like '-12.5e+3'.
+static bool isNumber(string_view text) {
+    size_t i = 0;
+    auto skipDigits = [&text, &i]() {
+        size_t start = i;
+        while(i < text.size() && isdigit((unsigned char) text[i])) i++;
+        return i > start;
+    };
+
+    if(i < text.size() && text[i] == '-') i++;
+    if(i < text.size() && text[i] == '0') i++;
+    else if(!skipDigits()) return false;
+
+    if(i < text.size() && text[i] == '.') {
+        i++;
+        if(!skipDigits()) return false;
+    }
+    if(i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+        i++;
+        if(i < text.size() && (text[i] == '+' || text[i] == '-')) i++;
+        if(!skipDigits()) return false;
+    }
+    return i == text.size();
+}
+
+bool JsonObject::parse(string_view text, string &error) {
+    values.clear();
+    skipSpaces(text);
+    if(text.empty() || text.front() != '{') {
+        error = "Expected an object.";
+        return false;
+    }
+    text.remove_prefix(1);
+    skipSpaces(text);
+
+    bool first = true;
+    while(true) {
+        if(!text.empty() && text.front() == '}' && first) {
+            text.remove_prefix(1);
+            break;
+        }
+
+        string name;
+        if(!readString(text, name)) {
+            error = "Expected the name of a member.";
+            return false;
+        }
+        skipSpaces(text);
+        if(text.empty() || text.front() != ':') {
+            error = "Expected ':' after '" + name + "'.";
+            return false;
+        }
+        text.remove_prefix(1);
+        skipSpaces(text);
+
+        Value value;
+        value.is_string = !text.empty() && text.front() == '"';
+        if(value.is_string) {
+            if(!readString(text, value.text)) {
+                error = "Invalid string in '" + name + "'.";
+                return false;
+            }
+        } else {
+            // A number or a literal: everything up to the next separator.
+            size_t size = 0;
+            while(size < text.size() && text[size] != ',' && text[size] != '}' && !isspace((unsigned char) text[size])) {
+                size++;
+            }
+            value.text = string(text.substr(0, size));
+            text.remove_prefix(size);
+
+            // Values are written back as given (see 'writeValue'), so
+            // anything that isn't valid JSON must be refused here.
+            bool is_literal = value.text == "true" || value.text == "false" || value.text == "null";
+            if(!is_literal && !isNumber(value.text)) {
+                error = "Unsupported value in '" + name + "' (only strings, numbers, booleans and null).";
+                return false;
+            }
+        }
+        values[name] = value;
+
+        skipSpaces(text);
+        if(!text.empty() && text.front() == ',') {
+            text.remove_prefix(1);
+            skipSpaces(text);
+            first = false;
+            continue;
+        }
+        if(!text.empty() && text.front() == '}') {
+            text.remove_prefix(1);
+            break;
+        }
+        error = "Expected ',' or '}' after '" + name + "'.";
+        return false;
+    }
+
+    skipSpaces(text);
+    if(!text.empty()) {
+        error = "Unexpected text after the object.";
+        return false;
+    }
+    return true;
+}
+
+bool JsonObject::has(const string &name) const {
+    return values.count(name) != 0;
+}
+
+bool JsonObject::getString(const string &name, string &value) const {
+    auto found = values.find(name);
+    if(found == values.end() || !found->second.is_string) return false;
+    value = found->second.text;
+    return true;
+}
+
+bool JsonObject::getInt(const string &name, long long &value) const {
+    auto found = values.find(name);
+    if(found == values.end() || found->second.is_string) return false;
+
+    // Numbers were checked by 'parse', so only a fraction or an exponent
+    // makes them something else than an integer.
+    const string &text = found->second.text;
+    if(text.find_first_of(".eE") != string::npos) return false;
+    errno = 0;
+    char *end;
+    long long number = strtoll(text.c_str(), &end, 10);
+    if(errno == ERANGE || *end != '\0') return false;
+    value = number;
+    return true;
+}
+
+bool JsonObject::getNumber(const string &name, double &value) const {
+    auto found = values.find(name);
+    if(found == values.end() || found->second.is_string) return false;
+
+    const char *text = found->second.text.c_str();
+    char *end;
+    value = strtod(text, &end);
+    return end != text && *end == '\0';
+}
+
+void JsonObject::writeValue(ostream &out, const string &name) const {
+    auto found = values.find(name);
+    if(found == values.end()) out << "null";
+    else if(found->second.is_string) writeString(out, found->second.text);
+    else out << found->second.text;
+}
+
+void JsonObject::writeString(ostream &out, string_view text) {
+    out << '"';
+    for(char c: text) {
+        switch(c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if((unsigned char) c < 0x20) {
+                    char escape[8];
+                    snprintf(escape, sizeof(escape), "\\u%04x", (unsigned int) c);
+                    out << escape;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <iomanip>
+#include <cctype>
+#include "loadGenerator.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+// How long the games being played may take to end once time is up, in seconds.
+static const double GRACE_SECONDS = 10;
+// Most events handled by each wait of the event loop.
+static const int MAX_EVENTS = 256;
+
+// Reads the next word (up to a space) of 'input', removing it.
+// Returns an empty word if there is none.
+static string_view readWord(string_view &input) {
+    while(!input.empty() && isspace((unsigned char) input.front())) input.remove_prefix(1);
+    size_t size = 0;
+    while(size < input.size() && !isspace((unsigned char) input[size])) size++;
+    string_view word = input.substr(0, size);
+    input.remove_prefix(size);
+    return word;
+}
+
+// Returns the number at the start of 'word', or 0 if there is none.
+static unsigned long parseNumber(string_view word) {
+    unsigned long number = 0;
+    for(char c: word) {
+        if(c < '0' || c > '9') break;
+        number = number * 10 + (unsigned long) (c - '0');
+    }
+    return number;
+}
+
+LoadGenerator::LoadGenerator(const Endpoint &endpoint, unsigned int num_clients, Rng rng):
+    endpoint(endpoint),
+    num_clients(num_clients),
+    rng(rng),
+    epoll_fd(-1),
+    joining(true),
+    errors(0),
+    turns(0),
+    games(0),
+    aborted_games(0),
+    elapsed_seconds(0)
+{}
+
+const string& LoadGenerator::getError() const {
+    return error;
+}
+
+void LoadGenerator::request(Connection &connection, const string &request) {
+    connection.output += request;
+    connection.output += '\n';
+    connection.awaiting = true;
+    connection.sent_at = chrono::steady_clock::now();
+}
+
+void LoadGenerator::handleLine(Connection &connection, string_view line) {
+    string_view kind = readWord(line);
+
+    if(kind == "OK" || kind == "ERROR" || kind == "LEGAL") {
+        chrono::duration<double, micro> latency = chrono::steady_clock::now() - connection.sent_at;
+        latencies.push_back(latency.count());
+        connection.awaiting = false;
+        if(kind == "ERROR") errors++;
+        if(!connection.playing || !connection.my_turn) return;
+
+        if(kind != "LEGAL") {
+            request(connection, "LEGAL");
+            return;
+        }
+
+        // Play one of the legal actions at random.
+        vector<string_view> choices;
+        for(string_view word = readWord(line); !word.empty(); word = readWord(line)) choices.push_back(word);
+        if(connection.prompt == "END" || choices.empty()) {
+            request(connection, "END");
+            return;
+        }
+        string_view choice = choices[rng.below((uint32_t) choices.size())];
+        request(connection, (connection.prompt == "MOVE" ? "MOVE " : "EXCHANGE ") + string(choice));
+        return;
+    }
+
+    if(kind == "GAME") {
+        readWord(line);
+        connection.seat = (int) parseNumber(readWord(line));
+        connection.playing = true;
+        connection.my_turn = false;
+        connection.turn_number = 0;
+    } else if(kind == "TURN") {
+        unsigned long turn_number = parseNumber(readWord(line));
+        int player = (int) parseNumber(readWord(line));
+        readWord(line);
+        connection.prompt = string(readWord(line));
+        if(connection.seat == 0) turns += turn_number - connection.turn_number;
+        connection.turn_number = turn_number;
+
+        connection.my_turn = player == connection.seat && connection.prompt != "OVER";
+        if(connection.my_turn && !connection.awaiting) request(connection, "LEGAL");
+    } else if(kind == "OVER" || kind == "ABORT") {
+        if(connection.seat == 0) {
+            if(kind == "OVER") games++;
+            else aborted_games++;
+        }
+        connection.playing = false;
+        connection.my_turn = false;
+        if(joining && !connection.awaiting) request(connection, "JOIN");
+    }
+}
+
+void LoadGenerator::print(ostream &out) const {
+    vector<double> sorted = latencies;
+    sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double fraction) {
+        if(sorted.empty()) return 0.0;
+        return sorted[min(sorted.size() - 1, (size_t) (fraction * sorted.size()))];
+    };
+
+    out << fixed << setprecision(2);
+    out << num_clients << " clients played " << games << " games (" << turns << " turns) in "
+            << elapsed_seconds << " s: " << setprecision(0) << turns / max(elapsed_seconds, 1e-9)
+            << " turns/s." << endl;
+    if(aborted_games > 0) out << aborted_games << " games were aborted." << endl;
+    out << sorted.size() << " requests (" << errors << " errors), latency: p50 " << setprecision(1)
+            << percentile(0.5) << " us, p99 " << percentile(0.99) << " us, max "
+            << (sorted.empty() ? 0.0 : sorted.back()) << " us." << endl;
+}
+
+#ifdef __linux__
+
+LoadGenerator::~LoadGenerator() {
+    for(Connection &connection: connections) close(connection.fd);
+    if(epoll_fd >= 0) close(epoll_fd);
+}
+
+bool LoadGenerator::run(double seconds) {
+    epoll_fd = epoll_create1(0);
+    if(epoll_fd < 0) {
+        error = "Couldn't create the event loop.";
+        return false;
+    }
+
+    connections.resize(num_clients);
+    for(unsigned int i = 0; i < num_clients; i++) {
+        Connection &connection = connections[i];
+        connection.fd = endpoint.connect();
+        connection.seat = -1;
+        connection.playing = false;
+        connection.my_turn = false;
+        connection.turn_number = 0;
+        connection.awaiting = false;
+        connection.watching_output = false;
+        if(connection.fd < 0) {
+            connections.resize(i);
+            error = "Couldn't connect to " + endpoint.describe() + ".";
+            return false;
+        }
+
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u32 = i;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, connection.fd, &event);
+        request(connection, "JOIN");
+    }
+
+    auto start = chrono::steady_clock::now();
+    epoll_event events[MAX_EVENTS];
+    while(true) {
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        if(elapsed.count() >= seconds) joining = false;
+
+        // Once time is up, wait for the games being played to end.
+        bool busy = false;
+        for(const Connection &connection: connections) busy = busy || connection.playing || connection.awaiting;
+        if(!joining && !busy) {
+            elapsed_seconds = elapsed.count();
+            return true;
+        }
+        if(elapsed.count() >= seconds + GRACE_SECONDS) {
+            elapsed_seconds = elapsed.count();
+            error = "The games didn't end in time.";
+            return false;
+        }
+
+        for(Connection &connection: connections) {
+            if(!connection.output.empty() && !connection.watching_output && !flush(connection)) {
+                error = "Lost the connection to the server.";
+                return false;
+            }
+        }
+
+        int count = epoll_wait(epoll_fd, events, MAX_EVENTS, 100);
+        if(count < 0 && errno != EINTR) {
+            error = "The event loop failed.";
+            return false;
+        }
+
+        for(int i = 0; i < count; i++) {
+            Connection &connection = connections[events[i].data.u32];
+            bool alive = (events[i].events & (EPOLLERR | EPOLLHUP)) == 0;
+            if(alive && (events[i].events & EPOLLIN)) alive = receive(connection);
+            if(alive && (events[i].events & EPOLLOUT)) alive = flush(connection);
+            if(!alive) {
+                error = "Lost the connection to the server.";
+                return false;
+            }
+        }
+    }
+}
+
+bool LoadGenerator::receive(Connection &connection) {
+    char buffer[4096];
+    while(true) {
+        ssize_t size = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if(size == 0) return false;
+        if(size < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if(errno == EINTR) continue;
+            return false;
+        }
+        connection.input.append(buffer, (size_t) size);
+    }
+
+    size_t start = 0;
+    while(true) {
+        size_t end = connection.input.find('\n', start);
+        if(end == string::npos) break;
+        handleLine(connection, string_view(connection.input.data() + start, end - start));
+        start = end + 1;
+    }
+    connection.input.erase(0, start);
+    return true;
+}
+
+bool LoadGenerator::flush(Connection &connection) {
+    while(!connection.output.empty()) {
+        ssize_t size = send(connection.fd, connection.output.data(), connection.output.size(), MSG_NOSIGNAL);
+        if(size < 0) {
+            if(errno == EINTR) continue;
+            if(errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+        connection.output.erase(0, (size_t) size);
+    }
+
+    bool watch = !connection.output.empty();
+    if(watch != connection.watching_output) {
+        epoll_event event = {};
+        event.events = watch ? EPOLLIN | EPOLLOUT : EPOLLIN;
+        event.data.u32 = (uint32_t) (&connection - connections.data());
+        if(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event) != 0) return false;
+        connection.watching_output = watch;
+    }
+    return true;
+}
+
+#else
+
+LoadGenerator::~LoadGenerator() {}
+
+bool LoadGenerator::run(double) {
+    error = "The load generator is only available on Linux.";
+    return false;
+}
+
+bool LoadGenerator::receive(Connection&) {
+    return false;
+}
+
+bool LoadGenerator::flush(Connection&) {
+    return false;
+}
+
+#endif
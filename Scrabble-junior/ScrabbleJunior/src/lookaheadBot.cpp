@@ -0,0 +1,125 @@
+#include "lookaheadBot.h"
+#include "greedyBot.h"
+
+using namespace std;
+
+// How many nodes are visited between checks of the clock.
+const int NODES_PER_CHECK = 256;
+// How much each coverable 'Cell' the player has a letter for is worth,
+// relative to a completed word.
+const double MOBILITY_WEIGHT = 0.01;
+// How much words completed a turn later are worth. Other players may
+// complete them first, so words now are preferred to words later.
+const double FUTURE_DISCOUNT = 0.5;
+
+LookaheadBot::LookaheadBot(Rng rng, int max_depth, int time_budget_ms):
+    Bot(true, time_budget_ms),
+    rng(rng),
+    max_depth(max_depth),
+    timed_out(false),
+    nodes_since_check(0),
+    turn_lists(max_depth)
+{
+    values.reserve(TurnList::RESERVED_TURNS);
+}
+
+const char* LookaheadBot::getName() const {
+    return "lookahead";
+}
+
+void LookaheadBot::reset(Rng rng) {
+    this->rng = rng;
+}
+
+bool LookaheadBot::isTimeUp() {
+    if(timed_out) return true;
+    if(++nodes_since_check < NODES_PER_CHECK) return false;
+
+    nodes_since_check = 0;
+    timed_out = chrono::steady_clock::now() >= getDeadline();
+    return timed_out;
+}
+
+int LookaheadBot::passOthers(GameState &state, unsigned int player_index, TurnUndo *undos) {
+    int num_passes = 0;
+    while(state.getCurrentPlayerIndex() != player_index) {
+        undos[num_passes++] = state.makeTurn(Turn::end());
+    }
+    return num_passes;
+}
+
+double LookaheadBot::search(GameState &state, int depth) {
+    unsigned int player_index = state.getCurrentPlayerIndex();
+    const Player &player = state.getPlayers()[player_index];
+    double leaf_value = MOBILITY_WEIGHT * GreedyBot::countMoves(state.getBoard(), player.getHand());
+    if(depth == 0 || state.isOver() || isTimeUp()) return leaf_value;
+
+    TurnList &turns = turn_lists[depth - 1];
+    state.getLegalTurns(turns);
+    // Without moves, the hand would change in ways the search can't know.
+    if(turns.isEmpty() || turns[0].countMoves() == 0) return leaf_value;
+
+    double best = 0;
+    TurnUndo passes[3];
+    for(const Turn &turn: turns) {
+        TurnUndo undo = state.makeTurn(turn);
+        int num_passes = passOthers(state, player_index, passes);
+
+        double value = undo.countCompletedWords() + FUTURE_DISCOUNT * search(state, depth - 1);
+
+        while(num_passes > 0) state.unmakeTurn(passes[--num_passes]);
+        state.unmakeTurn(undo);
+
+        if(value > best) best = value;
+        if(timed_out) break;
+    }
+
+    return best;
+}
+
+Turn LookaheadBot::decideTurn(GameState &state, const TurnList &turns) {
+    if(turns.size() == 1 || turns[0].countMoves() == 0) {
+        return turns[(int) rng.below((uint32_t) turns.size())];
+    }
+
+    timed_out = false;
+    nodes_since_check = 0;
+
+    unsigned int player_index = state.getCurrentPlayerIndex();
+    int best_index = 0;
+    TurnUndo passes[3];
+    values.assign(turns.size(), 0);
+
+    // Deepen one turn at a time, keeping the choice of the deepest
+    // search that finished in time. The first search always finishes.
+    for(int depth = 0; depth < max_depth; depth++) {
+        for(int i = 0; i < turns.size(); i++) {
+            TurnUndo undo = state.makeTurn(turns[i]);
+            int num_passes = passOthers(state, player_index, passes);
+
+            values[i] = undo.countCompletedWords() + FUTURE_DISCOUNT * search(state, depth);
+
+            while(num_passes > 0) state.unmakeTurn(passes[--num_passes]);
+            state.unmakeTurn(undo);
+
+            if(timed_out && depth > 0) break;
+        }
+        if(timed_out && depth > 0) break;
+
+        // Choose uniformly between the best turns (reservoir sampling).
+        uint32_t ties = 0;
+        for(int i = 0; i < turns.size(); i++) {
+            if(values[i] > values[best_index] || ties == 0) {
+                best_index = i;
+                ties = 1;
+            } else if(values[i] == values[best_index]) {
+                ties++;
+                if(rng.below(ties) == 0) best_index = i;
+            }
+        }
+
+        if(timed_out) break;
+    }
+
+    return turns[best_index];
+}
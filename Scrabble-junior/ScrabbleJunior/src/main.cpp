@@ -2,15 +2,44 @@
 #include <fstream>
 #include <sstream>
 #include <string>
-#include <random>
+#include <iomanip>
+#include <cstdlib>
 #include <chrono>
 #include <cctype>
 #include <limits>
 #include <algorithm>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include <mutex>
 #include "board.h"
 #include "game.h"
+#include "session.h"
+#include "gameState.h"
 #include "gameDisplayer.h"
+#include "rng.h"
+#include "bot.h"
+#include "expectimaxSolver.h"
+#include "simulator.h"
+#include "tournament.h"
+#include "journal.h"
+#include "replayer.h"
+#include "snapshot.h"
+#include "positionEncoder.h"
+#include "datasetWriter.h"
+#include "datasetReader.h"
+#include "options.h"
+#include "engine.h"
+#include "endpoint.h"
+#include "gameServer.h"
+#include "loadGenerator.h"
+#include "boardGenerator.h"
+#include "benchmark.h"
+#include "differentialTester.h"
 #include "cmd.h"
+#include "profiler.h"
 
 using namespace std;
 
@@ -18,6 +47,10 @@ using namespace std;
 const Color TEXT_COLOR = GameDisplayer::TEXT_COLOR;
 const Color ERROR_COLOR = GameDisplayer::ERROR_COLOR;
 
+// The file where the game being played is saved at the end of every
+// turn, to be resumed if the program stops before it ends.
+const char *SNAPSHOT_FILE = "autosave.snapshot";
+
 // Helper function for `promptBoardName`.
 // Returns whether given 'char' can belong to a valid board name.
 bool isValidCharForBoardName(char c) {
@@ -54,29 +87,1120 @@ bool openBoardFile(ifstream &board_file, string &name) {
     return true;
 }
 
-// Try to read 'width' and 'height' from 'board_file', validating the values.
-// Returns whether it was successful.
-bool readBoardSize(unsigned int &width, unsigned int &height, ifstream &board_file) {
-    board_file >> height;
-    if(board_file.fail() || height == 0 || height > 20) {
+// Loads the board with 'name' (see 'openBoardFile'), explaining
+// what went wrong if it fails (in this case, returns 'nullptr').
+unique_ptr<Board> loadBoard(string &name) {
+    ifstream board_file;
+    if(!openBoardFile(board_file, name)) return nullptr;
+
+    string error;
+    unique_ptr<Board> board = Board::load(board_file, error);
+    if(board == nullptr) {
         setcolor(ERROR_COLOR);
-        cout << "Failed to parse height in given file." << endl;
-        return false;
+        cout << error << endl;
     }
+    return board;
+}
+
+// Returns the hash of the contents of the file 'name' (see 'Journal::hashFile'),
+// or 0 if it can't be opened.
+uint64_t hashBoardFile(const string &name) {
+    ifstream file(name, ios::binary);
+    if(!file.is_open()) return 0;
+    return Journal::hashFile(file);
+}
 
-    char _x; // Ignored
-    board_file >> _x;
+// Returns the name of a new journal file, named after the current time.
+string newJournalName() {
+    long long now = chrono::duration_cast<chrono::seconds>(
+            chrono::system_clock::now().time_since_epoch()).count();
+    return "game-" + to_string(now) + ".journal";
+}
+
+// Runs the expectimax mode: prints the expected score of each player on
+// the board given, with every player playing optimally. Returns the exit
+// code of the program.
+//
+// Usage: --expectimax [--players N] BOARD
+int runExpectimax(Options &options) {
+    int num_players = (int) options.getInt("players", 2, 2, GameState::MAX_PLAYERS);
+    const vector<string> &board_names = options.getPositional();
 
-    board_file >> width;
-    if(board_file.fail() || width == 0 || width > 20) {
+    if(!options.isValid()) {
         setcolor(ERROR_COLOR);
-        cout << "Failed to parse width in given file." << endl;
-        return false;
+        cout << options.getError() << endl;
+        return 1;
+    }
+    if(board_names.size() != 1) {
+        setcolor(ERROR_COLOR);
+        cout << "Must give one board to solve." << endl;
+        return 1;
+    }
+
+    string board_name = board_names[0];
+    unique_ptr<Board> board = loadBoard(board_name);
+    if(board == nullptr) return 1;
+
+    setcolor(TEXT_COLOR);
+    if(board->countLetters() < 7u * num_players) {
+        setcolor(ERROR_COLOR);
+        cout << "This board can't be played by " << num_players << " players." << endl;
+        return 1;
+    }
+    if(!ExpectimaxSolver::canSolve(*board, num_players)) {
+        setcolor(ERROR_COLOR);
+        cout << "This board is too big to be solved." << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    ExpectimaxSolver solver;
+    vector<double> expected_scores;
+    solver.solve(*board, num_players, expected_scores);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    cout << "Expected scores on '" << board_name << "' with optimal play:" << endl;
+    for(int i = 0; i < num_players; i++) {
+        cout << "  Player " << i+1 << ": " << fixed << setprecision(4) << expected_scores[i] << endl;
+    }
+    cout << "Solved " << solver.countPositions() << " positions in "
+            << setprecision(2) << elapsed.count() << " s." << endl;
+
+    if(solver.countRepeatedPositions() > 0) {
+        setcolor(ERROR_COLOR);
+        cout << "Positions repeated " << solver.countRepeatedPositions()
+                << " times, so the scores are not exact." << endl;
+    }
+
+    return 0;
+}
+
+// Returns the bot of each of 'num_players' seats, given the names in
+// 'names' (repeated from the start when there are fewer names than seats).
+// Returns an empty list, explaining why, if a name is unknown.
+vector<string> getSeatBots(const vector<string> &names, int num_players) {
+    vector<string> seats;
+    const vector<string> &known = getBotNames();
+    for(const string &name: names) {
+        if(find(known.begin(), known.end(), name) == known.end()) {
+            setcolor(ERROR_COLOR);
+            cout << "Unknown bot '" << name << "'." << endl;
+            return {};
+        }
+    }
+
+    for(int i = 0; i < num_players && !names.empty(); i++) seats.push_back(names[i % names.size()]);
+    return seats;
+}
+
+// Runs the simulation mode: plays many games between bots on each board
+// given, reporting how fair they are and how long their games are.
+// With '--export', the positions of the games are saved to a dataset
+// file (see 'DatasetWriter'). Returns the exit code of the program.
+//
+// Usage: --simulate [--games N] [--players N] [--bots NAME,...] [--seed N]
+//        [--threads N] [--budget MILLISECONDS] [--export FILE] BOARD...
+int runSimulate(Options &options) {
+    unsigned long num_games = (unsigned long) options.getInt("games", 1000, 1);
+    int num_players = (int) options.getInt("players", 2);
+    uint64_t seed = (uint64_t) options.getInt("seed", 0);
+    unsigned int num_threads = (unsigned int) options.getInt("threads", 0, 0);
+    int time_budget_ms = (int) options.getInt("budget", 20, 1, INT_MAX);
+    vector<string> bots = getSeatBots(options.getList("bots", {"greedy"}), num_players);
+    string export_name = options.getString("export");
+    const vector<string> &board_names = options.getPositional();
+
+    if(!options.isValid()) {
+        setcolor(ERROR_COLOR);
+        cout << options.getError() << endl;
+        return 1;
+    }
+    if(bots.empty()) return 1;
+    if(board_names.empty()) {
+        setcolor(ERROR_COLOR);
+        cout << "Must give at least one board to simulate." << endl;
+        return 1;
+    }
+    if(!export_name.empty() && board_names.size() != 1) {
+        setcolor(ERROR_COLOR);
+        cout << "Can only export the games of one board." << endl;
+        return 1;
+    }
+
+    for(string board_name: board_names) {
+        unique_ptr<Board> board = loadBoard(board_name);
+        if(board == nullptr) return 1;
+
+        setcolor(TEXT_COLOR);
+        if(num_players < 2 || num_players > (int) GameState::MAX_PLAYERS
+                || board->countLetters() < 7u * num_players) {
+            setcolor(ERROR_COLOR);
+            cout << "Board '" << board_name << "' can't be played by " << num_players << " players." << endl;
+            return 1;
+        }
+
+        cout << "Board '" << board_name << "', " << num_players << " players (";
+        for(size_t i = 0; i < bots.size(); i++) cout << (i == 0 ? "" : ", ") << bots[i];
+        cout << "), seed " << seed << endl;
+
+        PositionEncoder encoder(*board, num_players);
+        DatasetWriter exporter(encoder);
+        if(!export_name.empty() && !exporter.open(export_name)) {
+            setcolor(ERROR_COLOR);
+            cout << "Couldn't create '" << export_name << "'." << endl;
+            return 1;
+        }
+
+        auto start = chrono::steady_clock::now();
+        Simulator simulator(*board, num_players, bots, seed, time_budget_ms);
+        if(!export_name.empty()) simulator.setExporter(&exporter);
+        SimulationStats stats = simulator.run(num_games, num_threads);
+        if(!export_name.empty() && !exporter.close()) {
+            setcolor(ERROR_COLOR);
+            cout << "Couldn't write '" << export_name << "'." << endl;
+            return 1;
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        stats.print(cout);
+        cout << "Simulated in " << fixed << setprecision(2) << elapsed.count() << " s ("
+                << setprecision(0) << num_games / elapsed.count() << " games/s)." << endl;
+        if(!export_name.empty()) {
+            cout << "Exported " << exporter.countRecords() << " positions of " << encoder.getRecordSize()
+                    << " bytes to '" << export_name << "'." << endl;
+        }
+        cout << endl;
+    }
+
+    return 0;
+}
+
+// Runs the dataset mode: checks that every record of a dataset file
+// (see 'DatasetWriter') can be read, reports its size and shows the
+// record given by '--record'. Returns the exit code of the program.
+//
+// Usage: --dataset [--record N] FILE
+int runDataset(Options &options) {
+    long long record_index = options.getInt("record", 0, 0);
+    const vector<string> &names = options.getPositional();
+
+    if(!options.isValid()) {
+        setcolor(ERROR_COLOR);
+        cout << options.getError() << endl;
+        return 1;
+    }
+    if(names.size() != 1) {
+        setcolor(ERROR_COLOR);
+        cout << "Must give one dataset to read." << endl;
+        return 1;
+    }
+
+    DatasetReader reader;
+    if(!reader.open(names[0])) {
+        setcolor(ERROR_COLOR);
+        cout << "'" << names[0] << "' is not a valid dataset." << endl;
+        return 1;
+    }
+
+    const PositionEncoder &encoder = reader.getEncoder();
+    vector<uint8_t> record(encoder.getRecordSize());
+    auto start = chrono::steady_clock::now();
+    for(uint64_t i = 0; i < reader.countRecords(); i++) {
+        if(!reader.read(i, record.data())) {
+            setcolor(ERROR_COLOR);
+            cout << "Record " << i << " is damaged." << endl;
+            return 1;
+        }
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    ifstream file(names[0], ios::binary | ios::ate);
+    double file_size = (double) file.tellg();
+    double raw_size = (double) reader.countRecords() * encoder.getRecordSize();
+    setcolor(TEXT_COLOR);
+    cout << reader.countRecords() << " positions of " << encoder.getNumPlayers() << " players in "
+            << reader.countChunks() << " chunks, " << encoder.getRecordSize() << " bytes each." << endl;
+    cout << fixed << setprecision(2) << file_size / 1e6 << " MB (" << setprecision(1)
+            << (raw_size > 0 ? 100 * file_size / raw_size : 0) << "% of the records), read in "
+            << setprecision(3) << elapsed.count() << " s." << endl;
+
+    if(record_index < 0 || (uint64_t) record_index >= reader.countRecords()) return 0;
+    reader.read((uint64_t) record_index, record.data());
+    DecodedPosition position;
+    encoder.decode(record.data(), position);
+
+    const string &letters = encoder.getLetters();
+    cout << endl << "Record " << record_index << ": player " << position.current_player + 1 << " to play, "
+            << position.moves_left << " moves left." << endl << "Covered: ";
+    for(bool covered: position.covered) cout << (covered ? '1' : '0');
+    cout << endl << "Pool:";
+    for(size_t i = 0; i < letters.size(); i++) {
+        if(position.pool[i] > 0) cout << " " << letters[i] << "x" << position.pool[i];
+    }
+    cout << endl;
+    for(unsigned int player = 0; player < encoder.getNumPlayers(); player++) {
+        cout << "Player " << player + 1 << ": " << position.scores[player] << " points (final "
+                << position.final_scores[player] << "), hand";
+        for(size_t i = 0; i < letters.size(); i++) {
+            if(position.hands[player][i] > 0) cout << " " << letters[i] << "x" << position.hands[player][i];
+        }
+        cout << endl;
+    }
+    return 0;
+}
+
+// Runs the tournament mode: every bot plays every other on each board
+// given, with each number of players, and they are rated by the results.
+// Returns the exit code of the program.
+//
+// Usage: --tournament [--rounds N] [--players N,...] [--bots NAME,...]
+//        [--seed N] [--threads N] [--budget MILLISECONDS] BOARD...
+int runTournament(Options &options) {
+    unsigned long rounds = (unsigned long) options.getInt("rounds", 20, 1);
+    uint64_t seed = (uint64_t) options.getInt("seed", 0);
+    unsigned int num_threads = (unsigned int) options.getInt("threads", 0, 0);
+    int time_budget_ms = (int) options.getInt("budget", 20, 1, INT_MAX);
+    vector<string> bots = options.getList("bots", getBotNames());
+    const vector<string> &board_names = options.getPositional();
+
+    vector<unsigned int> player_counts;
+    for(const string &count: options.getList("players", {"2", "3", "4"})) {
+        int num_players = atoi(count.c_str());
+        if(num_players < 2 || num_players > (int) GameState::MAX_PLAYERS) {
+            setcolor(ERROR_COLOR);
+            cout << "Can't play with '" << count << "' players." << endl;
+            return 1;
+        }
+        player_counts.push_back((unsigned int) num_players);
+    }
+
+    if(!options.isValid()) {
+        setcolor(ERROR_COLOR);
+        cout << options.getError() << endl;
+        return 1;
     }
+    if(getSeatBots(bots, (int) bots.size()).empty()) return 1;
+    if(bots.size() < 2) {
+        setcolor(ERROR_COLOR);
+        cout << "Must give at least two bots to rate." << endl;
+        return 1;
+    }
+    if(board_names.empty()) {
+        setcolor(ERROR_COLOR);
+        cout << "Must give at least one board to play on." << endl;
+        return 1;
+    }
+
+    vector<unique_ptr<Board>> boards;
+    vector<const Board*> board_pointers;
+    for(string board_name: board_names) {
+        boards.push_back(loadBoard(board_name));
+        if(boards.back() == nullptr) return 1;
+        board_pointers.push_back(boards.back().get());
+    }
+
+    Tournament tournament(board_pointers, bots, player_counts, seed, time_budget_ms);
+    if(tournament.countGamesPerRound() == 0) {
+        setcolor(ERROR_COLOR);
+        cout << "The boards can't be played by that many players." << endl;
+        return 1;
+    }
+
+    setcolor(TEXT_COLOR);
+    cout << "Tournament between ";
+    for(size_t i = 0; i < bots.size(); i++) cout << (i == 0 ? "" : ", ") << bots[i];
+    cout << " on " << boards.size() << " boards, " << tournament.countGamesPerRound()
+            << " games per round, seed " << seed << endl;
+
+    tournament.run(rounds, num_threads);
+    tournament.print(cout);
+    return 0;
+}
+
+// Runs the sessions mode: plays '--games' games between bots at once on
+// a single thread, the way a server would drive the games of its clients.
+// Every game is a 'Session', and each of them in turn is fed a single
+// 'Action' of its current player before moving on to the next one.
+// Reports how many 'Action's are applied per second. Returns the exit
+// code of the program.
+//
+// Usage: --sessions [--games N] [--players N] [--bots NAME,...] [--seed N]
+//        [--budget MILLISECONDS] BOARD
+int runSessions(Options &options) {
+    unsigned long num_games = (unsigned long) options.getInt("games", 1000, 1);
+    int num_players = (int) options.getInt("players", 2);
+    uint64_t seed = (uint64_t) options.getInt("seed", 0);
+    int time_budget_ms = (int) options.getInt("budget", 20, 1, INT_MAX);
+    vector<string> bot_names = getSeatBots(options.getList("bots", {"greedy"}), num_players);
+    const vector<string> &board_names = options.getPositional();
+
+    if(!options.isValid()) {
+        setcolor(ERROR_COLOR);
+        cout << options.getError() << endl;
+        return 1;
+    }
+    if(bot_names.empty()) return 1;
+    if(board_names.size() != 1) {
+        setcolor(ERROR_COLOR);
+        cout << "Must give one board to play." << endl;
+        return 1;
+    }
+
+    string board_name = board_names[0];
+    unique_ptr<Board> board = loadBoard(board_name);
+    if(board == nullptr) return 1;
+    if(num_players < 2 || num_players > (int) GameState::MAX_PLAYERS || board->countLetters() < 7u * num_players) {
+        setcolor(ERROR_COLOR);
+        cout << "Board '" << board_name << "' can't be played by " << num_players << " players." << endl;
+        return 1;
+    }
+
+    // A game in progress, with the 'Action's of the turn its current
+    // player chose that haven't been fed to it yet.
+    struct PendingGame {
+        unique_ptr<Session> session;
+        Action actions[Turn::MAX_ACTIONS];
+        int num_actions;
+        int next_action;
+        unsigned long turn_number;
+    };
 
+    // Bots don't keep anything between turns, so every game shares them.
+    vector<unique_ptr<Bot>> bots;
+    for(int i = 0; i < num_players; i++) {
+        bots.push_back(createBot(bot_names[i], Rng(seed, num_games + i), time_budget_ms));
+    }
+
+    vector<PendingGame> games(num_games);
+    for(unsigned long i = 0; i < num_games; i++) {
+        Rng rng(seed, i);
+        games[i].session = make_unique<Session>(*board, num_players, rng.split());
+        games[i].session->start();
+        games[i].num_actions = 0;
+        games[i].next_action = 0;
+        games[i].turn_number = 0;
+    }
+
+    setcolor(TEXT_COLOR);
+    cout << "Board '" << board_name << "', " << num_players << " players (";
+    for(size_t i = 0; i < bot_names.size(); i++) cout << (i == 0 ? "" : ", ") << bot_names[i];
+    cout << "), seed " << seed << ", " << num_games << " games at once" << endl;
+
+    TurnList turns;
+    unsigned long total_actions = 0, total_turns = 0, games_left = num_games;
+    vector<unsigned long> total_scores(num_players, 0);
+    auto start = chrono::steady_clock::now();
+
+    while(games_left > 0) {
+        for(PendingGame &game: games) {
+            Session &session = *game.session;
+            if(session.getPrompt() == PROMPT_GAME_OVER) continue;
+
+            // Once its turn ends, a game needs the next turn of its new current player.
+            if(game.next_action == game.num_actions || session.countTurns() != game.turn_number) {
+                GameState &state = session.getState();
+                state.getLegalTurns(turns);
+                Turn turn = bots[state.getCurrentPlayerIndex()]->chooseTurn(state, turns);
+                game.num_actions = turn.getActions(game.actions);
+                game.next_action = 0;
+                game.turn_number = session.countTurns();
+            }
+
+            if(session.submit(game.actions[game.next_action++]) != ACTION_OK) {
+                setcolor(ERROR_COLOR);
+                cout << "A bot chose an illegal action." << endl;
+                return 1;
+            }
+            total_actions++;
+
+            if(session.getPrompt() == PROMPT_GAME_OVER) {
+                games_left--;
+                total_turns += session.countTurns();
+                const vector<Player> &players = session.getState().getPlayers();
+                for(int i = 0; i < num_players; i++) total_scores[i] += players[i].getScore();
+                game.session.reset();
+            }
+        }
+        games.erase(remove_if(games.begin(), games.end(),
+                [](const PendingGame &game) { return game.session == nullptr; }), games.end());
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    cout << "Average score:";
+    for(int i = 0; i < num_players; i++) {
+        cout << " " << fixed << setprecision(2) << (double) total_scores[i] / num_games;
+    }
+    cout << endl << "Played " << num_games << " games (" << total_turns << " turns, " << total_actions
+            << " actions) in " << setprecision(2) << elapsed.count() << " s on one thread ("
+            << setprecision(0) << total_actions / elapsed.count() << " actions/s)." << endl;
+    cout << "Each session takes " << sizeof(Session) << " bytes, plus its hands and the words of the board."
+            << endl;
+
+    return 0;
+}
+
+// Returns the endpoint given by '--socket PATH' or '--port N' (7777 by default).
+Endpoint getEndpoint(Options &options) {
+    if(options.has("socket")) return Endpoint(options.getString("socket"));
+    return Endpoint((int) options.getInt("port", 7777, 1, 65535));
+}
+
+// Runs the server mode: hosts games on the board given for players that
+// connect to it (see 'GameServer'), until '--games' games have ended
+// (forever if 0). Returns the exit code of the program.
+//
+// Usage: --serve [--port N | --socket PATH] [--players N] [--seed N] [--games N] BOARD
+int runServe(Options &options) {
+    Endpoint endpoint = getEndpoint(options);
+    int num_players = (int) options.getInt("players", 2);
+    uint64_t seed = (uint64_t) options.getInt("seed",
+            chrono::system_clock::now().time_since_epoch().count());
+    unsigned long max_games = (unsigned long) options.getInt("games", 0, 0);
+    const vector<string> &board_names = options.getPositional();
+
+    if(!options.isValid()) {
+        setcolor(ERROR_COLOR);
+        cout << options.getError() << endl;
+        return 1;
+    }
+    if(!Endpoint::isSupported()) {
+        setcolor(ERROR_COLOR);
+        cout << "The server is only available on Linux." << endl;
+        return 1;
+    }
+    if(board_names.size() != 1) {
+        setcolor(ERROR_COLOR);
+        cout << "Must give one board to play." << endl;
+        return 1;
+    }
+
+    string board_name = board_names[0];
+    unique_ptr<Board> board = loadBoard(board_name);
+    if(board == nullptr) return 1;
+    if(num_players < 2 || num_players > (int) GameState::MAX_PLAYERS || board->countLetters() < 7u * num_players) {
+        setcolor(ERROR_COLOR);
+        cout << "Board '" << board_name << "' can't be played by " << num_players << " players." << endl;
+        return 1;
+    }
+
+    GameServer server(*board, num_players, seed);
+    if(!server.open(endpoint)) {
+        setcolor(ERROR_COLOR);
+        cout << "Couldn't listen on " << endpoint.describe() << "." << endl;
+        return 1;
+    }
+
+    setcolor(TEXT_COLOR);
+    cout << "Serving games of " << num_players << " players on '" << board_name << "' at "
+            << endpoint.describe() << ", seed " << seed << "." << endl;
+    auto start = chrono::steady_clock::now();
+    if(!server.run(max_games)) {
+        setcolor(ERROR_COLOR);
+        cout << "The event loop failed." << endl;
+        return 1;
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    cout << "Served " << server.countFinishedGames() << " games (" << server.countActions() << " actions) in "
+            << fixed << setprecision(2) << elapsed.count() << " s." << endl;
+    return 0;
+}
+
+// Runs the load generator mode: connects '--clients' clients to a server
+// (see '--serve') that play random legal actions for '--seconds', and
+// reports turns per second and the latency of requests. Returns the exit
+// code of the program.
+//
+// Usage: --loadgen [--port N | --socket PATH] [--clients N] [--seconds N] [--seed N]
+int runLoadgen(Options &options) {
+    Endpoint endpoint = getEndpoint(options);
+    unsigned int num_clients = (unsigned int) options.getInt("clients", 100, 1);
+    double seconds = (double) options.getInt("seconds", 5, 1);
+    uint64_t seed = (uint64_t) options.getInt("seed", 0);
+
+    if(!options.isValid()) {
+        setcolor(ERROR_COLOR);
+        cout << options.getError() << endl;
+        return 1;
+    }
+
+    LoadGenerator generator(endpoint, num_clients, Rng(seed));
+    bool ok = generator.run(seconds);
+    setcolor(TEXT_COLOR);
+    generator.print(cout);
+    if(!ok) {
+        setcolor(ERROR_COLOR);
+        cout << generator.getError() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Parses a size of '--sizes' (of '--bench' or '--oracle'), like "15" (square) or "20x10" (width first).
+// Returns whether it is valid for a 'Board'.
+bool parseBoardSize(const string &text, unsigned int &width, unsigned int &height) {
+    istringstream in(text);
+    char separator;
+    if(!(in >> width)) return false;
+    if(in >> separator) {
+        if(separator != 'x' || !(in >> height)) return false;
+    } else {
+        height = width;
+    }
+    return width >= 2 && height >= 2 && width <= Board::MAX_SIZE && height <= Board::MAX_SIZE;
+}
+
+// Times the operations of 'Board' and 'Pool', and whole games between
+// greedy bots, on the board just generated by 'generator' (of 'width'
+// by 'height', with the 'Word's 'placed'), with random choices seeded by
+// 'seed'. Every benchmark is named after the operation followed by
+// 'label', and only those whose name contains 'filter' are run.
+void runBoardBenchmarks(Benchmark &benchmark, const BoardGenerator &generator,
+        const vector<BoardGenerator::PlacedWord> &placed, unsigned int width, unsigned int height,
+        const string &label, const string &filter, uint64_t seed)
+{
+    auto report = [&](const string &operation, unsigned long operations_per_call, const Benchmark::Body &body) {
+        string name = operation + " " + label;
+        if(name.find(filter) == string::npos) return;
+        Benchmark::print(cout, benchmark.run(name, operations_per_call, body));
+    };
+
+    ostringstream words_out;
+    generator.writeWords(words_out);
+    string words_text = words_out.str();
+    istringstream words_in(words_text);
+    Board board(width, height);
+    board.loadWords(words_in);
+    vector<char> letters = board.getLettersInBoard();
+    Rng rng(seed);
+
+    report("Board::loadWords", 1, [&](unsigned long calls) {
+        for(unsigned long i = 0; i < calls; i++) {
+            istringstream in(words_text);
+            Board loaded(width, height);
+            loaded.loadWords(in);
+            Benchmark::keep(loaded.countLetters());
+        }
+    });
+
+    vector<Word> words;
+    for(const BoardGenerator::PlacedWord &word: placed) words.emplace_back(word.start, word.orientation, word.letters);
+    report("Board::addWord", words.size(), [&](unsigned long calls) {
+        for(unsigned long i = 0; i < calls; i++) {
+            Board built(width, height);
+            for(const Word &word: words) built.addWord(word);
+            Benchmark::keep(built.countWords());
+        }
+    });
+
+    report("Board::getLettersInBoard", 1, [&](unsigned long calls) {
+        for(unsigned long i = 0; i < calls; i++) Benchmark::keep(board.getLettersInBoard().size());
+    });
+
+    // Covers the whole 'Board' in a random legal order, remembering the
+    // 'Board' at a few points on the way to look for moves in. Covering a
+    // 'Cell' only makes the 'Cell's it unlocks coverable, so the list of
+    // coverable ones is kept up to date instead of found again each time.
+    vector<Position> cover_order;
+    vector<Board> stages;
+    Board covered = board;
+    vector<Position> coverable;
+    const vector<Position> &positions = covered.getLetterPositions();
+    for(int i = 0; i < (int) positions.size(); i++) {
+        if(covered.getLetterCell(i).isCoverable()) coverable.push_back(positions[i]);
+    }
+    while(!covered.isFullyCovered()) {
+        if(cover_order.size() % (letters.size() / 4 + 1) == 0) stages.push_back(covered);
+        size_t chosen = rng.below((uint32_t) coverable.size());
+        Position position = coverable[chosen];
+        coverable[chosen] = coverable.back();
+        coverable.pop_back();
+
+        Position unlocked[2];
+        int num_unlocked = covered.getUnlockedBy(position, unlocked);
+        coverable.insert(coverable.end(), unlocked, unlocked + num_unlocked);
+        covered.makeMove(position);
+        cover_order.push_back(position);
+    }
+
+    // Every move is made and then undone, so the 'Board' is the same for every call.
+    Board playing = board;
+    vector<BoardUndo> undos(cover_order.size());
+    report("Board::makeMove+unmakeMove", cover_order.size(), [&](unsigned long calls) {
+        for(unsigned long i = 0; i < calls; i++) {
+            for(size_t j = 0; j < cover_order.size(); j++) undos[j] = playing.makeMove(cover_order[j]);
+            for(size_t j = undos.size(); j-- > 0;) playing.unmakeMove(undos[j]);
+        }
+    });
+
+    // Full hands drawn from the letters of the 'Board'.
+    const unsigned int NUM_HANDS = 32;
+    vector<Hand> hands(NUM_HANDS);
+    for(Hand &hand: hands) {
+        Pool pool(letters);
+        hand.refill(pool, rng);
+    }
+
+    report("Board::hasMove", stages.size() * hands.size(), [&](unsigned long calls) {
+        for(unsigned long i = 0; i < calls; i++) {
+            for(const Board &stage: stages) {
+                for(const Hand &hand: hands) Benchmark::keep(stage.hasMove(hand));
+            }
+        }
+    });
+
+    vector<Position> legal_positions;
+    report("Board::mustPlayTwiceEdgeCase", stages.size() * hands.size(), [&](unsigned long calls) {
+        for(unsigned long i = 0; i < calls; i++) {
+            for(const Board &stage: stages) {
+                for(const Hand &hand: hands) {
+                    legal_positions.clear();
+                    Benchmark::keep(stage.mustPlayTwiceEdgeCase(hand, legal_positions));
+                }
+            }
+        }
+    });
+
+    // The 'Pool' is never shuffled: drawing every letter is what replaced it.
+    report("Pool::drawLetter", letters.size(), [&](unsigned long calls) {
+        for(unsigned long i = 0; i < calls; i++) {
+            Pool pool(letters);
+            while(!pool.isEmpty()) Benchmark::keep((uint64_t) pool.drawLetter(rng));
+        }
+    });
+
+    // A game needs at least 7 letters for each player.
+    const unsigned int NUM_PLAYERS = 2;
+    if(letters.size() < 7 * NUM_PLAYERS) return;
+    vector<unique_ptr<Bot>> bots;
+    for(unsigned int i = 0; i < NUM_PLAYERS; i++) bots.push_back(createBot("greedy", Rng(seed, i)));
+    unique_ptr<TurnList> turns(new TurnList());
+    // Games differ a lot in length, so every call plays the same few deals.
+    const unsigned long NUM_DEALS = 8;
+    const unsigned int MAX_TURNS = 10000;
+    report("game (greedy, 2 players)", NUM_DEALS, [&](unsigned long calls) {
+        for(unsigned long i = 0; i < calls * NUM_DEALS; i++) {
+            Rng game_rng(seed, i % NUM_DEALS);
+            GameState state(board, NUM_PLAYERS, game_rng.split());
+            for(auto &bot: bots) bot->reset(game_rng.split());
+            state.dealHands();
+            for(unsigned int turn = 0; turn < MAX_TURNS && !state.isOver(); turn++) {
+                state.getLegalTurns(*turns);
+                state.applyTurn(bots[state.getCurrentPlayerIndex()]->chooseTurn(state, *turns));
+            }
+            Benchmark::keep(state.getChecksum());
+        }
+    });
+}
+
+// Runs the benchmark mode: generates valid boards of every size and
+// density given and times the operations of the game on them (see
+// 'runBoardBenchmarks'). With '--output', the results are saved as JSON
+// lines; with '--baseline', they are compared against results saved
+// before, failing if any is more than '--tolerance' percent slower.
+// Returns the exit code of the program.
+//
+// Usage: --bench [--sizes N|WxH,...] [--densities PERCENT,...] [--repetitions N]
+//        [--warmup N] [--sample-ms N] [--seed N] [--words FILE] [--filter TEXT]
+//        [--output FILE] [--baseline FILE] [--tolerance PERCENT]
+int runBench(Options &options) {
+    vector<string> sizes = options.getList("sizes", {"5", "10", "15", "20", "40x30"});
+    vector<string> densities = options.getList("densities", {"20", "35", "50"});
+    unsigned int repetitions = (unsigned int) options.getInt("repetitions", 10, 1);
+    unsigned int warmup = (unsigned int) options.getInt("warmup", 2, 0);
+    long long sample_ms = options.getInt("sample-ms", 10, 1);
+    uint64_t seed = (uint64_t) options.getInt("seed", 0);
+    string words_name = options.getString("words");
+    string filter = options.getString("filter");
+    string output_name = options.getString("output");
+    string baseline_name = options.getString("baseline");
+    double tolerance = (double) options.getInt("tolerance", 10, 0);
+
+    if(!options.isValid()) {
+        setcolor(ERROR_COLOR);
+        cout << options.getError() << endl;
+        return 1;
+    }
+
+    vector<string> dictionary = BoardGenerator::getDefaultDictionary();
+    if(!words_name.empty()) {
+        ifstream words_file(words_name);
+        if(words_file.is_open()) dictionary = BoardGenerator::readDictionary(words_file);
+        if(!words_file.is_open() || dictionary.empty()) {
+            setcolor(ERROR_COLOR);
+            cout << "Couldn't read any word from '" << words_name << "'." << endl;
+            return 1;
+        }
+    }
+
+    vector<Benchmark::Result> baseline;
+    if(!baseline_name.empty()) {
+        ifstream baseline_file(baseline_name);
+        string error;
+        if(!baseline_file.is_open()) error = "Couldn't open the file.";
+        if(!baseline_file.is_open() || !Benchmark::readJson(baseline_file, baseline, error)) {
+            setcolor(ERROR_COLOR);
+            cout << "Couldn't read baseline '" << baseline_name << "': " << error << endl;
+            return 1;
+        }
+    }
+
+    setcolor(TEXT_COLOR);
+    cout << "Benchmarks on generated boards, seed " << seed << ", " << warmup << " warmup and "
+            << repetitions << " samples of at least " << sample_ms << " ms each." << endl;
+
+    Benchmark benchmark(warmup, repetitions, sample_ms / 1000.0);
+    BoardGenerator generator(dictionary, Rng(seed));
+    for(const string &size: sizes) {
+        unsigned int width, height;
+        if(!parseBoardSize(size, width, height)) {
+            setcolor(ERROR_COLOR);
+            cout << "Invalid size '" << size << "' (must be from 2 to " << Board::MAX_SIZE << ")." << endl;
+            return 1;
+        }
+
+        for(const string &density: densities) {
+            int percent = atoi(density.c_str());
+            if(percent <= 0 || percent > 100) {
+                setcolor(ERROR_COLOR);
+                cout << "Invalid density '" << density << "' (must be a percentage)." << endl;
+                return 1;
+            }
+
+            vector<BoardGenerator::PlacedWord> placed = generator.generate(width, height, percent / 100.0);
+            unsigned int num_letters = generator.countLetters();
+            // Boards of a size are told apart by the density asked for,
+            // so names stay the same in every run with the same options.
+            string label = to_string(width) + "x" + to_string(height) + "@" + to_string(percent) + "%";
+
+            setcolor(TEXT_COLOR);
+            cout << endl << "Board " << label << ": " << placed.size() << " words, " << num_letters << " letters ("
+                    << 100 * num_letters / (width * height) << "% of the cells)" << endl;
+            Benchmark::printHeader(cout);
+            runBoardBenchmarks(benchmark, generator, placed, width, height, label, filter,
+                    seed ^ (width * 1000003ull + height * 1009ull + (uint64_t) percent));
+        }
+    }
+
+    if(!output_name.empty()) {
+        ofstream output(output_name);
+        benchmark.writeJson(output);
+        output.close();
+        if(output.fail()) {
+            setcolor(ERROR_COLOR);
+            cout << "Couldn't write '" << output_name << "'." << endl;
+            return 1;
+        }
+        cout << endl << "Saved " << benchmark.getResults().size() << " results to '" << output_name << "'." << endl;
+    }
+
+    if(!baseline_name.empty()) {
+        cout << endl << "Compared with '" << baseline_name << "' (tolerance " << tolerance << "%):" << endl;
+        unsigned int regressions = benchmark.compare(baseline, tolerance, cout);
+        if(regressions > 0) {
+            setcolor(ERROR_COLOR);
+            cout << regressions << " benchmarks got slower than the baseline." << endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// Reads the whole file 'name' to 'contents'. Returns whether it could be read.
+bool readWholeFile(const string &name, string &contents) {
+    ifstream file(name, ios::binary);
+    if(!file.is_open()) return false;
+    ostringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
     return true;
 }
 
+// Saves 'game' as the board file 'prefix.txt' and the journal 'prefix.journal'
+// that plays it. Returns whether it was successful.
+bool saveOracleCase(const DifferentialTester::Case &game, const string &prefix) {
+    string board_name = prefix + ".txt";
+    if(!Snapshot::writeFileAtomically(board_name, game.board_text.data(), game.board_text.size())) return false;
+
+    istringstream board_text(game.board_text);
+    Journal journal(board_name, Journal::hashFile(board_text), game.num_players, game.rng);
+    for(const Action &action: game.actions) journal.record(action);
+    return journal.saveAtomically(prefix + ".journal");
+}
+
+// Runs the oracle mode: plays random games on 'GameState' and on the
+// 'ReferenceGame' side by side, on the boards given or on boards generated
+// with sizes from '--sizes', until they disagree (see 'DifferentialTester').
+// The first game where they disagree is shrunk and saved as a board and a
+// journal named after '--output'. With '--journal', checks a saved game
+// instead. Returns the exit code of the program (1 if they disagreed).
+//
+// Usage: --oracle [--games N] [--seed N] [--threads N] [--sizes N|WxH,...]
+//        [--words FILE] [--output PREFIX] [BOARD...]
+//        --oracle --journal FILE
+int runOracle(Options &options) {
+    unsigned long num_games = (unsigned long) options.getInt("games", 10000, 1);
+    uint64_t seed = (uint64_t) options.getInt("seed", 0);
+    unsigned int num_threads = (unsigned int) options.getInt("threads", 0, 0);
+    vector<string> sizes = options.getList("sizes", {"5", "10", "15", "20", "40x30"});
+    string words_name = options.getString("words");
+    string output_prefix = options.getString("output", "oracle-mismatch");
+    string journal_name = options.getString("journal");
+    const vector<string> &board_names = options.getPositional();
+
+    if(!options.isValid()) {
+        setcolor(ERROR_COLOR);
+        cout << options.getError() << endl;
+        return 1;
+    }
+
+    if(!journal_name.empty()) {
+        Journal journal;
+        ifstream file(journal_name, ios::binary);
+        DifferentialTester::Case game;
+        if(!file.is_open() || !journal.load(file) || !readWholeFile(journal.getBoardName(), game.board_text)) {
+            setcolor(ERROR_COLOR);
+            cout << "Couldn't read '" << journal_name << "' or its board." << endl;
+            return 1;
+        }
+        game.num_players = journal.getNumPlayers();
+        game.rng = journal.getRng();
+        game.actions = journal.getActions();
+
+        DifferentialTester tester;
+        DifferentialTester::Outcome outcome = tester.check(game);
+        setcolor(outcome == DifferentialTester::CASE_AGREES ? TEXT_COLOR : ERROR_COLOR);
+        if(outcome == DifferentialTester::CASE_AGREES) cout << "Both engines agree on every action." << endl;
+        else if(outcome == DifferentialTester::CASE_INVALID) cout << "The journal isn't a valid game." << endl;
+        else cout << tester.getMismatch() << endl;
+        return outcome == DifferentialTester::CASE_AGREES ? 0 : 1;
+    }
+
+    vector<string> board_texts;
+    for(const string &name: board_names) {
+        board_texts.emplace_back();
+        if(!readWholeFile(name, board_texts.back())) {
+            setcolor(ERROR_COLOR);
+            cout << "Couldn't read '" << name << "'." << endl;
+            return 1;
+        }
+    }
+    vector<pair<unsigned int, unsigned int>> board_sizes;
+    for(const string &size: sizes) {
+        unsigned int width, height;
+        if(!parseBoardSize(size, width, height)) {
+            setcolor(ERROR_COLOR);
+            cout << "Invalid size '" << size << "' (must be from 2 to " << Board::MAX_SIZE << ")." << endl;
+            return 1;
+        }
+        board_sizes.push_back({width, height});
+    }
+    vector<string> dictionary = BoardGenerator::getDefaultDictionary();
+    if(!words_name.empty()) {
+        ifstream words_file(words_name);
+        if(words_file.is_open()) dictionary = BoardGenerator::readDictionary(words_file);
+        if(!words_file.is_open() || dictionary.empty()) {
+            setcolor(ERROR_COLOR);
+            cout << "Couldn't read any word from '" << words_name << "'." << endl;
+            return 1;
+        }
+    }
+    if(num_threads == 0) num_threads = max(1u, thread::hardware_concurrency());
+
+    setcolor(TEXT_COLOR);
+    cout << "Checking " << num_games << " games on " << (board_texts.empty() ? "generated boards" : "the boards given")
+            << ", seed " << seed << ", " << num_threads << " threads." << endl;
+
+    // Game 'i' only depends on the seed and 'i', so the first game where the
+    // engines disagree is the same whatever the number of threads.
+    const unsigned long CHUNK_SIZE = 16;
+    atomic<unsigned long> next_game(0), games_played(0), actions_played(0), states_compared(0);
+    atomic<bool> failed(false);
+    mutex failure_mutex;
+    unsigned long failed_game = 0;
+    DifferentialTester::Case failure;
+
+    auto work = [&]() {
+        DifferentialTester tester;
+        BoardGenerator generator(dictionary, Rng());
+        unsigned long actions = 0, games = 0;
+        while(!failed) {
+            unsigned long first = next_game.fetch_add(CHUNK_SIZE);
+            if(first >= num_games) break;
+
+            for(unsigned long i = first; i < min(first + CHUNK_SIZE, num_games); i++) {
+                Rng rng(seed, i);
+                DifferentialTester::Case game;
+                if(!board_texts.empty()) {
+                    game.board_text = board_texts[i % board_texts.size()];
+                } else {
+                    pair<unsigned int, unsigned int> size = board_sizes[rng.below((uint32_t) board_sizes.size())];
+                    generator.setRng(rng.split());
+                    generator.generate(size.first, size.second, (10 + rng.below(41)) / 100.0);
+                    ostringstream board_text;
+                    generator.write(board_text);
+                    game.board_text = board_text.str();
+                }
+                game.num_players = 2 + rng.below(GameState::MAX_PLAYERS - 1);
+                game.rng = rng.split();
+
+                DifferentialTester::Outcome outcome = tester.play(game, rng.split());
+                actions += game.actions.size();
+                games++;
+                if(outcome == DifferentialTester::CASE_MISMATCH) {
+                    lock_guard<mutex> lock(failure_mutex);
+                    if(!failed || i < failed_game) {
+                        failed_game = i;
+                        failure = game;
+                    }
+                    failed = true;
+                }
+            }
+        }
+        games_played += games;
+        actions_played += actions;
+        states_compared += tester.countStates();
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for(unsigned int i = 1; i < num_threads; i++) threads.emplace_back(work);
+    work();
+    for(thread &t: threads) t.join();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    cout << "Played " << games_played << " games (" << actions_played << " actions, " << states_compared
+            << " states compared) in " << fixed << setprecision(2) << elapsed.count() << " s ("
+            << setprecision(0) << states_compared / elapsed.count() << " states/s)." << endl;
+    if(!failed) {
+        cout << "Both engines agree on every state." << endl;
+        return 0;
+    }
+
+    DifferentialTester tester;
+    tester.check(failure);
+    setcolor(ERROR_COLOR);
+    cout << "Game " << failed_game << " disagrees. " << tester.getMismatch() << endl;
+    size_t original_actions = failure.actions.size();
+    DifferentialTester::Case shrunk = tester.shrink(failure);
+    cout << "Shrunk from " << original_actions << " to " << shrunk.actions.size() << " actions. "
+            << tester.getMismatch() << endl;
+    if(!saveOracleCase(shrunk, output_prefix)) {
+        cout << "Couldn't save the game to '" << output_prefix << "'." << endl;
+    } else {
+        setcolor(TEXT_COLOR);
+        cout << "Saved to '" << output_prefix << ".txt' and '" << output_prefix << ".journal' (check it again with "
+                << "'--oracle --journal " << output_prefix << ".journal')." << endl;
+    }
+    return 1;
+}
+
+// Runs the replay mode: plays each journal given again as fast as possible,
+// checking that it ends exactly as it was recorded, and measures how fast
+// games are replayed and how fast any turn can be found. With '--seek',
+// shows the state at the start of that turn. Returns the exit code of the program.
+//
+// Usage: --replay [--keyframes TURNS] [--repeat N] [--seek TURN] JOURNAL...
+int runReplay(Options &options) {
+    unsigned int keyframe_interval = (unsigned int) options.getInt("keyframes", 16, 1);
+    int repeat = (int) options.getInt("repeat", 1, 1, INT_MAX);
+    long long seek_turn = options.getInt("seek", -1);
+    const vector<string> &journal_names = options.getPositional();
+
+    if(!options.isValid()) {
+        setcolor(ERROR_COLOR);
+        cout << options.getError() << endl;
+        return 1;
+    }
+    if(journal_names.empty()) {
+        setcolor(ERROR_COLOR);
+        cout << "Must give at least one journal to replay." << endl;
+        return 1;
+    }
+
+    int failures = 0;
+    unsigned long total_actions = 0, total_turns = 0;
+    double replay_seconds = 0, seek_seconds = 0;
+
+    for(const string &journal_name: journal_names) {
+        Journal journal;
+        ifstream file(journal_name, ios::binary);
+        setcolor(TEXT_COLOR);
+        cout << journal_name << ": ";
+        if(!file.is_open() || !journal.load(file)) {
+            setcolor(ERROR_COLOR);
+            cout << "not a valid journal." << endl;
+            failures++;
+            continue;
+        }
+
+        string board_name = journal.getBoardName();
+        unique_ptr<Board> board = loadBoard(board_name);
+        if(board == nullptr) {
+            failures++;
+            continue;
+        }
+        if(hashBoardFile(board_name) != journal.getBoardHash()) {
+            setcolor(ERROR_COLOR);
+            cout << "board '" << board_name << "' has changed since the game was played." << endl;
+            failures++;
+            continue;
+        }
+
+        Replayer replayer(journal, *board, keyframe_interval);
+        bool ok = true;
+        auto start = chrono::steady_clock::now();
+        for(int i = 0; i < repeat && ok; i++) ok = replayer.run();
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        if(!ok) {
+            setcolor(ERROR_COLOR);
+            cout << replayer.getError() << endl;
+            failures++;
+            continue;
+        }
+        replay_seconds += elapsed.count();
+        total_actions += journal.getActions().size() * repeat;
+
+        // Find every turn once, to measure seeking.
+        start = chrono::steady_clock::now();
+        uint64_t checksums = 0;
+        for(unsigned int turn = 0; turn <= replayer.countTurns(); turn++) {
+            checksums ^= replayer.seek(turn).getChecksum();
+        }
+        elapsed = chrono::steady_clock::now() - start;
+        seek_seconds += elapsed.count();
+        total_turns += replayer.countTurns() + 1;
+
+        cout << journal.getNumPlayers() << " players on '" << board_name << "', "
+                << replayer.countTurns() << " turns, " << journal.getActions().size() << " actions, "
+                << (journal.isFinished() ? "same final state" : "unfinished") << "." << endl;
+
+        if(seek_turn >= 0) {
+            GameState state = replayer.seek((unsigned int) seek_turn);
+            cout << "At the start of turn " << min((unsigned int) seek_turn, replayer.countTurns())
+                    << ", player " << state.getCurrentPlayer().getId() << " plays:" << endl;
+            GameDisplayer::printBoard(state.getBoard());
+            setcolor(TEXT_COLOR);
+            for(const Player &player: state.getPlayers()) {
+                cout << "Player " << player.getId() << ": " << player.getScore() << " points, hand "
+                        << player.getHand() << endl;
+            }
+        }
+    }
+
+    setcolor(TEXT_COLOR);
+    cout << endl << "Replayed " << journal_names.size() - failures << " of " << journal_names.size()
+            << " journals: " << total_actions << " actions in " << fixed << setprecision(3)
+            << replay_seconds << " s (" << setprecision(0)
+            << (replay_seconds > 0 ? total_actions / replay_seconds : 0) << " actions/s)." << endl;
+    cout << "Seeked " << total_turns << " turns, " << setprecision(2)
+            << (total_turns > 0 ? 1e6 * seek_seconds / total_turns : 0) << " us per seek." << endl;
+
+    return failures == 0 ? 0 : 1;
+}
+
 // Asks the user to input the number of players for the game.
 // Keeps asking until user enters a valid name (in this case,
 // returns true) or the stdin fails (in this case, returns false).
@@ -86,7 +1210,7 @@ bool readBoardSize(unsigned int &width, unsigned int &height, ifstream &board_fi
 // The number is stored in 'num_players'.
 bool promptNumberPlayers(int &num_players, unsigned int board_letters) {
     // Get maximum number of players from the number of letters.
-    int max_players = min(4, (int) board_letters/7);
+    int max_players = min((int) GameState::MAX_PLAYERS, (int) board_letters/7);
 
     if(max_players == 2) {
         // Max players is two, so user doesn't have a choice.
@@ -143,14 +1267,58 @@ bool promptNumberPlayers(int &num_players, unsigned int board_letters) {
     }
 }
 
+// Asks the user who plays each of the 'num_players' seats: a person
+// (the default) or one of the bots of 'getBotNames'. Keeps asking each
+// seat until the answer is valid, and returns false if the stdin fails.
+//
+// The bots are stored in 'bots', with 'nullptr' for seats played by people.
+// Each bot gets its own generator, split from 'rng'.
+bool promptBots(int num_players, vector<unique_ptr<Bot>> &bots, Rng &rng) {
+    const vector<string> &bot_names = getBotNames();
+    bots.clear();
+
+    for(int i = 1; i <= num_players; i++) {
+        string input;
+
+        setcolor(TEXT_COLOR);
+        cout << "Who plays as player " << i << "? (human";
+        for(const string &name: bot_names) cout << ", " << name;
+        cout << ") [human]: ";
+        getline(cin, input);
+        if(cin.fail()) return false;
+
+        stringstream input_stream(input);
+        string name;
+        input_stream >> name;
+        transform(name.begin(), name.end(), name.begin(),
+                [](char c) { return (char) tolower(c); });
+
+        if(name.size() == 0 || name == "human") {
+            bots.push_back(nullptr);
+            continue;
+        }
+
+        unique_ptr<Bot> bot = createBot(name, rng.split());
+        if(bot == nullptr) {
+            setcolor(ERROR_COLOR);
+            cout << "Unknown player '" << name << "'." << endl;
+            i--; // Ask again for the same seat.
+            continue;
+        }
+        bots.push_back(move(bot));
+    }
+
+    return true;
+}
+
 // Asks the user if they want to play again.
 // Returns true if the answer is 'Y', and false if the answer is 
 // 'N' (or the stdin fails).
-bool askPlayAgain() {
+bool askYesNo(const string &question) {
     string input;
     while(true) {
         setcolor(TEXT_COLOR);
-        cout << endl << "Play again? (Y/N): ";
+        cout << endl << question << " (Y/N): ";
         getline(cin, input);
         if(cin.fail()) return false;
 
@@ -172,10 +1340,151 @@ bool askPlayAgain() {
     }
 }
 
-int main() {
+// Asks the user whether they want to play again.
+bool askPlayAgain() {
+    return askYesNo("Play again?");
+}
+
+// Plays 'game', recorded in the journal 'journal_name' (empty if it
+// isn't), telling where it was saved once it is over. Returns false
+// if the stdin failed.
+bool playGame(Game &game, const string &journal_name) {
+    if(!game.play()) return false;
+
+    if(!journal_name.empty()) {
+        setcolor(TEXT_COLOR);
+        cout << "This game was saved to '" << journal_name << "'." << endl;
+    }
+    return true;
+}
+
+// Offers to resume the game saved in 'SNAPSHOT_FILE' (if there is one)
+// and plays it if the user wants to. Bots get generators split from
+// 'rng'. Returns false if the stdin failed.
+bool offerResume(Rng &rng) {
+    Snapshot snapshot;
+    if(!snapshot.load(SNAPSHOT_FILE)) return true;
+
+    string board_name = snapshot.getBoardName();
+    setcolor(TEXT_COLOR);
+    cout << "An unfinished game of " << snapshot.getNumPlayers() << " players on '" << board_name
+            << "' was found.";
+    if(!askYesNo("Resume it?")) {
+        if(cin.fail()) return false;
+        remove(SNAPSHOT_FILE);
+        return true;
+    }
+
+    unique_ptr<Board> board = loadBoard(board_name);
+    if(board == nullptr || hashBoardFile(board_name) != snapshot.getBoardHash()) {
+        setcolor(ERROR_COLOR);
+        cout << "The board of that game has changed, so it can't be resumed." << endl;
+        remove(SNAPSHOT_FILE);
+        return true;
+    }
+
+    vector<unique_ptr<Bot>> bots;
+    vector<Bot*> seats;
+    for(const string &name: snapshot.getSeats()) {
+        bots.push_back(name.empty() ? nullptr : createBot(name, rng.split()));
+        seats.push_back(bots.back().get());
+    }
+
+    // Keep recording the game in its journal, as it was when it was saved.
+    string journal_name = snapshot.getJournalName();
+    Journal journal;
+    ifstream journal_file(journal_name, ios::binary);
+    bool has_journal = journal_file.is_open() && journal.load(journal_file);
+    journal_file.close();
+    if(has_journal) {
+        journal.truncate(snapshot.getJournalActions());
+    } else {
+        journal_name.clear();
+    }
+
+    Game game(*board, snapshot.getNumPlayers(), Rng(), seats);
+    if(has_journal) game.setJournal(&journal);
+    game.setAutosave(SNAPSHOT_FILE, board_name, snapshot.getBoardHash(), journal_name);
+    if(!game.restore(snapshot)) {
+        setcolor(ERROR_COLOR);
+        cout << "That game couldn't be restored." << endl;
+        remove(SNAPSHOT_FILE);
+        return true;
+    }
+
+    return playGame(game, journal_name);
+}
+
+// Saves what was profiled (see 'Profiler') when the program exits, to
+// the files named by 'SCRABBLE_PROFILE_OUTPUT' ("scrabble-profile" by default).
+void writeProfile() {
+    const char *output = getenv("SCRABBLE_PROFILE_OUTPUT");
+    string prefix = output != nullptr && output[0] != '\0' ? output : "scrabble-profile";
+    if(Profiler::writeReport(prefix)) {
+        cerr << "Profile written to '" << prefix << ".trace.json' and '" << prefix << ".txt'." << endl;
+    } else {
+        cerr << "Couldn't write the profile to '" << prefix << "'." << endl;
+    }
+}
+
+int main(int argc, char **argv) {
+    if(Profiler::isEnabled()) atexit(writeProfile);
+
+    // Command line modes, instead of the interactive game.
+    if(argc >= 2 && string(argv[1]) == "--simulate") {
+        Options options(argc - 2, argv + 2);
+        return runSimulate(options);
+    }
+    if(argc >= 2 && string(argv[1]) == "--tournament") {
+        Options options(argc - 2, argv + 2);
+        return runTournament(options);
+    }
+    if(argc >= 2 && string(argv[1]) == "--dataset") {
+        Options options(argc - 2, argv + 2);
+        return runDataset(options);
+    }
+    if(argc >= 2 && string(argv[1]) == "--sessions") {
+        Options options(argc - 2, argv + 2);
+        return runSessions(options);
+    }
+    if(argc >= 2 && string(argv[1]) == "--engine") {
+        // Requests and answers are JSON lines (see 'Engine'), never mixed with the C streams.
+        ios::sync_with_stdio(false);
+        Engine engine;
+        engine.run(cin, cout);
+        return 0;
+    }
+    if(argc >= 2 && string(argv[1]) == "--serve") {
+        Options options(argc - 2, argv + 2);
+        return runServe(options);
+    }
+    if(argc >= 2 && string(argv[1]) == "--loadgen") {
+        Options options(argc - 2, argv + 2);
+        return runLoadgen(options);
+    }
+    if(argc >= 2 && string(argv[1]) == "--bench") {
+        Options options(argc - 2, argv + 2);
+        return runBench(options);
+    }
+    if(argc >= 2 && string(argv[1]) == "--oracle") {
+        Options options(argc - 2, argv + 2);
+        return runOracle(options);
+    }
+    if(argc >= 2 && string(argv[1]) == "--replay") {
+        Options options(argc - 2, argv + 2);
+        return runReplay(options);
+    }
+    if(argc >= 2 && string(argv[1]) == "--expectimax") {
+        Options options(argc - 2, argv + 2);
+        return runExpectimax(options);
+    }
+
     // Initialize rng
-    unsigned seed = (unsigned int) chrono::system_clock::now().time_since_epoch().count();
-    default_random_engine rng(seed);
+    uint64_t seed = (uint64_t) chrono::system_clock::now().time_since_epoch().count();
+    Rng rng(seed);
+
+    // A game that was stopped before it ended may be resumed first.
+    if(!offerResume(rng)) return 0;
     
     while(true) {
         // First, a valid board must be loaded.
@@ -186,18 +1495,9 @@ int main() {
         getline(cin, file_name);
         if(cin.fail()) return 0; // stdin failing ends the program
         
-        ifstream board_file;
-        if(!openBoardFile(board_file, file_name)) continue;
-
-        unsigned int width, height;
-        if(!readBoardSize(width, height, board_file)) {
-            board_file.close();
-            continue;
-        }
-
-        Board board(width, height);
-        board.loadWords(board_file);
-        board_file.close();
+        unique_ptr<Board> loaded_board = loadBoard(file_name);
+        if(loaded_board == nullptr) continue;
+        const Board &board = *loaded_board;
 
         // At this point the board is loaded, but it is only valid
         // to be played if it has at least 14 letters.
@@ -217,10 +1517,23 @@ int main() {
         int num_players; 
         promptNumberPlayers(num_players, board.countLetters());
 
-        // Everything is ready to start the game.
-        Game game(board, num_players);
+        vector<unique_ptr<Bot>> bots;
+        if(!promptBots(num_players, bots, rng)) return 0;
+        vector<Bot*> seats;
+        for(const auto &bot: bots) seats.push_back(bot.get());
+
+        // Everything is ready to start the game. It is recorded, so it can
+        // be played again exactly (see '--replay'), and saved at the end
+        // of every turn, so it can be resumed if the program stops.
+        Rng game_rng = rng.split();
+        uint64_t board_hash = hashBoardFile(file_name);
+        string journal_name = newJournalName();
+        Journal journal(file_name, board_hash, num_players, game_rng);
+        Game game(board, num_players, game_rng, seats);
+        game.setJournal(&journal);
+        game.setAutosave(SNAPSHOT_FILE, file_name, board_hash, journal_name);
         
-        bool game_ended_successfuly = game.play(rng);
+        bool game_ended_successfuly = playGame(game, journal_name);
         // if game ended because stdin failed, end the program.
         if(!game_ended_successfuly) return 0; 
 
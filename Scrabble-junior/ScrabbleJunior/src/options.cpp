@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <sstream>
+#include "options.h"
+
+using namespace std;
+
+Options::Options(int argc, char **argv, const vector<string> &flags) {
+    for(int i = 0; i < argc; i++) {
+        string argument = argv[i];
+
+        if(argument.size() <= 2 || argument.compare(0, 2, "--") != 0) {
+            positional.push_back(argument);
+            continue;
+        }
+
+        string name = argument.substr(2);
+        if(find(flags.begin(), flags.end(), name) != flags.end()) {
+            values[name] = "1";
+        } else if(i + 1 < argc) {
+            values[name] = argv[++i];
+        } else if(error.empty()) {
+            error = "Option '" + argument + "' needs a value.";
+        }
+    }
+}
+
+bool Options::isValid() const {
+    return error.empty();
+}
+
+const string& Options::getError() const {
+    return error;
+}
+
+bool Options::has(const string &name) const {
+    return values.count(name) != 0;
+}
+
+string Options::getString(const string &name, const string &default_value) const {
+    auto found = values.find(name);
+    return found == values.end() ? default_value : found->second;
+}
+
+long long Options::getInt(const string &name, long long default_value) {
+    if(!has(name)) return default_value;
+
+    stringstream input(values[name]);
+    long long value;
+    string unexpected;
+    input >> value;
+    if(input.fail() || (input >> unexpected, !unexpected.empty())) {
+        if(error.empty()) error = "Option '--" + name + "' must be an integer.";
+        return default_value;
+    }
+
+    return value;
+}
+
+long long Options::getInt(const string &name, long long default_value, long long min_value, long long max_value) {
+    long long value = getInt(name, default_value);
+    if(value >= min_value && value <= max_value) return value;
+
+    if(error.empty()) {
+        error = "Option '--" + name + "' must be ";
+        if(max_value == LLONG_MAX) error += "at least " + to_string(min_value) + ".";
+        else error += "from " + to_string(min_value) + " to " + to_string(max_value) + ".";
+    }
+    return default_value;
+}
+
+vector<string> Options::getList(const string &name, const vector<string> &default_values) const {
+    if(!has(name)) return default_values;
+
+    vector<string> list;
+    stringstream input(getString(name));
+    string item;
+    while(getline(input, item, ',')) {
+        if(!item.empty()) list.push_back(item);
+    }
+    return list;
+}
+
+const vector<string>& Options::getPositional() const {
+    return positional;
+}
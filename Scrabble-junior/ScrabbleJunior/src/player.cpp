@@ -24,3 +24,7 @@ unsigned int Player::getScore() const {
 void Player::addScore(unsigned int points) {
     this->score += points;
 }
+
+void Player::removeScore(unsigned int points) {
+    this->score -= points;
+}
@@ -1,33 +1,68 @@
 #include <algorithm>
+#include <cassert>
+#include <iterator>
 #include "pool.h"
+#include "profiler.h"
 
 using namespace std;
 
-Pool::Pool(vector<char> &&letters): letters(move(letters)) {}
+Pool::Pool(const vector<char> &letters): total(0) {
+    fill(begin(letter_count), end(letter_count), 0);
+    for(char letter: letters) returnLetter(letter);
+}
+
+char Pool::drawLetter(Rng &rng) {
+    PROFILE_COUNT("Pool::drawLetter", 1);
+    // Pick one of the 'total' letters uniformly and find
+    // which letter it falls into.
+    unsigned int target = rng.below(total);
+    int index = 0;
+    while(target >= letter_count[index]) {
+        target -= letter_count[index];
+        index++;
+    }
+
+    letter_count[index] -= 1;
+    total -= 1;
+    return (char) ('A' + index);
+}
 
-char Pool::popLetter() {
-    char letter = letters.back();
-    letters.pop_back();
-    return letter;
+void Pool::takeLetter(char letter) {
+    assert(letter >= 'A' && letter <= 'Z');
+    letter_count[letter - 'A'] -= 1;
+    total -= 1;
 }
 
-void Pool::exchange(char *letter) {
-    swap(letters[0], *letter);
+void Pool::returnLetter(char letter) {
+    assert(letter >= 'A' && letter <= 'Z');
+    letter_count[letter - 'A'] += 1;
+    total += 1;
 }
 
-void Pool::exchange(char *letter1, char *letter2) {
-    swap(letters[0], *letter1);
-    swap(letters[1], *letter2);
+void Pool::exchange(char *letter, Rng &rng) {
+    char drawn = drawLetter(rng);
+    returnLetter(*letter);
+    *letter = drawn;
 }
 
-void Pool::shuffle(default_random_engine &rng) {
-    std::shuffle(letters.begin(), letters.end(), rng);
+void Pool::exchange(char *letter1, char *letter2, Rng &rng) {
+    char drawn1 = drawLetter(rng);
+    char drawn2 = drawLetter(rng);
+    returnLetter(*letter1);
+    returnLetter(*letter2);
+    *letter1 = drawn1;
+    *letter2 = drawn2;
 }
 
 bool Pool::isEmpty() const {
-    return letters.empty();
+    return total == 0;
 }
 
 int Pool::size() const {
-    return (int) letters.size();
+    return (int) total;
+}
+
+int Pool::countLetter(char letter) const {
+    assert(letter >= 'A' && letter <= 'Z');
+    return (int) letter_count[letter - 'A'];
 }
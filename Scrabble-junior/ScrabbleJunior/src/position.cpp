@@ -6,9 +6,53 @@ Position::Position(): Position(0, 0) {}
 
 Position::Position(int x, int y): x(x), y(y) {}
 
-Position::Position(char x, char y) {
-    this->x = x - 'a';
-    this->y = y - 'A';
+// Returns the number written in 'letters' as one coordinate, where 'first'
+// is 0 and each letter after it one more (like 'Position::rowName'), or -1
+// if they aren't such a coordinate.
+static int parseCoordinate(string_view letters, char first) {
+    if(letters.empty() || letters.size() > (size_t) Position::MAX_COORDINATE_LETTERS) return -1;
+
+    // Letters are digits from 1 to 26, so 'A' to 'Z' are 0 to 25
+    // and 'AA' comes right after 'Z'.
+    int value = 0;
+    for(char letter: letters) {
+        if(letter < first || letter > first + 25) return -1;
+        value = value * 26 + (letter - first + 1);
+    }
+    return value - 1;
+}
+
+// Returns the letters of the coordinate 'value' (see 'parseCoordinate').
+static string coordinateName(int value, char first) {
+    string name;
+    for(value += 1; value > 0; value = (value - 1) / 26) {
+        name.insert(name.begin(), (char) (first + (value - 1) % 26));
+    }
+    return name;
+}
+
+bool Position::parse(string_view coordinates, Position &position) {
+    // The row is every uppercase letter at the start.
+    size_t column_start = 0;
+    while(column_start < coordinates.size() && coordinates[column_start] >= 'A'
+            && coordinates[column_start] <= 'Z') {
+        column_start++;
+    }
+
+    int y = parseCoordinate(coordinates.substr(0, column_start), 'A');
+    int x = parseCoordinate(coordinates.substr(column_start), 'a');
+    if(x < 0 || y < 0) return false;
+
+    position = Position(x, y);
+    return true;
+}
+
+string Position::rowName(int y) {
+    return coordinateName(y, 'A');
+}
+
+string Position::columnName(int x) {
+    return coordinateName(x, 'a');
 }
 
 int Position::getX() const {
@@ -50,6 +94,6 @@ bool Position::operator==(const Position &other) const {
 }
 
 ostream& operator<<(ostream &out, const Position &pos) {
-    out << (char)('A' + pos.y) << (char)('a' + pos.x);
+    out << Position::rowName(pos.y) << Position::columnName(pos.x);
     return out;
 }
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include "positionEncoder.h"
+#include "binaryIo.h"
+
+using namespace std;
+
+// Returns the number of bits needed to store any value from 0 to 'max_value'.
+static unsigned int bitsFor(unsigned int max_value) {
+    unsigned int bits = 0;
+    while(bits < 32 && ((uint64_t) 1 << bits) <= max_value) bits++;
+    return bits;
+}
+
+// Writes the 'bits' lowest bits of 'value' at bit 'offset' of 'data',
+// moving 'offset' past them. The bits must be zero before.
+static void writeBits(uint8_t *data, size_t &offset, uint32_t value, unsigned int bits) {
+    for(unsigned int i = 0; i < bits; i++, offset++) {
+        if(value & ((uint32_t) 1 << i)) data[offset / 8] |= (uint8_t) (1 << (offset % 8));
+    }
+}
+
+// Reads 'bits' bits written by 'writeBits' at bit 'offset' of 'data',
+// moving 'offset' past them.
+static uint32_t readBits(const uint8_t *data, size_t &offset, unsigned int bits) {
+    uint32_t value = 0;
+    for(unsigned int i = 0; i < bits; i++, offset++) {
+        if(data[offset / 8] & (1 << (offset % 8))) value |= (uint32_t) 1 << i;
+    }
+    return value;
+}
+
+PositionEncoder::PositionEncoder(const Board &board, unsigned int num_players):
+    num_cells(board.countLetters()),
+    num_players(num_players),
+    num_words(board.countWords())
+{
+    vector<char> board_letters = board.getLettersInBoard();
+    sort(board_letters.begin(), board_letters.end());
+    for(char letter: board_letters) {
+        if(letters.empty() || letters.back() != letter) {
+            letters.push_back(letter);
+            letter_counts.push_back(0);
+        }
+        letter_counts.back()++;
+    }
+
+    computeLayout();
+}
+
+PositionEncoder::PositionEncoder(istream &in):
+    num_cells(0),
+    num_players(0),
+    num_words(0)
+{
+    num_players = (unsigned int) readInt(in, 1);
+    num_cells = (unsigned int) readInt(in, 4);
+    num_words = (unsigned int) readInt(in, 4);
+    size_t num_letters = (size_t) readInt(in, 1);
+    for(size_t i = 0; i < num_letters && i < 26 && in; i++) {
+        letters.push_back((char) in.get());
+        letter_counts.push_back((unsigned int) readInt(in, 4));
+    }
+
+    if(!in || num_letters > 26 || num_players < 2 || num_players > GameState::MAX_PLAYERS) num_players = 0;
+    computeLayout();
+}
+
+void PositionEncoder::computeLayout() {
+    hand_bits.clear();
+    pool_bits.clear();
+    for(unsigned int count: letter_counts) {
+        hand_bits.push_back(bitsFor(min(count, (unsigned int) Hand::HAND_SIZE)));
+        pool_bits.push_back(bitsFor(count));
+    }
+    score_bits = bitsFor(num_words);
+
+    size_t bits = num_cells + 2 + 2;
+    for(size_t i = 0; i < letters.size(); i++) bits += num_players * hand_bits[i] + pool_bits[i];
+    bits += num_players * score_bits;
+
+    outcome_offset = bits;
+    bits += num_players * score_bits;
+    record_size = (bits + 7) / 8;
+}
+
+bool PositionEncoder::isValid() const {
+    return num_players != 0;
+}
+
+const string& PositionEncoder::getLetters() const {
+    return letters;
+}
+
+unsigned int PositionEncoder::getNumPlayers() const {
+    return num_players;
+}
+
+size_t PositionEncoder::getRecordSize() const {
+    return record_size;
+}
+
+void PositionEncoder::encode(const GameState &state, uint8_t *record) const {
+    fill(record, record + record_size, 0);
+    size_t offset = 0;
+
+    const Board &board = state.getBoard();
+    for(int i = 0; i < (int) board.countLetters(); i++) {
+        writeBits(record, offset, board.getLetterCell(i).isCovered() ? 1 : 0, 1);
+    }
+    writeBits(record, offset, state.getCurrentPlayerIndex(), 2);
+    writeBits(record, offset, state.getMovesLeft(), 2);
+
+    for(const Player &player: state.getPlayers()) {
+        for(size_t i = 0; i < letters.size(); i++) {
+            writeBits(record, offset, player.getHand().countLetter(letters[i]), hand_bits[i]);
+        }
+    }
+    for(size_t i = 0; i < letters.size(); i++) {
+        writeBits(record, offset, state.getPool().countLetter(letters[i]), pool_bits[i]);
+    }
+    for(const Player &player: state.getPlayers()) writeBits(record, offset, player.getScore(), score_bits);
+}
+
+void PositionEncoder::setOutcome(uint8_t *record, const vector<Player> &players) const {
+    size_t offset = outcome_offset;
+    for(const Player &player: players) writeBits(record, offset, player.getScore(), score_bits);
+}
+
+void PositionEncoder::decode(const uint8_t *record, DecodedPosition &position) const {
+    size_t offset = 0;
+
+    position.covered.assign(num_cells, false);
+    for(unsigned int i = 0; i < num_cells; i++) position.covered[i] = readBits(record, offset, 1) != 0;
+    position.current_player = readBits(record, offset, 2);
+    position.moves_left = readBits(record, offset, 2);
+
+    position.hands.assign(num_players, vector<unsigned int>(letters.size(), 0));
+    for(vector<unsigned int> &hand: position.hands) {
+        for(size_t i = 0; i < letters.size(); i++) hand[i] = readBits(record, offset, hand_bits[i]);
+    }
+    position.pool.assign(letters.size(), 0);
+    for(size_t i = 0; i < letters.size(); i++) position.pool[i] = readBits(record, offset, pool_bits[i]);
+
+    position.scores.assign(num_players, 0);
+    for(unsigned int &score: position.scores) score = readBits(record, offset, score_bits);
+    position.final_scores.assign(num_players, 0);
+    for(unsigned int &score: position.final_scores) score = readBits(record, offset, score_bits);
+}
+
+void PositionEncoder::save(ostream &out) const {
+    writeInt(out, num_players, 1);
+    writeInt(out, num_cells, 4);
+    writeInt(out, num_words, 4);
+    writeInt(out, letters.size(), 1);
+    for(size_t i = 0; i < letters.size(); i++) {
+        out.put(letters[i]);
+        writeInt(out, letter_counts[i], 4);
+    }
+}
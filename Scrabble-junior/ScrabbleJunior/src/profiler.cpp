@@ -0,0 +1,239 @@
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <cstring>
+#include "profiler.h"
+
+using namespace std;
+
+#ifdef SCRABBLE_PROFILE
+
+// Buckets of a histogram: four for each power of two of nanoseconds.
+static const int NUM_BUCKETS = 4 * 64;
+
+// A scope recorded in the trace.
+struct ProfileEvent {
+    // The site of the scope.
+    int site;
+    // When it started, in nanoseconds (see 'Profiler::now').
+    uint64_t start;
+    // How long it took, in nanoseconds.
+    uint64_t duration;
+};
+
+// How long the scopes of a site took.
+struct ProfileHistogram {
+    // Number of scopes.
+    uint64_t count = 0;
+    // Sum of their durations, in nanoseconds.
+    uint64_t total = 0;
+    // Longest duration, in nanoseconds.
+    uint64_t max = 0;
+    // Number of scopes in each bucket (see 'getBucket').
+    uint64_t buckets[NUM_BUCKETS] = {};
+};
+
+// What a thread recorded.
+struct ProfileBuffer {
+    // The id of the thread in the trace, from 1.
+    int thread_id;
+    // The scopes recorded, up to 'MAX_EVENTS_PER_THREAD'.
+    vector<ProfileEvent> events;
+    // Scopes not recorded in 'events' because it was full.
+    uint64_t dropped_events = 0;
+    // The histogram of each site, by id.
+    vector<ProfileHistogram> histograms;
+    // The counter of each site, by id.
+    vector<uint64_t> counts;
+};
+
+// Guards 'site_names' and 'buffers'.
+static mutex registry_mutex;
+// The name of each site, by id.
+static vector<const char*> site_names;
+// The buffer of every thread that recorded anything. Buffers outlive
+// their threads, so they can be reported at the end.
+static vector<unique_ptr<ProfileBuffer>> buffers;
+// The buffer of the calling thread, once it has recorded anything.
+static thread_local ProfileBuffer *thread_buffer = nullptr;
+// When the program started.
+static const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+
+// Returns the buffer of the calling thread, creating it the first time.
+static ProfileBuffer& getBuffer() {
+    if(thread_buffer == nullptr) {
+        lock_guard<mutex> lock(registry_mutex);
+        buffers.push_back(make_unique<ProfileBuffer>());
+        thread_buffer = buffers.back().get();
+        thread_buffer->thread_id = (int) buffers.size();
+    }
+    return *thread_buffer;
+}
+
+// Returns the bucket of a histogram of a duration of 'nanoseconds':
+// its power of two and the next two bits below it.
+static int getBucket(uint64_t nanoseconds) {
+    if(nanoseconds < 4) return (int) nanoseconds;
+    int power = 2;
+    while(power < 63 && (nanoseconds >> (power + 1)) != 0) power++;
+    return power * 4 + (int) ((nanoseconds >> (power - 2)) & 3);
+}
+
+// Returns the longest duration that falls in 'bucket', in nanoseconds.
+static uint64_t getBucketLimit(int bucket) {
+    if(bucket < 4) return (uint64_t) bucket;
+    int power = bucket / 4;
+    uint64_t fraction = (uint64_t) (bucket % 4);
+    return ((4 + fraction + 1) << (power - 2)) - 1;
+}
+
+// Returns the duration that at least 'fraction' of the scopes of
+// 'histogram' didn't exceed, in microseconds (up to a bucket).
+static double getPercentile(const ProfileHistogram &histogram, double fraction) {
+    uint64_t target = (uint64_t) (fraction * (double) histogram.count);
+    uint64_t seen = 0;
+    for(int bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+        seen += histogram.buckets[bucket];
+        if(seen > target) return min(getBucketLimit(bucket), histogram.max) / 1000.0;
+    }
+    return histogram.max / 1000.0;
+}
+
+bool Profiler::isEnabled() {
+    return true;
+}
+
+int Profiler::registerSite(const char *name) {
+    lock_guard<mutex> lock(registry_mutex);
+    for(size_t i = 0; i < site_names.size(); i++) {
+        if(strcmp(site_names[i], name) == 0) return (int) i;
+    }
+    site_names.push_back(name);
+    return (int) site_names.size() - 1;
+}
+
+uint64_t Profiler::now() {
+    return (uint64_t) chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+}
+
+void Profiler::recordScope(int site, uint64_t start) {
+    uint64_t duration = now() - start;
+    ProfileBuffer &buffer = getBuffer();
+
+    if(buffer.events.size() < MAX_EVENTS_PER_THREAD) buffer.events.push_back({site, start, duration});
+    else buffer.dropped_events++;
+
+    if((size_t) site >= buffer.histograms.size()) buffer.histograms.resize(site + 1);
+    ProfileHistogram &histogram = buffer.histograms[site];
+    histogram.count++;
+    histogram.total += duration;
+    histogram.max = max(histogram.max, duration);
+    histogram.buckets[getBucket(duration)]++;
+}
+
+void Profiler::addCount(int site, uint64_t amount) {
+    ProfileBuffer &buffer = getBuffer();
+    if((size_t) site >= buffer.counts.size()) buffer.counts.resize(site + 1, 0);
+    buffer.counts[site] += amount;
+}
+
+bool Profiler::writeReport(const string &prefix) {
+    lock_guard<mutex> lock(registry_mutex);
+
+    ofstream trace(prefix + ".trace.json");
+    if(!trace.is_open()) return false;
+    trace << fixed << setprecision(3) << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    uint64_t dropped_events = 0;
+    for(const unique_ptr<ProfileBuffer> &buffer: buffers) {
+        trace << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                << buffer->thread_id << ",\"args\":{\"name\":\"thread " << buffer->thread_id << "\"}}";
+        first = false;
+        for(const ProfileEvent &event: buffer->events) {
+            trace << ",\n{\"name\":\"" << site_names[event.site] << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                    << buffer->thread_id << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":"
+                    << event.duration / 1000.0 << "}";
+        }
+        dropped_events += buffer->dropped_events;
+    }
+    trace << "\n]}\n";
+    trace.close();
+
+    // Merge the histograms and counters of every thread.
+    vector<ProfileHistogram> histograms(site_names.size());
+    vector<uint64_t> counts(site_names.size(), 0);
+    vector<bool> is_counter(site_names.size(), false);
+    for(const unique_ptr<ProfileBuffer> &buffer: buffers) {
+        for(size_t site = 0; site < buffer->histograms.size(); site++) {
+            const ProfileHistogram &from = buffer->histograms[site];
+            ProfileHistogram &to = histograms[site];
+            to.count += from.count;
+            to.total += from.total;
+            to.max = max(to.max, from.max);
+            for(int bucket = 0; bucket < NUM_BUCKETS; bucket++) to.buckets[bucket] += from.buckets[bucket];
+        }
+        for(size_t site = 0; site < buffer->counts.size(); site++) {
+            counts[site] += buffer->counts[site];
+            if(buffer->counts[site] > 0) is_counter[site] = true;
+        }
+    }
+
+    // Scopes that took the most time first.
+    vector<size_t> order;
+    for(size_t site = 0; site < site_names.size(); site++) if(histograms[site].count > 0) order.push_back(site);
+    sort(order.begin(), order.end(), [&histograms](size_t a, size_t b) { return histograms[a].total > histograms[b].total; });
+
+    ofstream report(prefix + ".txt");
+    if(!report.is_open()) return false;
+    report << left << setw(36) << "Scope" << right << setw(10) << "Calls" << setw(12) << "Total ms"
+            << setw(10) << "Mean us" << setw(10) << "p50 us" << setw(10) << "p90 us" << setw(10) << "p99 us"
+            << setw(12) << "Max us" << '\n';
+    report << fixed;
+    for(size_t site: order) {
+        const ProfileHistogram &histogram = histograms[site];
+        report << left << setw(36) << site_names[site] << right << setw(10) << histogram.count
+                << setprecision(2) << setw(12) << histogram.total / 1e6
+                << setw(10) << histogram.total / 1e3 / histogram.count
+                << setw(10) << getPercentile(histogram, 0.5) << setw(10) << getPercentile(histogram, 0.9)
+                << setw(10) << getPercentile(histogram, 0.99) << setw(12) << histogram.max / 1e3 << '\n';
+    }
+
+    report << '\n' << left << setw(36) << "Counter" << right << setw(14) << "Total" << '\n';
+    for(size_t site = 0; site < site_names.size(); site++) {
+        if(is_counter[site]) report << left << setw(36) << site_names[site] << right << setw(14) << counts[site] << '\n';
+    }
+
+    if(dropped_events > 0) {
+        report << '\n' << dropped_events << " scopes were left out of the trace (only "
+                << MAX_EVENTS_PER_THREAD << " are kept per thread).\n";
+    }
+    return report.good();
+}
+
+#else
+
+bool Profiler::isEnabled() {
+    return false;
+}
+
+int Profiler::registerSite(const char*) {
+    return 0;
+}
+
+uint64_t Profiler::now() {
+    return 0;
+}
+
+void Profiler::recordScope(int, uint64_t) {}
+
+void Profiler::addCount(int, uint64_t) {}
+
+bool Profiler::writeReport(const string&) {
+    return false;
+}
+
+#endif
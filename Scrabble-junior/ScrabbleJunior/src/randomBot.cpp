@@ -0,0 +1,16 @@
+#include "randomBot.h"
+
+// Random play is a baseline, so it stays random in the endgame.
+RandomBot::RandomBot(Rng rng): Bot(false, 0), rng(rng) {}
+
+const char* RandomBot::getName() const {
+    return "random";
+}
+
+void RandomBot::reset(Rng rng) {
+    this->rng = rng;
+}
+
+Turn RandomBot::decideTurn(GameState&, const TurnList &turns) {
+    return turns[(int) rng.below((uint32_t) turns.size())];
+}
@@ -0,0 +1,357 @@
+#include <algorithm>
+#include <sstream>
+#include "referenceGame.h"
+#include "hand.h"
+
+using namespace std;
+
+ReferenceGame::ReferenceGame(istream &board_file, unsigned int num_players, Rng rng):
+    hands(num_players, string(Hand::HAND_SIZE, EMPTY_SLOT)),
+    scores(num_players, 0),
+    current_player(0),
+    moves_left(2),
+    rng(rng)
+{
+    shared_ptr<Layout> board = make_shared<Layout>();
+    layout = board;
+    char separator;
+    if(!(board_file >> board->height >> separator >> board->width) || board->height <= 0 || board->width <= 0) {
+        board->width = board->height = 0;
+        error = "Failed to parse the size of the board.";
+        return;
+    }
+    int num_cells = board->width * board->height;
+    board->letters.assign(num_cells, ' ');
+    board->cell_words.assign(num_cells, {});
+    covered.assign(num_cells, false);
+
+    // Every line is a word, like "Ab H WORD" or "ABcd V WORD", until one can't be read.
+    string coordinates, orientation, word;
+    while(board_file >> coordinates >> orientation >> word) {
+        if(orientation != "H" && orientation != "V") break;
+        // The row and the column count like spreadsheet columns: 'Z' is 25, 'AA' is 26.
+        size_t column_start = coordinates.find_first_not_of("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+        if(column_start == 0 || column_start == string::npos || column_start > 3 || coordinates.size() - column_start > 3
+                || coordinates.find_first_not_of("abcdefghijklmnopqrstuvwxyz", column_start) != string::npos) {
+            break;
+        }
+        int y = 0, x = 0;
+        for(size_t i = 0; i < column_start; i++) y = y * 26 + (coordinates[i] - 'A' + 1);
+        for(size_t i = column_start; i < coordinates.size(); i++) x = x * 26 + (coordinates[i] - 'a' + 1);
+        x--;
+        y--;
+        WordInfo info = {Position(x, y), orientation == "H" ? Horizontal : Vertical, (int) word.size()};
+        Position end = letterPosition(info, info.length - 1);
+        if(!info.start.inLimits(board->width, board->height) || !end.inLimits(board->width, board->height)) break;
+
+        for(int i = 0; i < info.length; i++) {
+            int index = indexOf(letterPosition(info, i));
+            board->letters[index] = word[i];
+            board->cell_words[index].push_back((int) board->words.size());
+        }
+        board->words.push_back(info);
+    }
+
+    for(int y = 0; y < board->height; y++) {
+        for(int x = 0; x < board->width; x++) {
+            if(board->letters[indexOf(Position(x, y))] != ' ') board->letter_positions.push_back(Position(x, y));
+        }
+    }
+    for(Position position: board->letter_positions) bag.push_back(getLetter(position));
+    sort(bag.begin(), bag.end());
+}
+
+bool ReferenceGame::isValid() const {
+    return error.empty();
+}
+
+const string& ReferenceGame::getError() const {
+    return error;
+}
+
+int ReferenceGame::indexOf(Position position) const {
+    return position.getY() * layout->width + position.getX();
+}
+
+Position ReferenceGame::letterPosition(const WordInfo &word, int i) {
+    if(word.orientation == Horizontal) return Position(word.start.getX() + i, word.start.getY());
+    return Position(word.start.getX(), word.start.getY() + i);
+}
+
+bool ReferenceGame::isComplete(const WordInfo &word) const {
+    for(int i = 0; i < word.length; i++) {
+        if(!covered[indexOf(letterPosition(word, i))]) return false;
+    }
+    return true;
+}
+
+bool ReferenceGame::hasLetter(const string &hand, char letter) {
+    return hand.find(letter) != string::npos;
+}
+
+int ReferenceGame::getWidth() const {
+    return layout->width;
+}
+
+int ReferenceGame::getHeight() const {
+    return layout->height;
+}
+
+const vector<Position>& ReferenceGame::getLetterPositions() const {
+    return layout->letter_positions;
+}
+
+char ReferenceGame::getLetter(Position position) const {
+    return layout->letters[indexOf(position)];
+}
+
+bool ReferenceGame::isCovered(Position position) const {
+    return covered[indexOf(position)];
+}
+
+bool ReferenceGame::isCoverable(Position position) const {
+    int index = indexOf(position);
+    if(layout->letters[index] == ' ' || covered[index]) return false;
+
+    for(int word_index: layout->cell_words[index]) {
+        const WordInfo &word = layout->words[word_index];
+        bool previous_covered = true;
+        for(int i = 0; i < word.length && !(letterPosition(word, i) == position); i++) {
+            if(!covered[indexOf(letterPosition(word, i))]) previous_covered = false;
+        }
+        if(previous_covered) return true;
+    }
+    return false;
+}
+
+const string& ReferenceGame::getHand(unsigned int index) const {
+    return hands[index];
+}
+
+unsigned int ReferenceGame::getScore(unsigned int index) const {
+    return scores[index];
+}
+
+const string& ReferenceGame::getBag() const {
+    return bag;
+}
+
+unsigned int ReferenceGame::getCurrentPlayer() const {
+    return current_player;
+}
+
+unsigned int ReferenceGame::getMovesLeft() const {
+    return moves_left;
+}
+
+bool ReferenceGame::isOver() const {
+    for(Position position: layout->letter_positions) {
+        if(!isCovered(position)) return false;
+    }
+    return true;
+}
+
+bool ReferenceGame::canMove(const string &hand) const {
+    for(Position position: layout->letter_positions) {
+        if(isCoverable(position) && hasLetter(hand, getLetter(position))) return true;
+    }
+    return false;
+}
+
+char ReferenceGame::draw() {
+    size_t index = rng.below((uint32_t) bag.size());
+    char letter = bag[index];
+    bag.erase(index, 1);
+    return letter;
+}
+
+void ReferenceGame::putBack(char letter) {
+    bag.insert(lower_bound(bag.begin(), bag.end(), letter), letter);
+}
+
+void ReferenceGame::dealHands() {
+    for(string &hand: hands) {
+        for(char &slot: hand) {
+            if(slot == EMPTY_SLOT && !bag.empty()) slot = draw();
+        }
+    }
+}
+
+TurnState ReferenceGame::getTurnState() const {
+    if(canMove(hands[current_player])) return MUST_MOVE;
+    if(moves_left == 1) return MUST_END_TURN;
+    if(bag.size() >= 2) return MUST_EXCHANGE_TWO;
+    if(bag.size() == 1) return MUST_EXCHANGE_ONE;
+    return MUST_SKIP_TURN;
+}
+
+vector<Position> ReferenceGame::getLegalMoves() const {
+    const string &hand = hands[current_player];
+    vector<Position> moves;
+    for(Position position: layout->letter_positions) {
+        if(isCoverable(position) && hasLetter(hand, getLetter(position))) moves.push_back(position);
+    }
+    if(moves_left != 2) return moves;
+
+    // Players must move twice whenever possible, so if some first move
+    // lets them move again, only those are legal. Each is tried on a copy.
+    vector<Position> moves_twice;
+    for(Position position: moves) {
+        ReferenceGame after = *this;
+        after.apply(Action::move(position));
+        if(after.canMove(after.hands[current_player])) moves_twice.push_back(position);
+    }
+    return moves_twice.empty() ? moves : moves_twice;
+}
+
+ActionError ReferenceGame::checkAction(const Action &action) const {
+    return checkAction(action, getTurnState());
+}
+
+ActionError ReferenceGame::checkAction(const Action &action, TurnState turn_state) const {
+    const string &hand = hands[current_player];
+
+    switch(action.getType()) {
+        case ACTION_MOVE: {
+            Position position = action.getPosition();
+            if(!position.inLimits(layout->width, layout->height)) return MOVE_OUT_OF_LIMITS;
+            if(getLetter(position) == ' ') return MOVE_EMPTY_CELL;
+            if(isCovered(position)) return MOVE_ALREADY_COVERED;
+            if(!isCoverable(position)) return MOVE_NOT_COVERABLE;
+            if(!hasLetter(hand, getLetter(position))) return MOVE_LETTER_NOT_IN_HAND;
+            vector<Position> moves = getLegalMoves();
+            if(find(moves.begin(), moves.end(), position) == moves.end()) return MOVE_WOULD_PLAY_ONCE;
+            return ACTION_OK;
+        }
+        case ACTION_EXCHANGE_ONE: {
+            char letter = action.getLetter1();
+            if(turn_state != MUST_EXCHANGE_ONE) return ACTION_NOT_ALLOWED_NOW;
+            if(letter < 'A' || letter > 'Z') return EXCHANGE_NOT_A_LETTER;
+            if(!hasLetter(hand, letter)) return EXCHANGE_LETTER_NOT_IN_HAND;
+            return ACTION_OK;
+        }
+        case ACTION_EXCHANGE_TWO: {
+            char letter1 = action.getLetter1(), letter2 = action.getLetter2();
+            if(turn_state != MUST_EXCHANGE_TWO) return ACTION_NOT_ALLOWED_NOW;
+            if(letter1 < 'A' || letter1 > 'Z' || letter2 < 'A' || letter2 > 'Z') return EXCHANGE_NOT_A_LETTER;
+            if(!hasLetter(hand, letter1) || !hasLetter(hand, letter2)) return EXCHANGE_LETTER_NOT_IN_HAND;
+            if(letter1 == letter2 && count(hand.begin(), hand.end(), letter1) < 2) return EXCHANGE_ONLY_ONE_IN_HAND;
+            return ACTION_OK;
+        }
+        case ACTION_END_TURN:
+            if(turn_state != MUST_END_TURN && turn_state != MUST_SKIP_TURN) return ACTION_NOT_ALLOWED_NOW;
+            return ACTION_OK;
+    }
+    return ACTION_NOT_ALLOWED_NOW;
+}
+
+vector<Action> ReferenceGame::getLegalActions() const {
+    vector<Action> actions;
+    for(Position position: getLegalMoves()) actions.push_back(Action::move(position));
+
+    // Every other 'Action' that could ever be legal is tried.
+    vector<Action> candidates;
+    for(char letter1 = 'A'; letter1 <= 'Z'; letter1++) {
+        candidates.push_back(Action::exchange(letter1));
+        for(char letter2 = letter1; letter2 <= 'Z'; letter2++) candidates.push_back(Action::exchange(letter1, letter2));
+    }
+    candidates.push_back(Action::endTurn());
+
+    TurnState turn_state = getTurnState();
+    for(const Action &action: candidates) {
+        if(checkAction(action, turn_state) == ACTION_OK) actions.push_back(action);
+    }
+    return actions;
+}
+
+vector<Turn> ReferenceGame::getLegalTurns() const {
+    vector<Turn> turns;
+    for(const Action &action: getLegalActions()) {
+        switch(action.getType()) {
+            case ACTION_EXCHANGE_ONE:
+                turns.push_back(Turn::exchange(action.getLetter1()));
+                break;
+            case ACTION_EXCHANGE_TWO:
+                turns.push_back(Turn::exchange(action.getLetter1(), action.getLetter2()));
+                break;
+            case ACTION_END_TURN:
+                turns.push_back(Turn::end());
+                break;
+            case ACTION_MOVE: {
+                // A move either ends the turn, or is followed by any legal second move.
+                ReferenceGame after = *this;
+                after.apply(action);
+                if(after.current_player != current_player) {
+                    turns.push_back(Turn::moveOnce(action.getPosition()));
+                    break;
+                }
+                vector<Position> second_moves = after.getLegalMoves();
+                if(second_moves.empty()) turns.push_back(Turn::moveOnce(action.getPosition()));
+                for(Position second: second_moves) turns.push_back(Turn::moveTwice(action.getPosition(), second));
+                break;
+            }
+        }
+    }
+    return turns;
+}
+
+vector<ReferenceGame::WordInfo> ReferenceGame::apply(const Action &action) {
+    string &hand = hands[current_player];
+    vector<WordInfo> completed;
+
+    switch(action.getType()) {
+        case ACTION_MOVE: {
+            Position position = action.getPosition();
+            hand[hand.find(getLetter(position))] = EMPTY_SLOT;
+            covered[indexOf(position)] = true;
+            // The cell wasn't covered before, so none of its words was complete.
+            for(int word_index: layout->cell_words[indexOf(position)]) {
+                const WordInfo &word = layout->words[word_index];
+                if(isComplete(word)) completed.push_back(word);
+            }
+            scores[current_player] += (unsigned int) completed.size();
+            moves_left--;
+            if(moves_left == 0) endTurn();
+            break;
+        }
+        case ACTION_EXCHANGE_ONE: {
+            size_t slot = hand.find(action.getLetter1());
+            char drawn = draw();
+            putBack(hand[slot]);
+            hand[slot] = drawn;
+            endTurn();
+            break;
+        }
+        case ACTION_EXCHANGE_TWO: {
+            size_t slot1 = hand.find(action.getLetter1());
+            size_t slot2 = action.getLetter1() == action.getLetter2() ?
+                    hand.find(action.getLetter2(), slot1 + 1) : hand.find(action.getLetter2());
+            // Both letters are drawn before returning any, so they are never drawn back.
+            char drawn1 = draw();
+            char drawn2 = draw();
+            putBack(hand[slot1]);
+            putBack(hand[slot2]);
+            hand[slot1] = drawn1;
+            hand[slot2] = drawn2;
+            endTurn();
+            break;
+        }
+        case ACTION_END_TURN:
+            endTurn();
+            break;
+    }
+    return completed;
+}
+
+void ReferenceGame::endTurn() {
+    string &hand = hands[current_player];
+    if(!isOver()) {
+        for(char &slot: hand) {
+            if(bag.empty()) break;
+            if(slot == EMPTY_SLOT) slot = draw();
+        }
+    }
+
+    moves_left = 2;
+    current_player = (current_player + 1) % hands.size();
+}
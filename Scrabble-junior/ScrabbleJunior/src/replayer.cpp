@@ -0,0 +1,82 @@
+#include <sstream>
+#include <algorithm>
+#include "replayer.h"
+
+using namespace std;
+
+Replayer::Replayer(const Journal &journal, const Board &board, unsigned int keyframe_interval):
+    journal(journal),
+    board(board),
+    keyframe_interval(max(1u, keyframe_interval)),
+    final_state(board, journal.getNumPlayers(), journal.getRng()) {}
+
+bool Replayer::run() {
+    const vector<Action> &actions = journal.getActions();
+    GameState state(board, journal.getNumPlayers(), journal.getRng());
+    state.dealHands();
+
+    turn_starts.assign(1, 0);
+    keyframes.assign(1, state);
+    error.clear();
+
+    for(size_t i = 0; i < actions.size(); i++) {
+        const Action &action = actions[i];
+        // A 'Bot' ends its turn even if its move ended the game.
+        bool allowed_now = !state.isOver() || action.getType() == ACTION_END_TURN;
+        ActionError action_error = allowed_now ? state.checkAction(action) : ACTION_NOT_ALLOWED_NOW;
+        if(action_error != ACTION_OK) {
+            stringstream message;
+            message << "Action " << i << " ('" << action << "') of turn " << turn_starts.size() - 1
+                    << " is illegal (error " << action_error << ").";
+            error = message.str();
+            return false;
+        }
+
+        // The turn ends after anything but the first of two moves.
+        bool ends_turn = action.getType() != ACTION_MOVE || state.getMovesLeft() == 1;
+        state.applyAction(action);
+
+        if(ends_turn) {
+            turn_starts.push_back(i + 1);
+            if((turn_starts.size() - 1) % keyframe_interval == 0) keyframes.push_back(state);
+        }
+    }
+    final_state = state;
+
+    if(journal.isFinished()) {
+        if(!state.isOver()) {
+            error = "The journal ends before the game is over.";
+            return false;
+        }
+        if(state.getChecksum() != journal.getFinalChecksum()) {
+            error = "The game didn't end in the same state.";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const string& Replayer::getError() const {
+    return error;
+}
+
+unsigned int Replayer::countTurns() const {
+    return (unsigned int) turn_starts.size() - 1;
+}
+
+const GameState& Replayer::getFinalState() const {
+    return final_state;
+}
+
+GameState Replayer::seek(unsigned int turn) const {
+    turn = min(turn, countTurns());
+    unsigned int keyframe = turn / keyframe_interval;
+    GameState state = keyframes[keyframe];
+
+    const vector<Action> &actions = journal.getActions();
+    for(size_t i = turn_starts[keyframe * keyframe_interval]; i < turn_starts[turn]; i++) {
+        state.applyAction(actions[i]);
+    }
+    return state;
+}
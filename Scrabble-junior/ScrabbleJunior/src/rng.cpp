@@ -0,0 +1,74 @@
+#include "rng.h"
+
+// Auxiliary generator (splitmix64) used to expand a seed into the full
+// state, as recommended by the authors of xoshiro.
+static uint64_t splitmix64(uint64_t &x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+Xoshiro256::Xoshiro256(uint64_t seed, uint64_t stream) {
+    // Mix the stream into the seed so that close streams
+    // (0, 1, 2...) don't produce correlated states.
+    uint64_t stream_mix = stream;
+    uint64_t x = seed ^ splitmix64(stream_mix);
+    for(uint64_t &word: state) {
+        word = splitmix64(x);
+    }
+}
+
+Xoshiro256::result_type Xoshiro256::operator()() {
+    uint64_t result = rotl(state[1] * 5, 7) * 9;
+    uint64_t t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+
+    return result;
+}
+
+uint32_t Xoshiro256::below(uint32_t bound) {
+    // Lemire's multiply-and-reject method: unbiased and without divisions
+    // in the common case.
+    uint64_t product = (uint64_t) (uint32_t) ((*this)() >> 32) * bound;
+    uint32_t low = (uint32_t) product;
+    if(low < bound) {
+        uint32_t threshold = (uint32_t) -bound % bound;
+        while(low < threshold) {
+            product = (uint64_t) (uint32_t) ((*this)() >> 32) * bound;
+            low = (uint32_t) product;
+        }
+    }
+    return (uint32_t) (product >> 32);
+}
+
+Xoshiro256 Xoshiro256::split() {
+    uint64_t seed = (*this)();
+    uint64_t stream = (*this)();
+    return Xoshiro256(seed, stream);
+}
+
+void Xoshiro256::getState(uint64_t *out) const {
+    for(int i = 0; i < STATE_SIZE; i++) out[i] = state[i];
+}
+
+void Xoshiro256::setState(const uint64_t *in) {
+    for(int i = 0; i < STATE_SIZE; i++) state[i] = in[i];
+}
+
+bool Xoshiro256::operator==(const Xoshiro256 &other) const {
+    for(int i = 0; i < STATE_SIZE; i++) {
+        if(state[i] != other.state[i]) return false;
+    }
+    return true;
+}
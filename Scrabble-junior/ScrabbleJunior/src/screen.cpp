@@ -0,0 +1,155 @@
+#include <iostream>
+#include <algorithm>
+#include "screen.h"
+
+using namespace std;
+
+bool Screen::Glyph::operator==(const Glyph &other) const {
+    return character == other.character && color == other.color && background == other.background;
+}
+
+bool Screen::Glyph::operator!=(const Glyph &other) const {
+    return !(*this == other);
+}
+
+Screen::Screen(int width, int height, Color text_color, Color background):
+    width(width),
+    height(height),
+    text_color(text_color),
+    background(background),
+    ansi(enableAnsi()),
+    shown(width * height, {0, text_color, background}),
+    next(width * height, {' ', text_color, background}),
+    is_dirty(width * height, true),
+    cursor_x(-1),
+    cursor_y(-1),
+    cursor_color(text_color),
+    cursor_background(background),
+    colors_known(false)
+{
+    dirty.reserve(width * height);
+    for(int i = 0; i < width * height; i++) dirty.push_back(i);
+}
+
+int Screen::getWidth() const {
+    return width;
+}
+
+int Screen::getHeight() const {
+    return height;
+}
+
+Screen::Glyph Screen::blank() const {
+    return {' ', text_color, background};
+}
+
+void Screen::set(int x, int y, const Glyph &glyph) {
+    int index = y * width + x;
+    if(next[index] == glyph) return;
+    next[index] = glyph;
+    if(!is_dirty[index]) {
+        is_dirty[index] = true;
+        dirty.push_back(index);
+    }
+}
+
+void Screen::put(int x, int y, char character, Color color, Color background) {
+    if(x < 0 || y < 0 || x >= width || y >= height) return;
+    set(x, y, {character, color, background});
+}
+
+int Screen::print(int x, int y, const string &text, Color color, Color background) {
+    for(char character: text) {
+        put(x, y, character, color, background);
+        x++;
+    }
+    return x;
+}
+
+void Screen::erase(int x, int y, int length) {
+    if(y < 0 || y >= height) return;
+    for(int i = max(x, 0); i < min(x + length, width); i++) set(i, y, blank());
+}
+
+void Screen::clear() {
+    fill(shown.begin(), shown.end(), blank());
+    fill(next.begin(), next.end(), blank());
+    fill(is_dirty.begin(), is_dirty.end(), false);
+    dirty.clear();
+}
+
+void Screen::moveCursor(int x, int y) {
+    if(x == cursor_x && y == cursor_y) return;
+    if(ansi) {
+        ansiGotoxy(output, x, y);
+    } else {
+        cout << output;
+        output.clear();
+        gotoxy(x, y);
+    }
+    cursor_x = x;
+    cursor_y = y;
+}
+
+void Screen::changeColors(Color color, Color background) {
+    if(colors_known && color == cursor_color && background == cursor_background) return;
+    if(ansi) {
+        ansiSetcolor(output, color, background);
+    } else {
+        cout << output;
+        output.clear();
+        setcolor(color, background);
+    }
+    cursor_color = color;
+    cursor_background = background;
+    colors_known = true;
+}
+
+void Screen::write(char character) {
+    output += character;
+    cursor_x++;
+}
+
+void Screen::flush() {
+    // Changes are written from top to bottom and left to right, so the
+    // cursor moves as little as possible.
+    sort(dirty.begin(), dirty.end());
+    output.clear();
+    // Nobody else writes to the console during a frame, but anybody
+    // may have before it.
+    cursor_x = cursor_y = -1;
+    colors_known = false;
+
+    for(int index: dirty) {
+        is_dirty[index] = false;
+        const Glyph &glyph = next[index];
+        if(glyph == shown[index]) continue;
+        int x = index % width, y = index / width;
+
+        // Close enough to the cursor, the characters in between are written
+        // again if they have the same colors, which is shorter than moving.
+        bool rewrite = y == cursor_y && x > cursor_x && x - cursor_x <= MAX_REWRITTEN_GAP;
+        for(int i = cursor_x; rewrite && i < x; i++) {
+            const Glyph &between = shown[y * width + i];
+            rewrite = between == next[y * width + i] && between.character != 0 && colors_known
+                    && (between.color == cursor_color || between.character == ' ')
+                    && between.background == cursor_background;
+        }
+        if(rewrite) {
+            while(cursor_x < x) write(shown[y * width + cursor_x].character);
+        }
+
+        moveCursor(x, y);
+        // Spaces look the same in any color, so they keep the current one.
+        if(glyph.character == ' ' && colors_known) changeColors(cursor_color, glyph.background);
+        else changeColors(glyph.color, glyph.background);
+        write(glyph.character);
+        shown[index] = glyph;
+    }
+    dirty.clear();
+
+    changeColors(text_color, background);
+    moveCursor(0, height);
+    cout << output;
+    cout.flush();
+}
@@ -0,0 +1,105 @@
+#include "session.h"
+
+using namespace std;
+
+Session::Session(const Board &board, unsigned int num_players, Rng rng):
+    state(board, num_players, rng),
+    journal(nullptr),
+    started(false),
+    can_undo_last_move(false),
+    turns_played(0)
+{}
+
+void Session::setObserver(GameObserver *observer) {
+    state.setObserver(observer);
+}
+
+void Session::setJournal(Journal *journal) {
+    this->journal = journal;
+}
+
+void Session::start() {
+    if(started) return;
+    state.dealHands();
+    started = true;
+}
+
+bool Session::restore(const Snapshot &snapshot) {
+    started = true;
+    return snapshot.restore(state);
+}
+
+bool Session::isStarted() const {
+    return started;
+}
+
+const GameState& Session::getState() const {
+    return state;
+}
+
+GameState& Session::getState() {
+    return state;
+}
+
+SessionPrompt Session::getPrompt() const {
+    if(state.isOver()) return PROMPT_GAME_OVER;
+
+    switch(state.getTurnState()) {
+        case MUST_MOVE: return PROMPT_MOVE;
+        case MUST_EXCHANGE_TWO: return PROMPT_EXCHANGE_TWO;
+        case MUST_EXCHANGE_ONE: return PROMPT_EXCHANGE_ONE;
+        default: return PROMPT_END_TURN;
+    }
+}
+
+unsigned long Session::countTurns() const {
+    return turns_played;
+}
+
+ActionError Session::submit(const Action &action) {
+    if(!started || state.isOver()) return ACTION_NOT_ALLOWED_NOW;
+
+    ActionError error = state.checkAction(action);
+    if(error != ACTION_OK) return error;
+
+    if(journal != nullptr) journal->record(action);
+
+    if(action.getType() == ACTION_MOVE && state.getMovesLeft() == 2) {
+        // Only the first move of a turn can be undone: the second
+        // one ends the turn, which draws new letters.
+        last_move = state.applyMove(action.getPosition());
+        can_undo_last_move = true;
+        return ACTION_OK;
+    }
+
+    state.applyAction(action);
+    can_undo_last_move = false;
+    turns_played++;
+    return ACTION_OK;
+}
+
+ActionError Session::submit(const Turn &turn) {
+    Action actions[Turn::MAX_ACTIONS];
+    int count = turn.getActions(actions);
+    unsigned long turn_number = turns_played;
+
+    for(int i = 0; i < count; i++) {
+        // A single move may end the turn (or the game) by itself,
+        // and then there is no turn left to end.
+        if(turns_played != turn_number || state.isOver()) break;
+
+        ActionError error = submit(actions[i]);
+        if(error != ACTION_OK) return error;
+    }
+    return ACTION_OK;
+}
+
+bool Session::canUndo() const {
+    return can_undo_last_move && !state.isOver();
+}
+
+void Session::undo() {
+    if(journal != nullptr) journal->forgetLast();
+    state.unmakeMove(last_move);
+    can_undo_last_move = false;
+}
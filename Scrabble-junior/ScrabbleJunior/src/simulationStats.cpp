@@ -0,0 +1,234 @@
+#include <iomanip>
+#include <cmath>
+#include "simulationStats.h"
+#include "allocationCounter.h"
+
+using namespace std;
+
+SimulationStats::SimulationStats(const Board &board, unsigned int num_players):
+    num_players(num_players),
+    board_width(board.getWidth()),
+    board_height(board.getHeight()),
+    letter_positions(board.getLetterPositions()),
+    games(0),
+    unfinished_games(0),
+    win_shares(num_players, 0),
+    score_histogram(num_players, vector<unsigned long>(board.countWords() + 1, 0)),
+    turns(0),
+    exchanges(0),
+    skips(0),
+    covered_turn_sum(board.countLetters(), 0),
+    covered_count(board.countLetters(), 0),
+    turn_allocations(0),
+    allocating_turns(0),
+    game_exchanges(0),
+    game_skips(0),
+    game_turn_allocations(0),
+    game_allocating_turns(0)
+{}
+
+void SimulationStats::recordTurn(const Board &board, const Turn &turn, unsigned int turn_number) {
+    switch(turn.getType()) {
+        case TURN_MOVE_TWICE: {
+            int second = board.getLetterAt(turn.getSecond());
+            covered_turn_sum[second] += turn_number;
+            covered_count[second]++;
+        }
+        // fall through
+        case TURN_MOVE_ONCE: {
+            int first = board.getLetterAt(turn.getFirst());
+            covered_turn_sum[first] += turn_number;
+            covered_count[first]++;
+            break;
+        }
+        case TURN_EXCHANGE_ONE:
+        case TURN_EXCHANGE_TWO:
+            game_exchanges++;
+            break;
+        case TURN_END:
+            // A whole turn with nothing to do is skipped.
+            game_skips++;
+            break;
+    }
+}
+
+void SimulationStats::recordAllocations(unsigned long allocations) {
+    game_turn_allocations += allocations;
+    if(allocations > 0) game_allocating_turns++;
+}
+
+void SimulationStats::recordGame(const vector<Player> &players, unsigned int num_turns) {
+    games++;
+    turns += num_turns;
+    exchanges += game_exchanges;
+    skips += game_skips;
+    turn_allocations += game_turn_allocations;
+    allocating_turns += game_allocating_turns;
+    game_exchanges = game_skips = game_turn_allocations = game_allocating_turns = 0;
+    if(turns_histogram.size() <= num_turns) turns_histogram.resize(num_turns + 1, 0);
+    turns_histogram[num_turns]++;
+
+    unsigned int best_score = 0;
+    int num_winners = 0;
+    for(unsigned int seat = 0; seat < num_players; seat++) {
+        unsigned int score = players[seat].getScore();
+        score_histogram[seat][score]++;
+
+        if(score > best_score) {
+            best_score = score;
+            num_winners = 1;
+        } else if(score == best_score) {
+            num_winners++;
+        }
+    }
+
+    for(unsigned int seat = 0; seat < num_players; seat++) {
+        if(players[seat].getScore() == best_score) win_shares[seat] += WIN_SHARES / num_winners;
+    }
+}
+
+void SimulationStats::recordUnfinishedGame() {
+    unfinished_games++;
+    game_exchanges = game_skips = game_turn_allocations = game_allocating_turns = 0;
+}
+
+void SimulationStats::merge(const SimulationStats &other) {
+    games += other.games;
+    unfinished_games += other.unfinished_games;
+    turns += other.turns;
+    exchanges += other.exchanges;
+    skips += other.skips;
+    turn_allocations += other.turn_allocations;
+    allocating_turns += other.allocating_turns;
+
+    for(unsigned int seat = 0; seat < num_players; seat++) {
+        win_shares[seat] += other.win_shares[seat];
+        for(size_t score = 0; score < score_histogram[seat].size(); score++) {
+            score_histogram[seat][score] += other.score_histogram[seat][score];
+        }
+    }
+
+    if(turns_histogram.size() < other.turns_histogram.size()) {
+        turns_histogram.resize(other.turns_histogram.size(), 0);
+    }
+    for(size_t i = 0; i < other.turns_histogram.size(); i++) turns_histogram[i] += other.turns_histogram[i];
+
+    for(size_t i = 0; i < covered_turn_sum.size(); i++) {
+        covered_turn_sum[i] += other.covered_turn_sum[i];
+        covered_count[i] += other.covered_count[i];
+    }
+}
+
+unsigned long SimulationStats::getGames() const {
+    return games;
+}
+
+unsigned int SimulationStats::getScorePercentile(unsigned int seat, double fraction) const {
+    const vector<unsigned long> &histogram = score_histogram[seat];
+    unsigned long seen = 0;
+    for(size_t score = 0; score < histogram.size(); score++) {
+        seen += histogram[score];
+        if(seen > 0 && seen >= fraction * games) return (unsigned int) score;
+    }
+    return (unsigned int) histogram.size() - 1;
+}
+
+unsigned int SimulationStats::getTurnsPercentile(double fraction) const {
+    unsigned long seen = 0;
+    for(size_t num_turns = 0; num_turns < turns_histogram.size(); num_turns++) {
+        seen += turns_histogram[num_turns];
+        if(seen > 0 && seen >= fraction * games) return (unsigned int) num_turns;
+    }
+    return 0;
+}
+
+void SimulationStats::print(ostream &out) const {
+    out << fixed;
+    out << "Games: " << games;
+    if(unfinished_games > 0) out << " (and " << unfinished_games << " stopped for being too long)";
+    out << endl;
+    if(games == 0) return;
+
+    // Wins and scores of each seat.
+    out << endl << "Seat  Win rate   Mean score  Std dev   Min  10%  50%  90%  Max" << endl;
+    for(unsigned int seat = 0; seat < num_players; seat++) {
+        const vector<unsigned long> &histogram = score_histogram[seat];
+        double sum = 0, sum_squares = 0;
+        for(size_t score = 0; score < histogram.size(); score++) {
+            sum += (double) score * histogram[score];
+            sum_squares += (double) score * score * histogram[score];
+        }
+        double mean = sum / games;
+        double std_dev = sqrt(max(0.0, sum_squares / games - mean * mean));
+
+        out << "P" << seat + 1 << "    "
+                << setw(7) << setprecision(2) << 100.0 * win_shares[seat] / WIN_SHARES / games << "%  "
+                << setw(10) << setprecision(2) << mean << "  "
+                << setw(7) << setprecision(2) << std_dev << " "
+                << setw(5) << getScorePercentile(seat, 0)
+                << setw(5) << getScorePercentile(seat, 0.1)
+                << setw(5) << getScorePercentile(seat, 0.5)
+                << setw(5) << getScorePercentile(seat, 0.9)
+                << setw(5) << getScorePercentile(seat, 1) << endl;
+    }
+
+    // Full distribution of the scores, only with the scores reached.
+    out << endl << "Score distribution (games with each score, by seat):" << endl;
+    out << "Score";
+    for(unsigned int seat = 0; seat < num_players; seat++) out << setw(10) << "P" + to_string(seat + 1);
+    out << endl;
+    for(size_t score = 0; score < score_histogram[0].size(); score++) {
+        bool reached = false;
+        for(unsigned int seat = 0; seat < num_players; seat++) reached |= score_histogram[seat][score] > 0;
+        if(!reached) continue;
+
+        out << setw(5) << score;
+        for(unsigned int seat = 0; seat < num_players; seat++) out << setw(10) << score_histogram[seat][score];
+        out << endl;
+    }
+
+    // Length of the games.
+    out << endl << "Turns per game: mean " << setprecision(1) << (double) turns / games
+            << ", min " << getTurnsPercentile(0)
+            << ", 50% " << getTurnsPercentile(0.5)
+            << ", 90% " << getTurnsPercentile(0.9)
+            << ", max " << getTurnsPercentile(1) << endl;
+    out << "Exchanges: " << setprecision(2) << (double) exchanges / games << " per game ("
+            << 100.0 * exchanges / turns << "% of turns)" << endl;
+    out << "Skips: " << setprecision(2) << (double) skips / games << " per game ("
+            << 100.0 * skips / turns << "% of turns)" << endl;
+    if(AllocationCounter::isEnabled()) {
+        out << "Allocations: " << setprecision(4) << (double) turn_allocations / turns << " per turn ("
+                << allocating_turns << " of " << turns << " turns allocated)" << endl;
+    }
+
+    out << endl << "Mean turn on which each cell was covered:" << endl;
+    if(board_width > MAX_HEATMAP_SIZE || board_height > MAX_HEATMAP_SIZE) {
+        // Too large to draw, so each letter is listed instead.
+        for(size_t i = 0; i < letter_positions.size(); i++) {
+            out << "  " << letter_positions[i] << ' ';
+            if(covered_count[i] == 0) out << "." << endl;
+            else out << setprecision(1) << (double) covered_turn_sum[i] / covered_count[i] << endl;
+        }
+        return;
+    }
+
+    // Heatmap, in the same layout as the 'Board'.
+    vector<int> letter_at(board_width * board_height, Board::NO_LETTER);
+    for(size_t i = 0; i < letter_positions.size(); i++) {
+        letter_at[letter_positions[i].getY() * board_width + letter_positions[i].getX()] = (int) i;
+    }
+
+    out << "  ";
+    for(unsigned int x = 0; x < board_width; x++) out << setw(5) << Position::columnName((int) x);
+    out << endl;
+    for(unsigned int y = 0; y < board_height; y++) {
+        out << Position::rowName((int) y) << " ";
+        for(unsigned int x = 0; x < board_width; x++) {
+            int letter = letter_at[y * board_width + x];
+            if(letter == Board::NO_LETTER || covered_count[letter] == 0) out << setw(5) << ".";
+            else out << setw(5) << setprecision(1) << (double) covered_turn_sum[letter] / covered_count[letter];
+        }
+        out << endl;
+    }
+}
@@ -0,0 +1,114 @@
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include "simulator.h"
+#include "gameState.h"
+#include "bot.h"
+#include "rng.h"
+#include "allocationCounter.h"
+#include "profiler.h"
+
+using namespace std;
+
+Simulator::Simulator(const Board &board, unsigned int num_players, const vector<string> &bot_names,
+        uint64_t seed, int time_budget_ms):
+    board(board),
+    num_players(num_players),
+    bot_names(bot_names),
+    seed(seed),
+    time_budget_ms(time_budget_ms),
+    exporter(nullptr) {}
+
+void Simulator::setExporter(DatasetWriter *exporter) {
+    this->exporter = exporter;
+}
+
+void Simulator::playGame(unsigned long game_index, vector<unique_ptr<Bot>> &bots, TurnList &turns,
+        SimulationStats &stats, vector<uint8_t> &records) const
+{
+    // Everything random in the game comes from its own stream.
+    Rng rng(seed, game_index);
+    GameState state(board, num_players, rng.split());
+    for(auto &bot: bots) bot->reset(rng.split());
+
+    state.dealHands();
+    unsigned int num_turns = 0;
+    while(!state.isOver()) {
+        if(num_turns == MAX_TURNS) {
+            stats.recordUnfinishedGame();
+            records.clear();
+            if(exporter != nullptr) exporter->addGame(game_index, records);
+            return;
+        }
+
+        if(exporter != nullptr) {
+            size_t record_size = exporter->getEncoder().getRecordSize();
+            records.resize(records.size() + record_size);
+            exporter->getEncoder().encode(state, &records[records.size() - record_size]);
+        }
+
+        uint64_t allocations = AllocationCounter::count();
+        Turn turn;
+        {
+            PROFILE_SCOPE("GameState::getLegalTurns");
+            state.getLegalTurns(turns);
+        }
+        {
+            PROFILE_SCOPE("Bot::chooseTurn");
+            turn = bots[state.getCurrentPlayerIndex()]->chooseTurn(state, turns);
+        }
+        {
+            PROFILE_SCOPE("GameState::applyTurn");
+            state.applyTurn(turn);
+        }
+        stats.recordAllocations((unsigned long) (AllocationCounter::count() - allocations));
+        stats.recordTurn(state.getBoard(), turn, num_turns);
+        num_turns++;
+    }
+
+    stats.recordGame(state.getPlayers(), num_turns);
+
+    if(exporter != nullptr) {
+        const PositionEncoder &encoder = exporter->getEncoder();
+        for(size_t offset = 0; offset < records.size(); offset += encoder.getRecordSize()) {
+            encoder.setOutcome(&records[offset], state.getPlayers());
+        }
+        exporter->addGame(game_index, records);
+        records.clear();
+    }
+}
+
+SimulationStats Simulator::run(unsigned long num_games, unsigned int num_threads) const {
+    if(num_threads == 0) num_threads = max(1u, thread::hardware_concurrency());
+
+    atomic<unsigned long> next_game(0);
+    vector<SimulationStats> thread_stats(num_threads, SimulationStats(board, num_players));
+
+    auto work = [&](unsigned int thread_index) {
+        unique_ptr<TurnList> turns(new TurnList());
+        vector<uint8_t> records;
+        // The bots of this thread play every game it takes. Games already
+        // run on every thread, so bots don't search on more.
+        vector<unique_ptr<Bot>> bots;
+        for(const string &name: bot_names) bots.push_back(createBot(name, Rng(), time_budget_ms, 1));
+        while(true) {
+            unsigned long first = next_game.fetch_add(CHUNK_SIZE);
+            if(first >= num_games) break;
+
+            unsigned long last = min(num_games, first + CHUNK_SIZE);
+            for(unsigned long game = first; game < last; game++) {
+                playGame(game, bots, *turns, thread_stats[thread_index], records);
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for(unsigned int i = 1; i < num_threads; i++) threads.emplace_back(work, i);
+    work(0);
+    for(thread &t: threads) t.join();
+
+    SimulationStats stats(board, num_players);
+    for(const SimulationStats &partial: thread_stats) stats.merge(partial);
+    return stats;
+}
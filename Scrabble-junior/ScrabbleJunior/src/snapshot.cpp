@@ -0,0 +1,195 @@
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include "snapshot.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace std;
+
+// First bytes of every snapshot.
+static const char MAGIC[4] = {'S', 'J', 'S', 0};
+
+// The layout is shared by every platform, so it must not depend on the compiler.
+static_assert(sizeof(Snapshot::Header) == 296, "Snapshot::Header must have a fixed layout");
+
+Snapshot::Snapshot() {}
+
+const Snapshot::Header& Snapshot::getHeader() const {
+    return *reinterpret_cast<const Header*>(data.data());
+}
+
+const char* Snapshot::getBody() const {
+    return reinterpret_cast<const char*>(data.data()) + sizeof(Header);
+}
+
+Snapshot Snapshot::capture(const GameState &state, const string &board_name, uint64_t board_hash,
+        const vector<string> &seats, const string &journal_name, size_t journal_actions)
+{
+    const Board &board = state.getBoard();
+    const vector<Position> &letter_positions = board.getLetterPositions();
+    size_t board_name_size = min(board_name.size(), (size_t) 255);
+    size_t journal_name_size = min(journal_name.size(), (size_t) 255);
+    size_t total_size = sizeof(Header) + letter_positions.size() + board_name_size + journal_name_size;
+
+    Snapshot snapshot;
+    snapshot.data.assign((total_size + 7) / 8, 0);
+    Header &header = *reinterpret_cast<Header*>(snapshot.data.data());
+
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.header_size = sizeof(Header);
+    header.total_size = (uint32_t) total_size;
+    header.num_cells = (uint32_t) letter_positions.size();
+    header.board_hash = board_hash;
+    header.checksum = state.getChecksum();
+    state.rng.getState(header.rng_state);
+    for(char letter = 'A'; letter <= 'Z'; letter++) header.pool_count[letter - 'A'] = state.pool.countLetter(letter);
+
+    header.num_players = (uint8_t) state.players.size();
+    header.current_player = (uint8_t) state.current_player_index;
+    header.moves_left = (uint8_t) state.moves_left;
+    for(size_t i = 0; i < state.players.size(); i++) {
+        header.scores[i] = state.players[i].getScore();
+        for(int slot = 0; slot < Hand::HAND_SIZE; slot++) header.hands[i][slot] = state.players[i].getHand().getSlot(slot);
+        if(i < seats.size()) strncpy(header.seats[i], seats[i].c_str(), sizeof(header.seats[i]) - 1);
+    }
+    header.journal_actions = (uint32_t) journal_actions;
+    header.board_name_size = (uint8_t) board_name_size;
+    header.journal_name_size = (uint8_t) journal_name_size;
+
+    char *body = reinterpret_cast<char*>(snapshot.data.data()) + sizeof(Header);
+    for(size_t i = 0; i < letter_positions.size(); i++) body[i] = (char) board.getLetterCell((int) i).getState();
+    body += letter_positions.size();
+    memcpy(body, board_name.data(), board_name_size);
+    memcpy(body + board_name_size, journal_name.data(), journal_name_size);
+
+    return snapshot;
+}
+
+bool Snapshot::writeFileAtomically(const string &name, const void *data, size_t size) {
+    // Write everything to a temporary file first, and only then put
+    // it in place of the old one, which is a single step.
+    string temporary_name = name + ".tmp";
+    {
+        ofstream file(temporary_name, ios::binary | ios::trunc);
+        if(!file.is_open()) return false;
+        file.write(static_cast<const char*>(data), (streamsize) size);
+        file.flush();
+        if(!file.good()) return false;
+    }
+
+#ifdef _WIN32
+    return MoveFileExA(temporary_name.c_str(), name.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(temporary_name.c_str(), name.c_str()) == 0;
+#endif
+}
+
+bool Snapshot::parse(const void *bytes, size_t size) {
+    data.clear();
+    if(size < sizeof(Header)) return false;
+
+    Header header;
+    memcpy(&header, bytes, sizeof(Header));
+    if(memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    // Checked first, since no other field can be read with another byte order.
+    if(header.byte_order != BYTE_ORDER_MARK) return false;
+    if(header.version != VERSION || header.header_size != sizeof(Header)) return false;
+    if(header.total_size != size) return false;
+    if(header.total_size != sizeof(Header) + header.num_cells + header.board_name_size + header.journal_name_size) {
+        return false;
+    }
+    if(header.num_players < 2 || header.num_players > GameState::MAX_PLAYERS) return false;
+    if(header.current_player >= header.num_players || header.moves_left > 2) return false;
+
+    data.assign((size + 7) / 8, 0);
+    memcpy(data.data(), bytes, size);
+    return true;
+}
+
+bool Snapshot::load(const string &name) {
+    data.clear();
+    ifstream file(name, ios::binary | ios::ate);
+    if(!file.is_open()) return false;
+
+    streamsize size = file.tellg();
+    if(size <= 0) return false;
+    vector<char> bytes((size_t) size);
+    file.seekg(0);
+    if(!file.read(bytes.data(), size)) return false;
+    return parse(bytes.data(), bytes.size());
+}
+
+bool Snapshot::save(const string &name) const {
+    if(data.empty()) return false;
+    return writeFileAtomically(name, data.data(), getHeader().total_size);
+}
+
+string Snapshot::getBoardName() const {
+    return string(getBody() + getHeader().num_cells, getHeader().board_name_size);
+}
+
+uint64_t Snapshot::getBoardHash() const {
+    return getHeader().board_hash;
+}
+
+unsigned int Snapshot::getNumPlayers() const {
+    return getHeader().num_players;
+}
+
+vector<string> Snapshot::getSeats() const {
+    const Header &header = getHeader();
+    vector<string> seats;
+    for(unsigned int i = 0; i < header.num_players; i++) {
+        seats.push_back(string(header.seats[i], strnlen(header.seats[i], sizeof(header.seats[i]))));
+    }
+    return seats;
+}
+
+string Snapshot::getJournalName() const {
+    const Header &header = getHeader();
+    return string(getBody() + header.num_cells + header.board_name_size, header.journal_name_size);
+}
+
+size_t Snapshot::getJournalActions() const {
+    return getHeader().journal_actions;
+}
+
+bool Snapshot::restore(GameState &state) const {
+    const Header &header = getHeader();
+    if(data.empty() || header.num_players != state.players.size()) return false;
+    if(header.num_cells != state.board.getLetterPositions().size()) return false;
+
+    state.board.setCellStates(reinterpret_cast<const uint8_t*>(getBody()));
+
+    // Every letter goes back to the 'Pool' before being dealt as saved,
+    // so the 'Pool' ends with exactly the letters that aren't in a 'Hand'.
+    for(Player &player: state.players) player.getHand().returnLetters(state.pool);
+    for(char letter = 'A'; letter <= 'Z'; letter++) {
+        while((uint32_t) state.pool.countLetter(letter) > header.pool_count[letter - 'A']) {
+            state.pool.takeLetter(letter);
+        }
+    }
+
+    for(size_t i = 0; i < state.players.size(); i++) {
+        Player &player = state.players[i];
+        player.removeScore(player.getScore());
+        player.addScore(header.scores[i]);
+        for(int slot = 0; slot < Hand::HAND_SIZE; slot++) {
+            char letter = header.hands[i][slot];
+            player.getHand().clearSlot(slot);
+            if(letter >= 'A' && letter <= 'Z') player.getHand().putLetter(slot, letter);
+        }
+    }
+
+    state.current_player_index = header.current_player;
+    state.moves_left = header.moves_left;
+    state.rng.setState(header.rng_state);
+
+    return state.getChecksum() == header.checksum;
+}
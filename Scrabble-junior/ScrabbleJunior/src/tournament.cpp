@@ -0,0 +1,296 @@
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <bitset>
+#include <algorithm>
+#include "tournament.h"
+#include "rng.h"
+
+using namespace std;
+
+Tournament::Tournament(const vector<const Board*> &boards, const vector<string> &bot_names,
+        const vector<unsigned int> &player_counts, uint64_t seed, int time_budget_ms):
+    bot_names(bot_names),
+    seed(seed),
+    time_budget_ms(time_budget_ms),
+    rounds(0),
+    elapsed_seconds(0)
+{
+    unsigned int num_bots = (unsigned int) bot_names.size();
+
+    for(const Board *board: boards) {
+        for(unsigned int num_players: player_counts) {
+            if(num_players < 2 || num_players > GameState::MAX_PLAYERS) continue;
+            if(num_players > num_bots || board->countLetters() < 7u * num_players) continue;
+
+            // Every group of 'num_players' different bots, as a set of bits.
+            for(uint32_t group = 0; group < ((uint32_t) 1 << num_bots); group++) {
+                if(bitset<32>(group).count() != num_players) continue;
+
+                Matchup matchup;
+                matchup.board = board;
+                for(unsigned int bot = 0; bot < num_bots; bot++) {
+                    if(group & ((uint32_t) 1 << bot)) matchup.bots.push_back(bot);
+                }
+                matchups.push_back(matchup);
+            }
+        }
+    }
+}
+
+unsigned long Tournament::countGamesPerRound() const {
+    unsigned long games = 0;
+    for(const Matchup &matchup: matchups) games += matchup.bots.size();
+    return games;
+}
+
+Tournament::RoundResult Tournament::playRound(const Matchup &matchup, unsigned long round,
+        vector<unique_ptr<Bot>> &bots, TurnList &turns) const
+{
+    RoundResult result = {};
+    unsigned int num_players = (unsigned int) matchup.bots.size();
+
+    // Every game of the round (of any 'Matchup') draws with the same generator.
+    Rng round_rng(seed, round);
+    Rng pool_rng = round_rng.split();
+
+    for(unsigned int rotation = 0; rotation < num_players; rotation++) {
+        // The bot in each seat, as its position in 'matchup.bots'.
+        unsigned int seats[GameState::MAX_PLAYERS];
+        for(unsigned int seat = 0; seat < num_players; seat++) {
+            seats[seat] = (seat + rotation) % num_players;
+            bots[matchup.bots[seats[seat]]]->reset(round_rng.split());
+        }
+
+        GameState state(*matchup.board, num_players, pool_rng);
+        state.dealHands();
+        unsigned int num_turns = 0;
+        while(!state.isOver() && num_turns < MAX_TURNS) {
+            state.getLegalTurns(turns);
+            Bot &bot = *bots[matchup.bots[seats[state.getCurrentPlayerIndex()]]];
+            state.applyTurn(bot.chooseTurn(state, turns));
+            num_turns++;
+        }
+
+        if(!state.isOver()) {
+            result.unfinished_games++;
+            continue;
+        }
+        result.games++;
+
+        unsigned int scores[GameState::MAX_PLAYERS];
+        unsigned int best_score = 0, num_winners = 0;
+        for(unsigned int seat = 0; seat < num_players; seat++) {
+            unsigned int score = state.getPlayers()[seat].getScore();
+            scores[seats[seat]] = score;
+            best_score = max(best_score, score);
+        }
+        for(unsigned int i = 0; i < num_players; i++) {
+            if(scores[i] == best_score) num_winners++;
+        }
+
+        for(unsigned int i = 0; i < num_players; i++) {
+            if(scores[i] == best_score) result.win_shares[i] += WIN_SHARES / num_winners;
+            for(unsigned int j = 0; j < num_players; j++) {
+                if(i == j) continue;
+                if(scores[i] > scores[j]) result.points[i][j] += 2;
+                else if(scores[i] == scores[j]) result.points[i][j] += 1;
+            }
+        }
+    }
+
+    return result;
+}
+
+void Tournament::run(unsigned long rounds, unsigned int num_threads) {
+    if(num_threads == 0) num_threads = max(1u, thread::hardware_concurrency());
+    this->rounds = rounds;
+    results.assign(matchups.size() * rounds, RoundResult());
+
+    auto start = chrono::steady_clock::now();
+
+    // Rounds are handed out in order, each with every 'Matchup', so
+    // that the threads play the same seeds at about the same time.
+    unsigned long num_tasks = matchups.size() * rounds;
+    atomic<unsigned long> next_task(0);
+
+    auto work = [&]() {
+        unique_ptr<TurnList> turns(new TurnList());
+        // The bots of this thread play every game it takes. Games already
+        // run on every thread, so bots don't search on more.
+        vector<unique_ptr<Bot>> bots;
+        for(const string &name: bot_names) bots.push_back(createBot(name, Rng(), time_budget_ms, 1));
+
+        while(true) {
+            unsigned long task = next_task.fetch_add(1);
+            if(task >= num_tasks) break;
+
+            unsigned long round = task / matchups.size();
+            unsigned long matchup = task % matchups.size();
+            // Each task writes its own result, so there is nothing to lock.
+            results[matchup * rounds + round] = playRound(matchups[matchup], round, bots, *turns);
+        }
+    };
+
+    vector<thread> threads;
+    for(unsigned int i = 1; i < num_threads; i++) threads.emplace_back(work);
+    work();
+    for(thread &t: threads) t.join();
+
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    elapsed_seconds = elapsed.count();
+}
+
+void Tournament::addResult(const Matchup &matchup, const RoundResult &result, Totals &totals) {
+    for(size_t i = 0; i < matchup.bots.size(); i++) {
+        for(size_t j = 0; j < matchup.bots.size(); j++) {
+            if(i == j) continue;
+            totals.points[matchup.bots[i]][matchup.bots[j]] += result.points[i][j];
+            totals.games[matchup.bots[i]][matchup.bots[j]] += result.games;
+        }
+    }
+}
+
+vector<double> Tournament::fitRatings(const Totals &totals) const {
+    size_t num_bots = bot_names.size();
+    if(num_bots < 2) return vector<double>(num_bots, BASE_RATING);
+
+    // Strength of each bot: 'i' is expected to beat 'j' in a fraction
+    // 'strength[i] / (strength[i] + strength[j])' of their games. Every
+    // pair starts with a tie, so that a bot that never won (or never
+    // lost) still has a finite strength.
+    vector<double> strength(num_bots, 1);
+    vector<double> wins(num_bots, 0);
+    for(size_t i = 0; i < num_bots; i++) {
+        for(size_t j = 0; j < num_bots; j++) {
+            if(i != j) wins[i] += (totals.points[i][j] + 1) / 2;
+        }
+    }
+
+    // Minorization-maximization: each step gets closer to the strengths
+    // that are most likely to have produced 'totals'.
+    for(int iteration = 0; iteration < 10000; iteration++) {
+        vector<double> next(num_bots);
+        double log_sum = 0;
+        for(size_t i = 0; i < num_bots; i++) {
+            double expected = 0;
+            for(size_t j = 0; j < num_bots; j++) {
+                if(i != j) expected += (totals.games[i][j] + 1) / (strength[i] + strength[j]);
+            }
+            next[i] = wins[i] / expected;
+            log_sum += log(next[i]);
+        }
+
+        // Keep the average bot at strength 1.
+        double mean = exp(log_sum / num_bots);
+        double change = 0;
+        for(size_t i = 0; i < num_bots; i++) {
+            next[i] /= mean;
+            change = max(change, fabs(next[i] - strength[i]));
+        }
+        strength = next;
+        if(change < 1e-9) break;
+    }
+
+    vector<double> ratings(num_bots);
+    for(size_t i = 0; i < num_bots; i++) ratings[i] = BASE_RATING + 400 * log10(strength[i]);
+    return ratings;
+}
+
+void Tournament::print(ostream &out) const {
+    size_t num_bots = bot_names.size();
+    auto emptyTotals = [&]() {
+        Totals totals;
+        totals.points.assign(num_bots, vector<double>(num_bots, 0));
+        totals.games.assign(num_bots, vector<double>(num_bots, 0));
+        return totals;
+    };
+
+    Totals totals = emptyTotals();
+    unsigned long games = 0, unfinished_games = 0;
+    vector<unsigned long> bot_games(num_bots, 0), bot_win_shares(num_bots, 0);
+    for(size_t m = 0; m < matchups.size(); m++) {
+        for(unsigned long round = 0; round < rounds; round++) {
+            const RoundResult &result = results[m * rounds + round];
+            addResult(matchups[m], result, totals);
+            games += result.games;
+            unfinished_games += result.unfinished_games;
+            for(size_t i = 0; i < matchups[m].bots.size(); i++) {
+                bot_games[matchups[m].bots[i]] += result.games;
+                bot_win_shares[matchups[m].bots[i]] += result.win_shares[i];
+            }
+        }
+    }
+    vector<double> ratings = fitRatings(totals);
+
+    // Resample whole rounds (every 'Matchup' of a round shares its draws)
+    // with a generator no round uses.
+    Rng rng(seed, UINT64_MAX);
+    vector<vector<double>> samples(num_bots);
+    for(int sample = 0; sample < BOOTSTRAP_SAMPLES && rounds > 0; sample++) {
+        Totals resampled = emptyTotals();
+        for(unsigned long i = 0; i < rounds; i++) {
+            unsigned long round = rng.below((uint32_t) rounds);
+            for(size_t m = 0; m < matchups.size(); m++) {
+                addResult(matchups[m], results[m * rounds + round], resampled);
+            }
+        }
+
+        vector<double> sample_ratings = fitRatings(resampled);
+        for(size_t i = 0; i < num_bots; i++) samples[i].push_back(sample_ratings[i]);
+    }
+
+    out << "Rounds: " << rounds << ", " << matchups.size() << " groups of bots, "
+            << games << " games";
+    if(unfinished_games > 0) out << " (" << unfinished_games << " stopped for being too long)";
+    out << endl << endl;
+
+    vector<size_t> order(num_bots);
+    for(size_t i = 0; i < num_bots; i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return ratings[a] > ratings[b]; });
+
+    out << left << setw(12) << "Bot" << right << setw(8) << "Rating" << setw(18) << "95% interval"
+            << setw(10) << "Games" << setw(10) << "Wins" << endl;
+    for(size_t i: order) {
+        out << left << setw(12) << bot_names[i] << right << fixed << setprecision(0)
+                << setw(8) << ratings[i];
+        if(samples[i].empty()) {
+            out << setw(18) << "-";
+        } else {
+            vector<double> &sorted = samples[i];
+            sort(sorted.begin(), sorted.end());
+            size_t low = (size_t) (sorted.size() * 0.025);
+            size_t high = min(sorted.size() - 1, (size_t) (sorted.size() * 0.975));
+            ostringstream interval;
+            interval << fixed << setprecision(0) << "[" << sorted[low] << ", " << sorted[high] << "]";
+            out << setw(18) << interval.str();
+        }
+        out << setw(10) << bot_games[i] << setw(9) << setprecision(1)
+                << (bot_games[i] == 0 ? 0.0 : 100.0 * bot_win_shares[i] / (WIN_SHARES * bot_games[i]))
+                << "%" << endl;
+    }
+
+    out << endl << "Games with more points than each opponent (ties count half):" << endl;
+    out << setw(12) << "";
+    for(size_t j: order) out << right << setw(11) << bot_names[j];
+    out << endl;
+    for(size_t i: order) {
+        out << left << setw(12) << bot_names[i] << right;
+        for(size_t j: order) {
+            if(i == j || totals.games[i][j] == 0) {
+                out << setw(11) << "-";
+                continue;
+            }
+            out << setw(10) << fixed << setprecision(1)
+                    << 100.0 * totals.points[i][j] / (2 * totals.games[i][j]) << "%";
+        }
+        out << endl;
+    }
+
+    out << endl << "Played in " << fixed << setprecision(2) << elapsed_seconds << " s ("
+            << setprecision(0) << (elapsed_seconds > 0 ? (games + unfinished_games) / elapsed_seconds : 0)
+            << " games/s)." << endl;
+}
@@ -0,0 +1,141 @@
+#include "turn.h"
+
+using namespace std;
+
+Turn::Turn(TurnType type, Position first, Position second, char letter1, char letter2):
+    type(type),
+    first(first),
+    second(second),
+    letter1(letter1),
+    letter2(letter2)
+{}
+
+Turn::Turn(): Turn(TURN_END, Position(), Position(), 0, 0) {}
+
+Turn Turn::moveTwice(Position first, Position second) {
+    return Turn(TURN_MOVE_TWICE, first, second, 0, 0);
+}
+
+Turn Turn::moveOnce(Position position) {
+    return Turn(TURN_MOVE_ONCE, position, Position(), 0, 0);
+}
+
+Turn Turn::exchange(char letter) {
+    return Turn(TURN_EXCHANGE_ONE, Position(), Position(), letter, 0);
+}
+
+Turn Turn::exchange(char letter1, char letter2) {
+    return Turn(TURN_EXCHANGE_TWO, Position(), Position(), letter1, letter2);
+}
+
+Turn Turn::end() {
+    return Turn();
+}
+
+TurnType Turn::getType() const {
+    return type;
+}
+
+int Turn::countMoves() const {
+    if(type == TURN_MOVE_TWICE) return 2;
+    if(type == TURN_MOVE_ONCE) return 1;
+    return 0;
+}
+
+Position Turn::getFirst() const {
+    return first;
+}
+
+Position Turn::getSecond() const {
+    return second;
+}
+
+char Turn::getLetter1() const {
+    return letter1;
+}
+
+char Turn::getLetter2() const {
+    return letter2;
+}
+
+Action Turn::getFirstAction() const {
+    switch(type) {
+        case TURN_MOVE_TWICE:
+        case TURN_MOVE_ONCE:
+            return Action::move(first);
+        case TURN_EXCHANGE_TWO:
+            return Action::exchange(letter1, letter2);
+        case TURN_EXCHANGE_ONE:
+            return Action::exchange(letter1);
+        default:
+            return Action::endTurn();
+    }
+}
+
+int Turn::getActions(Action actions[MAX_ACTIONS]) const {
+    actions[0] = getFirstAction();
+    if(type == TURN_MOVE_TWICE) {
+        actions[1] = Action::move(second);
+        return 2;
+    }
+    if(type == TURN_MOVE_ONCE) {
+        actions[1] = Action::endTurn();
+        return 2;
+    }
+    return 1;
+}
+
+bool Turn::operator==(const Turn &other) const {
+    if(type != other.type) return false;
+
+    switch(type) {
+        case TURN_MOVE_TWICE: return first == other.first && second == other.second;
+        case TURN_MOVE_ONCE: return first == other.first;
+        case TURN_EXCHANGE_TWO: return letter1 == other.letter1 && letter2 == other.letter2;
+        case TURN_EXCHANGE_ONE: return letter1 == other.letter1;
+        default: return true;
+    }
+}
+
+ostream& operator<<(ostream &out, const Turn &turn) {
+    switch(turn.type) {
+        case TURN_MOVE_TWICE: return out << turn.first << ", " << turn.second;
+        case TURN_MOVE_ONCE: return out << turn.first;
+        case TURN_EXCHANGE_TWO: return out << turn.letter1 << ' ' << turn.letter2;
+        case TURN_EXCHANGE_ONE: return out << turn.letter1;
+        default: return out << "-";
+    }
+}
+
+TurnList::TurnList() {
+    turns.reserve(RESERVED_TURNS);
+    first_moves.reserve(RESERVED_FIRST_MOVES);
+}
+
+void TurnList::clear() {
+    turns.clear();
+}
+
+void TurnList::push(const Turn &turn) {
+    turns.push_back(turn);
+}
+
+int TurnList::size() const {
+    return (int) turns.size();
+}
+
+bool TurnList::isEmpty() const {
+    return turns.empty();
+}
+
+const Turn& TurnList::operator[](int index) const {
+    return turns[index];
+}
+
+TurnList::const_iterator TurnList::begin() const {
+    return turns.begin();
+}
+
+TurnList::const_iterator TurnList::end() const {
+    return turns.end();
+}
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include "viewport.h"
+
+using namespace std;
+
+Viewport::Viewport(unsigned int board_width, unsigned int board_height):
+    board_width((int) board_width),
+    board_height((int) board_height),
+    x(0),
+    y(0),
+    width((int) board_width),
+    height((int) board_height)
+{}
+
+int Viewport::getX() const {
+    return x;
+}
+
+int Viewport::getY() const {
+    return y;
+}
+
+int Viewport::getWidth() const {
+    return width;
+}
+
+int Viewport::getHeight() const {
+    return height;
+}
+
+bool Viewport::isPartial() const {
+    return width < board_width || height < board_height;
+}
+
+bool Viewport::contains(Position position) const {
+    return position.getX() >= x && position.getX() < x + width
+            && position.getY() >= y && position.getY() < y + height;
+}
+
+void Viewport::clamp() {
+    x = max(0, min(x, board_width - width));
+    y = max(0, min(y, board_height - height));
+}
+
+bool Viewport::resize(unsigned int width, unsigned int height) {
+    int new_width = min((int) width, board_width), new_height = min((int) height, board_height);
+    if(new_width == this->width && new_height == this->height) return false;
+
+    this->width = new_width;
+    this->height = new_height;
+    clamp();
+    return true;
+}
+
+void Viewport::centerOn(Position position) {
+    x = position.getX() - width / 2;
+    y = position.getY() - height / 2;
+    clamp();
+}
+
+void Viewport::show(Position position) {
+    if(!contains(position)) centerOn(position);
+}
@@ -2,10 +2,10 @@
 
 using namespace std;
 
-Word::Word(Position start, Orientation orientation, string &word):
+Word::Word(Position start, Orientation orientation, string_view word):
     start(start),
     orientation(orientation),
-    word(move(word))
+    word(word)
 {}
 
 Position Word::getStart() const {